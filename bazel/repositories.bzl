@@ -136,6 +136,7 @@ def envoy_dependencies(skip_targets = []):
     _com_github_google_benchmark()
     _com_github_google_jwt_verify()
     _com_github_google_libprotobuf_mutator()
+    _com_github_google_snappy()
     _com_github_gperftools_gperftools()
     _com_github_grpc_grpc()
     _com_github_jbeder_yaml_cpp()
@@ -280,6 +281,16 @@ def _com_github_google_libprotobuf_mutator():
         actual = "@com_github_google_libprotobuf_mutator//:libprotobuf_mutator",
     )
 
+def _com_github_google_snappy():
+    _repository_impl(
+        name = "com_github_google_snappy",
+        build_file = "@envoy//bazel/external:snappy.BUILD",
+    )
+    native.bind(
+        name = "snappy",
+        actual = "@com_github_google_snappy//:snappy",
+    )
+
 def _com_github_jbeder_yaml_cpp():
     location = REPOSITORY_LOCATIONS["com_github_jbeder_yaml_cpp"]
     http_archive(
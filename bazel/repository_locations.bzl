@@ -73,6 +73,11 @@ REPOSITORY_LOCATIONS = dict(
         # 2018-03-06
         urls = ["https://github.com/google/libprotobuf-mutator/archive/c3d2faf04a1070b0b852b0efdef81e1a81ba925e.tar.gz"],
     ),
+    com_github_google_snappy = dict(
+        sha256 = "3dfa02e873ff51a11ee02b9ca391807f0c8ea0529a4924afa645fbf97163f9d4",
+        strip_prefix = "snappy-1.1.7",
+        urls = ["https://github.com/google/snappy/archive/1.1.7.tar.gz"],
+    ),
     com_github_gperftools_gperftools = dict(
         # TODO(cmluciano): Bump to release 2.8
         # This sha is specifically chosen to fix ppc64le builds that require inclusion
@@ -103,6 +103,11 @@ public:
    */
   virtual SysCallSizeResult sendmsg(int fd, const msghdr* message, int flags) PURE;
 
+  /**
+   * @see man 2 recvmsg
+   */
+  virtual SysCallSizeResult recvmsg(int fd, msghdr* message, int flags) PURE;
+
   /**
    * @see man 2 getsockname
    */
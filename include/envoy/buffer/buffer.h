@@ -52,6 +52,34 @@ protected:
   virtual ~BufferFragment() = default;
 };
 
+/**
+ * An account of the memory held by a group of buffers, such as the buffers of a connection. Buffers
+ * bound to an account charge it for the bytes they hold and credit it as they are drained.
+ */
+class BufferMemoryAccount {
+public:
+  virtual ~BufferMemoryAccount() = default;
+
+  /**
+   * Charge the account for bytes added to one of its buffers.
+   * @param amount supplies the number of bytes added.
+   */
+  virtual void charge(uint64_t amount) PURE;
+
+  /**
+   * Credit the account for bytes removed from one of its buffers.
+   * @param amount supplies the number of bytes removed.
+   */
+  virtual void credit(uint64_t amount) PURE;
+
+  /**
+   * @return uint64_t the number of bytes held by the buffers bound to the account.
+   */
+  virtual uint64_t balance() const PURE;
+};
+
+using BufferMemoryAccountSharedPtr = std::shared_ptr<BufferMemoryAccount>;
+
 /**
  * A basic buffer abstraction.
  */
@@ -206,6 +234,13 @@ public:
    */
   virtual Api::IoCallUint64Result write(Network::IoHandle& io_handle) PURE;
 
+  /**
+   * Bind the buffer to a memory account, which is charged for the bytes the buffer holds from
+   * then on. The bytes already held are moved from the previous account, if any, to the new one.
+   * @param account supplies the account, or nullptr to stop accounting the buffer.
+   */
+  virtual void bindAccount(BufferMemoryAccountSharedPtr account) PURE;
+
   /**
    * Copy an integer out of the buffer.
    * @param start supplies the buffer index to start copying from.
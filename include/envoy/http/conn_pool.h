@@ -102,6 +102,14 @@ public:
    */
   virtual bool hasActiveConnections() const PURE;
 
+  /**
+   * Establish connections ahead of demand until the pool holds at least the given number of
+   * connections. Connections are only established if the cluster's connection circuit breaker
+   * allows it. Pools that multiplex requests over a single connection establish at most one.
+   * @param min_connections supplies the number of connections the pool should hold.
+   */
+  virtual void preconnect(uint32_t min_connections) PURE;
+
   /**
    * Create a new stream on the pool.
    * @param response_decoder supplies the decoder events to fire when the response is
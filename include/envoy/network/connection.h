@@ -254,6 +254,34 @@ public:
    */
   virtual uint32_t bufferLimit() const PURE;
 
+  /**
+   * Set the memory accounts charged by the connection's buffers and by the buffers the codecs and
+   * filters of the connection bind them to. Only the receive account may be used to disable reads
+   * from the connection, as the bytes charged to the other account may only drain once more is
+   * read from the connection, for instance a window update for an HTTP/2 send buffer, or the next
+   * request of a pipeline for the read buffer.
+   * @param receive_account supplies the account of the buffers of received bytes which drain
+   *        without reading more from the connection, such as the receive buffers of the HTTP/2
+   *        streams. nullptr if the connection's memory isn't accounted.
+   * @param account supplies the account of all the other buffers: the read and write buffers of
+   *        the connection, the send buffers of the codecs and the bodies buffered by filters.
+   *        nullptr if the connection's memory isn't accounted.
+   */
+  virtual void setBufferMemoryAccounts(Buffer::BufferMemoryAccountSharedPtr receive_account,
+                                       Buffer::BufferMemoryAccountSharedPtr account) PURE;
+
+  /**
+   * @return const Buffer::BufferMemoryAccountSharedPtr& the receive account set with
+   *         setBufferMemoryAccounts(), or nullptr if the connection's memory isn't accounted.
+   */
+  virtual const Buffer::BufferMemoryAccountSharedPtr& receiveBufferMemoryAccount() const PURE;
+
+  /**
+   * @return const Buffer::BufferMemoryAccountSharedPtr& the account set with
+   *         setBufferMemoryAccounts(), or nullptr if the connection's memory isn't accounted.
+   */
+  virtual const Buffer::BufferMemoryAccountSharedPtr& bufferMemoryAccount() const PURE;
+
   /**
    * @return boolean telling if the connection's local address has been restored to an original
    *         destination address, rather than the address the connection was accepted at.
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "envoy/network/connection.h"
 #include "envoy/network/filter.h"
@@ -45,6 +46,15 @@ public:
    */
   virtual void removeListeners(uint64_t listener_tag) PURE;
 
+  /**
+   * Close the connections of a listener which were created by the given filter chains. This is
+   * used once filter chains removed from a listener by an in place update have drained.
+   * @param listener_tag supplies the tag passed to addListener().
+   * @param filter_chains supplies the filter chains whose connections should be closed.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::vector<const FilterChain*>& filter_chains) PURE;
+
   /**
    * Stop listeners using the listener tag as a key. This will not close any connections and is used
    * for draining.
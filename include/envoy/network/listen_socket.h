@@ -8,6 +8,7 @@
 #include "envoy/common/pure.h"
 #include "envoy/network/address.h"
 #include "envoy/network/io_handle.h"
+#include "envoy/stream_info/filter_state.h"
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -215,6 +216,13 @@ public:
    * @return requested server name (e.g. SNI in TLS), if any.
    */
   virtual absl::string_view requestedServerName() const PURE;
+
+  /**
+   * @return the filter state of the socket. Listener filters store the data they extract from the
+   *         socket here, and the connection created for the socket exposes the same state through
+   *         StreamInfo::filterState().
+   */
+  virtual StreamInfo::FilterState& filterState() PURE;
 };
 
 using ConnectionSocketPtr = std::unique_ptr<ConnectionSocket>;
@@ -62,6 +62,14 @@ public:
    */
   virtual uint32_t perConnectionBufferLimitBytes() const PURE;
 
+  /**
+   * Create the memory accounts charged by the buffers of a new connection of the listener and set
+   * them with Connection::setBufferMemoryAccounts(). Does nothing if the listener doesn't account
+   * the memory of its connections.
+   * @param connection supplies the new connection.
+   */
+  virtual void bindBufferMemoryAccounts(Connection& connection) PURE;
+
   /**
    * @return std::chrono::milliseconds the time to wait for all listener filters to complete
    *         operation. If the timeout is reached, the accepted socket is closed without a
@@ -14,6 +14,7 @@
 #include "envoy/http/codec.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/tracing/http_tracer.h"
 #include "envoy/upstream/resource_manager.h"
 #include "envoy/upstream/retry.h"
@@ -365,6 +366,27 @@ public:
   virtual Stats::StatName statName() const PURE;
 };
 
+/**
+ * All request stats of a virtual host or route. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_ROUTE_STATS(COUNTER, HISTOGRAM)                                                        \
+  COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_1xx)                                                                         \
+  COUNTER(upstream_rq_2xx)                                                                         \
+  COUNTER(upstream_rq_3xx)                                                                         \
+  COUNTER(upstream_rq_4xx)                                                                         \
+  COUNTER(upstream_rq_5xx)                                                                         \
+  HISTOGRAM(upstream_rq_time)
+// clang-format on
+
+/**
+ * Struct definition for all request stats of a virtual host or route. @see stats_macros.h
+ */
+struct RouteStats {
+  ALL_ROUTE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
 class RateLimitPolicy;
 class Config;
 
@@ -425,6 +447,12 @@ public:
    * @return bool whether to include the request count header in upstream requests.
    */
   virtual bool includeAttemptCount() const PURE;
+
+  /**
+   * @return const RouteStats* the request stats of the virtual host, or nullptr if the virtual
+   *         host does not emit request stats.
+   */
+  virtual const RouteStats* requestStats() const PURE;
 };
 
 /**
@@ -459,6 +487,30 @@ public:
                AddCookieCallback add_cookie) const PURE;
 };
 
+/**
+ * Tracks the recent upstream response times of a route in order to derive an adaptive delay before
+ * hedged requests are sent. A single estimator is shared by all workers, so implementations must be
+ * thread safe.
+ */
+class HedgeDelayEstimator {
+public:
+  virtual ~HedgeDelayEstimator() = default;
+
+  /**
+   * Record the time it took an upstream request to receive response headers. A request abandoned
+   * because a hedge won the race is recorded with the time it had been outstanding, a lower bound
+   * of its response time, so that slow requests aren't left out of the estimate.
+   * @param response_time supplies the observed response time.
+   */
+  virtual void recordResponseTime(std::chrono::milliseconds response_time) PURE;
+
+  /**
+   * @return absl::optional<std::chrono::milliseconds> the delay after which hedged requests should
+   * be sent, or absl::nullopt if not enough response times have been recorded yet.
+   */
+  virtual absl::optional<std::chrono::milliseconds> hedgeDelay() const PURE;
+};
+
 /**
  * Route level hedging policy.
  */
@@ -483,6 +535,12 @@ public:
    * will be canceled immediately.
    */
   virtual bool hedgeOnPerTryTimeout() const PURE;
+
+  /**
+   * @return HedgeDelayEstimator* the estimator used to delay the requests beyond the first one
+   * that are sent initially, or nullptr if they should be sent together with the first request.
+   */
+  virtual HedgeDelayEstimator* hedgeDelayEstimator() const PURE;
 };
 
 class MetadataMatchCriterion {
@@ -667,6 +725,12 @@ public:
    */
   virtual const VirtualHost& virtualHost() const PURE;
 
+  /**
+   * @return const RouteStats* the request stats of the route, or nullptr if the route does not
+   *         emit request stats. Routes may share their stats with other routes.
+   */
+  virtual const RouteStats* requestStats() const PURE;
+
   /**
    * @return bool true if the :authority header should be overwritten with the upstream hostname.
    */
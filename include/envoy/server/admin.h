@@ -49,6 +49,22 @@ public:
    * request.
    */
   virtual const Http::HeaderMap& getRequestHeaders() const PURE;
+
+  /**
+   * Callback that appends the next part of a chunked response.
+   * @param response supplies the buffer to append the chunk to.
+   * @return bool true if there is more data to follow, false if the response is complete.
+   */
+  using NextChunkCb = std::function<bool(Buffer::Instance& response)>;
+
+  /**
+   * Continue the response after the handler returns by calling next_chunk once per dispatcher
+   * iteration until it returns false. This lets handlers with very large responses write them
+   * out incrementally without blocking the main thread for the whole response. Chunks are not
+   * produced while the downstream connection is above its write buffer high watermark.
+   * @param next_chunk supplies the callback producing the rest of the response.
+   */
+  virtual void setNextChunkCallback(NextChunkCb next_chunk) PURE;
 };
 
 /**
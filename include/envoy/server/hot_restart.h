@@ -74,6 +74,14 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  /**
+   * Retrieve the TLS server session state of our parent process, so that connections to the new
+   * process can resume the sessions established with the parent.
+   * @return std::string the state as exported by the parent's Ssl::ContextManager, or empty if
+   *         there is no parent.
+   */
+  virtual std::string getParentTlsSessionState() PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
@@ -96,6 +96,16 @@ public:
   virtual uint64_t nextListenerTag() PURE;
 };
 
+/**
+ * The memory held by the buffers of a downstream connection.
+ */
+struct ConnectionMemoryUsage {
+  uint64_t connection_id_;
+  Network::Address::InstanceConstSharedPtr local_address_;
+  Network::Address::InstanceConstSharedPtr remote_address_;
+  uint64_t bytes_;
+};
+
 /**
  * A manager for all listeners and all threaded connection handling workers.
  */
@@ -142,6 +152,14 @@ public:
    */
   virtual uint64_t numConnections() PURE;
 
+  /**
+   * @param limit supplies the maximum number of connections to return.
+   * @return std::vector<ConnectionMemoryUsage> the connections holding the most buffered bytes,
+   *         largest first, among the connections of the listeners which account their memory.
+   *         This may be called from any thread.
+   */
+  virtual std::vector<ConnectionMemoryUsage> topConnectionsByMemory(uint64_t limit) const PURE;
+
   /**
    * Remove a listener by name.
    * @param name supplies the listener name to remove.
@@ -177,6 +177,12 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return uint32_t the number of per-thread slots allocated for each counter, or 0 if counters
+   *         are not sharded.
+   */
+  virtual uint32_t statsCounterShards() const PURE;
+
   /**
    * Converts the Options in to CommandLineOptions proto message defined in server_info.proto.
    * @return CommandLineOptionsPtr the protobuf representation of the options.
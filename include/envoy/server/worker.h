@@ -1,7 +1,9 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
+#include "envoy/network/filter.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload_manager.h"
 
@@ -65,6 +67,17 @@ public:
   virtual void removeListener(Network::ListenerConfig& listener,
                               std::function<void()> completion) PURE;
 
+  /**
+   * Close the connections of a listener which were created by the given filter chains.
+   * @param listener_tag supplies the tag of the listener the filter chains were removed from.
+   * @param filter_chains supplies the removed filter chains.
+   * @param completion supplies the completion to be called when the connections have been closed.
+   *        This completion is called on the worker thread. No locking is performed by the worker.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::vector<const Network::FilterChain*>& filter_chains,
+                                  std::function<void()> completion) PURE;
+
   /**
    * Stop a listener from accepting new connections. This is used for server draining.
    * @param listener supplies the listener to stop.
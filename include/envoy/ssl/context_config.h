@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
@@ -12,6 +14,18 @@
 namespace Envoy {
 namespace Ssl {
 
+/**
+ * Parameters of dynamic TLS record sizing.
+ */
+struct DynamicRecordSizingConfig {
+  // Size of the records written while the connection is new or has been idle.
+  uint32_t initial_record_size_;
+  // Bytes written with small records before switching to full size records.
+  uint64_t small_record_bytes_;
+  // Idle time after which small records are used again.
+  std::chrono::milliseconds idle_timeout_;
+};
+
 /**
  * Supplies the configuration for an SSL context.
  */
@@ -58,6 +72,18 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return true if the record layer of established connections should be offloaded to the
+   * kernel when possible.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
+  /**
+   * @return DynamicRecordSizingConfig the dynamic record sizing parameters, or nullptr if every
+   * record should be written with the maximum size.
+   */
+  virtual const DynamicRecordSizingConfig* dynamicRecordSizing() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
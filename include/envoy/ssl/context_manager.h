@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <string>
 
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
@@ -38,6 +39,20 @@ public:
    * Iterate through all currently allocated contexts.
    */
   virtual void iterateContexts(std::function<void(const Context&)> callback) PURE;
+
+  /**
+   * @return std::string the session state shared by the server contexts, serialized so that it
+   *         can be handed over to a new process on hot restart.
+   */
+  virtual std::string exportServerSessionState() PURE;
+
+  /**
+   * Seeds the session state shared by the server contexts with the state of another process.
+   * Server contexts then resume the sessions established through that process.
+   * @param state supplies the state returned by exportServerSessionState().
+   * @return bool false if the state could not be parsed.
+   */
+  virtual bool importServerSessionState(const std::string& state) PURE;
 };
 
 } // namespace Ssl
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * Callbacks used by a private key method provider to notify a connection that an asynchronous
+ * private key operation has finished and the handshake can be resumed.
+ */
+class PrivateKeyConnectionCallbacks {
+public:
+  virtual ~PrivateKeyConnectionCallbacks() = default;
+
+  /**
+   * Called on the connection's dispatcher thread when the pending private key operation has
+   * completed, either successfully or with a failure. The connection is expected to call
+   * SSL_do_handshake() again, which will collect the result via the provider's complete()
+   * function.
+   */
+  virtual void onPrivateKeyMethodComplete() PURE;
+};
+
+/**
+ * A private key method provider supplies a BoringSSL SSL_PRIVATE_KEY_METHOD which is used instead
+ * of a locally loaded private key for the handshake signing and decryption operations. The
+ * operations may complete asynchronously, in which case the handshake is suspended until the
+ * provider calls PrivateKeyConnectionCallbacks::onPrivateKeyMethodComplete().
+ */
+class PrivateKeyMethodProvider {
+public:
+  virtual ~PrivateKeyMethodProvider() = default;
+
+  /**
+   * Register an SSL connection with the provider. This is called once per connection before the
+   * handshake is started, on the thread that owns the connection.
+   * @param ssl supplies the SSL connection that may use the private key method.
+   * @param cb supplies the callbacks to invoke when an asynchronous operation completes.
+   * @param dispatcher supplies the dispatcher of the thread that owns the connection. Completions
+   *        must be posted to this dispatcher.
+   */
+  virtual void registerPrivateKeyMethod(SSL* ssl, PrivateKeyConnectionCallbacks& cb,
+                                        Event::Dispatcher& dispatcher) PURE;
+
+  /**
+   * Unregister an SSL connection from the provider. Any pending operation for the connection
+   * must be cancelled and its callbacks must not be called after this returns.
+   * @param ssl supplies the SSL connection to unregister.
+   */
+  virtual void unregisterPrivateKeyMethod(SSL* ssl) PURE;
+
+  /**
+   * @return const SSL_PRIVATE_KEY_METHOD* the BoringSSL private key method to install on the
+   *         SSL_CTX in place of the private key. Must remain valid for the provider's lifetime.
+   */
+  virtual const SSL_PRIVATE_KEY_METHOD* getBoringSslPrivateKeyMethod() PURE;
+};
+
+using PrivateKeyMethodProviderSharedPtr = std::shared_ptr<PrivateKeyMethodProvider>;
+
+} // namespace Ssl
+} // namespace Envoy
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/api/api.h"
+#include "envoy/common/pure.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/ssl/private_key_method_provider.h"
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * Implemented by each private key method provider and registered via
+ * Registry::registerFactory() or the convenience class RegistryFactory.
+ */
+class PrivateKeyMethodProviderInstanceFactory {
+public:
+  virtual ~PrivateKeyMethodProviderInstanceFactory() = default;
+
+  /**
+   * Create a particular private key method provider implementation.
+   * @param config const Protobuf::Message& supplies the config for the provider implementation.
+   * @param api Api::Api& supplies the Api used to create threads and read files.
+   * @param singleton_manager Singleton::Manager& supplies the singleton manager, through which the
+   *        instances of a provider may share state such as thread pools.
+   * @return PrivateKeyMethodProviderSharedPtr the provider instance. Should not be nullptr.
+   * @throw EnvoyException if the implementation is unable to produce an instance with the
+   *        provided parameters.
+   */
+  virtual PrivateKeyMethodProviderSharedPtr
+  createPrivateKeyMethodProviderInstance(const Protobuf::Message& config, Api::Api& api,
+                                         Singleton::Manager& singleton_manager) PURE;
+
+  /**
+   * @return ProtobufTypes::MessagePtr create empty config proto message. The provider config,
+   *         which arrives in an opaque google.protobuf.Struct or google.protobuf.Any message,
+   *         will be translated into this empty proto.
+   */
+  virtual ProtobufTypes::MessagePtr createEmptyConfigProto() PURE;
+
+  /**
+   * @return std::string the identifying name for a particular implementation of a private key
+   *         method provider produced by the factory.
+   */
+  virtual std::string name() PURE;
+};
+
+} // namespace Ssl
+} // namespace Envoy
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "envoy/common/pure.h"
+#include "envoy/ssl/private_key_method_provider.h"
 
 namespace Envoy {
 namespace Ssl {
@@ -44,6 +45,12 @@ public:
    * password was inlined.
    */
   virtual const std::string& passwordPath() const PURE;
+
+  /**
+   * @return the private key method provider to be used in place of privateKey(), or nullptr if
+   * the private key is loaded locally.
+   */
+  virtual PrivateKeyMethodProviderSharedPtr privateKeyMethod() const PURE;
 };
 
 using TlsCertificateConfigPtr = std::unique_ptr<TlsCertificateConfig>;
@@ -7,6 +7,8 @@
 #include "envoy/common/pure.h"
 #include "envoy/stats/stats.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Stats {
 
@@ -119,5 +121,22 @@ public:
 
 using ParentHistogramSharedPtr = std::shared_ptr<ParentHistogram>;
 
+/**
+ * Selects how the values of each histogram are recorded.
+ */
+class HistogramSettings {
+public:
+  virtual ~HistogramSettings() = default;
+
+  /**
+   * @param name the name of a histogram.
+   * @return bool true if the values of the histogram should be counted in fixed log linear buckets,
+   *         with a single atomic increment per value, rather than inserted into a circllhist.
+   */
+  virtual bool fixedBuckets(absl::string_view name) const PURE;
+};
+
+using HistogramSettingsConstPtr = std::unique_ptr<const HistogramSettings>;
+
 } // namespace Stats
 } // namespace Envoy
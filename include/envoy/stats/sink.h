@@ -50,6 +50,14 @@ public:
    */
   virtual void flush(MetricSnapshot& snapshot) PURE;
 
+  /**
+   * @return bool true if the sink only needs the metrics that changed since the previous flush.
+   *         The snapshot passed to flush() then only contains the counters with a non-zero delta,
+   *         the gauges updated since the previous flush and the histograms with values recorded
+   *         in the last interval.
+   */
+  virtual bool changedMetricsOnly() const PURE;
+
   /**
    * Flush a single histogram sample. Note: this call is called synchronously as a part of recording
    * the metric, so implementations must be thread-safe.
@@ -94,11 +94,13 @@ public:
    * Flags:
    * Used: used by all stats types to figure out whether they have been used.
    * Logic...: used by gauges to cache how they should be combined with a parent's value.
+   * Changed: used by gauges to track whether they have been updated since the last latchChanged().
    */
   struct Flags {
     static const uint8_t Used = 0x01;
     static const uint8_t LogicAccumulate = 0x02;
     static const uint8_t NeverImport = 0x04;
+    static const uint8_t Changed = 0x08;
   };
   virtual SymbolTable& symbolTable() PURE;
   virtual const SymbolTable& constSymbolTable() const PURE;
@@ -141,6 +143,13 @@ public:
   virtual void sub(uint64_t amount) PURE;
   virtual uint64_t value() const PURE;
 
+  /**
+   * Like Counter::latch(), this is called once per stats flush to find the gauges that need to be
+   * sent to sinks which only want changed metrics. It is not called if no sink wants them.
+   * @return bool whether the gauge has been updated since the last call.
+   */
+  virtual bool latchChanged() PURE;
+
   /**
    * @return the import mode, dictating behavior of the gauge across hot restarts.
    */
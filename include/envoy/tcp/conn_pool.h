@@ -191,6 +191,14 @@ public:
    */
   virtual void drainConnections() PURE;
 
+  /**
+   * Establish connections ahead of demand until the pool holds at least the given number of
+   * connections. Connections are only established if the cluster's connection circuit breaker
+   * allows it.
+   * @param min_connections supplies the number of connections the pool should hold.
+   */
+  virtual void preconnect(uint32_t min_connections) PURE;
+
   /**
    * Create a new connection on the pool.
    * @param cb supplies the callbacks to invoke when the connection is ready or has failed. The
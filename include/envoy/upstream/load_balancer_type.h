@@ -80,6 +80,12 @@ public:
    * selection from the fallback subset fails.
    */
   virtual bool panicModeAny() const PURE;
+
+  /*
+   * @return uint32_t the maximum number of subsets to create on demand, or 0 if all subsets are
+   * created eagerly from host metadata.
+   */
+  virtual uint32_t maxLazySubsets() const PURE;
 };
 
 } // namespace Upstream
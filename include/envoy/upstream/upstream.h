@@ -508,6 +508,7 @@ public:
   COUNTER(assignment_stale)                                                                        \
   COUNTER(assignment_timeout_received)                                                             \
   COUNTER(bind_errors)                                                                             \
+  COUNTER(lb_hash_bounded_load_overflow)                                                           \
   COUNTER(lb_healthy_panic)                                                                        \
   COUNTER(lb_local_cluster_not_ok)                                                                 \
   COUNTER(lb_recalculate_zone_structures)                                                          \
@@ -547,6 +548,9 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect_total)                                                            \
+  COUNTER(upstream_cx_preconnect_used)                                                             \
+  COUNTER(upstream_cx_preconnect_wasted)                                                           \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -559,6 +563,9 @@ public:
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_hedge_cancelled)                                                             \
+  COUNTER(upstream_rq_hedge_sent)                                                                  \
+  COUNTER(upstream_rq_hedge_won)                                                                   \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(upstream_rq_pending_failure_eject)                                                       \
   COUNTER(upstream_rq_pending_overflow)                                                            \
@@ -838,6 +845,19 @@ public:
    */
   virtual bool warmHosts() const PURE;
 
+  /**
+   * @return the number of connections each connection pool of this cluster keeps established
+   *         relative to its current number of active and pending requests. A value of 1.0 means
+   *         that connections are only established on demand.
+   */
+  virtual float perUpstreamPreconnectRatio() const PURE;
+
+  /**
+   * @return the number of connections each worker establishes to a host when it is added to
+   *         this cluster. Zero disables warming connection pools on host addition.
+   */
+  virtual uint32_t preconnectOnHostAdd() const PURE;
+
   /**
    * @return eds cluster service_name of the cluster.
    */
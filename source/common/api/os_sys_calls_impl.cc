@@ -89,6 +89,11 @@ SysCallSizeResult OsSysCallsImpl::sendmsg(int fd, const msghdr* message, int fla
   return {rc, errno};
 }
 
+SysCallSizeResult OsSysCallsImpl::recvmsg(int fd, msghdr* message, int flags) {
+  const ssize_t rc = ::recvmsg(fd, message, flags);
+  return {rc, errno};
+}
+
 SysCallIntResult OsSysCallsImpl::getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) {
   const int rc = ::getsockname(sockfd, addr, addrlen);
   return {rc, errno};
@@ -30,6 +30,7 @@ public:
   SysCallSizeResult sendto(int fd, const void* buffer, size_t size, int flags, const sockaddr* addr,
                            socklen_t addrlen) override;
   SysCallSizeResult sendmsg(int fd, const msghdr* message, int flags) override;
+  SysCallSizeResult recvmsg(int fd, msghdr* message, int flags) override;
   SysCallIntResult getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) override;
 };
 
@@ -28,6 +28,7 @@ void OwnedImpl::add(const void* data, uint64_t size) {
       new_slice_needed = true;
     }
   }
+  updateAccount();
 }
 
 void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
@@ -40,6 +41,7 @@ void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
     length_ += fragment.size();
     slices_.emplace_back(std::make_unique<UnownedSlice>(fragment));
   }
+  updateAccount();
 }
 
 void OwnedImpl::add(absl::string_view data) {
@@ -48,6 +50,7 @@ void OwnedImpl::add(absl::string_view data) {
   } else {
     add(data.data(), data.size());
   }
+  updateAccount();
 }
 
 void OwnedImpl::add(const Instance& data) {
@@ -86,6 +89,7 @@ void OwnedImpl::prepend(absl::string_view data) {
       new_slice_needed = true;
     }
   }
+  updateAccount();
 }
 
 void OwnedImpl::prepend(Instance& data) {
@@ -110,6 +114,7 @@ void OwnedImpl::prepend(Instance& data) {
     }
     other.postProcess();
   }
+  updateAccount();
 }
 
 void OwnedImpl::commit(RawSlice* iovecs, uint64_t num_iovecs) {
@@ -152,6 +157,7 @@ void OwnedImpl::commit(RawSlice* iovecs, uint64_t num_iovecs) {
 
     ASSERT(num_slices_committed > 0);
   }
+  updateAccount();
 }
 
 void OwnedImpl::copyOut(size_t start, uint64_t size, void* data) const {
@@ -213,6 +219,7 @@ void OwnedImpl::drain(uint64_t size) {
       }
     }
   }
+  updateAccount();
 }
 
 uint64_t OwnedImpl::getRawSlices(RawSlice* out, uint64_t out_size) const {
@@ -325,6 +332,7 @@ void OwnedImpl::move(Instance& rhs) {
     }
     other.postProcess();
   }
+  updateAccount();
 }
 
 void OwnedImpl::move(Instance& rhs, uint64_t length) {
@@ -360,6 +368,7 @@ void OwnedImpl::move(Instance& rhs, uint64_t length) {
     }
     other.postProcess();
   }
+  updateAccount();
 }
 
 Api::IoCallUint64Result OwnedImpl::read(Network::IoHandle& io_handle, uint64_t max_length) {
@@ -558,6 +567,31 @@ OwnedImpl::OwnedImpl(const Instance& data) : OwnedImpl() { add(data); }
 
 OwnedImpl::OwnedImpl(const void* data, uint64_t size) : OwnedImpl() { add(data, size); }
 
+OwnedImpl::~OwnedImpl() {
+  if (account_ != nullptr) {
+    account_->credit(account_charged_);
+  }
+}
+
+void OwnedImpl::bindAccount(BufferMemoryAccountSharedPtr account) {
+  if (account_ != nullptr) {
+    account_->credit(account_charged_);
+    account_charged_ = 0;
+  }
+  account_ = std::move(account);
+  updateAccount();
+}
+
+void OwnedImpl::updateAccountBalance() {
+  const uint64_t length = this->length();
+  if (length > account_charged_) {
+    account_->charge(length - account_charged_);
+  } else if (length < account_charged_) {
+    account_->credit(account_charged_ - length);
+  }
+  account_charged_ = length;
+}
+
 std::string OwnedImpl::toString() const {
   uint64_t num_slices = getRawSlices(nullptr, 0);
   STACK_ARRAY(slices, RawSlice, num_slices);
@@ -575,7 +609,7 @@ std::string OwnedImpl::toString() const {
   return output;
 }
 
-void OwnedImpl::postProcess() {}
+void OwnedImpl::postProcess() { updateAccount(); }
 
 void OwnedImpl::appendSliceForTest(const void* data, uint64_t size) {
   if (old_impl_) {
@@ -585,6 +619,7 @@ void OwnedImpl::appendSliceForTest(const void* data, uint64_t size) {
     slices_.emplace_back(OwnedSlice::create(data, size));
     length_ += size;
   }
+  updateAccount();
 }
 
 void OwnedImpl::appendSliceForTest(absl::string_view data) {
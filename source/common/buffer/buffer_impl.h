@@ -483,6 +483,7 @@ public:
   OwnedImpl(absl::string_view data);
   OwnedImpl(const Instance& data);
   OwnedImpl(const void* data, uint64_t size);
+  ~OwnedImpl() override;
 
   // Buffer::Instance
   void add(const void* data, uint64_t size) override;
@@ -504,6 +505,7 @@ public:
   ssize_t search(const void* data, uint64_t size, size_t start) const override;
   Api::IoCallUint64Result write(Network::IoHandle& io_handle) override;
   std::string toString() const override;
+  void bindAccount(BufferMemoryAccountSharedPtr account) override;
 
   // LibEventInstance
   Event::Libevent::BufferPtr& buffer() override { return buffer_; }
@@ -547,6 +549,17 @@ private:
    */
   bool isSameBufferImpl(const Instance& rhs) const;
 
+  /**
+   * Charges or credits the bound account, if any, for the change of length since the last update.
+   * Called at the end of every operation which can change the length of the buffer.
+   */
+  void updateAccount() {
+    if (account_ != nullptr) {
+      updateAccountBalance();
+    }
+  }
+  void updateAccountBalance();
+
   /** Whether to use the old evbuffer implementation when constructing new OwnedImpl objects. */
   static bool use_old_impl_;
 
@@ -561,6 +574,12 @@ private:
 
   /** Used when old_impl_==true */
   Event::Libevent::BufferPtr buffer_;
+
+  /** The account charged for the buffer's bytes, if any. */
+  BufferMemoryAccountSharedPtr account_;
+
+  /** Number of bytes the account was charged for. */
+  uint64_t account_charged_{0};
 };
 
 } // namespace Buffer
@@ -33,7 +33,10 @@ public:
   Api::IoCallUint64Result read(Network::IoHandle& io_handle, uint64_t max_length) override;
   uint64_t reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) override;
   Api::IoCallUint64Result write(Network::IoHandle& io_handle) override;
-  void postProcess() override { checkLowWatermark(); }
+  void postProcess() override {
+    OwnedImpl::postProcess();
+    checkLowWatermark();
+  }
 
   void setWatermarks(uint32_t watermark) { setWatermarks(watermark / 2, watermark); }
   void setWatermarks(uint32_t low_watermark, uint32_t high_watermark);
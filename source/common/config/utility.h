@@ -255,6 +255,12 @@ public:
   static Stats::StatsMatcherPtr
   createStatsMatcher(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
 
+  /**
+   * Create HistogramSettings instance.
+   */
+  static Stats::HistogramSettingsConstPtr
+  createHistogramSettings(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
   /**
    * Obtain gRPC async client factory from a envoy::api::v2::core::ApiConfigSource.
    * @param async_client_manager gRPC async client manager.
@@ -172,6 +172,7 @@ private:
       return nullptr;
     }
     bool includeAttemptCount() const override { return false; }
+    const Router::RouteStats* requestStats() const override { return nullptr; }
 
     static const NullRateLimitPolicy rate_limit_policy_;
     static const NullConfig route_configuration_;
@@ -226,6 +227,7 @@ private:
       return opaque_config_;
     }
     const Router::VirtualHost& virtualHost() const override { return virtual_host_; }
+    const Router::RouteStats* requestStats() const override { return nullptr; }
     bool autoHostRewrite() const override { return false; }
     bool includeVirtualHostRateLimits() const override { return true; }
     const envoy::api::v2::core::Metadata& metadata() const override { return metadata_; }
@@ -1856,6 +1856,7 @@ Buffer::WatermarkBufferPtr ConnectionManagerImpl::ActiveStreamDecoderFilter::cre
       std::make_unique<Buffer::WatermarkBuffer>([this]() -> void { this->requestDataDrained(); },
                                                 [this]() -> void { this->requestDataTooLarge(); });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->bindAccount(connection()->bufferMemoryAccount());
   return buffer;
 }
 
@@ -1984,6 +1985,7 @@ Buffer::WatermarkBufferPtr ConnectionManagerImpl::ActiveStreamEncoderFilter::cre
   auto buffer = new Buffer::WatermarkBuffer([this]() -> void { this->responseDataDrained(); },
                                             [this]() -> void { this->responseDataTooLarge(); });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->bindAccount(connection()->bufferMemoryAccount());
   return Buffer::WatermarkBufferPtr{buffer};
 }
 
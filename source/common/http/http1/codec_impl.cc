@@ -325,6 +325,7 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, http_parser_type
                                               [&]() -> void { this->onAboveHighWatermark(); }),
       max_headers_kb_(max_headers_kb) {
   output_buffer_.setWatermarks(connection.bufferLimit());
+  output_buffer_.bindAccount(connection.bufferMemoryAccount());
   http_parser_init(&parser_, type);
   parser_.data = this;
 }
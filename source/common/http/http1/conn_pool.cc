@@ -1,5 +1,6 @@
 #include "common/http/http1/conn_pool.h"
 
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -63,9 +64,20 @@ bool ConnPoolImpl::hasActiveConnections() const {
   return !pending_requests_.empty() || !busy_clients_.empty();
 }
 
+void ConnPoolImpl::preconnect(uint32_t min_connections) {
+  while (drained_callbacks_.empty() &&
+         ready_clients_.size() + busy_clients_.size() < min_connections &&
+         createPreconnectedConnection()) {
+  }
+}
+
 void ConnPoolImpl::attachRequestToClient(ActiveClient& client, StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) {
   ASSERT(!client.stream_wrapper_);
+  if (client.preconnected_) {
+    host_->cluster().stats().upstream_cx_preconnect_used_.inc();
+    client.preconnected_ = false;
+  }
   host_->cluster().stats().upstream_rq_total_.inc();
   host_->stats().rq_total_.inc();
   client.stream_wrapper_ = std::make_unique<StreamWrapper>(response_decoder, client);
@@ -90,12 +102,42 @@ void ConnPoolImpl::createNewConnection() {
   client->moveIntoList(std::move(client), busy_clients_);
 }
 
+bool ConnPoolImpl::createPreconnectedConnection() {
+  // Unlike connections created for a pending request, preconnected connections never exceed the
+  // connection circuit breaker. This bounds the load preconnecting puts on the upstream.
+  if (!host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    return false;
+  }
+
+  ENVOY_LOG(debug, "preconnecting a new connection");
+  host_->cluster().stats().upstream_cx_preconnect_total_.inc();
+  ActiveClientPtr client(new ActiveClient(*this));
+  client->preconnected_ = true;
+  client->moveIntoList(std::move(client), busy_clients_);
+  return true;
+}
+
+void ConnPoolImpl::maybePreconnect() {
+  const float ratio = host_->cluster().perUpstreamPreconnectRatio();
+  if (ratio <= 1.0 || !drained_callbacks_.empty()) {
+    return;
+  }
+
+  // Keep ratio times as many connections as there are active and pending requests. Connecting
+  // clients are part of busy_clients_ and so count towards the total.
+  const uint64_t demand = active_streams_ + pending_requests_.size();
+  const uint64_t target = static_cast<uint64_t>(std::ceil(demand * ratio));
+  while (ready_clients_.size() + busy_clients_.size() < target && createPreconnectedConnection()) {
+  }
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_decoder,
                                                      ConnectionPool::Callbacks& callbacks) {
   if (!ready_clients_.empty()) {
     ready_clients_.front()->moveBetweenLists(ready_clients_, busy_clients_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_clients_.front()->codec_client_);
     attachRequestToClient(*busy_clients_.front(), response_decoder, callbacks);
+    maybePreconnect();
     return nullptr;
   }
 
@@ -111,7 +153,9 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_dec
       createNewConnection();
     }
 
-    return newPendingRequest(response_decoder, callbacks);
+    ConnectionPool::Cancellable* pending = newPendingRequest(response_decoder, callbacks);
+    maybePreconnect();
+    return pending;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, absl::string_view(),
@@ -259,11 +303,13 @@ ConnPoolImpl::StreamWrapper::StreamWrapper(StreamDecoder& response_decoder, Acti
   StreamEncoderWrapper::inner_.getStream().addCallbacks(*this);
   parent_.parent_.host_->cluster().stats().upstream_rq_active_.inc();
   parent_.parent_.host_->stats().rq_active_.inc();
+  parent_.parent_.active_streams_++;
 }
 
 ConnPoolImpl::StreamWrapper::~StreamWrapper() {
   parent_.parent_.host_->cluster().stats().upstream_rq_active_.dec();
   parent_.parent_.host_->stats().rq_active_.dec();
+  parent_.parent_.active_streams_--;
 }
 
 void ConnPoolImpl::StreamWrapper::onEncodeComplete() { encode_complete_ = true; }
@@ -326,6 +372,9 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
 }
 
 ConnPoolImpl::ActiveClient::~ActiveClient() {
+  if (preconnected_) {
+    parent_.host_->cluster().stats().upstream_cx_preconnect_wasted_.inc();
+  }
   parent_.host_->cluster().stats().upstream_cx_active_.dec();
   parent_.host_->stats().cx_active_.dec();
   conn_length_->complete();
@@ -57,6 +57,8 @@ ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_l
   if (buffer_limit > 0) {
     setWriteBufferWatermarks(buffer_limit / 2, buffer_limit);
   }
+  pending_recv_data_.bindAccount(parent_.connection_.receiveBufferMemoryAccount());
+  pending_send_data_.bindAccount(parent_.connection_.bufferMemoryAccount());
 }
 
 static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
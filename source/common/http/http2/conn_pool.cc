@@ -57,6 +57,20 @@ bool ConnPoolImpl::hasActiveConnections() const {
   return !pending_requests_.empty();
 }
 
+void ConnPoolImpl::preconnect(uint32_t min_connections) {
+  // All streams are multiplexed over the primary client, so there is nothing to do beyond
+  // establishing it.
+  if (min_connections == 0 || primary_client_ != nullptr || !drained_callbacks_.empty() ||
+      !host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "preconnecting a new connection");
+  host_->cluster().stats().upstream_cx_preconnect_total_.inc();
+  primary_client_ = std::make_unique<ActiveClient>(*this);
+  primary_client_->preconnected_ = true;
+}
+
 void ConnPoolImpl::checkForDrained() {
   if (drained_callbacks_.empty()) {
     return;
@@ -94,6 +108,10 @@ void ConnPoolImpl::newClientStream(Http::StreamDecoder& response_decoder,
     host_->cluster().stats().upstream_rq_pending_overflow_.inc();
   } else {
     ENVOY_CONN_LOG(debug, "creating stream", *primary_client_->client_);
+    if (primary_client_->preconnected_) {
+      host_->cluster().stats().upstream_cx_preconnect_used_.inc();
+      primary_client_->preconnected_ = false;
+    }
     primary_client_->total_streams_++;
     host_->stats().rq_total_.inc();
     host_->stats().rq_active_.inc();
@@ -297,6 +315,9 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
 }
 
 ConnPoolImpl::ActiveClient::~ActiveClient() {
+  if (preconnected_) {
+    parent_.host_->cluster().stats().upstream_cx_preconnect_wasted_.inc();
+  }
   parent_.host_->stats().cx_active_.dec();
   parent_.host_->cluster().stats().upstream_cx_active_.dec();
   conn_length_->complete();
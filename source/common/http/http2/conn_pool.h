@@ -34,6 +34,7 @@ public:
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
   bool hasActiveConnections() const override;
+  void preconnect(uint32_t min_connections) override;
   ConnectionPool::Cancellable* newStream(Http::StreamDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
   Upstream::HostDescriptionConstSharedPtr host() const override { return host_; };
@@ -72,6 +73,8 @@ protected:
     bool upstream_ready_{};
     Stats::TimespanPtr conn_length_;
     bool closed_with_active_rq_{};
+    // Set if the client was established ahead of demand and has not served a stream yet.
+    bool preconnected_{};
   };
 
   using ActiveClientPtr = std::unique_ptr<ActiveClient>;
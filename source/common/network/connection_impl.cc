@@ -47,7 +47,7 @@ std::atomic<uint64_t> ConnectionImpl::next_global_id_;
 ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
                                TransportSocketPtr&& transport_socket, bool connected)
     : transport_socket_(std::move(transport_socket)), socket_(std::move(socket)),
-      filter_manager_(*this), stream_info_(dispatcher.timeSource()),
+      filter_manager_(*this), stream_info_(dispatcher.timeSource(), socket_->filterState()),
       write_buffer_(
           dispatcher.getWatermarkFactory().create([this]() -> void { this->onLowWatermark(); },
                                                   [this]() -> void { this->onHighWatermark(); })),
@@ -434,6 +434,14 @@ void ConnectionImpl::setBufferLimits(uint32_t limit) {
   }
 }
 
+void ConnectionImpl::setBufferMemoryAccounts(Buffer::BufferMemoryAccountSharedPtr receive_account,
+                                             Buffer::BufferMemoryAccountSharedPtr account) {
+  read_buffer_.bindAccount(account);
+  write_buffer_->bindAccount(account);
+  receive_buffer_memory_account_ = std::move(receive_account);
+  buffer_memory_account_ = std::move(account);
+}
+
 void ConnectionImpl::onLowWatermark() {
   ENVOY_CONN_LOG(debug, "onBelowWriteBufferLowWatermark", *this);
   ASSERT(above_high_watermark_);
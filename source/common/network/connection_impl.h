@@ -86,6 +86,14 @@ public:
   void write(Buffer::Instance& data, bool end_stream) override;
   void setBufferLimits(uint32_t limit) override;
   uint32_t bufferLimit() const override { return read_buffer_limit_; }
+  void setBufferMemoryAccounts(Buffer::BufferMemoryAccountSharedPtr receive_account,
+                               Buffer::BufferMemoryAccountSharedPtr account) override;
+  const Buffer::BufferMemoryAccountSharedPtr& receiveBufferMemoryAccount() const override {
+    return receive_buffer_memory_account_;
+  }
+  const Buffer::BufferMemoryAccountSharedPtr& bufferMemoryAccount() const override {
+    return buffer_memory_account_;
+  }
   bool localAddressRestored() const override { return socket_->localAddressRestored(); }
   bool aboveHighWatermark() const override { return above_high_watermark_; }
   const ConnectionSocket::OptionsSharedPtr& socketOptions() const override {
@@ -148,6 +156,8 @@ protected:
   // a generic pointer.
   Buffer::InstancePtr write_buffer_;
   uint32_t read_buffer_limit_ = 0;
+  Buffer::BufferMemoryAccountSharedPtr receive_buffer_memory_account_;
+  Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
   std::chrono::milliseconds delayed_close_timeout_{0};
 
 protected:
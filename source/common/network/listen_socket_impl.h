@@ -10,6 +10,7 @@
 #include "envoy/network/listen_socket.h"
 
 #include "common/common/assert.h"
+#include "common/stream_info/filter_state_impl.h"
 
 namespace Envoy {
 namespace Network {
@@ -156,12 +157,15 @@ public:
   }
   absl::string_view requestedServerName() const override { return server_name_; }
 
+  StreamInfo::FilterState& filterState() override { return filter_state_; }
+
 protected:
   Address::InstanceConstSharedPtr remote_address_;
   bool local_address_restored_{false};
   std::string transport_protocol_;
   std::vector<std::string> application_protocols_;
   std::string server_name_;
+  StreamInfo::FilterStateImpl filter_state_;
 };
 
 // ConnectionSocket used with server connections.
@@ -29,16 +29,21 @@
 #include "common/http/utility.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
+#include "common/router/hedge_delay_estimator_impl.h"
 #include "common/router/retry_state_impl.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 
 namespace Envoy {
 namespace Router {
 namespace {
 
+// The stat prefix shared by the routes beyond max_route_stats, which routes may not use.
+const char OtherRouteStatPrefix[] = "other";
+
 InternalRedirectAction
 convertInternalRedirectAction(const envoy::api::v2::route::RouteAction& route) {
   switch (route.internal_redirect_action()) {
@@ -60,7 +65,12 @@ std::string SslRedirector::newPath(const Http::HeaderMap& headers) const {
 HedgePolicyImpl::HedgePolicyImpl(const envoy::api::v2::route::HedgePolicy& hedge_policy)
     : initial_requests_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(hedge_policy, initial_requests, 1)),
       additional_request_chance_(hedge_policy.additional_request_chance()),
-      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {}
+      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {
+  if (hedge_policy.has_hedge_delay_percentile()) {
+    hedge_delay_estimator_ =
+        std::make_shared<HedgeDelayEstimatorImpl>(hedge_policy.hedge_delay_percentile().value());
+  }
+}
 
 HedgePolicyImpl::HedgePolicyImpl()
     : initial_requests_(1), additional_request_chance_({}), hedge_on_per_try_timeout_(false) {}
@@ -361,6 +371,7 @@ const envoy::type::FractionalPercent& RouteTracingImpl::getOverallSampling() con
 
 RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
                                        const envoy::api::v2::route::Route& route,
+                                       RouteStatsPool& route_stats_pool,
                                        Server::Configuration::FactoryContext& factory_context)
     : case_sensitive_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true)),
       prefix_rewrite_(route.route().prefix_rewrite()), host_rewrite_(route.route().host_rewrite()),
@@ -405,7 +416,11 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
       direct_response_body_(ConfigUtility::parseDirectResponseBody(route, factory_context.api())),
       per_filter_configs_(route.typed_per_filter_config(), route.per_filter_config(),
                           factory_context),
-      route_name_(route.name()), time_source_(factory_context.dispatcher().timeSource()),
+      route_name_(route.name()),
+      request_stats_(route.stat_prefix().empty()
+                         ? nullptr
+                         : &route_stats_pool.routeStats(vhost.statName(), route.stat_prefix())),
+      time_source_(factory_context.dispatcher().timeSource()),
       internal_redirect_action_(convertInternalRedirectAction(route.route())) {
   if (route.route().has_metadata_match()) {
     const auto filter_it = route.route().metadata_match().filter_metadata().find(
@@ -837,8 +852,10 @@ RouteEntryImplBase::WeightedClusterEntry::perFilterConfig(const std::string& nam
 
 PrefixRouteEntryImpl::PrefixRouteEntryImpl(const VirtualHostImpl& vhost,
                                            const envoy::api::v2::route::Route& route,
+                                           RouteStatsPool& route_stats_pool,
                                            Server::Configuration::FactoryContext& factory_context)
-    : RouteEntryImplBase(vhost, route, factory_context), prefix_(route.match().prefix()) {}
+    : RouteEntryImplBase(vhost, route, route_stats_pool, factory_context),
+      prefix_(route.match().prefix()) {}
 
 void PrefixRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
                                              bool insert_envoy_original_path) const {
@@ -858,8 +875,10 @@ RouteConstSharedPtr PrefixRouteEntryImpl::matches(const Http::HeaderMap& headers
 
 PathRouteEntryImpl::PathRouteEntryImpl(const VirtualHostImpl& vhost,
                                        const envoy::api::v2::route::Route& route,
+                                       RouteStatsPool& route_stats_pool,
                                        Server::Configuration::FactoryContext& factory_context)
-    : RouteEntryImplBase(vhost, route, factory_context), path_(route.match().path()) {}
+    : RouteEntryImplBase(vhost, route, route_stats_pool, factory_context),
+      path_(route.match().path()) {}
 
 void PathRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
                                            bool insert_envoy_original_path) const {
@@ -897,8 +916,9 @@ RouteConstSharedPtr PathRouteEntryImpl::matches(const Http::HeaderMap& headers,
 
 RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
+                                         RouteStatsPool& route_stats_pool,
                                          Server::Configuration::FactoryContext& factory_context)
-    : RouteEntryImplBase(vhost, route, factory_context),
+    : RouteEntryImplBase(vhost, route, route_stats_pool, factory_context),
       regex_(RegexUtil::parseRegex(route.match().regex())), regex_str_(route.match().regex()) {}
 
 void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
@@ -930,8 +950,50 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   return nullptr;
 }
 
+RouteStatsPool::RouteStatsPool(Stats::Scope& scope, uint32_t max_route_stats)
+    : parent_scope_(scope), max_route_stats_(max_route_stats) {}
+
+const RouteStats& RouteStatsPool::virtualHostStats(Stats::StatName virtual_host) {
+  return stats(parent_scope_.symbolTable().toString(virtual_host));
+}
+
+const RouteStats& RouteStatsPool::routeStats(Stats::StatName virtual_host,
+                                             const std::string& stat_prefix) {
+  if (stat_prefix == OtherRouteStatPrefix) {
+    throw EnvoyException(
+        fmt::format("route: stat_prefix '{}' is reserved for routes beyond max_route_stats",
+                    OtherRouteStatPrefix));
+  }
+  const std::string virtual_host_name = parent_scope_.symbolTable().toString(virtual_host);
+  const std::string prefix = absl::StrCat(virtual_host_name, ".route.", stat_prefix);
+  if (stats_.find(prefix) == stats_.end()) {
+    if (num_route_stats_ >= max_route_stats_) {
+      ENVOY_LOG(debug, "route stats limit of {} reached, using other stats for route {}",
+                max_route_stats_, prefix);
+      return stats(absl::StrCat(virtual_host_name, ".route.", OtherRouteStatPrefix));
+    }
+    num_route_stats_++;
+  }
+  return stats(prefix);
+}
+
+const RouteStats& RouteStatsPool::stats(const std::string& prefix) {
+  auto it = stats_.find(prefix);
+  if (it == stats_.end()) {
+    if (scope_ == nullptr) {
+      scope_ = parent_scope_.createScope("vhost.");
+    }
+    const std::string stat_prefix = prefix + ".";
+    const RouteStats route_stats{ALL_ROUTE_STATS(POOL_COUNTER_PREFIX(*scope_, stat_prefix),
+                                                 POOL_HISTOGRAM_PREFIX(*scope_, stat_prefix))};
+    it = stats_.emplace(prefix, route_stats).first;
+  }
+  return it->second;
+}
+
 VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
                                  const ConfigImpl& global_route_config,
+                                 RouteStatsPool& route_stats_pool,
                                  Server::Configuration::FactoryContext& factory_context,
                                  bool validate_clusters)
     : stat_name_pool_(factory_context.scope().symbolTable()),
@@ -944,6 +1006,8 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
       per_filter_configs_(virtual_host.typed_per_filter_config(), virtual_host.per_filter_config(),
                           factory_context),
       include_attempt_count_(virtual_host.include_request_attempt_count()),
+      request_stats_(virtual_host.request_stats() ? &route_stats_pool.virtualHostStats(stat_name_)
+                                                  : nullptr),
       virtual_cluster_catch_all_(stat_name_pool_) {
 
   switch (virtual_host.require_tls()) {
@@ -976,12 +1040,15 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
     if (has_prefix) {
-      routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context));
+      routes_.emplace_back(
+          new PrefixRouteEntryImpl(*this, route, route_stats_pool, factory_context));
     } else if (has_path) {
-      routes_.emplace_back(new PathRouteEntryImpl(*this, route, factory_context));
+      routes_.emplace_back(
+          new PathRouteEntryImpl(*this, route, route_stats_pool, factory_context));
     } else {
       ASSERT(has_regex);
-      routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
+      routes_.emplace_back(
+          new RegexRouteEntryImpl(*this, route, route_stats_pool, factory_context));
     }
 
     if (validate_clusters) {
@@ -1043,11 +1110,13 @@ const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
 
 RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_config,
                            const ConfigImpl& global_route_config,
+                           RouteStatsPool& route_stats_pool,
                            Server::Configuration::FactoryContext& factory_context,
                            bool validate_clusters) {
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
     VirtualHostSharedPtr virtual_host(new VirtualHostImpl(virtual_host_config, global_route_config,
-                                                          factory_context, validate_clusters));
+                                                          route_stats_pool, factory_context,
+                                                          validate_clusters));
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1175,8 +1244,11 @@ ConfigImpl::ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
                        bool validate_clusters_default)
     : name_(config.name()), symbol_table_(factory_context.scope().symbolTable()),
       uses_vhds_(config.has_vhds()) {
+  route_stats_pool_ = std::make_unique<RouteStatsPool>(
+      factory_context.scope(),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_route_stats, DEFAULT_MAX_ROUTE_STATS));
   route_matcher_ = std::make_unique<RouteMatcher>(
-      config, *this, factory_context,
+      config, *this, *route_stats_pool_, factory_context,
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
 
   for (const std::string& header : config.internal_only_headers()) {
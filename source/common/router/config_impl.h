@@ -141,6 +141,39 @@ private:
   bool legacy_enabled_;
 };
 
+/**
+ * Creates the request stats of the virtual hosts and routes of a route table, in a scope owned by
+ * the pool so that virtual hosts and routes can hold on to them. Routes of a virtual host with the
+ * same stat prefix share their stats. Once max_route_stats distinct route stats have been created,
+ * further routes share the "other" route stats of their virtual host, which bounds the number of
+ * stats a generated route table with many routes can create.
+ */
+class RouteStatsPool : Logger::Loggable<Logger::Id::router> {
+public:
+  RouteStatsPool(Stats::Scope& scope, uint32_t max_route_stats);
+
+  /**
+   * @return the stats in the vhost.<virtual host name>. namespace.
+   */
+  const RouteStats& virtualHostStats(Stats::StatName virtual_host);
+
+  /**
+   * @return the stats in the vhost.<virtual host name>.route.<stat_prefix>. namespace, or in the
+   *         vhost.<virtual host name>.route.other. namespace if there are too many route stats.
+   * @throw EnvoyException if stat_prefix is the reserved "other".
+   */
+  const RouteStats& routeStats(Stats::StatName virtual_host, const std::string& stat_prefix);
+
+private:
+  const RouteStats& stats(const std::string& prefix);
+
+  Stats::Scope& parent_scope_;
+  Stats::ScopePtr scope_;
+  const uint32_t max_route_stats_;
+  uint32_t num_route_stats_{};
+  std::unordered_map<std::string, RouteStats> stats_;
+};
+
 class ConfigImpl;
 /**
  * Holds all routing configuration for an entire virtual host.
@@ -148,7 +181,7 @@ class ConfigImpl;
 class VirtualHostImpl : public VirtualHost {
 public:
   VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
-                  const ConfigImpl& global_route_config,
+                  const ConfigImpl& global_route_config, RouteStatsPool& route_stats_pool,
                   Server::Configuration::FactoryContext& factory_context, bool validate_clusters);
 
   RouteConstSharedPtr getRouteFromEntries(const Http::HeaderMap& headers,
@@ -165,6 +198,7 @@ public:
   const Config& routeConfig() const override;
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
   bool includeAttemptCount() const override { return include_attempt_count_; }
+  const RouteStats* requestStats() const override { return request_stats_; }
   const absl::optional<envoy::api::v2::route::RetryPolicy>& retryPolicy() const {
     return retry_policy_;
   }
@@ -213,6 +247,7 @@ private:
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
   const bool include_attempt_count_;
+  const RouteStats* const request_stats_;
   absl::optional<envoy::api::v2::route::RetryPolicy> retry_policy_;
   absl::optional<envoy::api::v2::route::HedgePolicy> hedge_policy_;
   const CatchAllVirtualCluster virtual_cluster_catch_all_;
@@ -324,11 +359,16 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  HedgeDelayEstimator* hedgeDelayEstimator() const override {
+    return hedge_delay_estimator_.get();
+  }
 
 private:
   const uint32_t initial_requests_;
   const envoy::type::FractionalPercent additional_request_chance_;
   const bool hedge_on_per_try_timeout_;
+  // Shared by all workers, and rebuilt along with the route.
+  std::shared_ptr<HedgeDelayEstimator> hedge_delay_estimator_;
 };
 
 /**
@@ -385,6 +425,7 @@ public:
    * @throw EnvoyException with reason if the route configuration contains any errors
    */
   RouteEntryImplBase(const VirtualHostImpl& vhost, const envoy::api::v2::route::Route& route,
+                     RouteStatsPool& route_stats_pool,
                      Server::Configuration::FactoryContext& factory_context);
 
   bool isDirectResponse() const { return direct_response_code_.has_value(); }
@@ -433,6 +474,7 @@ public:
     return grpc_timeout_offset_;
   }
   const VirtualHost& virtualHost() const override { return vhost_; }
+  const RouteStats* requestStats() const override { return request_stats_; }
   bool autoHostRewrite() const override { return auto_host_rewrite_; }
   const std::multimap<std::string, std::string>& opaqueConfig() const override {
     return opaque_config_;
@@ -538,6 +580,7 @@ private:
     }
 
     const VirtualHost& virtualHost() const override { return parent_->virtualHost(); }
+    const RouteStats* requestStats() const override { return parent_->requestStats(); }
     bool autoHostRewrite() const override { return parent_->autoHostRewrite(); }
     bool includeVirtualHostRateLimits() const override {
       return parent_->includeVirtualHostRateLimits();
@@ -691,6 +734,7 @@ private:
   std::string direct_response_body_;
   PerFilterConfigs per_filter_configs_;
   const std::string route_name_;
+  const RouteStats* const request_stats_;
   TimeSource& time_source_;
   InternalRedirectAction internal_redirect_action_;
 };
@@ -701,6 +745,7 @@ private:
 class PrefixRouteEntryImpl : public RouteEntryImplBase {
 public:
   PrefixRouteEntryImpl(const VirtualHostImpl& vhost, const envoy::api::v2::route::Route& route,
+                       RouteStatsPool& route_stats_pool,
                        Server::Configuration::FactoryContext& factory_context);
 
   // Router::PathMatchCriterion
@@ -723,6 +768,7 @@ private:
 class PathRouteEntryImpl : public RouteEntryImplBase {
 public:
   PathRouteEntryImpl(const VirtualHostImpl& vhost, const envoy::api::v2::route::Route& route,
+                     RouteStatsPool& route_stats_pool,
                      Server::Configuration::FactoryContext& factory_context);
 
   // Router::PathMatchCriterion
@@ -745,6 +791,7 @@ private:
 class RegexRouteEntryImpl : public RouteEntryImplBase {
 public:
   RegexRouteEntryImpl(const VirtualHostImpl& vhost, const envoy::api::v2::route::Route& route,
+                      RouteStatsPool& route_stats_pool,
                       Server::Configuration::FactoryContext& factory_context);
 
   // Router::PathMatchCriterion
@@ -769,7 +816,7 @@ private:
 class RouteMatcher {
 public:
   RouteMatcher(const envoy::api::v2::RouteConfiguration& config,
-               const ConfigImpl& global_http_config,
+               const ConfigImpl& global_http_config, RouteStatsPool& route_stats_pool,
                Server::Configuration::FactoryContext& factory_context, bool validate_clusters);
 
   RouteConstSharedPtr route(const Http::HeaderMap& headers, uint64_t random_value) const;
@@ -826,6 +873,11 @@ public:
   bool usesVhds() const override { return uses_vhds_; }
 
 private:
+  // Default limit of distinct route stats if the route table does not set max_route_stats.
+  static const uint32_t DEFAULT_MAX_ROUTE_STATS = 100;
+
+  // Declared before route_matcher_, as virtual hosts and routes refer to the stats it owns.
+  std::unique_ptr<RouteStatsPool> route_stats_pool_;
   std::unique_ptr<RouteMatcher> route_matcher_;
   std::list<Http::LowerCaseString> internal_only_headers_;
   HeaderParserPtr request_headers_parser_;
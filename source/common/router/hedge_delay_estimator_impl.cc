@@ -0,0 +1,98 @@
+#include "common/router/hedge_delay_estimator_impl.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+// The largest response time that has its own bucket. Slower responses are counted in the last one.
+constexpr int64_t MaxTrackedResponseTimeMs = (8 << 14) - 1;
+} // namespace
+
+HedgeDelayEstimatorImpl::HedgeDelayEstimatorImpl(double percentile) : percentile_(percentile) {
+  ASSERT(percentile_ >= 0 && percentile_ <= 100);
+}
+
+uint32_t HedgeDelayEstimatorImpl::bucketIndex(std::chrono::milliseconds response_time) {
+  const uint64_t value = std::max<int64_t>(
+      0, std::min<int64_t>(response_time.count(), MaxTrackedResponseTimeMs));
+  if (value < 4) {
+    return value;
+  }
+
+  uint32_t exponent = 2;
+  while ((value >> (exponent + 1)) != 0) {
+    exponent++;
+  }
+  // The two bits below the leading one select one of four linear sub-buckets.
+  const uint32_t sub_bucket = (value >> (exponent - 2)) & 3;
+  return 4 * (exponent - 1) + sub_bucket;
+}
+
+std::chrono::milliseconds HedgeDelayEstimatorImpl::bucketUpperBound(uint32_t index) {
+  ASSERT(index < NumBuckets);
+  if (index < 4) {
+    return std::chrono::milliseconds(index);
+  }
+
+  const uint32_t exponent = index / 4 + 1;
+  const uint64_t sub_bucket = index % 4;
+  return std::chrono::milliseconds(((4 + sub_bucket + 1) << (exponent - 2)) - 1);
+}
+
+void HedgeDelayEstimatorImpl::recordResponseTime(std::chrono::milliseconds response_time) {
+  buckets_[bucketIndex(response_time)].fetch_add(1, std::memory_order_relaxed);
+  // Only the worker whose sample completes an interval recomputes. Should the previous
+  // recomputation still be running, this interval's is skipped.
+  if ((samples_recorded_.fetch_add(1, std::memory_order_relaxed) + 1) % RecomputeInterval == 0 &&
+      !recomputing_.exchange(true, std::memory_order_acquire)) {
+    recompute();
+    recomputing_.store(false, std::memory_order_release);
+  }
+}
+
+absl::optional<std::chrono::milliseconds> HedgeDelayEstimatorImpl::hedgeDelay() const {
+  const int64_t hedge_delay_ms = hedge_delay_ms_.load(std::memory_order_relaxed);
+  if (hedge_delay_ms < 0) {
+    return absl::nullopt;
+  }
+  return std::chrono::milliseconds(hedge_delay_ms);
+}
+
+void HedgeDelayEstimatorImpl::recompute() {
+  std::array<uint64_t, NumBuckets> counts;
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < NumBuckets; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total < MinSamples) {
+    return;
+  }
+
+  const uint64_t target =
+      std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(total * percentile_ / 100)));
+  uint64_t cumulative = 0;
+  for (uint32_t i = 0; i < NumBuckets; i++) {
+    cumulative += counts[i];
+    if (cumulative >= target) {
+      hedge_delay_ms_.store(bucketUpperBound(i).count(), std::memory_order_relaxed);
+      break;
+    }
+  }
+
+  // Decay by subtracting what was read rather than storing, so that samples recorded concurrently
+  // are not lost. Recomputations don't overlap, so each bucket still holds at least what was read.
+  if (total >= DecaySamples) {
+    for (uint32_t i = 0; i < NumBuckets; i++) {
+      buckets_[i].fetch_sub(counts[i] / 2, std::memory_order_relaxed);
+    }
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
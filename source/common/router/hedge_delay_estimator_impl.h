@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/router/router.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * HedgeDelayEstimator that keeps a lock free log-linear histogram of response times, with four
+ * buckets per power of two milliseconds. Once enough samples have been recorded the configured
+ * percentile is recomputed every few samples, and the histogram is periodically halved so that it
+ * tracks recent latency rather than the whole lifetime of the route.
+ *
+ * The samples of requests that lost to a hedge are censored: the router only knows how long they
+ * had been outstanding when they were abandoned. As they are recorded at that lower bound, the
+ * estimate can still be somewhat low when most slow requests are hedged, but it no longer only
+ * reflects the responses that won.
+ */
+class HedgeDelayEstimatorImpl : public HedgeDelayEstimator {
+public:
+  /**
+   * @param percentile supplies the response time percentile to use as the hedge delay, in the
+   *        range [0, 100].
+   */
+  explicit HedgeDelayEstimatorImpl(double percentile);
+
+  // Router::HedgeDelayEstimator
+  void recordResponseTime(std::chrono::milliseconds response_time) override;
+  absl::optional<std::chrono::milliseconds> hedgeDelay() const override;
+
+  static constexpr uint32_t NumBuckets = 64;
+  // Samples required before a hedge delay is reported.
+  static constexpr uint64_t MinSamples = 100;
+  // Number of samples between percentile recomputations.
+  static constexpr uint64_t RecomputeInterval = 16;
+  // Once the histogram holds this many samples it is halved after each recomputation.
+  static constexpr uint64_t DecaySamples = 1000;
+
+  static uint32_t bucketIndex(std::chrono::milliseconds response_time);
+  static std::chrono::milliseconds bucketUpperBound(uint32_t index);
+
+private:
+  void recompute();
+
+  const double percentile_;
+  std::array<std::atomic<uint64_t>, NumBuckets> buckets_{};
+  std::atomic<uint64_t> samples_recorded_{0};
+  // The current hedge delay in milliseconds, or -1 if there is no estimate yet.
+  std::atomic<int64_t> hedge_delay_ms_{-1};
+  // Set while a worker recomputes, so that concurrent decays can't subtract more than a bucket
+  // holds.
+  std::atomic<bool> recomputing_{false};
+};
+
+} // namespace Router
+} // namespace Envoy
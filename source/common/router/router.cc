@@ -86,6 +86,38 @@ bool convertRequestHeadersForInternalRedirect(Http::HeaderMap& downstream_header
   return true;
 }
 
+void chargeRouteStats(const RouteStats* stats, uint64_t response_status_code) {
+  if (stats == nullptr) {
+    return;
+  }
+  stats->upstream_rq_completed_.inc();
+  switch (response_status_code / 100) {
+  case 1:
+    stats->upstream_rq_1xx_.inc();
+    break;
+  case 2:
+    stats->upstream_rq_2xx_.inc();
+    break;
+  case 3:
+    stats->upstream_rq_3xx_.inc();
+    break;
+  case 4:
+    stats->upstream_rq_4xx_.inc();
+    break;
+  case 5:
+    stats->upstream_rq_5xx_.inc();
+    break;
+  default:
+    break;
+  }
+}
+
+void chargeRouteTiming(const RouteStats* stats, std::chrono::milliseconds response_time) {
+  if (stats != nullptr) {
+    stats->upstream_rq_time_.recordValue(response_time.count());
+  }
+}
+
 } // namespace
 
 void FilterUtility::setUpstreamScheme(Http::HeaderMap& headers,
@@ -196,9 +228,19 @@ FilterUtility::finalTimeout(const RouteEntry& route, Http::HeaderMap& request_he
   return timeout;
 }
 
-FilterUtility::HedgingParams FilterUtility::finalHedgingParams(const RouteEntry& route,
-                                                               Http::HeaderMap& request_headers) {
+FilterUtility::HedgingParams
+FilterUtility::finalHedgingParams(const RouteEntry& route, Http::HeaderMap& request_headers,
+                                  Runtime::RandomGenerator& random) {
   HedgingParams hedging_params;
+  hedging_params.initial_requests_ = std::max(route.hedgePolicy().initialRequests(), 1U);
+  // Most routes have no additional request chance, so don't draw a random number for them.
+  const envoy::type::FractionalPercent& additional_request_chance =
+      route.hedgePolicy().additionalRequestChance();
+  if (additional_request_chance.numerator() > 0 &&
+      ProtobufPercentHelper::evaluateFractionalPercent(additional_request_chance,
+                                                       random.random())) {
+    hedging_params.initial_requests_++;
+  }
   hedging_params.hedge_on_per_try_timeout_ = route.hedgePolicy().hedgeOnPerTryTimeout();
 
   Http::HeaderEntry* hedge_on_per_try_timeout_entry = request_headers.EnvoyHedgeOnPerTryTimeout();
@@ -257,6 +299,8 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
 
     Http::CodeStats& code_stats = httpContext().codeStats();
     code_stats.chargeResponseStat(info);
+    chargeRouteStats(route_entry_->requestStats(), response_status_code);
+    chargeRouteStats(route_entry_->virtualHost().requestStats(), response_status_code);
 
     if (alt_stat_prefix_ != nullptr) {
       Http::CodeStats::ResponseStatInfo alt_info{config_.scope_,
@@ -442,7 +486,7 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
     return Http::FilterHeadersStatus::StopIteration;
   }
 
-  hedging_params_ = FilterUtility::finalHedgingParams(*route_entry_, headers);
+  hedging_params_ = FilterUtility::finalHedgingParams(*route_entry_, headers, config_.random_);
 
   timeout_ = FilterUtility::finalTimeout(*route_entry_, headers, !config_.suppress_envoy_headers_,
                                          grpc_request_, hedging_params_.hedge_on_per_try_timeout_);
@@ -517,17 +561,20 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   // upstream_requests_.size() cannot be 0 because we add to it unconditionally
   // in decodeHeaders(). It cannot be > 1 because that only happens when a per
   // try timeout occurs with hedge_on_per_try_timeout enabled but the per
-  // try timeout timer is not started until onUpstreamComplete().
+  // try timeout timer is not started until onUpstreamComplete(), or when
+  // initial hedges are sent, which does not happen until onRequestComplete().
   ASSERT(upstream_requests_.size() == 1);
 
-  bool buffering = (retry_state_ && retry_state_->enabled()) || do_shadowing_;
+  bool buffering = (retry_state_ && retry_state_->enabled()) || do_shadowing_ ||
+                   hedging_params_.initial_requests_ > 1;
   if (buffering && buffer_limit_ > 0 &&
       getLength(callbacks_->decodingBuffer()) + data.length() > buffer_limit_) {
-    // The request is larger than we should buffer. Give up on the retry/shadow
+    // The request is larger than we should buffer. Give up on the retry/shadow/hedge
     cluster_->stats().retry_or_shadow_abandoned_.inc();
     retry_state_.reset();
     buffering = false;
     do_shadowing_ = false;
+    hedging_params_.initial_requests_ = 1;
   }
 
   if (buffering) {
@@ -559,7 +606,8 @@ Http::FilterTrailersStatus Filter::decodeTrailers(Http::HeaderMap& trailers) {
   // upstream_requests_.size() cannot be 0 because we add to it unconditionally
   // in decodeHeaders(). It cannot be > 1 because that only happens when a per
   // try timeout occurs with hedge_on_per_try_timeout enabled but the per
-  // try timeout timer is not started until onUpstreamComplete().
+  // try timeout timer is not started until onUpstreamComplete(), or when
+  // initial hedges are sent, which does not happen until onRequestComplete().
   ASSERT(upstream_requests_.size() == 1);
   downstream_trailers_ = &trailers;
   for (auto& upstream_request : upstream_requests_) {
@@ -587,6 +635,10 @@ void Filter::cleanup() {
     response_timeout_->disableTimer();
     response_timeout_.reset();
   }
+  if (hedge_timer_) {
+    hedge_timer_->disableTimer();
+    hedge_timer_.reset();
+  }
 }
 
 void Filter::maybeDoShadowing() {
@@ -631,6 +683,38 @@ void Filter::onRequestComplete() {
         upstream_request->setupPerTryTimeout();
       }
     }
+
+    if (hedging_params_.initial_requests_ > 1) {
+      // With an adaptive hedge delay only requests that are slower than the route's recent
+      // response times are hedged. Until there is an estimate, hedge immediately.
+      const HedgeDelayEstimator* hedge_delay_estimator =
+          route_entry_->hedgePolicy().hedgeDelayEstimator();
+      const absl::optional<std::chrono::milliseconds> hedge_delay =
+          hedge_delay_estimator != nullptr ? hedge_delay_estimator->hedgeDelay() : absl::nullopt;
+      if (hedge_delay) {
+        hedge_timer_ = dispatcher.createTimer([this]() -> void { sendInitialHedges(); });
+        hedge_timer_->enableTimer(hedge_delay.value());
+      } else {
+        sendInitialHedges();
+      }
+    }
+  }
+}
+
+void Filter::sendInitialHedges() {
+  // The response may have started, or every upstream request may have failed, while the hedge
+  // timer was pending.
+  for (uint32_t i = 1; i < hedging_params_.initial_requests_ && !downstream_response_started_ &&
+                       !upstream_requests_.empty();
+       i++) {
+    Http::ConnectionPool::Instance* conn_pool = getConnPool();
+    if (!conn_pool) {
+      // The first request is still in flight, so let it complete rather than failing here.
+      return;
+    }
+
+    attempt_count_++;
+    replayRequest(*conn_pool);
   }
 }
 
@@ -693,10 +777,8 @@ void Filter::onSoftPerTryTimeout(UpstreamRequest& upstream_request) {
       setupRetry();
       // Don't increment upstream_host->stats().rq_error_ here, we'll do that
       // later if 1) we hit global timeout or 2) we get bad response headers
-      // back.
+      // back. The hedge is counted when it is sent in replayRequest().
       upstream_request.retried_ = true;
-
-      // TODO: cluster stat for hedge attempted.
     } else if (retry_status == RetryStatus::NoOverflow) {
       callbacks_->streamInfo().setResponseFlag(StreamInfo::ResponseFlag::UpstreamOverflow);
     } else if (retry_status == RetryStatus::NoRetryLimitExceeded) {
@@ -929,9 +1011,10 @@ void Filter::resetOtherUpstreams(UpstreamRequest& upstream_request) {
     UpstreamRequestPtr upstream_request_tmp =
         upstream_requests_.back()->removeFromList(upstream_requests_);
     if (upstream_request_tmp.get() != &upstream_request) {
+      recordAbandonedResponseTime(*upstream_request_tmp);
       upstream_request_tmp->resetStream();
       // TODO: per-host stat for hedge abandoned.
-      // TODO: cluster stat for hedge abandoned.
+      cluster_->stats().upstream_rq_hedge_cancelled_.inc();
     } else {
       final_upstream_request = std::move(upstream_request_tmp);
     }
@@ -942,6 +1025,21 @@ void Filter::resetOtherUpstreams(UpstreamRequest& upstream_request) {
   final_upstream_request->moveIntoList(std::move(final_upstream_request), upstream_requests_);
 }
 
+void Filter::recordAbandonedResponseTime(const UpstreamRequest& upstream_request) {
+  // When a hedge wins, the request it raced would have taken at least as long as it has been
+  // outstanding. Recording that lower bound keeps the estimate from only seeing the winners, which
+  // would bias it low and hedge ever more requests. Abandoned hedges started after the request
+  // they raced, so their elapsed time says nothing about the tail and they are not recorded.
+  HedgeDelayEstimator* hedge_delay_estimator = route_entry_->hedgePolicy().hedgeDelayEstimator();
+  if (hedge_delay_estimator == nullptr || upstream_request.hedged_ ||
+      !upstream_request.upstream_timing_.first_upstream_tx_byte_sent_) {
+    return;
+  }
+  hedge_delay_estimator->recordResponseTime(std::chrono::duration_cast<std::chrono::milliseconds>(
+      callbacks_->dispatcher().timeSource().monotonicTime() -
+      upstream_request.upstream_timing_.first_upstream_tx_byte_sent_.value()));
+}
+
 void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& headers,
                                UpstreamRequest& upstream_request, bool end_stream) {
   ENVOY_STREAM_LOG(debug, "upstream headers complete: end_stream={}", *callbacks_, end_stream);
@@ -954,6 +1052,14 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& head
     upstream_request.upstream_host_->healthChecker().setUnhealthy();
   }
 
+  HedgeDelayEstimator* hedge_delay_estimator = route_entry_->hedgePolicy().hedgeDelayEstimator();
+  if (hedge_delay_estimator != nullptr &&
+      upstream_request.upstream_timing_.first_upstream_tx_byte_sent_) {
+    hedge_delay_estimator->recordResponseTime(std::chrono::duration_cast<std::chrono::milliseconds>(
+        upstream_request.upstream_timing_.first_upstream_rx_byte_received_.value() -
+        upstream_request.upstream_timing_.first_upstream_tx_byte_sent_.value()));
+  }
+
   bool could_not_retry = false;
 
   // Check if this upstream request was already retried, for instance after
@@ -1047,6 +1153,9 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::HeaderMapPtr&& head
 
   downstream_response_started_ = true;
   final_upstream_request_ = &upstream_request;
+  if (upstream_request.hedged_) {
+    cluster_->stats().upstream_rq_hedge_won_.inc();
+  }
   resetOtherUpstreams(upstream_request);
   if (end_stream) {
     onUpstreamComplete(upstream_request);
@@ -1131,6 +1240,8 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
                                              upstreamZone(upstream_request.upstream_host_)};
 
     code_stats.chargeResponseTiming(info);
+    chargeRouteTiming(route_entry_->requestStats(), response_time);
+    chargeRouteTiming(route_entry_->virtualHost().requestStats(), response_time);
 
     if (alt_stat_prefix_ != nullptr) {
       Http::CodeStats::ResponseTimingInfo info{config_.scope_,
@@ -1214,12 +1325,21 @@ void Filter::doRetry() {
     return;
   }
 
+  replayRequest(*conn_pool);
+}
+
+void Filter::replayRequest(Http::ConnectionPool::Instance& conn_pool) {
   if (include_attempt_count_) {
     downstream_headers_->insertEnvoyAttemptCount().value(attempt_count_);
   }
 
   ASSERT(response_timeout_ || timeout_.global_timeout_.count() == 0);
-  UpstreamRequestPtr upstream_request = std::make_unique<UpstreamRequest>(*this, *conn_pool);
+  UpstreamRequestPtr upstream_request = std::make_unique<UpstreamRequest>(*this, conn_pool);
+  // Any request sent while others are still in flight is racing them for the response.
+  if (!upstream_requests_.empty()) {
+    upstream_request->hedged_ = true;
+    cluster_->stats().upstream_rq_hedge_sent_.inc();
+  }
   UpstreamRequest* upstream_request_tmp = upstream_request.get();
   upstream_request->moveIntoList(std::move(upstream_request), upstream_requests_);
   upstream_requests_.front()->encodeHeaders(!callbacks_->decodingBuffer() && !downstream_trailers_);
@@ -1249,7 +1369,7 @@ Filter::UpstreamRequest::UpstreamRequest(Filter& parent, Http::ConnectionPool::I
       stream_info_(pool.protocol(), parent_.callbacks_->dispatcher().timeSource()),
       calling_encode_headers_(false), upstream_canary_(false), decode_complete_(false),
       encode_complete_(false), encode_trailers_(false), retried_(false), awaiting_headers_(true),
-      outlier_detection_timeout_recorded_(false),
+      outlier_detection_timeout_recorded_(false), hedged_(false),
       create_per_try_timeout_on_request_complete_(false) {
 
   if (parent_.config_.start_child_span_) {
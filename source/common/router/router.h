@@ -64,6 +64,9 @@ public:
   };
 
   struct HedgingParams {
+    // Number of upstream requests to send once the downstream request is complete, including the
+    // first one.
+    uint32_t initial_requests_;
     bool hedge_on_per_try_timeout_;
   };
 
@@ -100,10 +103,13 @@ public:
    * Determine the final hedging settings after applying randomized behavior.
    * @param route supplies the request route.
    * @param request_headers supplies the request headers.
+   * @param random supplies the random number generator used to decide whether an additional
+   *        request should be sent.
    * @return HedgingParams the final parameters to use for request hedging.
    */
   static HedgingParams finalHedgingParams(const RouteEntry& route,
-                                          Http::HeaderMap& request_headers);
+                                          Http::HeaderMap& request_headers,
+                                          Runtime::RandomGenerator& random);
 };
 
 /**
@@ -409,6 +415,8 @@ private:
     bool retried_ : 1;
     bool awaiting_headers_ : 1;
     bool outlier_detection_timeout_recorded_ : 1;
+    // Tracks whether this request was sent while other upstream requests were still in flight.
+    bool hedged_ : 1;
     // Tracks whether we deferred a per try timeout because the downstream request
     // had not been completed yet.
     bool create_per_try_timeout_on_request_complete_ : 1;
@@ -439,6 +447,8 @@ private:
   void onPerTryTimeout(UpstreamRequest& upstream_request);
   void onRequestComplete();
   void onResponseTimeout();
+  // Send the requests beyond the first one called for by hedging_params_.initial_requests_.
+  void sendInitialHedges();
   void onUpstream100ContinueHeaders(Http::HeaderMapPtr&& headers,
                                     UpstreamRequest& upstream_request);
   // Handle an upstream request aborted due to a local timeout.
@@ -464,11 +474,16 @@ private:
   // if a "good" response comes back and we return downstream, so there is no point in waiting
   // for the remaining upstream requests to return.
   void resetOtherUpstreams(UpstreamRequest& upstream_request);
+  // Feeds the hedge delay estimator a censored sample for a request abandoned to a faster hedge.
+  void recordAbandonedResponseTime(const UpstreamRequest& upstream_request);
   void sendNoHealthyUpstreamResponse();
   bool setupRetry();
   bool setupRedirect(const Http::HeaderMap& headers, UpstreamRequest& upstream_request);
   void updateOutlierDetection(Http::Code code, UpstreamRequest& upstream_request);
   void doRetry();
+  // Send the complete downstream request, including any buffered body and trailers, on a new
+  // upstream request.
+  void replayRequest(Http::ConnectionPool::Instance& conn_pool);
   // Called immediately after a non-5xx header is received from upstream, performs stats accounting
   // and handle difference between gRPC and non-gRPC requests.
   void handleNon5xxResponseHeaders(const Http::HeaderMap& headers,
@@ -484,6 +499,7 @@ private:
   std::unique_ptr<Stats::StatNameManagedStorage> alt_stat_prefix_;
   const VirtualCluster* request_vcluster_;
   Event::TimerPtr response_timeout_;
+  Event::TimerPtr hedge_timer_;
   FilterUtility::TimeoutData timeout_;
   FilterUtility::HedgingParams hedging_params_;
   Http::Code timeout_response_code_ = Http::Code::GatewayTimeout;
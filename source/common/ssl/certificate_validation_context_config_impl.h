@@ -32,6 +32,7 @@ public:
     return verify_certificate_spki_list_;
   }
   bool allowExpiredCertificate() const override { return allow_expired_certificate_; }
+  uint32_t verificationCacheSize() const override { return verification_cache_size_; }
 
 private:
   const std::string ca_cert_;
@@ -42,6 +43,7 @@ private:
   const std::vector<std::string> verify_certificate_hash_list_;
   const std::vector<std::string> verify_certificate_spki_list_;
   const bool allow_expired_certificate_;
+  const uint32_t verification_cache_size_;
 };
 
 } // namespace Ssl
@@ -1,18 +1,46 @@
 #include "common/ssl/tls_certificate_config_impl.h"
 
 #include "envoy/common/exception.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key_method_provider_config.h"
 
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/datasource.h"
+#include "common/config/utility.h"
+#include "common/protobuf/message_validator_impl.h"
 
 namespace Envoy {
 namespace Ssl {
 
 static const std::string INLINE_STRING = "<inline>";
 
+namespace {
+
+PrivateKeyMethodProviderSharedPtr
+createPrivateKeyMethod(const envoy::api::v2::auth::TlsCertificate& config, Api::Api& api,
+                       Singleton::Manager& singleton_manager) {
+  if (!config.has_private_key_provider()) {
+    return nullptr;
+  }
+  if (config.has_private_key()) {
+    throw EnvoyException("Certificate configuration can't have both private_key and "
+                         "private_key_provider");
+  }
+
+  const auto& provider_config = config.private_key_provider();
+  auto& factory = Config::Utility::getAndCheckFactory<PrivateKeyMethodProviderInstanceFactory>(
+      provider_config.provider_name());
+  ProtobufTypes::MessagePtr message = Config::Utility::translateToFactoryConfig(
+      provider_config, ProtobufMessage::getStrictValidationVisitor(), factory);
+  return factory.createPrivateKeyMethodProviderInstance(*message, api, singleton_manager);
+}
+
+} // namespace
+
 TlsCertificateConfigImpl::TlsCertificateConfigImpl(
-    const envoy::api::v2::auth::TlsCertificate& config, Api::Api& api)
+    const envoy::api::v2::auth::TlsCertificate& config, Api::Api& api,
+    Singleton::Manager& singleton_manager)
     : certificate_chain_(Config::DataSource::read(config.certificate_chain(), true, api)),
       certificate_chain_path_(
           Config::DataSource::getPath(config.certificate_chain())
@@ -22,9 +50,10 @@ TlsCertificateConfigImpl::TlsCertificateConfigImpl(
                             .value_or(private_key_.empty() ? EMPTY_STRING : INLINE_STRING)),
       password_(Config::DataSource::read(config.password(), true, api)),
       password_path_(Config::DataSource::getPath(config.password())
-                         .value_or(password_.empty() ? EMPTY_STRING : INLINE_STRING)) {
+                         .value_or(password_.empty() ? EMPTY_STRING : INLINE_STRING)),
+      private_key_method_(createPrivateKeyMethod(config, api, singleton_manager)) {
 
-  if (certificate_chain_.empty() || private_key_.empty()) {
+  if (certificate_chain_.empty() || (private_key_.empty() && private_key_method_ == nullptr)) {
     throw EnvoyException(fmt::format("Failed to load incomplete certificate from {}, {}",
                                      certificate_chain_path_, private_key_path_));
   }
@@ -4,6 +4,7 @@
 
 #include "envoy/api/api.h"
 #include "envoy/api/v2/auth/cert.pb.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/ssl/tls_certificate_config.h"
 
 namespace Envoy {
@@ -11,7 +12,8 @@ namespace Ssl {
 
 class TlsCertificateConfigImpl : public TlsCertificateConfig {
 public:
-  TlsCertificateConfigImpl(const envoy::api::v2::auth::TlsCertificate& config, Api::Api& api);
+  TlsCertificateConfigImpl(const envoy::api::v2::auth::TlsCertificate& config, Api::Api& api,
+                           Singleton::Manager& singleton_manager);
 
   const std::string& certificateChain() const override { return certificate_chain_; }
   const std::string& certificateChainPath() const override { return certificate_chain_path_; }
@@ -19,6 +21,9 @@ public:
   const std::string& privateKeyPath() const override { return private_key_path_; }
   const std::string& password() const override { return password_; }
   const std::string& passwordPath() const override { return password_path_; }
+  PrivateKeyMethodProviderSharedPtr privateKeyMethod() const override {
+    return private_key_method_;
+  }
 
 private:
   const std::string certificate_chain_;
@@ -27,6 +32,7 @@ private:
   const std::string private_key_path_;
   const std::string password_;
   const std::string password_path_;
+  const PrivateKeyMethodProviderSharedPtr private_key_method_;
 };
 
 } // namespace Ssl
@@ -0,0 +1,88 @@
+#include "common/stats/fixed_bucket_histogram.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+constexpr uint64_t PowersOf10[] = {1,
+                                   10,
+                                   100,
+                                   1000,
+                                   10000,
+                                   100000,
+                                   1000000,
+                                   10000000,
+                                   100000000,
+                                   1000000000,
+                                   10000000000,
+                                   100000000000,
+                                   1000000000000,
+                                   10000000000000,
+                                   100000000000000,
+                                   1000000000000000,
+                                   10000000000000000,
+                                   100000000000000000,
+                                   1000000000000000000,
+                                   10000000000000000000U};
+
+} // namespace
+
+FixedBucketHistogram::~FixedBucketHistogram() {
+  for (std::atomic<Counters*>& counters : counters_) {
+    delete counters.load(std::memory_order_relaxed);
+  }
+}
+
+hist_bucket_t FixedBucketHistogram::bucket(uint64_t value) {
+  if (value < 10) {
+    return hist_bucket_t{static_cast<int8_t>(value * 10), 0};
+  }
+  // floor(log10(value)), estimated from floor(log2(value)) as log10(2) ~= 1233 / 4096 and then
+  // corrected by a single comparison.
+  uint32_t exponent = ((64 - __builtin_clzll(value)) * 1233) >> 12;
+  if (value < PowersOf10[exponent]) {
+    --exponent;
+  }
+  return hist_bucket_t{static_cast<int8_t>(value / PowersOf10[exponent - 1]),
+                       static_cast<int8_t>(exponent)};
+}
+
+void FixedBucketHistogram::recordValue(uint64_t value) {
+  const hist_bucket_t bucket = FixedBucketHistogram::bucket(value);
+  // Only this thread stores the counters, so it does not need to synchronize with itself.
+  Counters* counters = counters_[bucket.exp].load(std::memory_order_relaxed);
+  if (counters == nullptr) {
+    // Value initialization zeroes the counters. The release store publishes them to merge().
+    counters = new Counters();
+    counters_[bucket.exp].store(counters, std::memory_order_release);
+    used_.store(true, std::memory_order_relaxed);
+  }
+  (*counters)[bucket.val].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t FixedBucketHistogram::merge(histogram_t* target) {
+  uint64_t sample_count = 0;
+  for (uint32_t exponent = 0; exponent < NumExponents; ++exponent) {
+    Counters* counters = counters_[exponent].load(std::memory_order_acquire);
+    if (counters == nullptr) {
+      continue;
+    }
+    for (uint32_t digits = 0; digits < NumDigits; ++digits) {
+      std::atomic<uint64_t>& counter = (*counters)[digits];
+      // Most buckets are empty, and reading them first avoids writing to them. A value recorded
+      // concurrently with the exchange is either taken by it or left for the next merge.
+      if (counter.load(std::memory_order_relaxed) != 0) {
+        const uint64_t count = counter.exchange(0, std::memory_order_relaxed);
+        hist_insert_raw(target,
+                        hist_bucket_t{static_cast<int8_t>(digits), static_cast<int8_t>(exponent)},
+                        count);
+        sample_count += count;
+      }
+    }
+  }
+  return sample_count;
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "circllhist.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Counts values in a fixed array of atomic counters, one per log linear bucket of libcircllhist,
+ * i.e. per two significant decimal digits and decimal exponent. Recording a value is a single
+ * relaxed atomic increment, and since merge() atomically takes the counts it may run on any thread
+ * while values are being recorded, without the double buffering a circllhist needs. Merging into a
+ * circllhist yields exactly the histogram that inserting the values into it would have.
+ *
+ * The counters of a decimal exponent are allocated when the first value with that exponent is
+ * recorded, so a histogram only uses memory for the orders of magnitude it sees.
+ *
+ * recordValue() must only be called from one thread.
+ */
+class FixedBucketHistogram {
+public:
+  FixedBucketHistogram() = default;
+  ~FixedBucketHistogram();
+
+  void recordValue(uint64_t value);
+
+  /**
+   * Inserts the values recorded since the last merge into target, and clears them.
+   * @return uint64_t the number of values that were merged.
+   */
+  uint64_t merge(histogram_t* target);
+
+  /**
+   * @return bool whether any value has ever been recorded.
+   */
+  bool used() const { return used_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return hist_bucket_t the circllhist bucket of value, i.e. its two most significant decimal
+   *         digits and its decimal exponent, as used by hist_insert_intscale(hist, value, 0, 1).
+   */
+  static hist_bucket_t bucket(uint64_t value);
+
+private:
+  // Values below 10 have exponent 0, and the largest uint64_t values have exponent 19.
+  static constexpr uint32_t NumExponents = 20;
+  // Counters are indexed by the two significant digits of the bucket, 10 to 99, except for values
+  // below 10, which are indexed by ten times their value. The zero bucket is index 0 of exponent 0.
+  static constexpr uint32_t NumDigits = 100;
+
+  using Counters = std::array<std::atomic<uint64_t>, NumDigits>;
+
+  std::atomic<Counters*> counters_[NumExponents]{};
+  std::atomic<bool> used_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -1,6 +1,7 @@
 #include "common/stats/heap_stat_data.h"
 
 #include <cstdint>
+#include <memory>
 
 #include "envoy/stats/stats.h"
 #include "envoy/stats/symbol_table.h"
@@ -20,6 +21,36 @@
 namespace Envoy {
 namespace Stats {
 
+constexpr size_t CounterShards::CacheLineSize;
+
+CounterShards::CounterShards(uint32_t num_shards)
+    : num_shards_(num_shards), storage_(new char[(num_shards + 1) * sizeof(Shard)]) {
+  ASSERT(num_shards_ > 0);
+  void* aligned = storage_.get();
+  size_t space = (num_shards_ + 1) * sizeof(Shard);
+  shards_ = static_cast<Shard*>(std::align(alignof(Shard), num_shards_ * sizeof(Shard), aligned,
+                                           space));
+  ASSERT(shards_ != nullptr);
+  // The slots only hold atomics, which are trivially destructible.
+  for (uint32_t i = 0; i < num_shards_; ++i) {
+    new (&shards_[i]) Shard();
+  }
+}
+
+uint64_t CounterShards::sum() const {
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < num_shards_; ++i) {
+    sum += shards_[i].value_.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+uint32_t CounterShards::threadIndex() {
+  static std::atomic<uint32_t> next_index{0};
+  static thread_local const uint32_t index = next_index++;
+  return index;
+}
+
 HeapStatDataAllocator::~HeapStatDataAllocator() { ASSERT(stats_.empty()); }
 
 HeapStatData* HeapStatData::alloc(StatName stat_name, SymbolTable& symbol_table) {
@@ -59,6 +90,7 @@ void HeapStatDataAllocator::free(HeapStatData& data) {
     Thread::LockGuard lock(mutex_);
     size_t key_removed = stats_.erase(&data);
     ASSERT(key_removed == 1);
+    sharded_counters_.erase(&data);
   }
 
   data.free(symbolTable());
@@ -108,6 +140,49 @@ private:
   HeapStatDataAllocator& alloc_;
 };
 
+/**
+ * Counter backed by CounterShards. The total is only summed when the value is read, which happens
+ * on the main thread at flush time and in admin requests, so increments on workers touch only
+ * their own slot.
+ */
+class ShardedCounterImpl : public Counter, public MetricImpl {
+public:
+  ShardedCounterImpl(HeapStatData& data, CounterShards& shards, HeapStatDataAllocator& alloc,
+                     absl::string_view tag_extracted_name, const std::vector<Tag>& tags)
+      : MetricImpl(tag_extracted_name, tags, alloc.symbolTable()), data_(data), shards_(shards),
+        alloc_(alloc) {}
+
+  ~ShardedCounterImpl() override {
+    MetricImpl::clear();
+    alloc_.free(data_);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    shards_.add(amount);
+    // Check first so that the shared flags are only written once, rather than on every increment.
+    if (!(data_.flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      data_.flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    const uint64_t sum = shards_.sum();
+    return sum - shards_.latched_sum_.exchange(sum);
+  }
+  void reset() override { shards_.reset_sum_ = shards_.sum(); }
+  bool used() const override { return data_.flags_ & Flags::Used; }
+  uint64_t value() const override { return shards_.sum() - shards_.reset_sum_; }
+
+  SymbolTable& symbolTable() override { return alloc_.symbolTable(); }
+  StatName statName() const override { return data_.statName(); }
+
+private:
+  HeapStatData& data_;
+  CounterShards& shards_;
+  HeapStatDataAllocator& alloc_;
+};
+
 class GaugeImpl : public Gauge, public MetricImpl {
 public:
   GaugeImpl(HeapStatData& data, HeapStatDataAllocator& alloc, absl::string_view tag_extracted_name,
@@ -141,20 +216,26 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     data_.value_ += amount;
-    data_.flags_ |= Flags::Used;
+    data_.flags_ |= Flags::Used | Flags::Changed;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     data_.value_ = value;
-    data_.flags_ |= Flags::Used;
+    data_.flags_ |= Flags::Used | Flags::Changed;
   }
   void sub(uint64_t amount) override {
     ASSERT(data_.value_ >= amount);
     ASSERT(used() || amount == 0);
     data_.value_ -= amount;
+    // Check first so that a gauge decremented many times per flush interval only writes the shared
+    // flags once.
+    if (!(data_.flags_.load(std::memory_order_relaxed) & Flags::Changed)) {
+      data_.flags_ |= Flags::Changed;
+    }
   }
   uint64_t value() const override { return data_.value_; }
+  bool latchChanged() override { return data_.flags_.fetch_and(~Flags::Changed) & Flags::Changed; }
   bool used() const override { return data_.flags_ & Flags::Used; }
 
   ImportMode importMode() const override {
@@ -188,7 +269,7 @@ public:
       // we clear the accumulated value.
       data_.value_ = 0;
       data_.flags_ &= ~Flags::Used;
-      data_.flags_ |= Flags::NeverImport;
+      data_.flags_ |= Flags::NeverImport | Flags::Changed;
       break;
     }
   }
@@ -204,7 +285,23 @@ private:
 CounterSharedPtr HeapStatDataAllocator::makeCounter(StatName name,
                                                     absl::string_view tag_extracted_name,
                                                     const std::vector<Tag>& tags) {
-  return std::make_shared<CounterImpl>(alloc(name), *this, tag_extracted_name, tags);
+  HeapStatData& data = alloc(name);
+  if (counter_shards_ == 0) {
+    return std::make_shared<CounterImpl>(data, *this, tag_extracted_name, tags);
+  }
+
+  CounterShards* shards;
+  {
+    // The data may be shared with a counter of the same name created from another scope, in which
+    // case its shards already exist.
+    Thread::LockGuard lock(mutex_);
+    std::unique_ptr<CounterShards>& data_shards = sharded_counters_[&data];
+    if (data_shards == nullptr) {
+      data_shards = std::make_unique<CounterShards>(counter_shards_);
+    }
+    shards = data_shards.get();
+  }
+  return std::make_shared<ShardedCounterImpl>(data, *shards, *this, tag_extracted_name, tags);
 }
 
 GaugeSharedPtr HeapStatDataAllocator::makeGauge(StatName name, absl::string_view tag_extracted_name,
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "envoy/stats/stat_data_allocator.h"
@@ -10,12 +13,51 @@
 
 #include "common/stats/metric_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Stats {
 
+/**
+ * Per-thread slots for a counter, so that hot counters incremented from many workers do not bounce
+ * a single cache line between cores. Each thread increments the slot selected by its thread index,
+ * and readers sum all the slots. Slots only ever grow; reset() and latch() are implemented by
+ * remembering the sum observed when they were last called.
+ */
+class CounterShards {
+public:
+  explicit CounterShards(uint32_t num_shards);
+
+  void add(uint64_t amount) {
+    shards_[threadIndex() % num_shards_].value_.fetch_add(amount, std::memory_order_relaxed);
+  }
+  uint64_t sum() const;
+
+  // Sum of the slots when the counter was last reset or latched.
+  std::atomic<uint64_t> reset_sum_{0};
+  std::atomic<uint64_t> latched_sum_{0};
+
+private:
+  static constexpr size_t CacheLineSize = 64;
+
+  // Aligned to a cache line so that slots for different threads never share one.
+  struct alignas(CacheLineSize) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+  static_assert(sizeof(Shard) == CacheLineSize, "a slot must fill exactly one cache line");
+
+  // Returns a small index that is stable for the lifetime of the calling thread.
+  static uint32_t threadIndex();
+
+  const uint32_t num_shards_;
+  // operator new[] only guarantees the alignment of max_align_t before C++17, so the slots are
+  // placed at the first cache line boundary of a slightly larger buffer.
+  std::unique_ptr<char[]> storage_;
+  Shard* shards_;
+};
+
 /**
  * Holds backing store for both CounterImpl and GaugeImpl. This provides a level
  * of indirection needed to enable stats created with the same name from
@@ -43,7 +85,13 @@ public:
 
 class HeapStatDataAllocator : public StatDataAllocator {
 public:
-  HeapStatDataAllocator(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+  /**
+   * @param symbol_table supplies the symbol table for stat names.
+   * @param counter_shards supplies the number of per-thread slots allocated for each counter. When
+   *        zero, counters are a single atomic value shared by all threads.
+   */
+  HeapStatDataAllocator(SymbolTable& symbol_table, uint32_t counter_shards = 0)
+      : symbol_table_(symbol_table), counter_shards_(counter_shards) {}
   ~HeapStatDataAllocator() override;
 
   HeapStatData& alloc(StatName name);
@@ -74,8 +122,13 @@ private:
   // StatNamePtr's own StatNamePtrHash and StatNamePtrCompare operators.
   using StatSet = absl::flat_hash_set<HeapStatData*, HeapStatHash, HeapStatCompare>;
   StatSet stats_ GUARDED_BY(mutex_);
+  // The slots of sharded counters, kept out of HeapStatData so that the memory of every stat only
+  // grows when sharding is enabled.
+  absl::flat_hash_map<const HeapStatData*, std::unique_ptr<CounterShards>>
+      sharded_counters_ GUARDED_BY(mutex_);
 
   SymbolTable& symbol_table_;
+  const uint32_t counter_shards_;
 
   // A mutex is needed here to protect both the stats_ object from both
   // alloc() and free() operations. Although alloc() operations are called under existing locking,
@@ -0,0 +1,22 @@
+#include "common/stats/histogram_settings_impl.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Stats {
+
+HistogramSettingsImpl::HistogramSettingsImpl(
+    const envoy::config::metrics::v2::StatsConfig& config) {
+  for (const auto& matcher : config.fixed_bucket_histograms().patterns()) {
+    fixed_bucket_matchers_.push_back(Matchers::StringMatcher(matcher));
+  }
+}
+
+bool HistogramSettingsImpl::fixedBuckets(absl::string_view name) const {
+  return std::any_of(
+      fixed_bucket_matchers_.begin(), fixed_bucket_matchers_.end(),
+      [name](const Matchers::StringMatcher& matcher) { return matcher.match(name); });
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "envoy/config/metrics/v2/stats.pb.h"
+#include "envoy/stats/histogram.h"
+
+#include "common/common/matchers.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Supplies the histogram settings of a StatsConfig.
+ */
+class HistogramSettingsImpl : public HistogramSettings {
+public:
+  explicit HistogramSettingsImpl(const envoy::config::metrics::v2::StatsConfig& config);
+
+  // Default constructor records all histograms into a circllhist.
+  HistogramSettingsImpl() = default;
+
+  // HistogramSettings
+  bool fixedBuckets(absl::string_view name) const override;
+
+private:
+  std::vector<Matchers::StringMatcher> fixed_bucket_matchers_;
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,30 @@
+#include "common/stats/lazy_stat_pool.h"
+
+namespace Envoy {
+namespace Stats {
+
+LazyStatPool::LazyStatPool(Scope& scope) : scope_(scope), names_(scope.symbolTable()) {}
+
+Counter& LazyStatPool::counter(const std::string& name) {
+  auto counter = std::make_unique<LazyCounter>(scope_, names_.add(name));
+  Counter& ref = *counter;
+  stats_.push_back(std::move(counter));
+  return ref;
+}
+
+Gauge& LazyStatPool::gauge(const std::string& name, Gauge::ImportMode import_mode) {
+  auto gauge = std::make_unique<LazyGauge>(scope_, names_.add(name), import_mode);
+  Gauge& ref = *gauge;
+  stats_.push_back(std::move(gauge));
+  return ref;
+}
+
+Histogram& LazyStatPool::histogram(const std::string& name) {
+  auto histogram = std::make_unique<LazyHistogram>(scope_, names_.add(name));
+  Histogram& ref = *histogram;
+  stats_.push_back(std::move(histogram));
+  return ref;
+}
+
+} // namespace Stats
+} // namespace Envoy
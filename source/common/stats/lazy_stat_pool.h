@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+#include "common/stats/null_gauge.h"
+#include "common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Base for metrics that are only created in their scope when first updated. Until then they
+ * read as zero and unused, and since nothing exists in the scope they are not seen by sinks or
+ * admin. Accessing the name or tags of the metric creates it.
+ */
+template <class StatType> class LazyStat : public StatType {
+public:
+  LazyStat(Scope& scope, StatName name) : scope_(scope), name_(name) {}
+
+  // Stats::Metric
+  std::string name() const override { return realize().name(); }
+  StatName statName() const override { return realize().statName(); }
+  std::vector<Tag> tags() const override { return realize().tags(); }
+  std::string tagExtractedName() const override { return realize().tagExtractedName(); }
+  StatName tagExtractedStatName() const override { return realize().tagExtractedStatName(); }
+  void iterateTagStatNames(const Metric::TagStatNameIterFn& fn) const override {
+    realize().iterateTagStatNames(fn);
+  }
+  void iterateTags(const Metric::TagIterFn& fn) const override { realize().iterateTags(fn); }
+  bool used() const override {
+    const StatType* stat = get();
+    return stat != nullptr && stat->used();
+  }
+  SymbolTable& symbolTable() override { return scope_.symbolTable(); }
+  const SymbolTable& constSymbolTable() const override { return scope_.constSymbolTable(); }
+
+protected:
+  /**
+   * @return the metric if it has been created, or nullptr otherwise.
+   */
+  StatType* get() const { return stat_.load(std::memory_order_acquire); }
+
+  /**
+   * @return the metric, creating it in the scope if needed. Threads racing to create the metric
+   *         get the same object back from the scope, so no further synchronization is needed.
+   */
+  StatType& realize() const {
+    StatType* stat = get();
+    if (stat == nullptr) {
+      stat = &create(scope_, name_);
+      stat_.store(stat, std::memory_order_release);
+    }
+    return *stat;
+  }
+
+  virtual StatType& create(Scope& scope, StatName name) const PURE;
+
+private:
+  Scope& scope_;
+  const StatName name_;
+  mutable std::atomic<StatType*> stat_{nullptr};
+};
+
+/**
+ * Counter created on its first increment.
+ */
+class LazyCounter : public LazyStat<Counter> {
+public:
+  using LazyStat<Counter>::LazyStat;
+
+  // Stats::Counter
+  void add(uint64_t amount) override { realize().add(amount); }
+  void inc() override { realize().inc(); }
+  uint64_t latch() override {
+    Counter* counter = get();
+    return counter != nullptr ? counter->latch() : 0;
+  }
+  void reset() override {
+    Counter* counter = get();
+    if (counter != nullptr) {
+      counter->reset();
+    }
+  }
+  uint64_t value() const override {
+    const Counter* counter = get();
+    return counter != nullptr ? counter->value() : 0;
+  }
+
+protected:
+  Counter& create(Scope& scope, StatName name) const override {
+    return scope.counterFromStatName(name);
+  }
+};
+
+/**
+ * Gauge created on its first update to a non-zero value. Many gauges, such as circuit breaker
+ * state, are set to zero far more often than to anything else.
+ */
+class LazyGauge : public LazyStat<Gauge> {
+public:
+  LazyGauge(Scope& scope, StatName name, ImportMode import_mode)
+      : LazyStat<Gauge>(scope, name), import_mode_(import_mode) {}
+
+  // Stats::Gauge
+  void add(uint64_t amount) override {
+    if (amount != 0 || get() != nullptr) {
+      realize().add(amount);
+    }
+  }
+  void dec() override { realize().dec(); }
+  void inc() override { realize().inc(); }
+  void set(uint64_t value) override {
+    if (value != 0 || get() != nullptr) {
+      realize().set(value);
+    }
+  }
+  void sub(uint64_t amount) override {
+    if (amount != 0 || get() != nullptr) {
+      realize().sub(amount);
+    }
+  }
+  uint64_t value() const override {
+    const Gauge* gauge = get();
+    return gauge != nullptr ? gauge->value() : 0;
+  }
+  bool latchChanged() override {
+    Gauge* gauge = get();
+    return gauge != nullptr && gauge->latchChanged();
+  }
+  ImportMode importMode() const override {
+    const Gauge* gauge = get();
+    return gauge != nullptr ? gauge->importMode() : import_mode_;
+  }
+  void mergeImportMode(ImportMode import_mode) override {
+    realize().mergeImportMode(import_mode);
+  }
+
+protected:
+  Gauge& create(Scope& scope, StatName name) const override {
+    return scope.gaugeFromStatName(name, import_mode_);
+  }
+
+private:
+  const ImportMode import_mode_;
+};
+
+/**
+ * Histogram created when its first value is recorded.
+ */
+class LazyHistogram : public LazyStat<Histogram> {
+public:
+  using LazyStat<Histogram>::LazyStat;
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override { realize().recordValue(value); }
+
+protected:
+  Histogram& create(Scope& scope, StatName name) const override {
+    return scope.histogramFromStatName(name);
+  }
+};
+
+/**
+ * Hands out lazily created metrics for a scope. It has the same counter(), gauge(), histogram()
+ * and nullGauge() methods as Scope, so it can be passed to the POOL_* macros in stats_macros.h to
+ * build a stats struct whose metrics only exist in the scope once they are used. This trades a
+ * small fixed cost per metric for not creating metrics that are never updated, which matters for
+ * large numbers of rarely used scopes such as clusters.
+ *
+ * The pool must outlive the references it returns, and the scope must outlive the pool.
+ */
+class LazyStatPool {
+public:
+  explicit LazyStatPool(Scope& scope);
+
+  Counter& counter(const std::string& name);
+  Gauge& gauge(const std::string& name, Gauge::ImportMode import_mode);
+  Histogram& histogram(const std::string& name);
+  NullGaugeImpl& nullGauge(const std::string& name) { return scope_.nullGauge(name); }
+
+private:
+  Scope& scope_;
+  StatNamePool names_;
+  std::vector<std::unique_ptr<Metric>> stats_;
+};
+
+using LazyStatPoolPtr = std::unique_ptr<LazyStatPool>;
+
+} // namespace Stats
+} // namespace Envoy
@@ -28,6 +28,7 @@ public:
   void set(uint64_t) override {}
   void sub(uint64_t) override {}
   uint64_t value() const override { return 0; }
+  bool latchChanged() override { return false; }
   ImportMode importMode() const override { return ImportMode::NeverImport; }
   void mergeImportMode(ImportMode /* import_mode */) override {}
 };
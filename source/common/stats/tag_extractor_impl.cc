@@ -2,15 +2,18 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
 
+#include "common/common/assert.h"
 #include "common/common/perf_annotation.h"
 #include "common/common/utility.h"
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Stats {
@@ -21,6 +24,9 @@ bool regexStartsWithDot(absl::string_view regex) {
   return absl::StartsWith(regex, "\\.") || absl::StartsWith(regex, "(?=\\.)");
 }
 
+// Matches the \w character class of the regexes the token patterns replace.
+bool isWordChar(char c) { return absl::ascii_isalnum(c) || c == '_'; }
+
 } // namespace
 
 TagExtractorImpl::TagExtractorImpl(const std::string& name, const std::string& regex,
@@ -105,5 +111,135 @@ bool TagExtractorImpl::extractTag(absl::string_view stat_name, std::vector<Tag>&
   return false;
 }
 
+TagExtractorPtr TagExtractorTokensImpl::createTagExtractor(const std::string& name,
+                                                           const std::string& tokens) {
+  if (name.empty()) {
+    throw EnvoyException("tag_name cannot be empty");
+  }
+  if (tokens.empty()) {
+    throw EnvoyException(fmt::format("No tokens specified for tag name: '{}'", name));
+  }
+  return TagExtractorPtr{new TagExtractorTokensImpl(name, tokens)};
+}
+
+TagExtractorTokensImpl::TagExtractorTokensImpl(const std::string& name, const std::string& tokens)
+    : name_(name) {
+  uint32_t num_values = 0;
+  for (absl::string_view token : absl::StrSplit(tokens, '.')) {
+    if (token == "*") {
+      tokens_.push_back({TokenType::Any, ""});
+    } else if (token == "**") {
+      tokens_.push_back({TokenType::AnyTokens, ""});
+    } else if (token == "%") {
+      tokens_.push_back({TokenType::Word, ""});
+    } else if (token == "$") {
+      tokens_.push_back({TokenType::Value, ""});
+      ++num_values;
+    } else if (token == "$$") {
+      tokens_.push_back({TokenType::ValueTokens, ""});
+      ++num_values;
+    } else {
+      tokens_.push_back({TokenType::Literal, std::string(token)});
+    }
+  }
+  if (num_values != 1) {
+    throw EnvoyException(
+        fmt::format("Tag tokens '{}' must contain exactly one '$' or '$$' value", tokens));
+  }
+  if (tokens_.front().type_ == TokenType::Literal) {
+    prefix_ = tokens_.front().literal_;
+  }
+}
+
+size_t TagExtractorTokensImpl::Match::tokenEnd(size_t pos) const {
+  const size_t dot = name_.find('.', pos);
+  return dot == absl::string_view::npos ? name_.size() : dot;
+}
+
+bool TagExtractorTokensImpl::matches(size_t index, size_t pos, Match& match) const {
+  if (index == tokens_.size()) {
+    return match.done(pos);
+  }
+  const Token& token = tokens_[index];
+  if (token.type_ == TokenType::AnyTokens) {
+    // A trailing "**" matches whatever is left of the name.
+    if (index + 1 == tokens_.size()) {
+      return true;
+    }
+    for (;; pos = match.nextToken(pos)) {
+      if (matches(index + 1, pos, match)) {
+        return true;
+      }
+      if (match.done(pos)) {
+        return false;
+      }
+    }
+  }
+
+  if (match.done(pos)) {
+    return false;
+  }
+  const size_t end = match.tokenEnd(pos);
+  const absl::string_view name_token = match.name_.substr(pos, end - pos);
+  switch (token.type_) {
+  case TokenType::AnyTokens:
+    // Handled above.
+    break;
+  case TokenType::Literal:
+    return name_token == token.literal_ && matches(index + 1, end + 1, match);
+  case TokenType::Any:
+    return matches(index + 1, end + 1, match);
+  case TokenType::Word:
+    return !name_token.empty() && std::all_of(name_token.begin(), name_token.end(), isWordChar) &&
+           matches(index + 1, end + 1, match);
+  case TokenType::Value:
+  case TokenType::ValueTokens: {
+    // A value other than the last token of the pattern must be followed by a '.'.
+    const bool last = index + 1 == tokens_.size();
+    for (size_t value_end = end;; value_end = match.tokenEnd(value_end + 1)) {
+      if (!last && value_end == match.name_.size()) {
+        return false;
+      }
+      if (matches(index + 1, value_end + 1, match)) {
+        match.value_start_ = pos;
+        match.value_end_ = value_end;
+        return true;
+      }
+      if (token.type_ == TokenType::Value || value_end == match.name_.size()) {
+        return false;
+      }
+    }
+  }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+bool TagExtractorTokensImpl::extractTag(absl::string_view stat_name, std::vector<Tag>& tags,
+                                        IntervalSet<size_t>& remove_characters) const {
+  PERF_OPERATION(perf);
+
+  Match match{stat_name};
+  if (!matches(0, 0, match)) {
+    PERF_RECORD(perf, "tokens-miss", name_);
+    return false;
+  }
+
+  tags.emplace_back();
+  Tag& tag = tags.back();
+  tag.name_ = name_;
+  tag.value_ = std::string(
+      stat_name.substr(match.value_start_, match.value_end_ - match.value_start_));
+
+  // Removes the value along with the '.' after it, or the '.' before it if it ends the name.
+  if (match.value_end_ < stat_name.size()) {
+    remove_characters.insert(match.value_start_, match.value_end_ + 1);
+  } else {
+    remove_characters.insert(match.value_start_ > 0 ? match.value_start_ - 1 : 0,
+                             match.value_end_);
+  }
+  PERF_RECORD(perf, "tokens-match", name_);
+  return true;
+}
+
 } // namespace Stats
 } // namespace Envoy
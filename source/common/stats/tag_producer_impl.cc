@@ -45,14 +45,21 @@ int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
   int num_found = 0;
   for (const auto& desc : Config::TagNames::get().descriptorVec()) {
     if (desc.name_ == name) {
-      addExtractor(
-          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+      addExtractor(createDefaultExtractor(desc));
       ++num_found;
     }
   }
   return num_found;
 }
 
+TagExtractorPtr
+TagProducerImpl::createDefaultExtractor(const Config::TagNameValues::Descriptor& desc) {
+  if (!desc.tokens_.empty()) {
+    return Stats::TagExtractorTokensImpl::createTagExtractor(desc.name_, desc.tokens_);
+  }
+  return Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_);
+}
+
 void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
   const absl::string_view prefix = extractor->prefixToken();
   if (prefix.empty()) {
@@ -101,8 +108,7 @@ TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v2::StatsCon
   if (!config.has_use_all_default_tags() || config.use_all_default_tags().value()) {
     for (const auto& desc : Config::TagNames::get().descriptorVec()) {
       names.emplace(desc.name_);
-      addExtractor(
-          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+      addExtractor(createDefaultExtractor(desc));
     }
   }
   return names;
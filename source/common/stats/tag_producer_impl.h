@@ -58,6 +58,14 @@ private:
    */
   int addExtractorsMatching(absl::string_view name);
 
+  /**
+   * Creates the extractor for a default tag, matching its token pattern if it has one and its
+   * regex otherwise.
+   * @param desc const Config::TagNameValues::Descriptor& the default tag.
+   * @return TagExtractorPtr the extractor.
+   */
+  static TagExtractorPtr createDefaultExtractor(const Config::TagNameValues::Descriptor& desc);
+
   /**
    * Roughly estimate the size of the vectors.
    * @param config const envoy::config::metrics::v2::StatsConfig& the config.
@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/sink.h"
@@ -20,6 +21,13 @@
 namespace Envoy {
 namespace Stats {
 
+namespace {
+
+// Number of histograms a thread takes at a time while merging histograms.
+constexpr size_t HistogramMergeBatchSize = 64;
+
+} // namespace
+
 ThreadLocalStoreImpl::ThreadLocalStoreImpl(StatDataAllocator& alloc)
     : alloc_(alloc), default_scope_(createScope("")),
       tag_producer_(std::make_unique<TagProducerImpl>()),
@@ -131,7 +139,12 @@ std::vector<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
 }
 
 std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
-  std::vector<ParentHistogramSharedPtr> ret;
+  const std::vector<ParentHistogramImplSharedPtr> histograms = parentHistograms();
+  return std::vector<ParentHistogramSharedPtr>(histograms.begin(), histograms.end());
+}
+
+std::vector<ParentHistogramImplSharedPtr> ThreadLocalStoreImpl::parentHistograms() const {
+  std::vector<ParentHistogramImplSharedPtr> ret;
   Thread::LockGuard lock(lock_);
   // TODO(ramaraochavali): As histograms don't share storage, there is a chance of duplicate names
   // here. We need to create global storage for histograms similar to how we have a central storage
@@ -140,8 +153,7 @@ std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
   // less confusing for users who have such configs.
   for (ScopeImpl* scope : scopes_) {
     for (const auto& name_histogram_pair : scope->central_cache_.histograms_) {
-      const ParentHistogramSharedPtr& parent_hist = name_histogram_pair.second;
-      ret.push_back(parent_hist);
+      ret.push_back(name_histogram_pair.second);
     }
   }
 
@@ -186,14 +198,47 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
-    for (const ParentHistogramSharedPtr& histogram : histograms()) {
-      histogram->merge();
+    // Each histogram is merged independently of the others, so the merge is shared between the
+    // workers, which take batches of histograms until there are none left. This keeps the main
+    // thread free while the statistics are computed. It then publishes them all at once.
+    const std::thread::id main_thread_id = std::this_thread::get_id();
+    auto merge = std::make_shared<HistogramMerge>(parentHistograms());
+    tls_->runOnAllThreads(
+        [merge, main_thread_id]() -> void {
+          if (std::this_thread::get_id() != main_thread_id) {
+            merge->run();
+          }
+        },
+        [this, merge, merge_complete_cb]() -> void {
+          if (!shutting_down_) {
+            // Finish any histograms not taken by a worker. Without workers, this is all of them.
+            merge->run();
+            merge->publish();
+            merge_complete_cb();
+            merge_in_progress_ = false;
+          }
+        });
+  }
+}
+
+void ThreadLocalStoreImpl::HistogramMerge::run() {
+  for (size_t begin = next_.fetch_add(HistogramMergeBatchSize); begin < histograms_.size();
+       begin = next_.fetch_add(HistogramMergeBatchSize)) {
+    const size_t end = std::min(begin + HistogramMergeBatchSize, histograms_.size());
+    for (size_t i = begin; i < end; i++) {
+      histograms_[i]->prepareMerge();
     }
-    merge_complete_cb();
-    merge_in_progress_ = false;
   }
 }
 
+void ThreadLocalStoreImpl::HistogramMerge::publish() {
+  for (const ParentHistogramImplSharedPtr& histogram : histograms_) {
+    histogram->publishMerge();
+  }
+  // Release the histograms here, so that none are destroyed on a worker thread.
+  histograms_.clear();
+}
+
 void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
   Thread::ReleasableLockGuard lock(lock_);
   ASSERT(scopes_.count(scope) == 1);
@@ -284,6 +329,16 @@ private:
   std::string tag_extracted_name_;
 };
 
+bool ThreadLocalStoreImpl::fixedBuckets(StatName name) const {
+  bool fixed_buckets = false;
+  if (histogram_settings_ != nullptr) {
+    constSymbolTable().callWithStringView(name, [this, &fixed_buckets](absl::string_view name_str) {
+      fixed_buckets = histogram_settings_->fixedBuckets(name_str);
+    });
+  }
+  return fixed_buckets;
+}
+
 bool ThreadLocalStoreImpl::checkAndRememberRejection(StatName name,
                                                      StatNameStorageSet& central_rejected_stats,
                                                      StatNameHashSet* tls_rejected_stats) {
@@ -501,8 +556,10 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatName(StatName name)
     return parent_.null_histogram_;
   } else {
     TagExtraction extraction(parent_, final_stat_name);
-    auto stat = std::make_shared<ParentHistogramImpl>(
-        final_stat_name, parent_, *this, extraction.tagExtractedName(), extraction.tags());
+    auto stat = std::make_shared<ParentHistogramImpl>(final_stat_name, parent_, *this,
+                                                      extraction.tagExtractedName(),
+                                                      extraction.tags(),
+                                                      parent_.fixedBuckets(final_stat_name));
     central_ref = &central_cache_.histograms_[stat->statName()];
     *central_ref = stat;
   }
@@ -554,8 +611,8 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
   std::vector<Tag> tags;
   std::string tag_extracted_name =
       parent_.tagProducer().produceTags(symbolTable().toString(name), tags);
-  TlsHistogramSharedPtr hist_tls_ptr =
-      std::make_shared<ThreadLocalHistogramImpl>(name, tag_extracted_name, tags, symbolTable());
+  TlsHistogramSharedPtr hist_tls_ptr = std::make_shared<ThreadLocalHistogramImpl>(
+      name, tag_extracted_name, tags, symbolTable(), parent.fixedBuckets());
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -568,40 +625,60 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name,
                                                    absl::string_view tag_extracted_name,
                                                    const std::vector<Tag>& tags,
-                                                   SymbolTable& symbol_table)
+                                                   SymbolTable& symbol_table,
+                                                   bool fixed_buckets)
     : MetricImpl(tag_extracted_name, tags, symbol_table), current_active_(0), used_(false),
       created_thread_id_(std::this_thread::get_id()), name_(name, symbol_table),
       symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
+  if (fixed_buckets) {
+    fixed_buckets_ = std::make_unique<FixedBucketHistogram>();
+  } else {
+    histograms_[0] = hist_alloc();
+    histograms_[1] = hist_alloc();
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   MetricImpl::clear();
   name_.free(symbolTable());
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  if (fixed_buckets_ == nullptr) {
+    hist_free(histograms_[0]);
+    hist_free(histograms_[1]);
+  }
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
+  if (fixed_buckets_ != nullptr) {
+    fixed_buckets_->recordValue(value);
+    return;
+  }
   hist_insert_intscale(histograms_[current_active_], value, 0, 1);
   used_ = true;
 }
 
-void ThreadLocalHistogramImpl::merge(histogram_t* target) {
+uint64_t ThreadLocalHistogramImpl::merge(histogram_t* target) {
+  if (fixed_buckets_ != nullptr) {
+    return fixed_buckets_->merge(target);
+  }
   histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
-  hist_accumulate(target, other_histogram, 1);
-  hist_clear(*other_histogram);
+  const uint64_t sample_count = hist_sample_count(*other_histogram);
+  if (sample_count > 0) {
+    hist_accumulate(target, other_histogram, 1);
+    hist_clear(*other_histogram);
+  }
+  return sample_count;
 }
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Store& parent, TlsScope& tls_scope,
                                          absl::string_view tag_extracted_name,
-                                         const std::vector<Tag>& tags)
+                                         const std::vector<Tag>& tags, bool fixed_buckets)
     : MetricImpl(tag_extracted_name, tags, parent.symbolTable()), parent_(parent),
-      tls_scope_(tls_scope), interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
-      interval_statistics_(interval_histogram_), cumulative_statistics_(cumulative_histogram_),
-      merged_(false), name_(name, parent.symbolTable()) {}
+      tls_scope_(tls_scope), fixed_buckets_(fixed_buckets), interval_histogram_(hist_alloc()),
+      cumulative_histogram_(hist_alloc()),
+      interval_statistics_{{interval_histogram_}, {interval_histogram_}},
+      cumulative_statistics_{{cumulative_histogram_}, {cumulative_histogram_}}, merged_(false),
+      name_(name, parent.symbolTable()) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   MetricImpl::clear();
@@ -622,6 +699,11 @@ bool ParentHistogramImpl::used() const {
 }
 
 void ParentHistogramImpl::merge() {
+  prepareMerge();
+  publishMerge();
+}
+
+void ParentHistogramImpl::prepareMerge() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
     hist_clear(interval_histogram_);
@@ -629,27 +711,55 @@ void ParentHistogramImpl::merge() {
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
+    uint64_t sample_count = 0;
     for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
+      sample_count += tls_histogram->merge(interval_histogram_);
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
-    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
-    merged_ = true;
+
+    // Computing quantiles is the expensive part of the merge, so statistics are only recomputed
+    // when they can have changed: the cumulative ones when there are new values, and the interval
+    // ones unless this and the last interval were both empty.
+    if (sample_count > 0) {
+      hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+      cumulative_statistics_[1 - cumulative_index_].refresh(cumulative_histogram_);
+      cumulative_statistics_pending_ = true;
+    }
+    if (sample_count > 0 || !interval_empty_) {
+      interval_statistics_[1 - interval_index_].refresh(interval_histogram_);
+      interval_statistics_pending_ = true;
+    }
+    interval_empty_ = sample_count == 0;
+    merge_prepared_ = true;
+  }
+}
+
+void ParentHistogramImpl::publishMerge() {
+  if (!merge_prepared_) {
+    return;
+  }
+  if (cumulative_statistics_pending_) {
+    cumulative_index_ = 1 - cumulative_index_;
+    cumulative_statistics_pending_ = false;
+  }
+  if (interval_statistics_pending_) {
+    interval_index_ = 1 - interval_index_;
+    interval_statistics_pending_ = false;
   }
+  merge_prepared_ = false;
+  merged_ = true;
 }
 
 const std::string ParentHistogramImpl::quantileSummary() const {
   if (used()) {
     std::vector<std::string> summary;
-    const std::vector<double>& supported_quantiles_ref = interval_statistics_.supportedQuantiles();
+    const std::vector<double>& supported_quantiles_ref = intervalStatistics().supportedQuantiles();
     summary.reserve(supported_quantiles_ref.size());
     for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
       summary.push_back(fmt::format("P{}({},{})", 100 * supported_quantiles_ref[i],
-                                    interval_statistics_.computedQuantiles()[i],
-                                    cumulative_statistics_.computedQuantiles()[i]));
+                                    intervalStatistics().computedQuantiles()[i],
+                                    cumulativeStatistics().computedQuantiles()[i]));
     }
     return absl::StrJoin(summary, " ");
   } else {
@@ -660,12 +770,12 @@ const std::string ParentHistogramImpl::quantileSummary() const {
 const std::string ParentHistogramImpl::bucketSummary() const {
   if (used()) {
     std::vector<std::string> bucket_summary;
-    const std::vector<double>& supported_buckets = interval_statistics_.supportedBuckets();
+    const std::vector<double>& supported_buckets = intervalStatistics().supportedBuckets();
     bucket_summary.reserve(supported_buckets.size());
     for (size_t i = 0; i < supported_buckets.size(); ++i) {
       bucket_summary.push_back(fmt::format("B{}({},{})", supported_buckets[i],
-                                           interval_statistics_.computedBuckets()[i],
-                                           cumulative_statistics_.computedBuckets()[i]));
+                                           intervalStatistics().computedBuckets()[i],
+                                           cumulativeStatistics().computedBuckets()[i]));
     }
     return absl::StrJoin(bucket_summary, " ");
   } else {
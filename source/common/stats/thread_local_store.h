@@ -4,11 +4,13 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/hash.h"
+#include "common/stats/fixed_bucket_histogram.h"
 #include "common/stats/heap_stat_data.h"
 #include "common/stats/histogram_impl.h"
 #include "common/stats/null_counter.h"
@@ -26,15 +28,21 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process. Histograms with fixed buckets instead count their values
+ * in a FixedBucketHistogram, which can be merged while values are recorded, so they need no swap.
  */
 class ThreadLocalHistogramImpl : public Histogram, public MetricImpl {
 public:
   ThreadLocalHistogramImpl(StatName name, absl::string_view tag_extracted_name,
-                           const std::vector<Tag>& tags, SymbolTable& symbol_table);
+                           const std::vector<Tag>& tags, SymbolTable& symbol_table,
+                           bool fixed_buckets);
   ~ThreadLocalHistogramImpl() override;
 
-  void merge(histogram_t* target);
+  /**
+   * Merges the values collected before the last beginMerge() into target, and clears them.
+   * @return uint64_t the number of values that were merged.
+   */
+  uint64_t merge(histogram_t* target);
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
@@ -48,7 +56,9 @@ public:
 
   // Stats::Histogram
   void recordValue(uint64_t value) override;
-  bool used() const override { return used_; }
+  bool used() const override {
+    return fixed_buckets_ != nullptr ? fixed_buckets_->used() : used_.load();
+  }
 
   // Stats::Metric
   StatName statName() const override { return name_.statName(); }
@@ -57,8 +67,10 @@ public:
 private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
-  histogram_t* histograms_[2];
+  histogram_t* histograms_[2]{};
   std::atomic<bool> used_;
+  // Set instead of histograms_ when the histogram has fixed buckets.
+  std::unique_ptr<FixedBucketHistogram> fixed_buckets_;
   std::thread::id created_thread_id_;
   StatNameStorage name_;
   SymbolTable& symbol_table_;
@@ -74,10 +86,12 @@ class TlsScope;
 class ParentHistogramImpl : public ParentHistogram, public MetricImpl {
 public:
   ParentHistogramImpl(StatName name, Store& parent, TlsScope& tlsScope,
-                      absl::string_view tag_extracted_name, const std::vector<Tag>& tags);
+                      absl::string_view tag_extracted_name, const std::vector<Tag>& tags,
+                      bool fixed_buckets);
   ~ParentHistogramImpl() override;
 
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
+  bool fixedBuckets() const { return fixed_buckets_; }
   bool used() const override;
   void recordValue(uint64_t value) override;
 
@@ -89,9 +103,25 @@ public:
    */
   void merge() override;
 
-  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  /**
+   * The first half of merge(), which merges the TLS histograms and computes the new statistics
+   * without making them visible. Unlike the rest of this class it may be called from any thread,
+   * as long as merges of the same histogram do not overlap. Statistics that cannot have changed,
+   * because no values were recorded in the interval, are not recomputed.
+   */
+  void prepareMerge();
+
+  /**
+   * The second half of merge(), which makes the statistics computed by prepareMerge() visible.
+   * This must be called on the main thread, after prepareMerge() has completed.
+   */
+  void publishMerge();
+
+  const HistogramStatistics& intervalStatistics() const override {
+    return interval_statistics_[interval_index_];
+  }
   const HistogramStatistics& cumulativeStatistics() const override {
-    return cumulative_statistics_;
+    return cumulative_statistics_[cumulative_index_];
   }
   const std::string quantileSummary() const override;
   const std::string bucketSummary() const override;
@@ -105,13 +135,24 @@ private:
 
   Store& parent_;
   TlsScope& tls_scope_;
+  const bool fixed_buckets_;
   histogram_t* interval_histogram_;
   histogram_t* cumulative_histogram_;
-  HistogramStatisticsImpl interval_statistics_;
-  HistogramStatisticsImpl cumulative_statistics_;
+  // The statistics are double buffered, so that prepareMerge() can compute new statistics into the
+  // buffers not selected by interval_index_ and cumulative_index_ while the current ones are read.
+  HistogramStatisticsImpl interval_statistics_[2];
+  HistogramStatisticsImpl cumulative_statistics_[2];
+  uint32_t interval_index_{};
+  uint32_t cumulative_index_{};
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ GUARDED_BY(merge_lock_);
   bool merged_;
+  // Set by prepareMerge() for publishMerge().
+  bool merge_prepared_{};
+  bool interval_statistics_pending_{};
+  bool cumulative_statistics_pending_{};
+  // Whether the last merged interval had no values.
+  bool interval_empty_{true};
   StatNameStorage name_;
 };
 
@@ -209,6 +250,9 @@ public:
     tag_producer_ = std::move(tag_producer);
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
+  void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override {
+    histogram_settings_ = std::move(histogram_settings);
+  }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -336,12 +380,29 @@ private:
     absl::flat_hash_map<uint64_t, TlsCacheEntry> scope_cache_;
   };
 
+  /**
+   * Histograms being merged by mergeInternal(). Threads call run() to take batches of histograms
+   * to prepare until there are none left, then the main thread publishes them all.
+   */
+  struct HistogramMerge {
+    explicit HistogramMerge(std::vector<ParentHistogramImplSharedPtr>&& histograms)
+        : histograms_(std::move(histograms)) {}
+
+    void run();
+    void publish();
+
+    std::vector<ParentHistogramImplSharedPtr> histograms_;
+    std::atomic<size_t> next_{};
+  };
+
+  std::vector<ParentHistogramImplSharedPtr> parentHistograms() const;
   std::string getTagsForName(const std::string& name, std::vector<Tag>& tags) const;
   void clearScopeFromCaches(uint64_t scope_id, const Event::PostCb& clean_central_cache);
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb mergeCb);
   bool rejects(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
+  bool fixedBuckets(StatName name) const;
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
   bool checkAndRememberRejection(StatName name, StatNameStorageSet& central_rejected_stats,
@@ -356,6 +417,8 @@ private:
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
+  // No histogram has fixed buckets until histogram settings are set.
+  HistogramSettingsConstPtr histogram_settings_;
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
@@ -21,6 +21,13 @@ struct StreamInfoImpl : public StreamInfo {
     protocol_ = protocol;
   }
 
+  // Uses filter state owned by the caller, e.g. by the socket of a connection, which must outlive
+  // this object.
+  StreamInfoImpl(TimeSource& time_source, FilterState& filter_state)
+      : StreamInfoImpl(time_source) {
+    filter_state_ = &filter_state;
+  }
+
   SystemTime startTime() const override { return start_time_; }
 
   MonotonicTime startTimeMonotonic() const override { return start_time_monotonic_; }
@@ -191,8 +198,8 @@ struct StreamInfoImpl : public StreamInfo {
     (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
   };
 
-  FilterState& filterState() override { return filter_state_; }
-  const FilterState& filterState() const override { return filter_state_; }
+  FilterState& filterState() override { return *filter_state_; }
+  const FilterState& filterState() const override { return *filter_state_; }
 
   void setRequestedServerName(absl::string_view requested_server_name) override {
     requested_server_name_ = std::string(requested_server_name);
@@ -225,7 +232,8 @@ struct StreamInfoImpl : public StreamInfo {
   bool health_check_request_{};
   const Router::RouteEntry* route_entry_{};
   envoy::api::v2::core::Metadata metadata_{};
-  FilterStateImpl filter_state_{};
+  FilterStateImpl owned_filter_state_{};
+  FilterState* filter_state_{&owned_filter_state_};
   std::string route_name_;
 
 private:
@@ -1,5 +1,6 @@
 #include "common/tcp/conn_pool.h"
 
+#include <cmath>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -57,8 +58,18 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
   checkForDrained();
 }
 
+void ConnPoolImpl::preconnect(uint32_t min_connections) {
+  while (drained_callbacks_.empty() && numConnections() < min_connections &&
+         createPreconnectedConnection()) {
+  }
+}
+
 void ConnPoolImpl::assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks) {
   ASSERT(conn.wrapper_ == nullptr);
+  if (conn.preconnected_) {
+    host_->cluster().stats().upstream_cx_preconnect_used_.inc();
+    conn.preconnected_ = false;
+  }
   conn.wrapper_ = std::make_shared<ConnectionWrapper>(conn);
 
   callbacks.onPoolReady(std::make_unique<ConnectionDataImpl>(conn.wrapper_),
@@ -84,11 +95,40 @@ void ConnPoolImpl::createNewConnection() {
   conn->moveIntoList(std::move(conn), pending_conns_);
 }
 
+bool ConnPoolImpl::createPreconnectedConnection() {
+  // Unlike connections created for a pending request, preconnected connections never exceed the
+  // connection circuit breaker. This bounds the load preconnecting puts on the upstream.
+  if (!host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    return false;
+  }
+
+  ENVOY_LOG(debug, "preconnecting a new connection");
+  host_->cluster().stats().upstream_cx_preconnect_total_.inc();
+  ActiveConnPtr conn(new ActiveConn(*this));
+  conn->preconnected_ = true;
+  conn->moveIntoList(std::move(conn), pending_conns_);
+  return true;
+}
+
+void ConnPoolImpl::maybePreconnect() {
+  const float ratio = host_->cluster().perUpstreamPreconnectRatio();
+  if (ratio <= 1.0 || !drained_callbacks_.empty()) {
+    return;
+  }
+
+  // Keep ratio times as many connections as there are assigned connections and pending requests.
+  const uint64_t demand = busy_conns_.size() + pending_requests_.size();
+  const uint64_t target = static_cast<uint64_t>(std::ceil(demand * ratio));
+  while (numConnections() < target && createPreconnectedConnection()) {
+  }
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbacks& callbacks) {
   if (!ready_conns_.empty()) {
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
     assignConnection(*busy_conns_.front(), callbacks);
+    maybePreconnect();
     return nullptr;
   }
 
@@ -108,6 +148,7 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
+    maybePreconnect();
     return pending_requests_.front().get();
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
@@ -386,6 +427,9 @@ ConnPoolImpl::ActiveConn::~ActiveConn() {
   if (wrapper_) {
     wrapper_->invalidate();
   }
+  if (preconnected_) {
+    parent_.host_->cluster().stats().upstream_cx_preconnect_wasted_.inc();
+  }
 
   parent_.host_->cluster().stats().upstream_cx_active_.dec();
   parent_.host_->stats().cx_active_.dec();
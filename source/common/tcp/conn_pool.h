@@ -30,6 +30,7 @@ public:
   // ConnectionPool::Instance
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
+  void preconnect(uint32_t min_connections) override;
   ConnectionPool::Cancellable* newConnection(ConnectionPool::Callbacks& callbacks) override;
 
 protected:
@@ -116,6 +117,8 @@ protected:
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
     bool timed_out_;
+    // Set if the connection was established ahead of demand and has not been assigned yet.
+    bool preconnected_{};
   };
 
   using ActiveConnPtr = std::unique_ptr<ActiveConn>;
@@ -137,6 +140,11 @@ protected:
 
   void assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks);
   void createNewConnection();
+  bool createPreconnectedConnection();
+  void maybePreconnect();
+  size_t numConnections() const {
+    return pending_conns_.size() + ready_conns_.size() + busy_conns_.size();
+  }
   void onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent event);
   void onPendingRequestCancel(PendingRequest& request, ConnectionPool::CancelPolicy cancel_policy);
   virtual void onConnReleased(ActiveConn& conn);
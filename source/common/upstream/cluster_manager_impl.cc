@@ -1006,6 +1006,10 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
+
+  if (!hosts_added.empty() && cluster_entry->cluster_info_->preconnectOnHostAdd() > 0) {
+    cluster_entry->preconnectHosts(hosts_added);
+  }
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
@@ -1171,6 +1175,11 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     option->hashKey(hash_key);
   }
 
+  if (priority == ResourcePriority::Default && upstream_options->empty() &&
+      cluster_info_->preconnectOnHostAdd() > 0) {
+    preconnect_http_protocols_.insert(protocol);
+  }
+
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
@@ -1220,6 +1229,9 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
 
   if (transport_socket_options != nullptr) {
     transport_socket_options->hashKey(hash_key);
+  } else if (priority == ResourcePriority::Default && !have_options &&
+             cluster_info_->preconnectOnHostAdd() > 0) {
+    preconnect_tcp_ = true;
   }
 
   TcpConnPoolsContainer& container = parent_.host_tcp_conn_pool_map_[host];
@@ -1233,6 +1245,42 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
   return container.pools_[hash_key].get();
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::preconnectHosts(
+    const HostVector& hosts) {
+  const uint32_t min_connections = cluster_info_->preconnectOnHostAdd();
+  for (const HostSharedPtr& host : hosts) {
+    // Hosts that are not yet usable, e.g. because they are awaiting their first active health
+    // check, are not warmed.
+    if (host->health() == Host::Health::Unhealthy) {
+      continue;
+    }
+
+    for (const Http::Protocol protocol : preconnect_http_protocols_) {
+      ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
+      ConnPoolsContainer::ConnPools::OptPoolRef pool = container.pools_->getPool(
+          ResourcePriority::Default, {uint8_t(protocol)}, [&]() {
+            return parent_.parent_.factory_.allocateConnPool(parent_.thread_local_dispatcher_,
+                                                             host, ResourcePriority::Default,
+                                                             protocol, nullptr);
+          });
+      if (pool.has_value()) {
+        pool.value().get().preconnect(min_connections);
+      }
+    }
+
+    if (preconnect_tcp_) {
+      TcpConnPoolsContainer& container = parent_.host_tcp_conn_pool_map_[host];
+      Tcp::ConnectionPool::InstancePtr& pool =
+          container.pools_[{uint8_t(ResourcePriority::Default)}];
+      if (!pool) {
+        pool = parent_.parent_.factory_.allocateTcpConnPool(
+            parent_.thread_local_dispatcher_, host, ResourcePriority::Default, nullptr, nullptr);
+      }
+      pool->preconnect(min_connections);
+    }
+  }
+}
+
 ClusterManagerPtr ProdClusterManagerFactory::clusterManagerFromProto(
     const envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
   return ClusterManagerPtr{new ClusterManagerImpl(
@@ -6,6 +6,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -302,6 +303,10 @@ private:
       tcpConnPool(ResourcePriority priority, LoadBalancerContext* context,
                   Network::TransportSocketOptionsSharedPtr transport_socket_options);
 
+      // Warms the default priority connection pools of the given hosts for the pool types this
+      // worker has already used for the cluster. See PreconnectPolicy.preconnect_on_host_add.
+      void preconnectHosts(const HostVector& hosts);
+
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
@@ -317,6 +322,10 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+      // The default priority connection pools that have been used for this cluster, which are
+      // warmed when hosts are added. Only tracked if preconnecting on host add is configured.
+      std::set<Http::Protocol> preconnect_http_protocols_;
+      bool preconnect_tcp_{};
     };
 
     using ClusterEntryPtr = std::unique_ptr<ClusterEntry>;
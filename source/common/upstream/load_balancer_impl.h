@@ -485,7 +485,8 @@ public:
         default_subset_(subset_config.default_subset()),
         locality_weight_aware_(subset_config.locality_weight_aware()),
         scale_locality_weight_(subset_config.scale_locality_weight()),
-        panic_mode_any_(subset_config.panic_mode_any()) {
+        panic_mode_any_(subset_config.panic_mode_any()),
+        max_lazy_subsets_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(subset_config, max_lazy_subsets, 0)) {
     for (const auto& subset : subset_config.subset_selectors()) {
       if (!subset.keys().empty()) {
         subset_selectors_.emplace_back(std::make_shared<SubsetSelector>(
@@ -507,6 +508,7 @@ public:
   bool localityWeightAware() const override { return locality_weight_aware_; }
   bool scaleLocalityWeight() const override { return scale_locality_weight_; }
   bool panicModeAny() const override { return panic_mode_any_; }
+  uint32_t maxLazySubsets() const override { return max_lazy_subsets_; }
 
 private:
   const bool enabled_;
@@ -516,6 +518,7 @@ private:
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
   const bool panic_mode_any_;
+  const uint32_t max_lazy_subsets_;
 };
 
 } // namespace Upstream
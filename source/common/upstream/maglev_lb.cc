@@ -74,12 +74,14 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   }
 }
 
-HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
+HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash, uint32_t attempt) const {
   if (table_.empty()) {
     return nullptr;
   }
 
-  return table_[hash % table_size_];
+  // Each subsequent attempt moves to the next slot of the table. Since the table is populated by
+  // interleaving the hosts' permutations, adjacent slots generally belong to different hosts.
+  return table_[(hash % table_size_ + attempt) % table_size_];
 }
 
 uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
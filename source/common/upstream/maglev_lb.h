@@ -36,7 +36,7 @@ public:
               double max_normalized_weight, uint64_t table_size, MaglevLoadBalancerStats& stats);
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
-  HostConstSharedPtr chooseHost(uint64_t hash) const override;
+  HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
   // Recommended table size in section 5.3 of the paper.
   static const uint64_t DefaultTableSize = 65537;
@@ -34,7 +34,9 @@ struct RingHashLoadBalancerStats {
  * In the future it would be nice to support:
  * 1) Weighting.
  * 2) Per-zone rings and optional zone aware routing (not all applications will want this).
- * 3) Max request fallback to support hot shards (not all applications will want this).
+ *
+ * Max request fallback to support hot shards is provided by bounded load hashing, see
+ * ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer.
  */
 class RingHashLoadBalancer : public ThreadAwareLoadBalancerBase,
                              Logger::Loggable<Logger::Id::upstream> {
@@ -60,7 +62,11 @@ private:
          RingHashLoadBalancerStats& stats);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
-    HostConstSharedPtr chooseHost(uint64_t hash) const override;
+    HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
+
+    // @return the index of the first ring entry at or clockwise from the hash. The ring must not
+    //         be empty.
+    uint64_t findIndex(uint64_t hash) const;
 
     std::vector<RingEntry> ring_;
 
@@ -1,5 +1,6 @@
 #include "common/upstream/subset_lb.h"
 
+#include <algorithm>
 #include <memory>
 #include <unordered_set>
 
@@ -32,7 +33,8 @@ SubsetLoadBalancer::SubsetLoadBalancer(
       subset_selectors_(subsets.subsetSelectors()), original_priority_set_(priority_set),
       original_local_priority_set_(local_priority_set),
       locality_weight_aware_(subsets.localityWeightAware()),
-      scale_locality_weight_(subsets.scaleLocalityWeight()) {
+      scale_locality_weight_(subsets.scaleLocalityWeight()),
+      max_lazy_subsets_(subsets.maxLazySubsets()) {
   ASSERT(subsets.isEnabled());
 
   if (fallback_policy_ != envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK) {
@@ -264,7 +266,9 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   }
 
   // Route has metadata match criteria defined, see if we have a matching subset.
-  LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  LbSubsetEntryPtr entry = max_lazy_subsets_ != 0
+                               ? findOrCreateLazySubset(match_criteria->metadataMatchCriteria())
+                               : findSubset(match_criteria->metadataMatchCriteria());
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -314,6 +318,98 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
   return nullptr;
 }
 
+// Like findSubset, but in lazy mode: creates the subset described by the match criteria if it does
+// not exist yet, and evicts the least recently used subset if there are too many.
+SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findOrCreateLazySubset(
+    const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
+  LbSubsetEntryPtr entry = findSubset(match_criteria);
+  if (entry != nullptr && entry->initialized()) {
+    lazy_subsets_lru_.splice(lazy_subsets_lru_.begin(), lazy_subsets_lru_, entry->lru_it_);
+    return entry;
+  }
+
+  SubsetMetadata kvs;
+  for (const auto& match_criterion : match_criteria) {
+    kvs.emplace_back(match_criterion->name(), match_criterion->value().value());
+  }
+
+  // Only criteria naming exactly the keys of a subset selector describe a subset. The criteria are
+  // sorted by key, as are the selector keys.
+  if (!matchesSubsetSelector(kvs)) {
+    return nullptr;
+  }
+
+  ENVOY_LOG(debug, "subset lb: lazily creating load balancer for {}", describeMetadata(kvs));
+  HostPredicate predicate = [this, kvs](const Host& host) -> bool {
+    return hostMatches(kvs, host);
+  };
+  entry = findOrCreateSubset(subsets_, kvs, 0);
+  entry->lazy_kvs_ = kvs;
+  entry->priority_subset_ = std::make_shared<PrioritySubsetImpl>(
+      *this, predicate, locality_weight_aware_, scale_locality_weight_);
+  if (entry->active()) {
+    stats_.lb_subsets_active_.inc();
+    stats_.lb_subsets_created_.inc();
+  }
+
+  // Subsets without hosts are kept as well, so that requests for them do not rebuild them and so
+  // that they are populated if matching hosts are added later.
+  lazy_subsets_lru_.push_front(entry);
+  entry->lru_it_ = lazy_subsets_lru_.begin();
+
+  if (lazy_subsets_lru_.size() > max_lazy_subsets_) {
+    LbSubsetEntryPtr evicted = lazy_subsets_lru_.back();
+    lazy_subsets_lru_.pop_back();
+    if (evicted->active()) {
+      stats_.lb_subsets_active_.dec();
+      stats_.lb_subsets_removed_.inc();
+    }
+    // The entry is rebuilt on next use. Until then, it and any ancestors left without a subset or
+    // children are removed from the trie, so that a stream of distinct values does not grow it.
+    evicted->priority_subset_.reset();
+    pruneSubset(subsets_, evicted->lazy_kvs_, 0);
+  }
+
+  return entry;
+}
+
+// Finds the initialized LbSubsetEntryPtr for the given key-values (from extractSubsetMetadata)
+// without creating any entries.
+SubsetLoadBalancer::LbSubsetEntryPtr
+SubsetLoadBalancer::findInitializedSubset(const SubsetMetadata& kvs) {
+  const LbSubsetMap* subsets = &subsets_;
+  LbSubsetEntryPtr entry;
+
+  for (const auto& kv : kvs) {
+    const auto kv_it = subsets->find(kv.first);
+    if (kv_it == subsets->end()) {
+      return nullptr;
+    }
+
+    const auto vs_it = kv_it->second.find(HashedValue(kv.second));
+    if (vs_it == kv_it->second.end()) {
+      return nullptr;
+    }
+
+    entry = vs_it->second;
+    subsets = &entry->children_;
+  }
+
+  return entry != nullptr && entry->initialized() ? entry : nullptr;
+}
+
+bool SubsetLoadBalancer::matchesSubsetSelector(const SubsetMetadata& kvs) const {
+  return std::any_of(
+      subset_selectors_.begin(), subset_selectors_.end(), [&kvs](const SubsetSelectorPtr& selector) {
+        const auto& keys = selector->selector_keys_;
+        return keys.size() == kvs.size() &&
+               std::equal(keys.begin(), keys.end(), kvs.begin(),
+                          [](const std::string& key, const SubsetMetadata::value_type& kv) {
+                            return key == kv.first;
+                          });
+      });
+}
+
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                                               const HostVector& hosts_removed) {
 
@@ -344,11 +440,17 @@ void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVecto
 // unique LbSubsetEntryPtr found, it either invokes new_cb or update_cb depending on whether the
 // LbSubsetEntryPtr is already initialized (update_cb) or not (new_cb). In addition, update_cb is
 // invoked for any otherwise unmodified but active and initialized LbSubsetEntryPtr to allow host
-// health to be updated.
+// health to be updated. In lazy mode, only subsets which already exist are updated and no new
+// subsets are created.
 void SubsetLoadBalancer::processSubsets(
     const HostVector& hosts_added, const HostVector& hosts_removed,
     std::function<void(LbSubsetEntryPtr)> update_cb,
     std::function<void(LbSubsetEntryPtr, HostPredicate, const SubsetMetadata&, bool)> new_cb) {
+  const bool lazy = max_lazy_subsets_ != 0;
+  if (lazy && lazy_subsets_lru_.empty()) {
+    return;
+  }
+
   std::unordered_set<LbSubsetEntryPtr> subsets_modified;
 
   std::pair<const HostVector&, bool> steps[] = {{hosts_added, true}, {hosts_removed, false}};
@@ -363,7 +465,12 @@ void SubsetLoadBalancer::processSubsets(
         SubsetMetadata kvs = extractSubsetMetadata(keys, *host);
         if (!kvs.empty()) {
           // The host has metadata for each key, find or create its subset.
-          LbSubsetEntryPtr entry = findOrCreateSubset(subsets_, kvs, 0);
+          LbSubsetEntryPtr entry =
+              lazy ? findInitializedSubset(kvs) : findOrCreateSubset(subsets_, kvs, 0);
+          if (entry == nullptr) {
+            // Lazy mode and the subset is not in use.
+            continue;
+          }
           if (subsets_modified.find(entry) != subsets_modified.end()) {
             // We've already invoked the callback for this entry.
             continue;
@@ -383,7 +490,7 @@ void SubsetLoadBalancer::processSubsets(
     }
   }
 
-  forEachSubset(subsets_, [&](LbSubsetEntryPtr entry) {
+  const auto update_unmodified = [&](LbSubsetEntryPtr entry) {
     if (subsets_modified.find(entry) != subsets_modified.end()) {
       // Already handled due to hosts being added or removed.
       return;
@@ -392,7 +499,15 @@ void SubsetLoadBalancer::processSubsets(
     if (entry->initialized() && entry->active()) {
       update_cb(entry);
     }
-  });
+  };
+
+  if (lazy) {
+    for (const auto& entry : lazy_subsets_lru_) {
+      update_unmodified(entry);
+    }
+  } else {
+    forEachSubset(subsets_, update_unmodified);
+  }
 }
 
 // Given the addition and/or removal of hosts, update all subsets for this priority level, creating
@@ -549,6 +664,36 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
   return findOrCreateSubset(entry->children_, kvs, idx);
 }
 
+// Removes the uninitialized, childless entries along the path described by kvs, starting at idx,
+// and the maps left empty by their removal.
+void SubsetLoadBalancer::pruneSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
+                                     uint32_t idx) {
+  ASSERT(idx < kvs.size());
+
+  const auto kv_it = subsets.find(kvs[idx].first);
+  if (kv_it == subsets.end()) {
+    return;
+  }
+  ValueSubsetMap& value_subset_map = kv_it->second;
+  const auto vs_it = value_subset_map.find(HashedValue(kvs[idx].second));
+  if (vs_it == value_subset_map.end()) {
+    return;
+  }
+
+  LbSubsetEntry& entry = *vs_it->second;
+  if (idx + 1 < kvs.size()) {
+    pruneSubset(entry.children_, kvs, idx + 1);
+  }
+  if (entry.initialized() || !entry.children_.empty()) {
+    return;
+  }
+
+  value_subset_map.erase(vs_it);
+  if (value_subset_map.empty()) {
+    subsets.erase(kv_it);
+  }
+}
+
 // Invokes cb for each LbSubsetEntryPtr in subsets.
 void SubsetLoadBalancer::forEachSubset(LbSubsetMap& subsets,
                                        std::function<void(LbSubsetEntryPtr)> cb) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -144,6 +145,11 @@ private:
 
     // Only initialized if a match exists at this level.
     PrioritySubsetImplPtr priority_subset_;
+
+    // Position in lazy_subsets_lru_. Only valid for initialized entries in lazy mode.
+    std::list<LbSubsetEntryPtr>::iterator lru_it_;
+    // The key-values leading to this entry, kept in lazy mode to prune the entry once evicted.
+    SubsetMetadata lazy_kvs_;
   };
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
@@ -170,9 +176,14 @@ private:
 
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  LbSubsetEntryPtr
+  findOrCreateLazySubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  LbSubsetEntryPtr findInitializedSubset(const SubsetMetadata& kvs);
+  bool matchesSubsetSelector(const SubsetMetadata& kvs) const;
 
   LbSubsetEntryPtr findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
                                       uint32_t idx);
+  void pruneSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs, uint32_t idx);
   void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr)> cb);
 
   SubsetMetadata extractSubsetMetadata(const std::set<std::string>& subset_keys, const Host& host);
@@ -210,7 +221,13 @@ private:
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
 
+  // If non-zero, subsets are created on first use and at most this many are kept.
+  const uint32_t max_lazy_subsets_;
+  // Lazily created subsets, most recently used first.
+  std::list<LbSubsetEntryPtr> lazy_subsets_lru_;
+
   friend class SubsetLoadBalancerDescribeMetadataTester;
+  friend class SubsetLoadBalancerLazySubsetsTester;
 };
 
 } // namespace Upstream
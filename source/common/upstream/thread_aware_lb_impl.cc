@@ -1,5 +1,7 @@
 #include "common/upstream/thread_aware_lb_impl.h"
 
+#include <cmath>
+#include <limits>
 #include <memory>
 
 namespace Envoy {
@@ -109,6 +111,10 @@ void ThreadAwareLoadBalancerBase::refresh() {
                      min_normalized_weight, max_normalized_weight);
     per_priority_state->current_lb_ =
         createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+    if (hash_balance_factor_ > 0) {
+      per_priority_state->current_lb_ = std::make_shared<BoundedLoadHashingLoadBalancer>(
+          per_priority_state->current_lb_, normalized_host_weights, hash_balance_factor_, stats_);
+    }
   }
 
   {
@@ -142,7 +148,75 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   if (per_priority_state->global_panic_) {
     stats_.lb_healthy_panic_.inc();
   }
-  return per_priority_state->current_lb_->chooseHost(h);
+  return per_priority_state->current_lb_->chooseHost(h, 0);
+}
+
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::BoundedLoadHashingLoadBalancer(
+    HashingLoadBalancerSharedPtr hashing_lb,
+    const NormalizedHostWeightVector& normalized_host_weights, uint32_t hash_balance_factor,
+    ClusterStats& stats)
+    : hashing_lb_(std::move(hashing_lb)), hash_balance_factor_(hash_balance_factor),
+      stats_(stats) {
+  ASSERT(hash_balance_factor_ >= 100);
+  normalized_host_weights_.reserve(normalized_host_weights.size());
+  for (const auto& entry : normalized_host_weights) {
+    normalized_host_weights_.emplace(entry.first.get(), entry.second);
+  }
+}
+
+HostConstSharedPtr
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t hash,
+                                                                         uint32_t attempt) const {
+  // Walk through at most as many candidates as there are hosts. Both the ring and the Maglev table
+  // may yield the same host more than once, so this does not guarantee that every host is
+  // visited, but it bounds the work done per request. If every candidate is overloaded, the least
+  // overloaded one is used.
+  HostConstSharedPtr least_overloaded_host;
+  double least_overload_factor = std::numeric_limits<double>::max();
+  const uint64_t total_active = totalActiveRequests();
+  const uint32_t max_attempts = attempt + normalized_host_weights_.size();
+  for (; attempt < max_attempts; ++attempt) {
+    HostConstSharedPtr host = hashing_lb_->chooseHost(hash, attempt);
+    if (host == nullptr) {
+      return nullptr;
+    }
+
+    const auto it = normalized_host_weights_.find(host.get());
+    ASSERT(it != normalized_host_weights_.end());
+    const double overload_factor = hostOverloadFactor(*host, it->second, total_active);
+    if (overload_factor <= 1.0) {
+      return host;
+    }
+
+    stats_.lb_hash_bounded_load_overflow_.inc();
+    if (overload_factor < least_overload_factor) {
+      least_overload_factor = overload_factor;
+      least_overloaded_host = std::move(host);
+    }
+  }
+
+  return least_overloaded_host;
+}
+
+uint64_t ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::totalActiveRequests() const {
+  // Summed from the hosts' own counts rather than read from the cluster's upstream_rq_active, which
+  // also counts the requests of the hosts of other priorities and of requests not yet assigned a
+  // host.
+  uint64_t total_active = 0;
+  for (const auto& entry : normalized_host_weights_) {
+    total_active += entry.first->stats().rq_active_.value();
+  }
+  return total_active;
+}
+
+double ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::hostOverloadFactor(
+    const Host& host, double weight, uint64_t total_active) const {
+  // The request being load balanced is counted towards both the total and the host, so that a
+  // host is only chosen if it still has room for the request after accepting it. Every host is
+  // allowed at least one active request.
+  const double allowed =
+      std::max(std::ceil((total_active + 1) * weight * hash_balance_factor_ / 100.0), 1.0);
+  return (host.stats().rq_active_.value() + 1) / allowed;
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
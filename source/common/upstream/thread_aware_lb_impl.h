@@ -2,6 +2,7 @@
 
 #include "common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
@@ -22,10 +23,54 @@ public:
   class HashingLoadBalancer {
   public:
     virtual ~HashingLoadBalancer() = default;
-    virtual HostConstSharedPtr chooseHost(uint64_t hash) const PURE;
+
+    /**
+     * @param hash supplies the hash of the request.
+     * @param attempt supplies the number of candidates already rejected for this request. Attempt
+     *        0 is the host the hash maps to and each subsequent attempt walks to the next
+     *        candidate, so that a caller may skip hosts it does not want to use.
+     * @return the selected host or nullptr if there are no hosts.
+     */
+    virtual HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const PURE;
   };
   using HashingLoadBalancerSharedPtr = std::shared_ptr<HashingLoadBalancer>;
 
+  /**
+   * Wraps a hashing load balancer to implement consistent hashing with bounded loads as described
+   * in https://arxiv.org/abs/1608.01350. A host is only selected if its active request count is
+   * within hash_balance_factor / 100 of its weighted share of the active requests of the hosts.
+   * Otherwise subsequent candidates of the wrapped load balancer are tried, falling back to the
+   * least loaded candidate if all of them are at their bound. The counts are shared by all the
+   * workers and read without coordination, so the bound is only approximated.
+   */
+  class BoundedLoadHashingLoadBalancer : public HashingLoadBalancer {
+  public:
+    BoundedLoadHashingLoadBalancer(HashingLoadBalancerSharedPtr hashing_lb,
+                                   const NormalizedHostWeightVector& normalized_host_weights,
+                                   uint32_t hash_balance_factor, ClusterStats& stats);
+
+    // ThreadAwareLoadBalancerBase::HashingLoadBalancer
+    HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
+
+  private:
+    /**
+     * @return the sum of the active requests of the hosts of this load balancer.
+     */
+    uint64_t totalActiveRequests() const;
+
+    /**
+     * @return the ratio of the host's active requests to the number of requests it is allowed
+     *         given its normalized weight and the total active requests. A value above 1.0 means
+     *         that the host is overloaded.
+     */
+    double hostOverloadFactor(const Host& host, double weight, uint64_t total_active) const;
+
+    const HashingLoadBalancerSharedPtr hashing_lb_;
+    absl::flat_hash_map<const Host*, double> normalized_host_weights_;
+    const uint32_t hash_balance_factor_;
+    ClusterStats& stats_;
+  };
+
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   void initialize() override;
@@ -40,7 +85,9 @@ protected:
                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                               const envoy::api::v2::Cluster::CommonLbConfig& common_config)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
-        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+        factory_(new LoadBalancerFactoryImpl(stats, random)),
+        hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            common_config.consistent_hashing_lb_config(), hash_balance_factor, 0)) {}
 
 private:
   struct PerPriorityState {
@@ -85,6 +132,8 @@ private:
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  // Zero if load is not bounded.
+  const uint32_t hash_balance_factor_;
 };
 
 } // namespace Upstream
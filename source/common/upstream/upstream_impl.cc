@@ -539,10 +539,18 @@ ClusterStats ClusterInfoImpl::generateStats(Stats::Scope& scope) {
   return {ALL_CLUSTER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+ClusterStats ClusterInfoImpl::generateStats(Stats::LazyStatPool& pool) {
+  return {ALL_CLUSTER_STATS(POOL_COUNTER(pool), POOL_GAUGE(pool), POOL_HISTOGRAM(pool))};
+}
+
 ClusterLoadReportStats ClusterInfoImpl::generateLoadReportStats(Stats::Scope& scope) {
   return {ALL_CLUSTER_LOAD_REPORT_STATS(POOL_COUNTER(scope))};
 }
 
+ClusterLoadReportStats ClusterInfoImpl::generateLoadReportStats(Stats::LazyStatPool& pool) {
+  return {ALL_CLUSTER_LOAD_REPORT_STATS(POOL_COUNTER(pool))};
+}
+
 ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
                                  const envoy::api::v2::core::BindConfig& bind_config,
                                  Runtime::Loader& runtime,
@@ -557,12 +565,20 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       transport_socket_factory_(std::move(socket_factory)), stats_scope_(std::move(stats_scope)),
-      stats_(generateStats(*stats_scope_)),
-      load_report_stats_(generateLoadReportStats(load_report_stats_store_)),
+      lazy_stat_pool_(config.lazy_stats() ? std::make_unique<Stats::LazyStatPool>(*stats_scope_)
+                                          : nullptr),
+      stats_(lazy_stat_pool_ != nullptr ? generateStats(*lazy_stat_pool_)
+                                        : generateStats(*stats_scope_)),
+      lazy_load_report_stat_pool_(
+          config.lazy_stats() ? std::make_unique<Stats::LazyStatPool>(load_report_stats_store_)
+                              : nullptr),
+      load_report_stats_(lazy_load_report_stat_pool_ != nullptr
+                             ? generateLoadReportStats(*lazy_load_report_stat_pool_)
+                             : generateLoadReportStats(load_report_stats_store_)),
       features_(parseFeatures(config)),
       http2_settings_(Http::Utility::parseHttp2Settings(config.http2_protocol_options())),
       extension_protocol_options_(parseExtensionProtocolOptions(config, validation_visitor)),
-      resource_managers_(config, runtime, name_, *stats_scope_),
+      resource_managers_(config, runtime, name_, *stats_scope_, lazy_stat_pool_.get()),
       maintenance_mode_runtime_key_(fmt::format("upstream.maintenance_mode.{}", name_)),
       source_address_(getSourceAddress(config, bind_config)),
       lb_least_request_config_(config.least_request_lb_config()),
@@ -578,7 +594,10 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
       cluster_type_(config.has_cluster_type()
                         ? absl::make_optional<envoy::api::v2::Cluster::CustomClusterType>(
                               config.cluster_type())
-                        : absl::nullopt) {
+                        : absl::nullopt),
+      per_upstream_preconnect_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
+      preconnect_on_host_add_(config.preconnect_policy().preconnect_on_host_add()) {
   switch (config.lb_policy()) {
   case envoy::api::v2::Cluster::ROUND_ROBIN:
     lb_type_ = LoadBalancerType::RoundRobin;
@@ -880,11 +899,14 @@ ClusterImplBase::resolveProtoAddress(const envoy::api::v2::core::Address& addres
 ClusterInfoImpl::ResourceManagers::ResourceManagers(const envoy::api::v2::Cluster& config,
                                                     Runtime::Loader& runtime,
                                                     const std::string& cluster_name,
-                                                    Stats::Scope& stats_scope) {
-  managers_[enumToInt(ResourcePriority::Default)] = load(
-      config, runtime, cluster_name, stats_scope, envoy::api::v2::core::RoutingPriority::DEFAULT);
+                                                    Stats::Scope& stats_scope,
+                                                    Stats::LazyStatPool* lazy_stat_pool) {
+  managers_[enumToInt(ResourcePriority::Default)] =
+      load(config, runtime, cluster_name, stats_scope, lazy_stat_pool,
+           envoy::api::v2::core::RoutingPriority::DEFAULT);
   managers_[enumToInt(ResourcePriority::High)] =
-      load(config, runtime, cluster_name, stats_scope, envoy::api::v2::core::RoutingPriority::HIGH);
+      load(config, runtime, cluster_name, stats_scope, lazy_stat_pool,
+           envoy::api::v2::core::RoutingPriority::HIGH);
 }
 
 ClusterCircuitBreakersStats
@@ -900,10 +922,25 @@ ClusterInfoImpl::generateCircuitBreakersStats(Stats::Scope& scope, const std::st
   }
 }
 
+ClusterCircuitBreakersStats
+ClusterInfoImpl::generateCircuitBreakersStats(Stats::LazyStatPool& pool,
+                                              const std::string& stat_prefix,
+                                              bool track_remaining) {
+  std::string prefix(fmt::format("circuit_breakers.{}.", stat_prefix));
+  if (track_remaining) {
+    return {ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE_PREFIX(pool, prefix),
+                                               POOL_GAUGE_PREFIX(pool, prefix))};
+  } else {
+    return {ALL_CLUSTER_CIRCUIT_BREAKERS_STATS(POOL_GAUGE_PREFIX(pool, prefix),
+                                               NULL_POOL_GAUGE(pool))};
+  }
+}
+
 ResourceManagerImplPtr
 ClusterInfoImpl::ResourceManagers::load(const envoy::api::v2::Cluster& config,
                                         Runtime::Loader& runtime, const std::string& cluster_name,
                                         Stats::Scope& stats_scope,
+                                        Stats::LazyStatPool* lazy_stat_pool,
                                         const envoy::api::v2::core::RoutingPriority& priority) {
   uint64_t max_connections = 1024;
   uint64_t max_pending_requests = 1024;
@@ -947,7 +984,11 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::api::v2::Cluster& config,
   return std::make_unique<ResourceManagerImpl>(
       runtime, runtime_prefix, max_connections, max_pending_requests, max_requests, max_retries,
       max_connection_pools,
-      ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_name, track_remaining));
+      lazy_stat_pool != nullptr
+          ? ClusterInfoImpl::generateCircuitBreakersStats(*lazy_stat_pool, priority_name,
+                                                          track_remaining)
+          : ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_name,
+                                                          track_remaining));
 }
 
 PriorityStateManager::PriorityStateManager(ClusterImplBase& cluster,
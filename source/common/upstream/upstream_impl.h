@@ -37,6 +37,7 @@
 #include "common/init/manager_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/stats/lazy_stat_pool.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
 #include "common/upstream/resource_manager_impl.h"
@@ -512,10 +513,15 @@ public:
                   ProtobufMessage::ValidationVisitor& validation_visitor);
 
   static ClusterStats generateStats(Stats::Scope& scope);
+  static ClusterStats generateStats(Stats::LazyStatPool& pool);
   static ClusterLoadReportStats generateLoadReportStats(Stats::Scope& scope);
+  static ClusterLoadReportStats generateLoadReportStats(Stats::LazyStatPool& pool);
   static ClusterCircuitBreakersStats generateCircuitBreakersStats(Stats::Scope& scope,
                                                                   const std::string& stat_prefix,
                                                                   bool track_remaining);
+  static ClusterCircuitBreakersStats generateCircuitBreakersStats(Stats::LazyStatPool& pool,
+                                                                  const std::string& stat_prefix,
+                                                                  bool track_remaining);
 
   // Upstream::ClusterInfo
   bool addedViaApi() const override { return added_via_api_; }
@@ -573,15 +579,19 @@ public:
 
   bool drainConnectionsOnHostRemoval() const override { return drain_connections_on_host_removal_; }
   bool warmHosts() const override { return warm_hosts_; }
+  float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
+  uint32_t preconnectOnHostAdd() const override { return preconnect_on_host_add_; }
 
   absl::optional<std::string> eds_service_name() const override { return eds_service_name_; }
 
 private:
   struct ResourceManagers {
     ResourceManagers(const envoy::api::v2::Cluster& config, Runtime::Loader& runtime,
-                     const std::string& cluster_name, Stats::Scope& stats_scope);
+                     const std::string& cluster_name, Stats::Scope& stats_scope,
+                     Stats::LazyStatPool* lazy_stat_pool);
     ResourceManagerImplPtr load(const envoy::api::v2::Cluster& config, Runtime::Loader& runtime,
                                 const std::string& cluster_name, Stats::Scope& stats_scope,
+                                Stats::LazyStatPool* lazy_stat_pool,
                                 const envoy::api::v2::core::RoutingPriority& priority);
 
     using Managers = std::array<ResourceManagerImplPtr, NumResourcePriorities>;
@@ -598,8 +608,12 @@ private:
   const uint32_t per_connection_buffer_limit_bytes_;
   Network::TransportSocketFactoryPtr transport_socket_factory_;
   Stats::ScopePtr stats_scope_;
+  // Only set when the cluster is configured with lazy_stats, in which case the cluster's stats
+  // are created in stats_scope_ on first use.
+  const Stats::LazyStatPoolPtr lazy_stat_pool_;
   mutable ClusterStats stats_;
   Stats::IsolatedStoreImpl load_report_stats_store_;
+  const Stats::LazyStatPoolPtr lazy_load_report_stat_pool_;
   mutable ClusterLoadReportStats load_report_stats_;
   const uint64_t features_;
   const Http::Http2Settings http2_settings_;
@@ -621,6 +635,8 @@ private:
   const bool warm_hosts_;
   absl::optional<std::string> eds_service_name_;
   const absl::optional<envoy::api::v2::Cluster::CustomClusterType> cluster_type_;
+  const float per_upstream_preconnect_ratio_;
+  const uint32_t preconnect_on_host_add_;
 };
 
 /**
@@ -91,6 +91,12 @@ EXTENSIONS = {
     "envoy.filters.network.sni_cluster":                "//source/extensions/filters/network/sni_cluster:config",
     "envoy.filters.network.zookeeper_proxy":            "//source/extensions/filters/network/zookeeper_proxy:config",
 
+    #
+    # Private key providers
+    #
+
+    "envoy.private_key_providers.thread_pool":          "//source/extensions/private_key_providers/thread_pool:config",
+
     #
     # Resource monitors
     #
@@ -105,6 +111,7 @@ EXTENSIONS = {
     "envoy.stat_sinks.dog_statsd":                      "//source/extensions/stat_sinks/dog_statsd:config",
     "envoy.stat_sinks.hystrix":                         "//source/extensions/stat_sinks/hystrix:config",
     "envoy.stat_sinks.metrics_service":                 "//source/extensions/stat_sinks/metrics_service:config",
+    "envoy.stat_sinks.prometheus_remote_write":         "//source/extensions/stat_sinks/prometheus_remote_write:config",
     "envoy.stat_sinks.statsd":                          "//source/extensions/stat_sinks/statsd:config",
 
     #
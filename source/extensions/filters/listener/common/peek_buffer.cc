@@ -0,0 +1,43 @@
+#include "extensions/filters/listener/common/peek_buffer.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+
+namespace {
+
+thread_local uint8_t buffer[PeekBuffer::SIZE];
+thread_local int prefix_fd = -1;
+thread_local size_t prefix_offset;
+thread_local size_t prefix_length;
+
+} // namespace
+
+constexpr size_t PeekBuffer::SIZE;
+
+uint8_t* PeekBuffer::data() {
+  clearStreamPrefix();
+  return buffer;
+}
+
+void PeekBuffer::setStreamPrefix(int fd, size_t offset, size_t length) {
+  ASSERT(offset + length <= SIZE);
+  prefix_fd = fd;
+  prefix_offset = offset;
+  prefix_length = length;
+}
+
+absl::string_view PeekBuffer::streamPrefix(int fd) {
+  if (fd == -1 || fd != prefix_fd) {
+    return {};
+  }
+  return {reinterpret_cast<const char*>(buffer) + prefix_offset, prefix_length};
+}
+
+void PeekBuffer::clearStreamPrefix() { prefix_fd = -1; }
+
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
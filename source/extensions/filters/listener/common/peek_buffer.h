@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+
+/**
+ * Per-thread buffer the listener filters peek the beginning of accepted sockets into.
+ *
+ * The listener filters of a socket run one after the other on the worker which accepted it. A
+ * filter which consumes the beginning of the stream, e.g. the PROXY protocol header, usually peeked
+ * more than it consumed. It passes the remainder to the next filters for the duration of its
+ * continueFilterChain(true) call, so that they can inspect it without peeking at the socket again.
+ */
+class PeekBuffer {
+public:
+  // Fits the largest v2 PROXY protocol header, and the largest ClientHello the TLS inspector
+  // accepts.
+  static constexpr size_t SIZE = 16 + 65535;
+
+  /**
+   * @return uint8_t* the buffer of the calling thread, of SIZE bytes. The stream prefix set by
+   *         setStreamPrefix() is cleared, as the caller is about to overwrite it.
+   */
+  static uint8_t* data();
+
+  /**
+   * Records that a range of the buffer holds the first bytes currently queued on a socket.
+   * @param fd supplies the socket.
+   * @param offset supplies the offset of the bytes in the buffer.
+   * @param length supplies the number of bytes.
+   */
+  static void setStreamPrefix(int fd, size_t offset, size_t length);
+
+  /**
+   * @param fd supplies the socket.
+   * @return absl::string_view the first bytes queued on the socket if they were peeked already, or
+   *         an empty view.
+   */
+  static absl::string_view streamPrefix(int fd);
+
+  /**
+   * Forgets the stream prefix, once the filters which could use it ran.
+   */
+  static void clearStreamPrefix();
+};
+
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
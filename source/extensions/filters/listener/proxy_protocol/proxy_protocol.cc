@@ -1,7 +1,6 @@
 #include "extensions/filters/listener/proxy_protocol/proxy_protocol.h"
 
 #include <string.h>
-#include <sys/ioctl.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -48,6 +47,7 @@ void Filter::onRead() {
   try {
     onReadWorker();
   } catch (const EnvoyException& ee) {
+    PeekBuffer::clearStreamPrefix();
     config_->stats_.downstream_cx_proxy_proto_error_.inc();
     cb_->continueFilterChain(false);
   }
@@ -56,11 +56,9 @@ void Filter::onRead() {
 void Filter::onReadWorker() {
   Network::ConnectionSocket& socket = cb_->socket();
 
-  if ((!proxy_protocol_header_.has_value() && !readProxyHeader(socket.ioHandle().fd())) ||
-      (proxy_protocol_header_.has_value() && !parseExtensions(socket.ioHandle().fd()))) {
-    // We return if a) we do not yet have the header, or b) we have the header but not yet all
-    // the extension data. In both cases we'll be called again when the socket is ready to read
-    // and pick up where we left off.
+  if (!readProxyHeader(socket.ioHandle().fd())) {
+    // We return if we do not yet have the whole header, extensions included. We'll be called
+    // again when the socket is ready to read and peek at it again.
     return;
   }
 
@@ -89,9 +87,16 @@ void Filter::onReadWorker() {
     socket.setRemoteAddress(proxy_protocol_header_.value().remote_address_);
   }
 
+  if (tlvs_ != nullptr) {
+    socket.filterState().setData(ProxyProtocolTlvs::key(), std::move(tlvs_),
+                                 StreamInfo::FilterState::StateType::ReadOnly);
+  }
+
   // Release the file event so that we do not interfere with the connection read events.
   file_event_.reset();
   cb_->continueFilterChain(true);
+  // The filters which may inspect the bytes peeked past the header have run by now.
+  PeekBuffer::clearStreamPrefix();
 }
 
 size_t Filter::lenV2Address(char* buf) {
@@ -234,144 +239,83 @@ void Filter::parseV1Header(char* buf, size_t len) {
   }
 }
 
-bool Filter::parseExtensions(int fd) {
-  // If we ever implement extensions elsewhere, be sure to
-  // continue to skip and ignore those for LOCAL.
-  while (proxy_protocol_header_.value().extensions_length_) {
-    // buf_ is no longer in use so we re-use it to read/discard
-    int bytes_avail;
-    auto& os_syscalls = Api::OsSysCallsSingleton::get();
-    if (os_syscalls.ioctl(fd, FIONREAD, &bytes_avail).rc_ < 0) {
-      throw EnvoyException("failed to read proxy protocol (no bytes avail)");
+bool Filter::readProxyHeader(int fd) {
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  char* buf = reinterpret_cast<char*>(PeekBuffer::data());
+  const Api::SysCallSizeResult result = os_syscalls.recv(fd, buf, peek_len_, MSG_PEEK);
+  if (result.rc_ == -1 && result.errno_ == EAGAIN) {
+    return false;
+  }
+  if (result.rc_ < 1) {
+    throw EnvoyException("failed to read proxy protocol (no bytes read)");
+  }
+  const size_t nread = result.rc_;
+
+  size_t header_len;
+  if (buf[0] == PROXY_PROTO_V2_SIGNATURE[0]) {
+    if (memcmp(buf, PROXY_PROTO_V2_SIGNATURE,
+               std::min<size_t>(nread, PROXY_PROTO_V2_SIGNATURE_LEN))) {
+      // It is not v2, and can't be v1, so no sense hanging around: it is invalid
+      throw EnvoyException("failed to read proxy protocol (invalid v2 signature)");
     }
-    if (bytes_avail == 0) {
+    if (nread < PROXY_PROTO_V2_HEADER_LEN) {
       return false;
     }
-    bytes_avail = std::min(size_t(bytes_avail), sizeof(buf_));
-    bytes_avail = std::min(size_t(bytes_avail), proxy_protocol_header_.value().extensions_length_);
-    const Api::SysCallSizeResult recv_result = os_syscalls.recv(fd, buf_, bytes_avail, 0);
-    if (recv_result.rc_ != bytes_avail) {
-      throw EnvoyException("failed to read proxy protocol extension");
+    const int ver_cmd = buf[PROXY_PROTO_V2_SIGNATURE_LEN];
+    if (((ver_cmd & 0xf0) >> 4) != PROXY_PROTO_V2_VERSION) {
+      throw EnvoyException("Unsupported V2 proxy protocol version");
     }
-    proxy_protocol_header_.value().extensions_length_ -= recv_result.rc_;
-  }
-  return true;
-}
-
-bool Filter::readProxyHeader(int fd) {
-  while (buf_off_ < MAX_PROXY_PROTO_LEN_V2) {
-    int bytes_avail;
-    auto& os_syscalls = Api::OsSysCallsSingleton::get();
-
-    if (os_syscalls.ioctl(fd, FIONREAD, &bytes_avail).rc_ < 0) {
-      throw EnvoyException("failed to read proxy protocol (no bytes avail)");
+    const size_t addr_len = lenV2Address(buf);
+    const uint8_t upper_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 2];
+    const uint8_t lower_byte = buf[PROXY_PROTO_V2_HEADER_LEN - 1];
+    const size_t hdr_addr_len = (upper_byte << 8) + lower_byte;
+    if (hdr_addr_len < addr_len) {
+      throw EnvoyException("failed to read proxy protocol (insufficient data)");
     }
-
-    if (bytes_avail == 0) {
+    header_len = PROXY_PROTO_V2_HEADER_LEN + hdr_addr_len;
+    if (nread < header_len) {
+      // Wait for the rest of the header, and peek no more than the header from now on.
+      peek_len_ = header_len;
       return false;
     }
-
-    bytes_avail = std::min(size_t(bytes_avail), MAX_PROXY_PROTO_LEN_V2 - buf_off_);
-
-    const Api::SysCallSizeResult result =
-        os_syscalls.recv(fd, buf_ + buf_off_, bytes_avail, MSG_PEEK);
-    ssize_t nread = result.rc_;
-
-    if (nread < 1) {
-      throw EnvoyException("failed to read proxy protocol (no bytes read)");
+    parseV2Header(buf);
+
+    // If we ever implement extensions elsewhere, be sure to continue to skip and ignore those for
+    // LOCAL. They end the header, and are copied straight from the peeked bytes.
+    const WireHeader& header = proxy_protocol_header_.value();
+    if (!header.local_command_ && header.extensions_length_ > 0) {
+      tlvs_ = std::make_unique<ProxyProtocolTlvs>(absl::string_view(
+          buf + header_len - header.extensions_length_, header.extensions_length_));
     }
-
-    if (buf_off_ + nread >= PROXY_PROTO_V2_HEADER_LEN) {
-      const char* sig = PROXY_PROTO_V2_SIGNATURE;
-      if (!memcmp(buf_, sig, PROXY_PROTO_V2_SIGNATURE_LEN)) {
-        header_version_ = V2;
-      } else if (memcmp(buf_, PROXY_PROTO_V1_SIGNATURE, PROXY_PROTO_V1_SIGNATURE_LEN)) {
-        // It is not v2, and can't be v1, so no sense hanging around: it is invalid
-        throw EnvoyException("failed to read proxy protocol (exceed max v1 header len)");
-      }
+  } else {
+    if (memcmp(buf, PROXY_PROTO_V1_SIGNATURE,
+               std::min<size_t>(nread, PROXY_PROTO_V1_SIGNATURE_LEN))) {
+      throw EnvoyException("failed to read proxy protocol");
     }
-
-    if (header_version_ == V2) {
-      const int ver_cmd = buf_[PROXY_PROTO_V2_SIGNATURE_LEN];
-      if (((ver_cmd & 0xf0) >> 4) != PROXY_PROTO_V2_VERSION) {
-        throw EnvoyException("Unsupported V2 proxy protocol version");
-      }
-      if (buf_off_ < PROXY_PROTO_V2_HEADER_LEN) {
-        ssize_t exp = PROXY_PROTO_V2_HEADER_LEN - buf_off_;
-        const Api::SysCallSizeResult read_result = os_syscalls.recv(fd, buf_ + buf_off_, exp, 0);
-        if (read_result.rc_ != exp) {
-          throw EnvoyException("failed to read proxy protocol (remote closed)");
-        }
-        buf_off_ += read_result.rc_;
-        nread -= read_result.rc_;
-      }
-      ssize_t addr_len = lenV2Address(buf_);
-      uint8_t upper_byte = buf_[PROXY_PROTO_V2_HEADER_LEN - 2];
-      uint8_t lower_byte = buf_[PROXY_PROTO_V2_HEADER_LEN - 1];
-      ssize_t hdr_addr_len = (upper_byte << 8) + lower_byte;
-      if (hdr_addr_len < addr_len) {
-        throw EnvoyException("failed to read proxy protocol (insufficient data)");
-      }
-      if (ssize_t(buf_off_) + nread >= PROXY_PROTO_V2_HEADER_LEN + addr_len) {
-        ssize_t missing = (PROXY_PROTO_V2_HEADER_LEN + addr_len) - buf_off_;
-        const Api::SysCallSizeResult read_result =
-            os_syscalls.recv(fd, buf_ + buf_off_, missing, 0);
-        if (read_result.rc_ != missing) {
-          throw EnvoyException("failed to read proxy protocol (remote closed)");
-        }
-        buf_off_ += read_result.rc_;
-        parseV2Header(buf_);
-        // The TLV remain, they are read/discard in parseExtensions() which is called from the
-        // parent (if needed).
-        return true;
-      } else {
-        const Api::SysCallSizeResult result = os_syscalls.recv(fd, buf_ + buf_off_, nread, 0);
-        nread = result.rc_;
-        if (nread < 0) {
-          throw EnvoyException("failed to read proxy protocol (remote closed)");
-        }
-        buf_off_ += nread;
-      }
-    } else {
-      // continue searching buf_ from where we left off
-      for (; search_index_ < buf_off_ + nread; search_index_++) {
-        if (buf_[search_index_] == '\n' && buf_[search_index_ - 1] == '\r') {
-          if (search_index_ == 1) {
-            // This could be the binary protocol. It cannot be the ascii protocol
-            header_version_ = InProgress;
-          } else {
-            header_version_ = V1;
-            search_index_++;
-          }
-          break;
-        }
-      }
-
-      // If we bailed on the first char, we might be v2, but are for sure not v1. Thus we
-      // can read up to min(PROXY_PROTO_V2_HEADER_LEN, bytes_avail). If we bailed after first
-      // char, but before we hit \r\n, read up to search_index_. We're asking only for
-      // bytes we've already seen so there should be no block or fail
-      size_t ntoread;
-      if (header_version_ == InProgress) {
-        ntoread = bytes_avail;
-      } else {
-        ntoread = search_index_ - buf_off_;
-      }
-
-      const Api::SysCallSizeResult result = os_syscalls.recv(fd, buf_ + buf_off_, ntoread, 0);
-      nread = result.rc_;
-      ASSERT(size_t(nread) == ntoread);
-
-      buf_off_ += nread;
-
-      if (header_version_ == V1) {
-        parseV1Header(buf_, buf_off_);
-        return true;
+    const size_t end =
+        absl::string_view(buf, nread).substr(0, MAX_PROXY_PROTO_LEN_V1).find("\r\n");
+    if (end == absl::string_view::npos) {
+      if (nread >= MAX_PROXY_PROTO_LEN_V1) {
+        throw EnvoyException("failed to read proxy protocol (exceed max v1 header len)");
       }
+      // Wait for the rest of the line, and peek no more than the longest line from now on.
+      peek_len_ = MAX_PROXY_PROTO_LEN_V1;
+      return false;
     }
+    header_len = end + 2;
+    parseV1Header(buf, header_len);
   }
 
-  throw EnvoyException("failed to read proxy protocol (exceed max v2 header len)");
+  // The whole header was peeked, so this read removes exactly the header from the socket. It reads
+  // the same bytes again, which leaves the buffer as it was.
+  const Api::SysCallSizeResult read_result = os_syscalls.recv(fd, buf, header_len, 0);
+  if (read_result.rc_ != static_cast<ssize_t>(header_len)) {
+    throw EnvoyException("failed to read proxy protocol (remote closed)");
+  }
+  if (nread > header_len) {
+    PeekBuffer::setStreamPrefix(fd, header_len, nread - header_len);
+  }
+  return true;
 }
 
 } // namespace ProxyProtocol
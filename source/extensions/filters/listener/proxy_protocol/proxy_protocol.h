@@ -7,7 +7,9 @@
 
 #include "common/common/logger.h"
 
-#include "proxy_protocol_header.h"
+#include "extensions/filters/listener/common/peek_buffer.h"
+#include "extensions/filters/listener/proxy_protocol/proxy_protocol_header.h"
+#include "extensions/filters/listener/proxy_protocol/proxy_protocol_tlvs.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -41,8 +43,6 @@ public:
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
 
-enum ProxyProtocolVersion { Unknown = -1, InProgress = -2, V1 = 1, V2 = 2 };
-
 /**
  * Implementation the PROXY Protocol listener filter
  * (https://github.com/haproxy/haproxy/blob/master/doc/proxy-protocol.txt)
@@ -51,7 +51,11 @@ enum ProxyProtocolVersion { Unknown = -1, InProgress = -2, V1 = 1, V2 = 2 };
  * and Proxy Protocol v2 (TCP/UDP, v4/v6).
  *
  * Non INET (AF_UNIX) address family in v2 is not supported, will throw an error.
- * Extensions (TLV) in v2 are skipped over.
+ * Extensions (TLV) in v2 are stored in the filter state of the socket as ProxyProtocolTlvs, and
+ * skipped over for LOCAL commands.
+ *
+ * The header is peeked whole into the per-thread PeekBuffer and then removed from the socket with a
+ * single read. The bytes peeked past the header are handed to the next listener filters.
  */
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
@@ -61,8 +65,6 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  static const size_t MAX_PROXY_PROTO_LEN_V2 =
-      PROXY_PROTO_V2_HEADER_LEN + PROXY_PROTO_V2_ADDR_LEN_UNIX;
   static const size_t MAX_PROXY_PROTO_LEN_V1 = 108;
 
   void onRead();
@@ -76,11 +78,6 @@ private:
    */
   bool readProxyHeader(int fd);
 
-  /**
-   * Parse (and discard unknown) header extensions (until hdr.extensions_length == 0)
-   */
-  bool parseExtensions(int fd);
-
   /**
    * Given a char * & len, parse the header as per spec
    */
@@ -91,20 +88,15 @@ private:
   Network::ListenerFilterCallbacks* cb_{};
   Event::FileEventPtr file_event_;
 
-  // The offset in buf_ that has been fully read
-  size_t buf_off_{};
-
-  // The index in buf_ where the search for '\r\n' should continue from
-  size_t search_index_{1};
-
-  ProxyProtocolVersion header_version_{Unknown};
-
-  // Stores the portion of the first line that has been read so far.
-  char buf_[MAX_PROXY_PROTO_LEN_V2];
+  // The number of bytes to peek. Until the header is known to be incomplete, this is the whole
+  // buffer, so that the next filters are given the beginning of the stream along with the header.
+  // Afterwards it is the length of the v2 header, or the maximal length of the v1 header.
+  size_t peek_len_{PeekBuffer::SIZE};
 
   ConfigSharedPtr config_;
 
   absl::optional<WireHeader> proxy_protocol_header_;
+  std::unique_ptr<ProxyProtocolTlvs> tlvs_;
 };
 
 } // namespace ProxyProtocol
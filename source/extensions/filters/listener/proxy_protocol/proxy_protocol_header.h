@@ -51,6 +51,17 @@ constexpr uint32_t PROXY_PROTO_V2_ADDR_LEN_UNIX = 216;
 constexpr uint8_t PROXY_PROTO_V2_TRANSPORT_STREAM = 0x1;
 constexpr uint8_t PROXY_PROTO_V2_TRANSPORT_DGRAM = 0x2;
 
+// Each extension is a 1 byte type, a 2 bytes length in network byte order and the value.
+constexpr uint32_t PROXY_PROTO_V2_TLV_HEADER_LEN = 3;
+
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_ALPN = 0x01;
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_AUTHORITY = 0x02;
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_CRC32C = 0x03;
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_NOOP = 0x04;
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_UNIQUE_ID = 0x05;
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_SSL = 0x20;
+constexpr uint8_t PROXY_PROTO_V2_TLV_TYPE_NETNS = 0x30;
+
 } // namespace ProxyProtocol
 } // namespace ListenerFilters
 } // namespace Extensions
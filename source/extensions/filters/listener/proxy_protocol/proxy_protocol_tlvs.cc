@@ -0,0 +1,49 @@
+#include "extensions/filters/listener/proxy_protocol/proxy_protocol_tlvs.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/macros.h"
+
+#include "extensions/filters/listener/proxy_protocol/proxy_protocol_header.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace ProxyProtocol {
+
+ProxyProtocolTlvs::ProxyProtocolTlvs(absl::string_view extensions)
+    : extensions_(extensions.data(), extensions.size()) {
+  const uint8_t* buf = reinterpret_cast<const uint8_t*>(extensions_.data());
+  size_t offset = 0;
+  while (offset < extensions_.size()) {
+    if (extensions_.size() - offset < PROXY_PROTO_V2_TLV_HEADER_LEN) {
+      throw EnvoyException("failed to read proxy protocol extension (truncated header)");
+    }
+    const uint8_t type = buf[offset];
+    const size_t length = (buf[offset + 1] << 8) + buf[offset + 2];
+    offset += PROXY_PROTO_V2_TLV_HEADER_LEN;
+    if (extensions_.size() - offset < length) {
+      throw EnvoyException("failed to read proxy protocol extension (truncated value)");
+    }
+    tlvs_.push_back({type, absl::string_view(extensions_).substr(offset, length)});
+    offset += length;
+  }
+}
+
+absl::optional<absl::string_view> ProxyProtocolTlvs::value(uint8_t type) const {
+  for (const Tlv& tlv : tlvs_) {
+    if (tlv.type_ == type) {
+      return tlv.value_;
+    }
+  }
+  return absl::nullopt;
+}
+
+const std::string& ProxyProtocolTlvs::key() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "envoy.filters.listener.proxy_protocol.tlvs");
+}
+
+} // namespace ProxyProtocol
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/stream_info/filter_state.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace ProxyProtocol {
+
+/**
+ * The type-length-value extensions of a v2 PROXY protocol header, e.g. the ALPN or the authority
+ * the client used to reach the proxy. The filter stores them in the filter state of the connection
+ * under key().
+ */
+class ProxyProtocolTlvs : public StreamInfo::FilterState::Object {
+public:
+  struct Tlv {
+    uint8_t type_;
+    // Points into the copy of the extensions owned by this object.
+    absl::string_view value_;
+  };
+
+  /**
+   * @param extensions supplies the extensions of the header, which are copied once.
+   * @throw EnvoyException if the extensions aren't a sequence of complete TLVs.
+   */
+  explicit ProxyProtocolTlvs(absl::string_view extensions);
+  ProxyProtocolTlvs(const ProxyProtocolTlvs&) = delete;
+  ProxyProtocolTlvs& operator=(const ProxyProtocolTlvs&) = delete;
+
+  /**
+   * @return the TLVs, in the order of the header.
+   */
+  const std::vector<Tlv>& tlvs() const { return tlvs_; }
+
+  /**
+   * @param type supplies a TLV type, see PROXY_PROTO_V2_TLV_TYPE_*.
+   * @return the value of the first TLV of the type, if any.
+   */
+  absl::optional<absl::string_view> value(uint8_t type) const;
+
+  static const std::string& key();
+
+private:
+  const std::string extensions_;
+  std::vector<Tlv> tlvs_;
+};
+
+} // namespace ProxyProtocol
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -59,11 +60,10 @@ Config::Config(Stats::Scope& scope, uint32_t max_client_hello_size)
 
 bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_ctx_.get())}; }
 
-thread_local uint8_t Filter::buf_[Config::TLS_MAX_CLIENT_HELLO];
+static_assert(PeekBuffer::SIZE >= Config::TLS_MAX_CLIENT_HELLO,
+              "The peek buffer must fit the largest ClientHello");
 
 Filter::Filter(const ConfigSharedPtr config) : config_(config), ssl_(config_->newSsl()) {
-  RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
-
   SSL_set_app_data(ssl_.get(), this);
   SSL_set_accept_state(ssl_.get());
 }
@@ -72,6 +72,25 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
   ENVOY_LOG(debug, "tls inspector: new connection accepted");
   Network::ConnectionSocket& socket = cb.socket();
   ASSERT(file_event_ == nullptr);
+  cb_ = &cb;
+
+  // A previous listener filter, e.g. the PROXY protocol one, may have peeked the beginning of the
+  // stream already. If it holds the whole ClientHello, the socket isn't peeked at all.
+  const absl::string_view prefix = PeekBuffer::streamPrefix(socket.ioHandle().fd());
+  if (!prefix.empty()) {
+    read_ = std::min<uint64_t>(prefix.size(), config_->maxClientHelloSize());
+    switch (parseClientHello(prefix.data(), read_)) {
+    case ParseState::Done:
+      return Network::FilterStatus::Continue;
+    case ParseState::Error:
+      // The filter chain can't be failed from onAccept(). The read event below is signalled right
+      // away, since the socket is readable, and fails it.
+      stream_prefix_error_ = true;
+      break;
+    case ParseState::Continue:
+      break;
+    }
+  }
 
   file_event_ = cb.dispatcher().createFileEvent(
       socket.ioHandle().fd(),
@@ -87,7 +106,6 @@ Network::FilterStatus Filter::onAccept(Network::ListenerFilterCallbacks& cb) {
       },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Closed);
 
-  cb_ = &cb;
   return Network::FilterStatus::StopIteration;
 }
 
@@ -135,8 +153,14 @@ void Filter::onRead() {
   //
   // TODO(ggreenway): write an integration test to ensure the events work as expected on all
   // platforms.
+  if (stream_prefix_error_) {
+    done(false);
+    return;
+  }
+
   auto& os_syscalls = Api::OsSysCallsSingleton::get();
-  const Api::SysCallSizeResult result = os_syscalls.recv(cb_->socket().ioHandle().fd(), buf_,
+  uint8_t* buf = PeekBuffer::data();
+  const Api::SysCallSizeResult result = os_syscalls.recv(cb_->socket().ioHandle().fd(), buf,
                                                          config_->maxClientHelloSize(), MSG_PEEK);
   ENVOY_LOG(trace, "tls inspector: recv: {}", result.rc_);
 
@@ -151,10 +175,19 @@ void Filter::onRead() {
   // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so
   // skip over what we've already processed.
   if (static_cast<uint64_t>(result.rc_) > read_) {
-    const uint8_t* data = buf_ + read_;
+    const uint8_t* data = buf + read_;
     const size_t len = result.rc_ - read_;
     read_ = result.rc_;
-    parseClientHello(data, len);
+    switch (parseClientHello(data, len)) {
+    case ParseState::Done:
+      done(true);
+      break;
+    case ParseState::Error:
+      done(false);
+      break;
+    case ParseState::Continue:
+      break;
+    }
   }
 }
 
@@ -164,7 +197,7 @@ void Filter::done(bool success) {
   cb_->continueFilterChain(success);
 }
 
-void Filter::parseClientHello(const void* data, size_t len) {
+ParseState Filter::parseClientHello(const void* data, size_t len) {
   // Ownership is passed to ssl_ in SSL_set_bio()
   bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(data, len));
 
@@ -185,9 +218,9 @@ void Filter::parseClientHello(const void* data, size_t len) {
       // We've hit the specified size limit. This is an unreasonably large ClientHello;
       // indicate failure.
       config_->stats().client_hello_too_large_.inc();
-      done(false);
+      return ParseState::Error;
     }
-    break;
+    return ParseState::Continue;
   case SSL_ERROR_SSL:
     if (clienthello_success_) {
       config_->stats().tls_found_.inc();
@@ -200,11 +233,9 @@ void Filter::parseClientHello(const void* data, size_t len) {
     } else {
       config_->stats().tls_not_found_.inc();
     }
-    done(true);
-    break;
+    return ParseState::Done;
   default:
-    done(false);
-    break;
+    return ParseState::Error;
   }
 }
 
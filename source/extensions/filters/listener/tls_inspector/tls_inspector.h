@@ -8,6 +8,8 @@
 
 #include "common/common/logger.h"
 
+#include "extensions/filters/listener/common/peek_buffer.h"
+
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -57,8 +59,18 @@ private:
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
 
+enum class ParseState {
+  // The ClientHello was parsed, or the stream isn't TLS.
+  Done,
+  // More data is needed.
+  Continue,
+  // The stream can't be inspected and the connection must be closed.
+  Error
+};
+
 /**
- * TLS inspector listener filter.
+ * TLS inspector listener filter. The ClientHello is peeked into the per-thread PeekBuffer; when a
+ * previous listener filter already peeked the beginning of the stream, it is inspected first.
  */
 class Filter : public Network::ListenerFilter, Logger::Loggable<Logger::Id::filter> {
 public:
@@ -68,7 +80,7 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  void parseClientHello(const void* data, size_t len);
+  ParseState parseClientHello(const void* data, size_t len);
   void onRead();
   void done(bool success);
   void onALPN(const unsigned char* data, unsigned int len);
@@ -82,8 +94,8 @@ private:
   uint64_t read_{0};
   bool alpn_found_{false};
   bool clienthello_success_{false};
-
-  static thread_local uint8_t buf_[Config::TLS_MAX_CLIENT_HELLO];
+  // Set when the bytes peeked by a previous filter were enough to fail the inspection.
+  bool stream_prefix_error_{false};
 
   // Allows callbacks on the SSL_CTX to set fields in this class.
   friend class Config;
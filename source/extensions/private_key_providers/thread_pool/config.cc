@@ -0,0 +1,44 @@
+#include "extensions/private_key_providers/thread_pool/config.h"
+
+#include "envoy/config/private_key_provider/thread_pool/v2alpha/thread_pool.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+#include "extensions/private_key_providers/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyProviders {
+namespace ThreadPool {
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+ThreadPoolPrivateKeyMethodProviderFactory::createPrivateKeyMethodProviderInstance(
+    const Protobuf::Message& config, Api::Api& api, Singleton::Manager& singleton_manager) {
+  return std::make_shared<ThreadPoolPrivateKeyMethodProvider>(
+      MessageUtil::downcastAndValidate<
+          const envoy::config::private_key_provider::thread_pool::v2alpha::
+              ThreadPoolPrivateKeyProvider&>(config),
+      api, singleton_manager);
+}
+
+ProtobufTypes::MessagePtr ThreadPoolPrivateKeyMethodProviderFactory::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::config::private_key_provider::thread_pool::v2alpha::ThreadPoolPrivateKeyProvider>();
+}
+
+std::string ThreadPoolPrivateKeyMethodProviderFactory::name() {
+  return PrivateKeyProviderNames::get().ThreadPool;
+}
+
+/**
+ * Static registration for the thread pool private key method provider. @see RegisterFactory.
+ */
+REGISTER_FACTORY(ThreadPoolPrivateKeyMethodProviderFactory,
+                 Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace ThreadPool
+} // namespace PrivateKeyProviders
+} // namespace Extensions
+} // namespace Envoy
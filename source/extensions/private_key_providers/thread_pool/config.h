@@ -0,0 +1,27 @@
+#pragma once
+
+#include "envoy/ssl/private_key_method_provider_config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyProviders {
+namespace ThreadPool {
+
+/**
+ * Config registration for the thread pool private key method provider.
+ */
+class ThreadPoolPrivateKeyMethodProviderFactory
+    : public Ssl::PrivateKeyMethodProviderInstanceFactory {
+public:
+  // Ssl::PrivateKeyMethodProviderInstanceFactory
+  Ssl::PrivateKeyMethodProviderSharedPtr
+  createPrivateKeyMethodProviderInstance(const Protobuf::Message& config, Api::Api& api,
+                                         Singleton::Manager& singleton_manager) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+  std::string name() override;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyProviders
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,285 @@
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
+
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyProviders {
+namespace ThreadPool {
+
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(thread_pool_private_key_provider_worker_pool);
+
+WorkerPool::WorkerPool(Thread::ThreadFactory& thread_factory) : thread_factory_(thread_factory) {}
+
+std::shared_ptr<WorkerPool> WorkerPool::getSingleton(Singleton::Manager& singleton_manager,
+                                                     Thread::ThreadFactory& thread_factory) {
+  return singleton_manager.getTyped<WorkerPool>(
+      SINGLETON_MANAGER_REGISTERED_NAME(thread_pool_private_key_provider_worker_pool),
+      [&thread_factory] { return std::make_shared<WorkerPool>(thread_factory); });
+}
+
+void WorkerPool::ensureThreads(uint32_t num_threads) {
+  while (threads_.size() < num_threads) {
+    threads_.emplace_back(thread_factory_.createThread([this]() { workerLoop(); }));
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    Thread::LockGuard guard(lock_);
+    shutdown_ = true;
+    queue_.clear();
+  }
+  cond_.notifyAll();
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void WorkerPool::post(std::function<void()> work) {
+  {
+    Thread::LockGuard guard(lock_);
+    queue_.push_back(std::move(work));
+  }
+  cond_.notifyOne();
+}
+
+void WorkerPool::workerLoop() {
+  while (true) {
+    std::function<void()> work;
+    {
+      Thread::LockGuard guard(lock_);
+      while (!shutdown_ && queue_.empty()) {
+        cond_.wait(lock_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      work = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    work();
+  }
+}
+
+PrivateKeyConnection::~PrivateKeyConnection() {
+  if (pending_ != nullptr) {
+    Thread::LockGuard guard(pending_->lock_);
+    pending_->cancelled_ = true;
+  }
+}
+
+const SSL_PRIVATE_KEY_METHOD ThreadPoolPrivateKeyMethodProvider::method_ = {
+    ThreadPoolPrivateKeyMethodProvider::sign,
+    ThreadPoolPrivateKeyMethodProvider::decrypt,
+    ThreadPoolPrivateKeyMethodProvider::complete,
+};
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::config::private_key_provider::thread_pool::v2alpha::ThreadPoolPrivateKeyProvider&
+        config,
+    Api::Api& api, Singleton::Manager& singleton_manager)
+    : pool_(WorkerPool::getSingleton(singleton_manager, api.threadFactory())) {
+  // The pool is shared by all providers, so it is sized by the largest configured value.
+  pool_->ensureThreads(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, threads, std::max(1U, std::thread::hardware_concurrency())));
+  const std::string private_key = Config::DataSource::read(config.private_key(), false, api);
+  const std::string password = Config::DataSource::read(config.password(), true, api);
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  pkey_.reset(PEM_read_bio_PrivateKey(
+      bio.get(), nullptr, nullptr,
+      !password.empty() ? const_cast<char*>(password.c_str()) : nullptr));
+  if (pkey_ == nullptr) {
+    throw EnvoyException(fmt::format(
+        "Failed to load private key from {}",
+        Config::DataSource::getPath(config.private_key()).value_or("<inline>")));
+  }
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, freeConnection);
+    RELEASE_ASSERT(index >= 0, "");
+    return index;
+  }());
+}
+
+void ThreadPoolPrivateKeyMethodProvider::freeConnection(void*, void* ptr, CRYPTO_EX_DATA*, int,
+                                                        long, void*) {
+  delete static_cast<PrivateKeyConnection*>(ptr);
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  auto* connection = static_cast<PrivateKeyConnection*>(SSL_get_ex_data(ssl, connectionIndex()));
+  if (connection == nullptr) {
+    connection = new PrivateKeyConnection(cb, dispatcher);
+    SSL_set_ex_data(ssl, connectionIndex(), connection);
+  }
+  ASSERT(&connection->callbacks_ == &cb);
+  connection->providers_.push_back(this);
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  auto* connection = static_cast<PrivateKeyConnection*>(SSL_get_ex_data(ssl, connectionIndex()));
+  if (connection == nullptr) {
+    return;
+  }
+  auto& providers = connection->providers_;
+  providers.erase(std::remove(providers.begin(), providers.end(), this), providers.end());
+  if (providers.empty()) {
+    SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+    delete connection;
+  }
+}
+
+ThreadPoolPrivateKeyMethodProvider*
+ThreadPoolPrivateKeyMethodProvider::provider(SSL* ssl, PrivateKeyConnection& connection) {
+  if (connection.providers_.size() == 1) {
+    return connection.providers_[0];
+  }
+  // Several certificates use this provider type; pick the key matching the certificate selected
+  // for this handshake.
+  X509* cert = SSL_get_certificate(ssl);
+  if (cert == nullptr) {
+    return nullptr;
+  }
+  bssl::UniquePtr<EVP_PKEY> public_key(X509_get_pubkey(cert));
+  for (ThreadPoolPrivateKeyMethodProvider* provider : connection.providers_) {
+    if (EVP_PKEY_cmp(public_key.get(), provider->pkey_.get()) == 1) {
+      return provider;
+    }
+  }
+  return nullptr;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::start(SSL* ssl, Operation operation) {
+  auto* connection = static_cast<PrivateKeyConnection*>(SSL_get_ex_data(ssl, connectionIndex()));
+  if (connection == nullptr || connection->pending_ != nullptr) {
+    return ssl_private_key_failure;
+  }
+  ThreadPoolPrivateKeyMethodProvider* self = provider(ssl, *connection);
+  if (self == nullptr) {
+    return ssl_private_key_failure;
+  }
+
+  auto pending =
+      std::make_shared<PrivateKeyOperation>(connection->callbacks_, connection->dispatcher_);
+  connection->pending_ = pending;
+  EVP_PKEY* pkey = self->pkey_.get();
+  self->pool_->post([pending, pkey, operation]() {
+    pending->succeeded_ = operation(pkey, pending->output_);
+    pending->done_ = true;
+
+    // The connection cancels the operation on its own thread, so holding the lock across the post
+    // guarantees that the dispatcher is still alive.
+    Thread::LockGuard guard(pending->lock_);
+    if (pending->cancelled_) {
+      return;
+    }
+    pending->dispatcher_.post([pending]() {
+      {
+        Thread::LockGuard guard(pending->lock_);
+        if (pending->cancelled_) {
+          return;
+        }
+      }
+      pending->callbacks_.onPrivateKeyMethodComplete();
+    });
+  });
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t
+ThreadPoolPrivateKeyMethodProvider::sign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                         uint16_t signature_algorithm, const uint8_t* in,
+                                         size_t in_len) {
+  std::vector<uint8_t> input(in, in + in_len);
+  return start(ssl, [signature_algorithm, input](EVP_PKEY* pkey, std::vector<uint8_t>& output) {
+    if (SSL_get_signature_algorithm_key_type(signature_algorithm) != EVP_PKEY_id(pkey)) {
+      return false;
+    }
+    const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm);
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pctx;
+    if (!EVP_DigestSignInit(ctx.get(), &pctx, md, nullptr, pkey)) {
+      return false;
+    }
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+        (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+         !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1 /* salt length matches digest */))) {
+      return false;
+    }
+    size_t len = EVP_PKEY_size(pkey);
+    output.resize(len);
+    if (!EVP_DigestSign(ctx.get(), output.data(), &len, input.data(), input.size())) {
+      return false;
+    }
+    output.resize(len);
+    return true;
+  });
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::decrypt(SSL* ssl, uint8_t*, size_t*,
+                                                                     size_t, const uint8_t* in,
+                                                                     size_t in_len) {
+  std::vector<uint8_t> input(in, in + in_len);
+  return start(ssl, [input](EVP_PKEY* pkey, std::vector<uint8_t>& output) {
+    RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+    if (rsa == nullptr) {
+      return false;
+    }
+    size_t len;
+    output.resize(RSA_size(rsa));
+    if (!RSA_decrypt(rsa, &len, output.data(), output.size(), input.data(), input.size(),
+                     RSA_NO_PADDING)) {
+      return false;
+    }
+    output.resize(len);
+    return true;
+  });
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::complete(SSL* ssl, uint8_t* out,
+                                                                      size_t* out_len,
+                                                                      size_t max_out) {
+  auto* connection = static_cast<PrivateKeyConnection*>(SSL_get_ex_data(ssl, connectionIndex()));
+  if (connection == nullptr || connection->pending_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!connection->pending_->done_) {
+    return ssl_private_key_retry;
+  }
+
+  PrivateKeyOperationSharedPtr pending = std::move(connection->pending_);
+  if (!pending->succeeded_ || pending->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  memcpy(out, pending->output_.data(), pending->output_.size());
+  *out_len = pending->output_.size();
+  return ssl_private_key_success;
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyProviders
+} // namespace Extensions
+} // namespace Envoy
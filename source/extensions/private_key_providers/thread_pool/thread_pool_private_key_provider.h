@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/config/private_key_provider/thread_pool/v2alpha/thread_pool.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/ssl/private_key_method_provider.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyProviders {
+namespace ThreadPool {
+
+/**
+ * A set of threads running closures in FIFO order, shared by all thread pool providers through
+ * the singleton manager. Closures that have not started by the time the pool is destroyed are
+ * dropped.
+ */
+class WorkerPool : public Singleton::Instance {
+public:
+  explicit WorkerPool(Thread::ThreadFactory& thread_factory);
+  ~WorkerPool() override;
+
+  static std::shared_ptr<WorkerPool> getSingleton(Singleton::Manager& singleton_manager,
+                                                  Thread::ThreadFactory& thread_factory);
+
+  /**
+   * Grows the pool to at least num_threads threads. Only called on the main thread.
+   */
+  void ensureThreads(uint32_t num_threads);
+  uint32_t numThreads() const { return threads_.size(); }
+
+  void post(std::function<void()> work);
+
+private:
+  void workerLoop();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar cond_;
+  std::list<std::function<void()>> queue_ GUARDED_BY(lock_);
+  bool shutdown_ GUARDED_BY(lock_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+/**
+ * A single in-flight private key operation. It is shared between the connection, which may
+ * cancel it, and the worker thread, which fills in the result.
+ */
+struct PrivateKeyOperation {
+  PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& callbacks, Event::Dispatcher& dispatcher)
+      : callbacks_(callbacks), dispatcher_(dispatcher) {}
+
+  Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+  Event::Dispatcher& dispatcher_;
+  // Written by the worker thread before the completion is posted and only read on the
+  // dispatcher thread after the completion has run.
+  std::vector<uint8_t> output_;
+  bool succeeded_{};
+  std::atomic<bool> done_{};
+  // Guards posting to the dispatcher against the connection going away.
+  Thread::MutexBasicLockable lock_;
+  bool cancelled_ GUARDED_BY(lock_){};
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+class ThreadPoolPrivateKeyMethodProvider;
+
+/**
+ * Per-connection state, owned by the SSL object through its ex_data.
+ */
+struct PrivateKeyConnection {
+  PrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& callbacks,
+                       Event::Dispatcher& dispatcher)
+      : callbacks_(callbacks), dispatcher_(dispatcher) {}
+  ~PrivateKeyConnection();
+
+  Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+  Event::Dispatcher& dispatcher_;
+  // All thread pool providers registered for the connection. There is more than one only when
+  // several certificates of the same context use this provider type.
+  std::vector<ThreadPoolPrivateKeyMethodProvider*> providers_;
+  PrivateKeyOperationSharedPtr pending_;
+};
+
+/**
+ * A private key method provider which performs the signing and decryption operations of the
+ * handshake on a local thread pool, so that the expensive RSA/ECDSA computations do not block the
+ * worker's event loop. The handshake is resumed by posting the completion to the connection's
+ * dispatcher.
+ */
+class ThreadPoolPrivateKeyMethodProvider : public Ssl::PrivateKeyMethodProvider {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::config::private_key_provider::thread_pool::v2alpha::ThreadPoolPrivateKeyProvider&
+          config,
+      Api::Api& api, Singleton::Manager& singleton_manager);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  const SSL_PRIVATE_KEY_METHOD* getBoringSslPrivateKeyMethod() override { return &method_; }
+
+  const WorkerPool& poolForTest() const { return *pool_; }
+
+private:
+  using Operation = std::function<bool(EVP_PKEY*, std::vector<uint8_t>&)>;
+
+  static int connectionIndex();
+  static void freeConnection(void* parent, void* ptr, CRYPTO_EX_DATA* ad, int index, long argl,
+                             void* argp);
+  static ThreadPoolPrivateKeyMethodProvider* provider(SSL* ssl, PrivateKeyConnection& connection);
+  static ssl_private_key_result_t start(SSL* ssl, Operation operation);
+
+  // SSL_PRIVATE_KEY_METHOD
+  static ssl_private_key_result_t sign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                       uint16_t signature_algorithm, const uint8_t* in,
+                                       size_t in_len);
+  static ssl_private_key_result_t decrypt(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                          const uint8_t* in, size_t in_len);
+  static ssl_private_key_result_t complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out);
+
+  static const SSL_PRIVATE_KEY_METHOD method_;
+
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  std::shared_ptr<WorkerPool> pool_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyProviders
+} // namespace Extensions
+} // namespace Envoy
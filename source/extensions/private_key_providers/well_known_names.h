@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "common/singleton/const_singleton.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyProviders {
+
+/**
+ * Well-known private key method provider names.
+ * NOTE: New providers should use the well known name: envoy.private_key_providers.name.
+ */
+class PrivateKeyProviderNameValues {
+public:
+  // Local thread pool performing the private key operations off the event loop.
+  const std::string ThreadPool = "envoy.private_key_providers.thread_pool";
+};
+
+using PrivateKeyProviderNames = ConstSingleton<PrivateKeyProviderNameValues>;
+
+} // namespace PrivateKeyProviders
+} // namespace Extensions
+} // namespace Envoy
@@ -20,6 +20,12 @@ namespace StatSinks {
 namespace Common {
 namespace Statsd {
 
+namespace {
+// How long messages buffered on a thread, i.e. histogram samples recorded on a worker, may wait for
+// their datagram to fill up.
+constexpr std::chrono::milliseconds BufferFlushInterval{1000};
+} // namespace
+
 Writer::Writer(Network::Address::InstanceConstSharedPtr address)
     : io_handle_(address->socket(Network::Address::SocketType::Datagram)) {
   ASSERT(io_handle_->fd() != -1);
@@ -29,22 +35,89 @@ Writer::Writer(Network::Address::InstanceConstSharedPtr address)
 }
 
 Writer::~Writer() {
+  // write() may be overridden, and the override is already gone here, so the pending datagram is
+  // sent directly rather than through flushBuffer().
+  if (!buffer_.empty()) {
+    send(buffer_);
+  }
   if (io_handle_->isOpen()) {
     RELEASE_ASSERT(io_handle_->close().err_ == nullptr, "");
   }
 }
 
-void Writer::write(const std::string& message) {
+void Writer::write(const std::string& message) { send(message); }
+
+void Writer::send(const std::string& message) {
   ::send(io_handle_->fd(), message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+void Writer::enableBuffering(Event::Dispatcher& dispatcher, uint64_t max_bytes_per_datagram,
+                             std::chrono::milliseconds flush_interval) {
+  max_bytes_per_datagram_ = max_bytes_per_datagram;
+  flush_interval_ = flush_interval;
+  flush_timer_ = dispatcher.createTimer([this]() -> void { flushBuffer(); });
+}
+
+void Writer::writeBuffered(const std::string& message) {
+  if (max_bytes_per_datagram_ == 0) {
+    write(message);
+    return;
+  }
+
+  // Account for the newline separating the message from the previous one.
+  if (!buffer_.empty() && buffer_.size() + 1 + message.size() > max_bytes_per_datagram_) {
+    flushBuffer();
+  }
+
+  if (buffer_.empty()) {
+    buffer_.append(message);
+    flush_timer_->enableTimer(flush_interval_);
+  } else {
+    buffer_.push_back('\n');
+    buffer_.append(message);
+  }
+}
+
+void Writer::flushBuffer() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  write(buffer_);
+  // clear() keeps the capacity, so steady state batching does not allocate.
+  buffer_.clear();
+  flush_timer_->disableTimer();
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
-                             const std::string& prefix)
+                             const std::string& prefix, uint64_t max_bytes_per_datagram,
+                             bool changed_metrics_only)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
-      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix) {
-  tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::make_shared<Writer>(this->server_address_);
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      max_bytes_per_datagram_(max_bytes_per_datagram), changed_metrics_only_(changed_metrics_only) {
+  tls_->set([this](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    auto writer = std::make_shared<Writer>(this->server_address_);
+    if (max_bytes_per_datagram_ > 0) {
+      writer->enableBuffering(dispatcher, max_bytes_per_datagram_, BufferFlushInterval);
+    }
+    return writer;
+  });
+}
+
+UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
+                             const std::shared_ptr<Writer>& writer, const bool use_tag,
+                             const std::string& prefix, uint64_t max_bytes_per_datagram,
+                             bool changed_metrics_only)
+    : tls_(tls.allocateSlot()), use_tag_(use_tag),
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      max_bytes_per_datagram_(max_bytes_per_datagram), changed_metrics_only_(changed_metrics_only) {
+  tls_->set([this, writer](Event::Dispatcher& dispatcher)
+                -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    if (max_bytes_per_datagram_ > 0) {
+      writer->enableBuffering(dispatcher, max_bytes_per_datagram_, BufferFlushInterval);
+    }
+    return writer;
   });
 }
 
@@ -52,17 +125,20 @@ void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   Writer& writer = tls_->getTyped<Writer>();
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
-      writer.write(fmt::format("{}.{}:{}|c{}", prefix_, getName(counter.counter_.get()),
-                               counter.delta_, buildTagStr(counter.counter_.get().tags())));
+      writer.writeBuffered(fmt::format("{}.{}:{}|c{}", prefix_, getName(counter.counter_.get()),
+                                       counter.delta_, buildTagStr(counter.counter_.get().tags())));
     }
   }
 
   for (const auto& gauge : snapshot.gauges()) {
     if (gauge.get().used()) {
-      writer.write(fmt::format("{}.{}:{}|g{}", prefix_, getName(gauge.get()), gauge.get().value(),
-                               buildTagStr(gauge.get().tags())));
+      writer.writeBuffered(fmt::format("{}.{}:{}|g{}", prefix_, getName(gauge.get()),
+                                       gauge.get().value(), buildTagStr(gauge.get().tags())));
     }
   }
+
+  // Don't hold the tail of the snapshot back until the next flush.
+  writer.flushBuffer();
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -70,7 +146,7 @@ void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint6
   const std::string message(fmt::format("{}.{}:{}|ms{}", prefix_, getName(histogram),
                                         std::chrono::milliseconds(value).count(),
                                         buildTagStr(histogram.tags())));
-  tls_->getTyped<Writer>().write(message);
+  tls_->getTyped<Writer>().writeBuffered(message);
 }
 
 const std::string UdpStatsdSink::getName(const Stats::Metric& metric) {
@@ -97,8 +173,9 @@ const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
                              const std::string& cluster_name, ThreadLocal::SlotAllocator& tls,
                              Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
-                             const std::string& prefix)
-    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix), tls_(tls.allocateSlot()),
+                             const std::string& prefix, bool changed_metrics_only)
+    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      changed_metrics_only_(changed_metrics_only), tls_(tls.allocateSlot()),
       cluster_manager_(cluster_manager), cx_overflow_stat_(scope.counter("statsd.cx_overflow")) {
 
   Config::Utility::checkClusterAndLocalInfo("tcp statsd", cluster_name, cluster_manager,
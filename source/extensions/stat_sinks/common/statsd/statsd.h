@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
 #include "envoy/stats/histogram.h"
@@ -23,7 +25,9 @@ namespace Statsd {
 static const std::string& getDefaultPrefix() { CONSTRUCT_ON_FIRST_USE(std::string, "envoy"); }
 
 /**
- * This is a simple UDP localhost writer for statsd messages.
+ * This is a simple UDP localhost writer for statsd messages. Each call to write() sends a single
+ * datagram. When buffering is enabled, messages passed to writeBuffered() are joined with newlines
+ * into datagrams of up to a maximum size, which statsd and DogStatsD servers both accept.
  */
 class Writer : public ThreadLocal::ThreadLocalObject {
 public:
@@ -33,11 +37,37 @@ public:
   virtual ~Writer();
 
   virtual void write(const std::string& message);
+
+  /**
+   * Enable coalescing of buffered messages on this thread.
+   * @param dispatcher supplies the dispatcher of the thread owning this writer.
+   * @param max_bytes_per_datagram supplies the maximum size of a coalesced datagram. A message
+   *        that is larger on its own is sent in a datagram by itself.
+   * @param flush_interval supplies the longest time a buffered message is held back.
+   */
+  void enableBuffering(Event::Dispatcher& dispatcher, uint64_t max_bytes_per_datagram,
+                       std::chrono::milliseconds flush_interval);
+  /**
+   * Append a message to the pending datagram, sending the datagram first if the message would not
+   * fit. If buffering is not enabled the message is sent right away.
+   */
+  void writeBuffered(const std::string& message);
+  /**
+   * Send the pending datagram, if any.
+   */
+  void flushBuffer();
+
   // Called in unit test to validate address.
   int getFdForTests() const { return io_handle_->fd(); }
 
 private:
+  void send(const std::string& message);
+
   Network::IoHandlePtr io_handle_;
+  uint64_t max_bytes_per_datagram_{};
+  std::chrono::milliseconds flush_interval_{};
+  std::string buffer_;
+  Event::TimerPtr flush_timer_;
 };
 
 /**
@@ -45,24 +75,29 @@ private:
  */
 class UdpStatsdSink : public Stats::Sink {
 public:
+  /**
+   * @param max_bytes_per_datagram supplies the maximum size of the datagrams that metrics are
+   *        coalesced into. If 0, every metric is sent in its own datagram.
+   * @param changed_metrics_only supplies whether to only send the metrics that changed since the
+   *        previous flush.
+   */
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix());
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                uint64_t max_bytes_per_datagram = 0, bool changed_metrics_only = false);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix())
-      : tls_(tls.allocateSlot()), use_tag_(use_tag),
-        prefix_(prefix.empty() ? getDefaultPrefix() : prefix) {
-    tls_->set(
-        [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
-  }
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                uint64_t max_bytes_per_datagram = 0, bool changed_metrics_only = false);
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
+  bool changedMetricsOnly() const override { return changed_metrics_only_; }
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
 
   // Called in unit test to validate writer construction and address.
   int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
   bool getUseTagForTest() { return use_tag_; }
+  uint64_t getMaxBytesPerDatagramForTest() { return max_bytes_per_datagram_; }
   const std::string& getPrefix() { return prefix_; }
 
 private:
@@ -74,6 +109,8 @@ private:
   const bool use_tag_;
   // Prefix for all flushed stats.
   const std::string prefix_;
+  const uint64_t max_bytes_per_datagram_;
+  const bool changed_metrics_only_;
 };
 
 /**
@@ -83,10 +120,12 @@ class TcpStatsdSink : public Stats::Sink {
 public:
   TcpStatsdSink(const LocalInfo::LocalInfo& local_info, const std::string& cluster_name,
                 ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
-                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix());
+                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix(),
+                bool changed_metrics_only = false);
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
+  bool changedMetricsOnly() const override { return changed_metrics_only_; }
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override {
     // For statsd histograms are all timers.
     tls_->getTyped<TlsSink>().onTimespanComplete(histogram.name(),
@@ -131,6 +170,7 @@ private:
 
   // Prefix for all flushed stats.
   const std::string prefix_;
+  const bool changed_metrics_only_;
 
   Upstream::ClusterInfoConstSharedPtr cluster_info_;
   ThreadLocal::SlotPtr tls_;
@@ -51,6 +51,7 @@ public:
   Http::Code handlerHystrixEventStream(absl::string_view, Http::HeaderMap& response_headers,
                                        Buffer::Instance&, Server::AdminStream& admin_stream);
   void flush(Stats::MetricSnapshot& snapshot) override;
+  bool changedMetricsOnly() const override { return false; }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override{};
 
   /**
@@ -76,6 +76,7 @@ public:
   MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
                      TimeSource& time_system);
   void flush(Stats::MetricSnapshot& snapshot) override;
+  bool changedMetricsOnly() const override { return false; }
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
   void flushCounter(const Stats::Counter& counter);
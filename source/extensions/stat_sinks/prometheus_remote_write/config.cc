@@ -0,0 +1,47 @@
+#include "extensions/stat_sinks/prometheus_remote_write/config.h"
+
+#include <memory>
+
+#include "envoy/config/metrics/v2/stats.pb.h"
+#include "envoy/config/metrics/v2/stats.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/stat_sinks/prometheus_remote_write/prometheus_remote_write.h"
+#include "extensions/stat_sinks/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace PrometheusRemoteWrite {
+
+Stats::SinkPtr PrometheusRemoteWriteSinkFactory::createStatsSink(const Protobuf::Message& config,
+                                                                 Server::Instance& server) {
+  const auto& sink_config = MessageUtil::downcastAndValidate<
+      const envoy::config::metrics::v2::PrometheusRemoteWriteSink&>(config);
+  return std::make_unique<RemoteWriteSink>(
+      sink_config.http_uri(),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_series_per_request, 1000),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sink_config, max_requests_in_flight, 100),
+      sink_config.changed_metrics_only(), server.clusterManager(), server.dispatcher(),
+      server.stats(), server.timeSource());
+}
+
+ProtobufTypes::MessagePtr PrometheusRemoteWriteSinkFactory::createEmptyConfigProto() {
+  return std::make_unique<envoy::config::metrics::v2::PrometheusRemoteWriteSink>();
+}
+
+std::string PrometheusRemoteWriteSinkFactory::name() {
+  return StatsSinkNames::get().PrometheusRemoteWrite;
+}
+
+/**
+ * Static registration for the Prometheus remote write sink factory. @see RegisterFactory.
+ */
+REGISTER_FACTORY(PrometheusRemoteWriteSinkFactory, Server::Configuration::StatsSinkFactory);
+
+} // namespace PrometheusRemoteWrite
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,328 @@
+#include "extensions/stat_sinks/prometheus_remote_write/prometheus_remote_write.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/config/utility.h"
+#include "common/http/codes.h"
+#include "common/http/headers.h"
+#include "common/http/message_impl.h"
+#include "common/http/utility.h"
+#include "common/protobuf/utility.h"
+#include "common/singleton/const_singleton.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "snappy.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace PrometheusRemoteWrite {
+
+namespace {
+
+struct RemoteWriteHeaderValues {
+  const Http::LowerCaseString Version{"x-prometheus-remote-write-version"};
+
+  const std::string ContentTypeValue{"application/x-protobuf"};
+  const std::string ContentEncodingValue{"snappy"};
+  const std::string VersionValue{"0.1.0"};
+};
+
+using RemoteWriteHeaders = ConstSingleton<RemoteWriteHeaderValues>;
+
+// Protobuf wire format tags of the remote write protos, i.e. (field_number << 3) | wire_type.
+// WriteRequest.timeseries, TimeSeries.labels and Label.name are all field 1, length delimited.
+constexpr char LengthDelimitedField1 = 0x0a;
+// TimeSeries.samples and Label.value are field 2, length delimited.
+constexpr char LengthDelimitedField2 = 0x12;
+// Sample.value is field 1, a double.
+constexpr char SampleValueTag = 0x09;
+// Sample.timestamp is field 2, an int64.
+constexpr char SampleTimestampTag = 0x10;
+
+void appendVarint(uint64_t value, std::string& output) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+size_t varintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+void appendLengthDelimited(char tag, absl::string_view value, std::string& output) {
+  output.push_back(tag);
+  appendVarint(value.size(), output);
+  output.append(value.data(), value.size());
+}
+
+// The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by Prometheus, as in the
+// /stats/prometheus admin endpoint. Refer to https://prometheus.io/docs/concepts/data_model/.
+std::string sanitizeName(absl::string_view name) {
+  std::string sanitized;
+  sanitized.reserve(name.size() + 1);
+  if (!name.empty() && absl::ascii_isdigit(name[0])) {
+    sanitized.push_back('_');
+  }
+  for (const char c : name) {
+    sanitized.push_back(absl::ascii_isalnum(c) ? c : '_');
+  }
+  return sanitized;
+}
+
+using Label = std::pair<std::string, std::string>;
+
+// Encodes the labels of a series, which remote write requires to be sorted by name, as a sequence
+// of TimeSeries.labels fields.
+std::string encodeLabels(std::vector<Label>& labels) {
+  std::sort(labels.begin(), labels.end());
+  std::string encoded;
+  std::string label;
+  for (const Label& name_value : labels) {
+    label.clear();
+    appendLengthDelimited(LengthDelimitedField1, name_value.first, label);
+    appendLengthDelimited(LengthDelimitedField2, name_value.second, label);
+    appendLengthDelimited(LengthDelimitedField1, label, encoded);
+  }
+  return encoded;
+}
+
+} // namespace
+
+RemoteWriteSink::RemoteWriteSink(const envoy::api::v2::core::HttpUri& http_uri,
+                                 uint32_t max_series_per_request,
+                                 uint32_t max_requests_in_flight, bool changed_metrics_only,
+                                 Upstream::ClusterManager& cluster_manager,
+                                 Event::Dispatcher& dispatcher, Stats::Scope& scope,
+                                 TimeSource& time_source)
+    : http_uri_(http_uri),
+      timeout_(DurationUtil::durationToMilliseconds(http_uri.timeout())),
+      max_series_per_request_(max_series_per_request),
+      max_requests_in_flight_(max_requests_in_flight),
+      changed_metrics_only_(changed_metrics_only), cluster_manager_(cluster_manager),
+      dispatcher_(dispatcher), symbol_table_(scope.symbolTable()), time_source_(time_source),
+      stats_{ALL_PROMETHEUS_REMOTE_WRITE_STATS(
+          POOL_COUNTER_PREFIX(scope, "prometheus_remote_write."))} {
+  Config::Utility::checkCluster("prometheus remote write", http_uri.cluster(), cluster_manager);
+}
+
+RemoteWriteSink::~RemoteWriteSink() {
+  for (const ActiveRequestPtr& request : active_requests_) {
+    if (request->request_ != nullptr) {
+      request->request_->cancel();
+    }
+  }
+  for (CachedSeriesMap* cache : {&counters_, &gauges_, &histograms_}) {
+    for (auto& entry : *cache) {
+      entry.second->stat_name_.free(symbol_table_);
+    }
+  }
+}
+
+void RemoteWriteSink::flush(Stats::MetricSnapshot& snapshot) {
+  ++flushes_;
+  timestamp_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      time_source_.systemTime().time_since_epoch())
+                      .count();
+
+  for (const auto& counter : snapshot.counters()) {
+    if (counter.counter_.get().used()) {
+      const auto& labels = seriesLabels(counters_, counter.counter_.get(), nullptr);
+      addSeries(labels[0], counter.counter_.get().value());
+    }
+  }
+
+  for (const Stats::Gauge& gauge : snapshot.gauges()) {
+    if (gauge.used()) {
+      const auto& labels = seriesLabels(gauges_, gauge, nullptr);
+      addSeries(labels[0], gauge.value());
+    }
+  }
+
+  for (const Stats::ParentHistogram& histogram : snapshot.histograms()) {
+    if (!histogram.used()) {
+      continue;
+    }
+    const Stats::HistogramStatistics& statistics = histogram.cumulativeStatistics();
+    const std::vector<double>& supported_buckets = statistics.supportedBuckets();
+    const std::vector<uint64_t>& computed_buckets = statistics.computedBuckets();
+    ASSERT(computed_buckets.size() == supported_buckets.size());
+    const auto& labels = seriesLabels(histograms_, histogram, &supported_buckets);
+    const size_t num_buckets = supported_buckets.size();
+    for (size_t i = 0; i < num_buckets; ++i) {
+      addSeries(labels[i], computed_buckets[i]);
+    }
+    addSeries(labels[num_buckets], statistics.sampleCount());
+    addSeries(labels[num_buckets + 1], statistics.sampleSum());
+    addSeries(labels[num_buckets + 2], statistics.sampleCount());
+  }
+
+  if (num_series_ > 0) {
+    sendRequest();
+  }
+
+  expireCachedSeries(counters_);
+  expireCachedSeries(gauges_);
+  expireCachedSeries(histograms_);
+}
+
+const std::vector<std::string>& RemoteWriteSink::seriesLabels(CachedSeriesMap& cache,
+                                                              const Stats::Metric& metric,
+                                                              const std::vector<double>* buckets) {
+  auto iter = cache.find(metric.statName());
+  if (iter == cache.end()) {
+    auto series = std::make_unique<CachedSeries>(metric.statName(), symbol_table_);
+    const Stats::StatName key = series->stat_name_.statName();
+    iter = cache.emplace(key, std::move(series)).first;
+
+    // Add namespacing prefix to avoid conflicts, as per best practice:
+    // https://prometheus.io/docs/practices/naming/#metric-names
+    const std::string name = sanitizeName(absl::StrCat("envoy_", metric.tagExtractedName()));
+    std::vector<Label> tags;
+    for (const Stats::Tag& tag : metric.tags()) {
+      tags.emplace_back(sanitizeName(tag.name_), tag.value_);
+    }
+    auto makeLabels = [&tags](const std::string& metric_name, const Label* extra_label) {
+      std::vector<Label> labels = tags;
+      labels.emplace_back("__name__", metric_name);
+      if (extra_label != nullptr) {
+        labels.push_back(*extra_label);
+      }
+      return encodeLabels(labels);
+    };
+
+    std::vector<std::string>& labels = iter->second->labels_;
+    if (buckets == nullptr) {
+      labels.push_back(makeLabels(name, nullptr));
+    } else {
+      const std::string bucket_name = absl::StrCat(name, "_bucket");
+      for (const double bucket : *buckets) {
+        // Bucket bounds are formatted as in /stats/prometheus, in fixed point wherever possible.
+        const Label le{"le", fmt::format("{:.32g}", bucket)};
+        labels.push_back(makeLabels(bucket_name, &le));
+      }
+      const Label le_inf{"le", "+Inf"};
+      labels.push_back(makeLabels(bucket_name, &le_inf));
+      labels.push_back(makeLabels(absl::StrCat(name, "_sum"), nullptr));
+      labels.push_back(makeLabels(absl::StrCat(name, "_count"), nullptr));
+    }
+  }
+  iter->second->last_flush_ = flushes_;
+  return iter->second->labels_;
+}
+
+void RemoteWriteSink::addSeries(const std::string& labels, double value) {
+  // Sample is a little endian double value followed by a varint timestamp.
+  sample_.clear();
+  sample_.push_back(SampleValueTag);
+  uint64_t value_bits;
+  memcpy(&value_bits, &value, sizeof(value_bits));
+  for (size_t i = 0; i < sizeof(value_bits); ++i) {
+    sample_.push_back(static_cast<char>(value_bits >> (8 * i)));
+  }
+  sample_.push_back(SampleTimestampTag);
+  appendVarint(timestamp_ms_, sample_);
+
+  const size_t series_size = labels.size() + 1 + varintSize(sample_.size()) + sample_.size();
+  write_request_.push_back(LengthDelimitedField1);
+  appendVarint(series_size, write_request_);
+  write_request_.append(labels);
+  appendLengthDelimited(LengthDelimitedField2, sample_, write_request_);
+
+  if (++num_series_ == max_series_per_request_) {
+    sendRequest();
+  }
+}
+
+void RemoteWriteSink::sendRequest() {
+  if (active_requests_.size() >= max_requests_in_flight_) {
+    // The endpoint isn't keeping up. Queueing would grow without bound, while the samples of the
+    // next flush supersede these anyway.
+    ENVOY_LOG(debug, "prometheus remote write to {} dropped: {} requests in flight",
+              http_uri_.uri(), active_requests_.size());
+    stats_.requests_dropped_.inc();
+    write_request_.clear();
+    num_series_ = 0;
+    return;
+  }
+
+  Http::MessagePtr message = Http::Utility::prepareHeaders(http_uri_);
+  message->headers().insertMethod().value().setReference(Http::Headers::get().MethodValues.Post);
+  message->headers().insertContentType().value().setReference(
+      RemoteWriteHeaders::get().ContentTypeValue);
+  message->headers().insertContentEncoding().value().setReference(
+      RemoteWriteHeaders::get().ContentEncodingValue);
+  message->headers().addReference(RemoteWriteHeaders::get().Version,
+                                  RemoteWriteHeaders::get().VersionValue);
+
+  std::string compressed;
+  snappy::Compress(write_request_.data(), write_request_.size(), &compressed);
+  message->body() = std::make_unique<Buffer::OwnedImpl>(compressed);
+  write_request_.clear();
+
+  ActiveRequestPtr request = std::make_unique<ActiveRequest>(*this, num_series_);
+  ActiveRequest& active_request = *request;
+  request->moveIntoList(std::move(request), active_requests_);
+  num_series_ = 0;
+
+  // The request may complete, and be deferred deleted, before send() returns.
+  active_request.request_ =
+      cluster_manager_.httpAsyncClientForCluster(http_uri_.cluster())
+          .send(std::move(message), active_request,
+                Http::AsyncClient::RequestOptions().setTimeout(timeout_));
+}
+
+void RemoteWriteSink::ActiveRequest::onSuccess(Http::MessagePtr&& response) {
+  const uint64_t status = Http::Utility::getResponseStatus(response->headers());
+  if (!Http::CodeUtility::is2xx(status)) {
+    ENVOY_LOG(debug, "prometheus remote write to {} failed with status {}", parent_.http_uri_.uri(),
+              status);
+    parent_.onRequestComplete(*this, false);
+    return;
+  }
+  parent_.onRequestComplete(*this, true);
+}
+
+void RemoteWriteSink::ActiveRequest::onFailure(Http::AsyncClient::FailureReason) {
+  ENVOY_LOG(debug, "prometheus remote write to {} failed", parent_.http_uri_.uri());
+  parent_.onRequestComplete(*this, false);
+}
+
+void RemoteWriteSink::onRequestComplete(ActiveRequest& request, bool success) {
+  if (success) {
+    stats_.requests_sent_.inc();
+    stats_.series_sent_.add(request.num_series_);
+  } else {
+    stats_.requests_failed_.inc();
+  }
+  request.request_ = nullptr;
+  dispatcher_.deferredDelete(request.removeFromList(active_requests_));
+}
+
+void RemoteWriteSink::expireCachedSeries(CachedSeriesMap& cache) {
+  for (auto iter = cache.begin(); iter != cache.end();) {
+    if (flushes_ - iter->second->last_flush_ > CachedSeriesExpiryFlushes) {
+      iter->second->stat_name_.free(symbol_table_);
+      cache.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+} // namespace PrometheusRemoteWrite
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/v2/core/http_uri.pb.h"
+#include "envoy/common/time.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/async_client.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/sink.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+#include "common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace PrometheusRemoteWrite {
+
+/**
+ * All Prometheus remote write sink stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_PROMETHEUS_REMOTE_WRITE_STATS(COUNTER)                                                 \
+  COUNTER(requests_sent)                                                                           \
+  COUNTER(requests_failed)                                                                         \
+  COUNTER(requests_dropped)                                                                        \
+  COUNTER(series_sent)
+// clang-format on
+
+/**
+ * Struct definition for all Prometheus remote write sink stats. @see stats_macros.h
+ */
+struct PrometheusRemoteWriteStats {
+  ALL_PROMETHEUS_REMOTE_WRITE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Stats sink pushing metrics to a Prometheus remote write endpoint. Each flush is encoded as
+ * WriteRequest protobufs of at most max_series_per_request time series, which are snappy
+ * compressed and POSTed to the endpoint. At most max_requests_in_flight requests are awaiting a
+ * response at any time: while the endpoint is that far behind, further requests are dropped.
+ *
+ * Computing the Prometheus name and labels of a metric from its tag extracted name and tags is by
+ * far the most expensive part of encoding it, so the encoded labels of each series are cached by
+ * metric name. Entries for metrics that have not been flushed for a while are dropped.
+ */
+class RemoteWriteSink : public Stats::Sink, public Logger::Loggable<Logger::Id::stats> {
+public:
+  RemoteWriteSink(const envoy::api::v2::core::HttpUri& http_uri, uint32_t max_series_per_request,
+                  uint32_t max_requests_in_flight, bool changed_metrics_only,
+                  Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher,
+                  Stats::Scope& scope, TimeSource& time_source);
+  ~RemoteWriteSink();
+
+  // Stats::Sink
+  void flush(Stats::MetricSnapshot& snapshot) override;
+  bool changedMetricsOnly() const override { return changed_metrics_only_; }
+  void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+
+  const PrometheusRemoteWriteStats& stats() const { return stats_; }
+
+  // The number of flushes a metric can be missing from before its cached labels are dropped.
+  static constexpr uint64_t CachedSeriesExpiryFlushes = 10;
+
+private:
+  /**
+   * Encoded labels of the series of a metric: one for counters and gauges, and one per bucket
+   * plus the "+Inf" bucket, sum and count for histograms.
+   */
+  struct CachedSeries {
+    CachedSeries(Stats::StatName stat_name, Stats::SymbolTable& symbol_table)
+        : stat_name_(stat_name, symbol_table) {}
+
+    Stats::StatNameStorage stat_name_;
+    std::vector<std::string> labels_;
+    uint64_t last_flush_{};
+  };
+  using CachedSeriesPtr = std::unique_ptr<CachedSeries>;
+  using CachedSeriesMap = Stats::StatNameHashMap<CachedSeriesPtr>;
+
+  /**
+   * A remote write request in flight.
+   */
+  class ActiveRequest : public Http::AsyncClient::Callbacks,
+                        public Event::DeferredDeletable,
+                        public LinkedObject<ActiveRequest> {
+  public:
+    ActiveRequest(RemoteWriteSink& parent, uint64_t num_series)
+        : parent_(parent), num_series_(num_series) {}
+
+    // Http::AsyncClient::Callbacks
+    void onSuccess(Http::MessagePtr&& response) override;
+    void onFailure(Http::AsyncClient::FailureReason reason) override;
+
+    RemoteWriteSink& parent_;
+    const uint64_t num_series_;
+    Http::AsyncClient::Request* request_{};
+  };
+  using ActiveRequestPtr = std::unique_ptr<ActiveRequest>;
+
+  /**
+   * @return the cached labels of the series of metric, computing them if needed.
+   */
+  const std::vector<std::string>& seriesLabels(CachedSeriesMap& cache, const Stats::Metric& metric,
+                                               const std::vector<double>* buckets);
+  void addSeries(const std::string& labels, double value);
+  void sendRequest();
+  void onRequestComplete(ActiveRequest& request, bool success);
+  void expireCachedSeries(CachedSeriesMap& cache);
+
+  const envoy::api::v2::core::HttpUri http_uri_;
+  const std::chrono::milliseconds timeout_;
+  const uint32_t max_series_per_request_;
+  const uint32_t max_requests_in_flight_;
+  const bool changed_metrics_only_;
+  Upstream::ClusterManager& cluster_manager_;
+  Event::Dispatcher& dispatcher_;
+  Stats::SymbolTable& symbol_table_;
+  TimeSource& time_source_;
+  PrometheusRemoteWriteStats stats_;
+
+  CachedSeriesMap counters_;
+  CachedSeriesMap gauges_;
+  CachedSeriesMap histograms_;
+  uint64_t flushes_{};
+
+  // The WriteRequest being built, the number of series in it and the timestamp of their samples.
+  std::string write_request_;
+  uint64_t num_series_{};
+  int64_t timestamp_ms_{};
+  // Scratch buffer for encoding samples.
+  std::string sample_;
+  std::list<ActiveRequestPtr> active_requests_;
+};
+
+} // namespace PrometheusRemoteWrite
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
@@ -22,6 +22,8 @@ public:
   const std::string MetricsService = "envoy.metrics_service";
   // Hystrix sink
   const std::string Hystrix = "envoy.stat_sinks.hystrix";
+  // Prometheus remote write sink
+  const std::string PrometheusRemoteWrite = "envoy.stat_sinks.prometheus_remote_write";
 };
 
 using StatsSinkNames = ConstSingleton<StatsSinkNameValues>;
@@ -0,0 +1,81 @@
+#include "extensions/transport_sockets/tls/cert_verify_cache.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "openssl/pool.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+constexpr size_t CertVerifyCache::NumShards;
+
+CertVerifyCache::CertVerifyCache(uint32_t max_entries)
+    : num_shards_(std::max<size_t>(1, std::min<size_t>(NumShards, max_entries))) {
+  ASSERT(max_entries > 0);
+  // The first shards take the remainder, so that the shard capacities add up to max_entries.
+  for (size_t i = 0; i < num_shards_; ++i) {
+    shards_[i].max_entries_ = max_entries / num_shards_ + (i < max_entries % num_shards_ ? 1 : 0);
+  }
+}
+
+CertVerifyCache::Key CertVerifyCache::key(const SSL* ssl) {
+  // The DER encoded certificates as received, which avoids re-encoding the parsed X509s.
+  const STACK_OF(CRYPTO_BUFFER)* chain = SSL_get0_peer_certificates(ssl);
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  if (chain != nullptr) {
+    for (const CRYPTO_BUFFER* cert : chain) {
+      // Length prefix each certificate so that different splits of the same bytes differ.
+      const uint64_t length = CRYPTO_BUFFER_len(cert);
+      SHA256_Update(&sha256, &length, sizeof(length));
+      SHA256_Update(&sha256, CRYPTO_BUFFER_data(cert), length);
+    }
+  }
+  Key key;
+  SHA256_Final(key.data(), &sha256);
+  return key;
+}
+
+absl::optional<std::chrono::microseconds> CertVerifyCache::lookup(const Key& key,
+                                                                  SystemTime now) {
+  Shard& s = shard(key);
+  absl::MutexLock lock(&s.mutex_);
+  auto it = s.entries_.find(key);
+  if (it == s.entries_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second.expiry_ <= now) {
+    s.lru_.erase(it->second.lru_position_);
+    s.entries_.erase(it);
+    return absl::nullopt;
+  }
+  s.lru_.splice(s.lru_.begin(), s.lru_, it->second.lru_position_);
+  return it->second.verify_time_;
+}
+
+void CertVerifyCache::insert(const Key& key, SystemTime expiry,
+                             std::chrono::microseconds verify_time) {
+  Shard& s = shard(key);
+  absl::MutexLock lock(&s.mutex_);
+  auto it = s.entries_.find(key);
+  if (it != s.entries_.end()) {
+    // Another worker verified the same chain concurrently.
+    s.lru_.splice(s.lru_.begin(), s.lru_, it->second.lru_position_);
+    return;
+  }
+  if (s.entries_.size() >= s.max_entries_) {
+    s.entries_.erase(s.lru_.back());
+    s.lru_.pop_back();
+  }
+  s.lru_.push_front(key);
+  s.entries_.emplace(key, Entry{expiry, verify_time, s.lru_.begin()});
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
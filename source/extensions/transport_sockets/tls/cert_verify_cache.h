@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+
+#include "envoy/common/time.h"
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "openssl/sha.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A bounded LRU cache of successful peer certificate verifications, keyed by the SHA-256 of the
+ * peer's certificate chain. A context rebuilt with a new validation context gets a new, empty
+ * cache, so results never outlive the configuration that produced them.
+ *
+ * The cache is shared by all the workers using a context. Entries are spread over independently
+ * locked shards so that concurrent handshakes rarely contend on the same lock.
+ */
+class CertVerifyCache {
+public:
+  using Key = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
+  /**
+   * @param max_entries supplies the maximum number of cached chains. It is split as evenly as
+   *        possible between the shards, and fewer shards are used when it is smaller than their
+   *        number, so the cache holds exactly this many chains once full.
+   */
+  explicit CertVerifyCache(uint32_t max_entries);
+
+  /**
+   * @param ssl supplies the connection whose peer certificates are being verified.
+   * @return Key the cache key of the chain presented by the peer.
+   */
+  static Key key(const SSL* ssl);
+
+  /**
+   * Looks up a chain and marks it most recently used.
+   * @param key supplies the chain's key.
+   * @param now supplies the current time. Entries whose certificates have expired are dropped.
+   * @return the time the original verification took, if the chain is cached.
+   */
+  absl::optional<std::chrono::microseconds> lookup(const Key& key, SystemTime now);
+
+  /**
+   * Records a successful verification, evicting the least recently used chain of the shard if
+   * it is full.
+   * @param key supplies the chain's key.
+   * @param expiry supplies the time at which the first certificate of the chain expires.
+   * @param verify_time supplies the time the verification took.
+   */
+  void insert(const Key& key, SystemTime expiry, std::chrono::microseconds verify_time);
+
+private:
+  static constexpr size_t NumShards = 16;
+
+  struct Entry {
+    SystemTime expiry_;
+    std::chrono::microseconds verify_time_;
+    std::list<Key>::iterator lru_position_;
+  };
+
+  struct Shard {
+    size_t max_entries_{0};
+    absl::Mutex mutex_;
+    // Most recently used first.
+    std::list<Key> lru_ GUARDED_BY(mutex_);
+    absl::flat_hash_map<Key, Entry> entries_ GUARDED_BY(mutex_);
+  };
+
+  // The key is a cryptographic hash, so any of its bytes selects a shard uniformly.
+  Shard& shard(const Key& key) { return shards_[key[0] % num_shards_]; }
+
+  const size_t num_shards_;
+  std::array<Shard, NumShards> shards_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,232 @@
+#include "extensions/transport_sockets/tls/certificate_cache.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+
+#include "openssl/err.h"
+#include "openssl/pem.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+void hashLengthPrefixed(SHA256_CTX& sha256, const std::string& data) {
+  // Length prefix each field so that different splits of the same bytes differ.
+  const uint64_t length = data.size();
+  SHA256_Update(&sha256, &length, sizeof(length));
+  SHA256_Update(&sha256, data.data(), data.size());
+}
+
+} // namespace
+
+template <class T>
+std::shared_ptr<const T>
+CertificateCache::lookup(absl::flat_hash_map<Key, std::weak_ptr<const T>>& entries,
+                         const Key& key) {
+  auto it = entries.find(key);
+  if (it == entries.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<const T> entry = it->second.lock();
+  if (entry == nullptr) {
+    // The last context using the entry is gone.
+    entries.erase(it);
+  }
+  return entry;
+}
+
+template <class T>
+void CertificateCache::insert(absl::flat_hash_map<Key, std::weak_ptr<const T>>& entries,
+                              const Key& key, const std::shared_ptr<const T>& entry) {
+  // Entries whose contexts are gone are only erased by lookup() if their material is requested
+  // again, which it never is once a secret has been rotated. Sweep them here, which is cheap
+  // next to the parsing that precedes every insertion.
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.expired()) {
+      entries.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  entries[key] = entry;
+}
+
+CertificateCache::TrustedCaConstSharedPtr
+CertificateCache::trustedCa(const Envoy::Ssl::CertificateValidationContextConfig& config) {
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  hashLengthPrefixed(sha256, config.caCert());
+  hashLengthPrefixed(sha256, config.certificateRevocationList());
+  const uint8_t allow_expired = config.allowExpiredCertificate();
+  SHA256_Update(&sha256, &allow_expired, sizeof(allow_expired));
+  Key key;
+  SHA256_Final(key.data(), &sha256);
+
+  absl::MutexLock lock(&mutex_);
+  TrustedCaConstSharedPtr trusted_ca = lookup(trusted_cas_, key);
+  if (trusted_ca == nullptr) {
+    trusted_ca = parseTrustedCa(config, key);
+    insert(trusted_cas_, key, trusted_ca);
+  }
+  return trusted_ca;
+}
+
+CertificateCache::CertificateChainConstSharedPtr
+CertificateCache::certificateChain(const std::string& pem, const std::string& path) {
+  Key key;
+  SHA256(reinterpret_cast<const uint8_t*>(pem.data()), pem.size(), key.data());
+
+  absl::MutexLock lock(&mutex_);
+  CertificateChainConstSharedPtr chain = lookup(certificate_chains_, key);
+  if (chain == nullptr) {
+    chain = parseCertificateChain(pem, path);
+    insert(certificate_chains_, key, chain);
+  }
+  return chain;
+}
+
+uint64_t CertificateCache::sizeForTest() {
+  absl::MutexLock lock(&mutex_);
+  return trusted_cas_.size() + certificate_chains_.size();
+}
+
+CertificateCache::TrustedCaConstSharedPtr
+CertificateCache::parseTrustedCa(const Envoy::Ssl::CertificateValidationContextConfig& config,
+                                 const Key& digest) {
+  auto trusted_ca = std::make_shared<TrustedCa>();
+  trusted_ca->digest_ = digest;
+  trusted_ca->store_.reset(X509_STORE_new());
+  RELEASE_ASSERT(trusted_ca->store_ != nullptr, "");
+  X509_STORE* store = trusted_ca->store_.get();
+  trusted_ca->subject_names_.reset(sk_X509_NAME_new(
+      [](const X509_NAME** a, const X509_NAME** b) -> int { return X509_NAME_cmp(*a, *b); }));
+  RELEASE_ASSERT(trusted_ca->subject_names_ != nullptr, "");
+
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(config.caCert().data()), config.caCert().size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  // Based on BoringSSL's X509_load_cert_crl_file().
+  bssl::UniquePtr<STACK_OF(X509_INFO)> list(
+      PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+  if (list == nullptr) {
+    throw EnvoyException(
+        fmt::format("Failed to load trusted CA certificates from {}", config.caCertPath()));
+  }
+
+  bool has_crl = false;
+  for (const X509_INFO* item : list.get()) {
+    if (item->x509) {
+      X509_STORE_add_cert(store, item->x509);
+      if (trusted_ca->first_cert_ == nullptr) {
+        X509_up_ref(item->x509);
+        trusted_ca->first_cert_.reset(item->x509);
+      }
+      // Based on BoringSSL's SSL_add_file_cert_subjects_to_stack().
+      X509_NAME* name = X509_get_subject_name(item->x509);
+      if (name == nullptr) {
+        throw EnvoyException(fmt::format("Failed to load trusted client CA certificates from {}",
+                                         config.caCertPath()));
+      }
+      if (!sk_X509_NAME_find(trusted_ca->subject_names_.get(), nullptr, name)) {
+        bssl::UniquePtr<X509_NAME> name_dup(X509_NAME_dup(name));
+        if (name_dup == nullptr ||
+            !sk_X509_NAME_push(trusted_ca->subject_names_.get(), name_dup.release())) {
+          throw EnvoyException(fmt::format(
+              "Failed to load trusted client CA certificates from {}", config.caCertPath()));
+        }
+      }
+    }
+    if (item->crl) {
+      X509_STORE_add_crl(store, item->crl);
+      has_crl = true;
+    }
+  }
+  if (trusted_ca->first_cert_ == nullptr) {
+    throw EnvoyException(
+        fmt::format("Failed to load trusted CA certificates from {}", config.caCertPath()));
+  }
+
+  if (!config.certificateRevocationList().empty()) {
+    bio.reset(BIO_new_mem_buf(const_cast<char*>(config.certificateRevocationList().data()),
+                              config.certificateRevocationList().size()));
+    RELEASE_ASSERT(bio != nullptr, "");
+    // Based on BoringSSL's X509_load_cert_crl_file().
+    list.reset(PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+    if (list == nullptr) {
+      throw EnvoyException(
+          fmt::format("Failed to load CRL from {}", config.certificateRevocationListPath()));
+    }
+    for (const X509_INFO* item : list.get()) {
+      if (item->crl) {
+        X509_STORE_add_crl(store, item->crl);
+        has_crl = true;
+      }
+    }
+  }
+  if (has_crl) {
+    X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+  }
+
+  // NOTE: We're using SSL_CTX_set_cert_verify_callback() instead of X509_verify_cert()
+  // directly. However, our new callback is still calling X509_verify_cert() under
+  // the hood. Therefore, to ignore cert expiration, we need to set the callback
+  // for X509_verify_cert to ignore that error.
+  if (config.allowExpiredCertificate()) {
+    X509_STORE_set_verify_cb(store, CertificateCache::ignoreCertificateExpirationCallback);
+  }
+  return trusted_ca;
+}
+
+CertificateCache::CertificateChainConstSharedPtr
+CertificateCache::parseCertificateChain(const std::string& pem, const std::string& path) {
+  auto chain = std::make_shared<CertificateChain>();
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(const_cast<char*>(pem.data()), pem.size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  chain->leaf_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
+  if (chain->leaf_ == nullptr) {
+    while (uint64_t err = ERR_get_error()) {
+      ENVOY_LOG_MISC(debug, "SSL error: {}:{}:{}:{}", err, ERR_lib_error_string(err),
+                     ERR_func_error_string(err), ERR_GET_REASON(err),
+                     ERR_reason_error_string(err));
+    }
+    throw EnvoyException(fmt::format("Failed to load certificate chain from {}", path));
+  }
+  // Read rest of the certificate chain.
+  while (true) {
+    bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+    if (cert == nullptr) {
+      break;
+    }
+    chain->intermediates_.push_back(std::move(cert));
+  }
+  // Check for EOF.
+  uint32_t err = ERR_peek_last_error();
+  if (ERR_GET_LIB(err) == ERR_LIB_PEM && ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
+    ERR_clear_error();
+  } else {
+    throw EnvoyException(fmt::format("Failed to load certificate chain from {}", path));
+  }
+  return chain;
+}
+
+int CertificateCache::ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* ctx) {
+  if (!ok) {
+    int err = X509_STORE_CTX_get_error(ctx);
+    if (err == X509_V_ERR_CERT_HAS_EXPIRED || err == X509_V_ERR_CERT_NOT_YET_VALID) {
+      return 1;
+    }
+  }
+
+  return ok;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
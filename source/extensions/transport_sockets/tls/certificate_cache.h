@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/ssl/certificate_validation_context_config.h"
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/sha.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Parsed certificate material shared by all the contexts of a context manager, keyed by the
+ * SHA-256 of its PEM encoding. When a secret is rotated, every context referencing it is rebuilt;
+ * the material which didn't change, typically CA bundles shared by many filter chains, is then
+ * reused instead of being parsed again. Entries live for as long as a context uses them.
+ */
+class CertificateCache {
+public:
+  struct TrustedCa {
+    // The CA certificates and CRLs, with the verification flags they imply. The store is shared by
+    // the SSL_CTXs of all the contexts using the bundle and must not be modified.
+    bssl::UniquePtr<X509_STORE> store_;
+    // The first certificate of the bundle, reported in the certificate details.
+    bssl::UniquePtr<X509> first_cert_;
+    // The subject names of the CA certificates, deduplicated, as advertised to TLS clients.
+    bssl::UniquePtr<STACK_OF(X509_NAME)> subject_names_;
+    // The SHA-256 of the CA bundle, the CRL and the verification flags the store was built from.
+    std::array<uint8_t, SHA256_DIGEST_LENGTH> digest_;
+  };
+  using TrustedCaConstSharedPtr = std::shared_ptr<const TrustedCa>;
+
+  struct CertificateChain {
+    bssl::UniquePtr<X509> leaf_;
+    std::vector<bssl::UniquePtr<X509>> intermediates_;
+  };
+  using CertificateChainConstSharedPtr = std::shared_ptr<const CertificateChain>;
+
+  /**
+   * @param config supplies a validation context with a trusted CA.
+   * @return TrustedCaConstSharedPtr the parsed CA bundle and certificate revocation list.
+   * @throw EnvoyException if the CA or the CRL can't be parsed.
+   */
+  TrustedCaConstSharedPtr
+  trustedCa(const Envoy::Ssl::CertificateValidationContextConfig& config);
+
+  /**
+   * @param pem supplies the PEM encoded certificate chain, leaf first.
+   * @param path supplies the path the chain was loaded from, for error messages.
+   * @return CertificateChainConstSharedPtr the parsed chain.
+   * @throw EnvoyException if the chain can't be parsed.
+   */
+  CertificateChainConstSharedPtr certificateChain(const std::string& pem,
+                                                  const std::string& path);
+
+  /**
+   * @return uint64_t the number of cached CA bundles and certificate chains, including entries no
+   *         longer in use which have not been swept yet.
+   */
+  uint64_t sizeForTest();
+
+private:
+  using Key = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
+  static TrustedCaConstSharedPtr
+  parseTrustedCa(const Envoy::Ssl::CertificateValidationContextConfig& config, const Key& digest);
+  static CertificateChainConstSharedPtr parseCertificateChain(const std::string& pem,
+                                                              const std::string& path);
+  static int ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* store_ctx);
+
+  template <class T>
+  static std::shared_ptr<const T> lookup(absl::flat_hash_map<Key, std::weak_ptr<const T>>& entries,
+                                         const Key& key);
+  template <class T>
+  static void insert(absl::flat_hash_map<Key, std::weak_ptr<const T>>& entries, const Key& key,
+                     const std::shared_ptr<const T>& entry);
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, std::weak_ptr<const TrustedCa>> trusted_cas_ GUARDED_BY(mutex_);
+  absl::flat_hash_map<Key, std::weak_ptr<const CertificateChain>>
+      certificate_chains_ GUARDED_BY(mutex_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
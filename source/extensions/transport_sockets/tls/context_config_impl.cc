@@ -111,7 +111,7 @@ ContextConfigImpl::ContextConfigImpl(
     const unsigned default_min_protocol_version, const unsigned default_max_protocol_version,
     const std::string& default_cipher_suites, const std::string& default_curves,
     Server::Configuration::TransportSocketFactoryContext& factory_context)
-    : api_(factory_context.api()),
+    : api_(factory_context.api()), singleton_manager_(factory_context.singletonManager()),
       alpn_protocols_(RepeatedPtrUtil::join(config.alpn_protocols(), ",")),
       cipher_suites_(StringUtil::nonEmptyStringOrDefault(
           RepeatedPtrUtil::join(config.tls_params().cipher_suites(), ":"), default_cipher_suites)),
@@ -123,7 +123,16 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      kernel_tls_offload_(config.kernel_tls_offload()) {
+  if (config.has_dynamic_record_sizing()) {
+    const auto& sizing = config.dynamic_record_sizing();
+    dynamic_record_sizing_ =
+        std::make_unique<const Ssl::DynamicRecordSizingConfig>(Ssl::DynamicRecordSizingConfig{
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, initial_record_size, 1300),
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, small_record_bytes, 1024 * 1024),
+            std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(sizing, idle_timeout, 1000))});
+  }
   if (default_cvc_ && certificate_validation_context_provider_ != nullptr) {
     // We need to validate combined certificate validation context.
     // The default certificate validation context and dynamic certificate validation
@@ -144,7 +153,7 @@ ContextConfigImpl::ContextConfigImpl(
   if (!tls_certificate_providers_.empty()) {
     for (auto& provider : tls_certificate_providers_) {
       if (provider->secret() != nullptr) {
-        tls_certificate_configs_.emplace_back(*provider->secret(), api_);
+        tls_certificate_configs_.emplace_back(*provider->secret(), api_, singleton_manager_);
       }
     }
   }
@@ -175,7 +184,8 @@ void ContextConfigImpl::setSecretUpdateCallback(std::function<void()> callback)
           // This breaks multiple certificate support, but today SDS is only single cert.
           // TODO(htuch): Fix this when SDS goes multi-cert.
           tls_certificate_configs_.clear();
-          tls_certificate_configs_.emplace_back(*tls_certificate_providers_[0]->secret(), api_);
+          tls_certificate_configs_.emplace_back(*tls_certificate_providers_[0]->secret(), api_,
+                                               singleton_manager_);
           callback();
         });
   }
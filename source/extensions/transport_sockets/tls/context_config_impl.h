@@ -43,6 +43,10 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
+  const Ssl::DynamicRecordSizingConfig* dynamicRecordSizing() const override {
+    return dynamic_record_sizing_.get();
+  }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -66,6 +70,7 @@ protected:
                     const std::string& default_cipher_suites, const std::string& default_curves,
                     Server::Configuration::TransportSocketFactoryContext& factory_context);
   Api::Api& api_;
+  Singleton::Manager& singleton_manager_;
 
 private:
   static unsigned
@@ -92,6 +97,8 @@ private:
   Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool kernel_tls_offload_;
+  std::unique_ptr<const Ssl::DynamicRecordSizingConfig> dynamic_record_sizing_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
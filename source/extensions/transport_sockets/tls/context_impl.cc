@@ -12,6 +12,7 @@
 #include "common/common/base64.h"
 #include "common/common/fmt.h"
 #include "common/common/hex.h"
+#include "common/common/macros.h"
 #include "common/common/utility.h"
 #include "common/protobuf/utility.h"
 
@@ -46,9 +47,14 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
 } // namespace
 
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-                         TimeSource& time_source)
+                         CertificateCache& certificate_cache, TimeSource& time_source)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
-      tls_max_version_(config.maxProtocolVersion()) {
+      tls_max_version_(config.maxProtocolVersion()),
+      kernel_tls_offload_(config.kernelTlsOffload()) {
+  if (config.dynamicRecordSizing() != nullptr) {
+    dynamic_record_sizing_ = *config.dynamicRecordSizing();
+  }
+
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(static_cast<size_t>(1), tls_certificates.size()));
 
@@ -88,80 +94,18 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
   if (config.certificateValidationContext() != nullptr &&
       !config.certificateValidationContext()->caCert().empty()) {
     ca_file_path_ = config.certificateValidationContext()->caCertPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(config.certificateValidationContext()->caCert().data()),
-                        config.certificateValidationContext()->caCert().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
-      throw EnvoyException(fmt::format("Failed to load trusted CA certificates from {}",
-                                       config.certificateValidationContext()->caCertPath()));
-    }
+    // The parsed CA bundle, together with any CRL, is shared with every other context using the
+    // same material, so a secret rotation doesn't parse it again.
+    trusted_ca_ = certificate_cache.trustedCa(*config.certificateValidationContext());
+    X509_up_ref(trusted_ca_->first_cert_.get());
+    ca_cert_.reset(trusted_ca_->first_cert_.get());
 
     for (auto& ctx : tls_contexts_) {
-      X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      bool has_crl = false;
-      for (const X509_INFO* item : list.get()) {
-        if (item->x509) {
-          X509_STORE_add_cert(store, item->x509);
-          if (ca_cert_ == nullptr) {
-            X509_up_ref(item->x509);
-            ca_cert_.reset(item->x509);
-          }
-        }
-        if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
-          has_crl = true;
-        }
-      }
-      if (ca_cert_ == nullptr) {
-        throw EnvoyException(fmt::format("Failed to load trusted CA certificates from {}",
-                                         config.certificateValidationContext()->caCertPath()));
-      }
-      if (has_crl) {
-        X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
-      }
+      // SSL_CTX_set_cert_store() takes ownership.
+      X509_STORE_up_ref(trusted_ca_->store_.get());
+      SSL_CTX_set_cert_store(ctx.ssl_ctx_.get(), trusted_ca_->store_.get());
       verify_mode = SSL_VERIFY_PEER;
       verify_trusted_ca_ = true;
-
-      // NOTE: We're using SSL_CTX_set_cert_verify_callback() instead of X509_verify_cert()
-      // directly. However, our new callback is still calling X509_verify_cert() under
-      // the hood. Therefore, to ignore cert expiration, we need to set the callback
-      // for X509_verify_cert to ignore that error.
-      if (config.certificateValidationContext()->allowExpiredCertificate()) {
-        X509_STORE_set_verify_cb(store, ContextImpl::ignoreCertificateExpirationCallback);
-      }
-    }
-  }
-
-  if (config.certificateValidationContext() != nullptr &&
-      !config.certificateValidationContext()->certificateRevocationList().empty()) {
-    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(
-        const_cast<char*>(
-            config.certificateValidationContext()->certificateRevocationList().data()),
-        config.certificateValidationContext()->certificateRevocationList().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-
-    // Based on BoringSSL's X509_load_cert_crl_file().
-    bssl::UniquePtr<STACK_OF(X509_INFO)> list(
-        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
-    if (list == nullptr) {
-      throw EnvoyException(
-          fmt::format("Failed to load CRL from {}",
-                      config.certificateValidationContext()->certificateRevocationListPath()));
-    }
-
-    for (auto& ctx : tls_contexts_) {
-      X509_STORE* store = SSL_CTX_get_cert_store(ctx.ssl_ctx_.get());
-      for (const X509_INFO* item : list.get()) {
-        if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
-        }
-      }
-
-      X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
     }
   }
 
@@ -208,19 +152,24 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     }
   }
 
+  if (verify_mode != SSL_VERIFY_NONE &&
+      config.certificateValidationContext()->verificationCacheSize() > 0) {
+    verify_cache_ = std::make_unique<CertVerifyCache>(
+        config.certificateValidationContext()->verificationCacheSize());
+    verify_allow_expired_ = config.certificateValidationContext()->allowExpiredCertificate();
+  }
+
   std::unordered_set<int> cert_pkey_ids;
   for (uint32_t i = 0; i < tls_certificates.size(); ++i) {
     auto& ctx = tls_contexts_[i];
     // Load certificate chain.
     const auto& tls_certificate = tls_certificates[i].get();
     ctx.cert_chain_file_path_ = tls_certificate.certificateChainPath();
-    bssl::UniquePtr<BIO> bio(
-        BIO_new_mem_buf(const_cast<char*>(tls_certificate.certificateChain().data()),
-                        tls_certificate.certificateChain().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    ctx.cert_chain_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
-    if (ctx.cert_chain_ == nullptr ||
-        !SSL_CTX_use_certificate(ctx.ssl_ctx_.get(), ctx.cert_chain_.get())) {
+    ctx.parsed_cert_chain_ = certificate_cache.certificateChain(
+        tls_certificate.certificateChain(), ctx.cert_chain_file_path_);
+    X509_up_ref(ctx.parsed_cert_chain_->leaf_.get());
+    ctx.cert_chain_.reset(ctx.parsed_cert_chain_->leaf_.get());
+    if (!SSL_CTX_use_certificate(ctx.ssl_ctx_.get(), ctx.cert_chain_.get())) {
       while (uint64_t err = ERR_get_error()) {
         ENVOY_LOG_MISC(debug, "SSL error: {}:{}:{}:{}", err, ERR_lib_error_string(err),
                        ERR_func_error_string(err), ERR_GET_REASON(err),
@@ -229,26 +178,14 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       throw EnvoyException(
           fmt::format("Failed to load certificate chain from {}", ctx.cert_chain_file_path_));
     }
-    // Read rest of the certificate chain.
-    while (true) {
-      bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
-      if (cert == nullptr) {
-        break;
-      }
-      if (!SSL_CTX_add_extra_chain_cert(ctx.ssl_ctx_.get(), cert.get())) {
+    for (const auto& intermediate : ctx.parsed_cert_chain_->intermediates_) {
+      X509_up_ref(intermediate.get());
+      // SSL_CTX_add_extra_chain_cert() takes ownership.
+      if (!SSL_CTX_add_extra_chain_cert(ctx.ssl_ctx_.get(), intermediate.get())) {
+        X509_free(intermediate.get());
         throw EnvoyException(
             fmt::format("Failed to load certificate chain from {}", ctx.cert_chain_file_path_));
       }
-      // SSL_CTX_add_extra_chain_cert() takes ownership.
-      cert.release();
-    }
-    // Check for EOF.
-    uint32_t err = ERR_peek_last_error();
-    if (ERR_GET_LIB(err) == ERR_LIB_PEM && ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
-      ERR_clear_error();
-    } else {
-      throw EnvoyException(
-          fmt::format("Failed to load certificate chain from {}", ctx.cert_chain_file_path_));
     }
 
     bssl::UniquePtr<EVP_PKEY> public_key(X509_get_pubkey(ctx.cert_chain_.get()));
@@ -302,40 +239,52 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 #endif
     }
 
-    // Load private key.
-    bio.reset(BIO_new_mem_buf(const_cast<char*>(tls_certificate.privateKey().data()),
-                              tls_certificate.privateKey().size()));
-    RELEASE_ASSERT(bio != nullptr, "");
-    bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(
-        bio.get(), nullptr, nullptr,
-        !tls_certificate.password().empty() ? const_cast<char*>(tls_certificate.password().c_str())
-                                            : nullptr));
-    if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey.get())) {
-      throw EnvoyException(
-          fmt::format("Failed to load private key from {}", tls_certificate.privateKeyPath()));
-    }
+    Envoy::Ssl::PrivateKeyMethodProviderSharedPtr private_key_method_provider =
+        tls_certificate.privateKeyMethod();
+    if (private_key_method_provider != nullptr) {
+      // The private key operations are performed by the provider, possibly asynchronously. The
+      // key itself is never seen by this context.
+      ctx.private_key_method_provider_ = private_key_method_provider;
+      SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(),
+                                     private_key_method_provider->getBoringSslPrivateKeyMethod());
+    } else {
+      // Load private key.
+      bssl::UniquePtr<BIO> bio(
+          BIO_new_mem_buf(const_cast<char*>(tls_certificate.privateKey().data()),
+                          tls_certificate.privateKey().size()));
+      RELEASE_ASSERT(bio != nullptr, "");
+      bssl::UniquePtr<EVP_PKEY> pkey(
+          PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr,
+                                  !tls_certificate.password().empty()
+                                      ? const_cast<char*>(tls_certificate.password().c_str())
+                                      : nullptr));
+      if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey.get())) {
+        throw EnvoyException(
+            fmt::format("Failed to load private key from {}", tls_certificate.privateKeyPath()));
+      }
 
 #ifdef BORINGSSL_FIPS
-    // Verify that private keys are passing FIPS pairwise consistency tests.
-    switch (pkey_id) {
-    case EVP_PKEY_EC: {
-      const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey.get());
-      if (!EC_KEY_check_fips(ecdsa_private_key)) {
-        throw EnvoyException(fmt::format("Failed to load private key from {}, ECDSA key failed "
-                                         "pairwise consistency test required in FIPS mode",
-                                         tls_certificate.privateKeyPath()));
-      }
-    } break;
-    case EVP_PKEY_RSA: {
-      RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey.get());
-      if (!RSA_check_fips(rsa_private_key)) {
-        throw EnvoyException(fmt::format("Failed to load private key from {}, RSA key failed "
-                                         "pairwise consistency test required in FIPS mode",
-                                         tls_certificate.privateKeyPath()));
+      // Verify that private keys are passing FIPS pairwise consistency tests.
+      switch (pkey_id) {
+      case EVP_PKEY_EC: {
+        const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey.get());
+        if (!EC_KEY_check_fips(ecdsa_private_key)) {
+          throw EnvoyException(fmt::format("Failed to load private key from {}, ECDSA key failed "
+                                           "pairwise consistency test required in FIPS mode",
+                                           tls_certificate.privateKeyPath()));
+        }
+      } break;
+      case EVP_PKEY_RSA: {
+        RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey.get());
+        if (!RSA_check_fips(rsa_private_key)) {
+          throw EnvoyException(fmt::format("Failed to load private key from {}, RSA key failed "
+                                           "pairwise consistency test required in FIPS mode",
+                                           tls_certificate.privateKeyPath()));
+        }
+      } break;
       }
-    } break;
-    }
 #endif
+    }
   }
 
   // use the server's cipher list preferences
@@ -387,6 +336,26 @@ std::vector<uint8_t> ContextImpl::parseAlpnProtocols(const std::string& alpn_pro
   return out;
 }
 
+std::vector<Envoy::Ssl::PrivateKeyMethodProviderSharedPtr>
+ContextImpl::getPrivateKeyMethodProviders() {
+  std::vector<Envoy::Ssl::PrivateKeyMethodProviderSharedPtr> providers;
+
+  for (const auto& ctx : tls_contexts_) {
+    if (ctx.private_key_method_provider_ != nullptr) {
+      providers.push_back(ctx.private_key_method_provider_);
+    }
+  }
+  return providers;
+}
+
+int ContextImpl::handshakePhaseTimesIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(index >= 0, "");
+    return index;
+  }());
+}
+
 bssl::UniquePtr<SSL> ContextImpl::newSsl(absl::optional<std::string>) {
   // We use the first certificate for a new SSL object, later in the
   // SSL_CTX_set_select_certificate_cb() callback following ClientHello, we replace with the
@@ -394,19 +363,24 @@ bssl::UniquePtr<SSL> ContextImpl::newSsl(absl::optional<std::string>) {
   return bssl::UniquePtr<SSL>(SSL_new(tls_contexts_[0].ssl_ctx_.get()));
 }
 
-int ContextImpl::ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* ctx) {
-  if (!ok) {
-    int err = X509_STORE_CTX_get_error(ctx);
-    if (err == X509_V_ERR_CERT_HAS_EXPIRED || err == X509_V_ERR_CERT_NOT_YET_VALID) {
+int ContextImpl::verifyCallback(X509_STORE_CTX* store_ctx, void* arg) {
+  ContextImpl* impl = reinterpret_cast<ContextImpl*>(arg);
+  SSL* ssl = reinterpret_cast<SSL*>(
+      X509_STORE_CTX_get_ex_data(store_ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
+
+  CertVerifyCache::Key cache_key{};
+  if (impl->verify_cache_ != nullptr) {
+    cache_key = CertVerifyCache::key(ssl);
+    const auto verify_time =
+        impl->verify_cache_->lookup(cache_key, impl->time_source_.systemTime());
+    if (verify_time.has_value()) {
+      impl->stats_.verify_cache_hit_.inc();
+      impl->stats_.verify_cache_time_saved_us_.add(verify_time.value().count());
       return 1;
     }
+    impl->stats_.verify_cache_miss_.inc();
   }
-
-  return ok;
-}
-
-int ContextImpl::verifyCallback(X509_STORE_CTX* store_ctx, void* arg) {
-  ContextImpl* impl = reinterpret_cast<ContextImpl*>(arg);
+  const MonotonicTime start = impl->time_source_.monotonicTime();
 
   if (impl->verify_trusted_ca_) {
     int ret = X509_verify_cert(store_ctx);
@@ -416,10 +390,30 @@ int ContextImpl::verifyCallback(X509_STORE_CTX* store_ctx, void* arg) {
     }
   }
 
-  SSL* ssl = reinterpret_cast<SSL*>(
-      X509_STORE_CTX_get_ex_data(store_ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
   bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl));
-  return impl->verifyCertificate(cert.get());
+  const int ret = impl->verifyCertificate(cert.get());
+  if (ret == 1 && cert != nullptr && impl->verify_cache_ != nullptr) {
+    impl->verify_cache_->insert(
+        cache_key, impl->verifiedChainExpiry(store_ctx, *cert),
+        std::chrono::duration_cast<std::chrono::microseconds>(impl->time_source_.monotonicTime() -
+                                                              start));
+  }
+  return ret;
+}
+
+SystemTime ContextImpl::verifiedChainExpiry(X509_STORE_CTX* store_ctx, X509& cert) const {
+  if (verify_allow_expired_) {
+    return SystemTime::max();
+  }
+  if (!verify_trusted_ca_) {
+    return Utility::getExpirationTime(cert);
+  }
+  // The chain built by X509_verify_cert(), from the peer certificate up to the trusted CA.
+  SystemTime expiry = SystemTime::max();
+  for (X509* chain_cert : X509_STORE_CTX_get0_chain(store_ctx)) {
+    expiry = std::min(expiry, Utility::getExpirationTime(*chain_cert));
+  }
+  return expiry;
 }
 
 int ContextImpl::verifyCertificate(X509* cert) {
@@ -626,13 +620,18 @@ Envoy::Ssl::CertificateDetailsPtr ContextImpl::certificateDetails(X509* cert,
 
 ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ClientContextConfig& config,
+                                     CertificateCache& certificate_cache,
                                      TimeSource& time_source)
-    : ContextImpl(scope, config, time_source),
+    : ContextImpl(scope, config, certificate_cache, time_source),
       server_name_indication_(config.serverNameIndication()),
       allow_renegotiation_(config.allowRenegotiation()),
       max_session_keys_(config.maxSessionKeys()) {
   // This should be guaranteed during configuration ingestion for client contexts.
   ASSERT(tls_contexts_.size() == 1);
+  // The kernel can't rekey a connection, so renegotiated connections must stay in userspace.
+  if (allow_renegotiation_) {
+    kernel_tls_offload_ = false;
+  }
   if (!parsed_alpn_protocols_.empty()) {
     for (auto& ctx : tls_contexts_) {
       int rc = SSL_CTX_set_alpn_protos(ctx.ssl_ctx_.get(), &parsed_alpn_protocols_[0],
@@ -738,8 +737,10 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()) {
+                                     CertificateCache& certificate_cache,
+                                     ServerSessionCache& session_cache, TimeSource& time_source)
+    : ContextImpl(scope, config, certificate_cache, time_source),
+      session_ticket_keys_(config.sessionTicketKeys()) {
   if (config.tlsCertificates().empty()) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -758,12 +759,15 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // is used.
   uint8_t session_context_buf[EVP_MAX_MD_SIZE] = {};
   unsigned session_context_len = 0;
-  generateHashForSessionContexId(server_names, session_context_buf, session_context_len);
+  generateHashForSessionContexId(server_names, config.requireClientCertificate(),
+                                 session_context_buf, session_context_len);
+  // Contexts with the same session id context share their session state, so that it survives this
+  // context being replaced on an SDS or LDS update.
+  session_state_ = session_cache.sessionState(
+      absl::string_view(reinterpret_cast<const char*>(session_context_buf), session_context_len));
   for (auto& ctx : tls_contexts_) {
-    if (config.certificateValidationContext() != nullptr &&
-        !config.certificateValidationContext()->caCert().empty()) {
-      ctx.addClientValidationContext(*config.certificateValidationContext(),
-                                     config.requireClientCertificate());
+    if (trusted_ca_ != nullptr) {
+      ctx.addClientValidationContext(*trusted_ca_, config.requireClientCertificate());
     }
 
     if (!parsed_alpn_protocols_.empty()) {
@@ -776,19 +780,40 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
           this);
     }
 
-    if (!session_ticket_keys_.empty()) {
-      SSL_CTX_set_tlsext_ticket_key_cb(
-          ctx.ssl_ctx_.get(),
-          [](SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx,
-             int encrypt) -> int {
-            ContextImpl* context_impl =
-                static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
-            ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
-            RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
-            return server_context_impl->sessionTicketProcess(ssl, key_name, iv, ctx, hmac_ctx,
-                                                             encrypt);
-          });
-    }
+    SSL_CTX_set_tlsext_ticket_key_cb(
+        ctx.ssl_ctx_.get(),
+        [](SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx,
+           int encrypt) -> int {
+          ContextImpl* context_impl =
+              static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+          ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+          RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+          return server_context_impl->sessionTicketProcess(ssl, key_name, iv, ctx, hmac_ctx,
+                                                           encrypt);
+        });
+
+    // Sessions resumed by session id are cached in the shared session state instead of the
+    // SSL_CTX.
+    SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                   SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+      ContextImpl* context_impl =
+          static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+      ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+      RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+      return server_context_impl->newSession(session);
+    });
+    SSL_CTX_sess_set_get_cb(
+        ctx.ssl_ctx_.get(),
+        [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+          ContextImpl* context_impl =
+              static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+          ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+          RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+          // The returned session is parsed for this lookup, hand its reference over to BoringSSL.
+          *out_copy = 0;
+          return server_context_impl->getSession(ssl, id, id_len);
+        });
 
     int rc = SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_context_buf,
                                             session_context_len);
@@ -797,6 +822,7 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
 }
 
 void ServerContextImpl::generateHashForSessionContexId(const std::vector<std::string>& server_names,
+                                                       bool require_client_certificate,
                                                        uint8_t* session_context_buf,
                                                        unsigned& session_context_len) {
   EVP_MD_CTX md;
@@ -850,10 +876,15 @@ void ServerContextImpl::generateHashForSessionContexId(const std::vector<std::st
   // the client connection. This ensures that the client is always validated against
   // the correct settings, even if session resumption across different listeners
   // is enabled.
-  if (ca_cert_ != nullptr) {
-    rc = X509_digest(ca_cert_.get(), EVP_sha256(), session_context_buf, &session_context_len);
-    RELEASE_ASSERT(rc == 1 && session_context_len == SHA256_DIGEST_LENGTH, "");
-    rc = EVP_DigestUpdate(&md, session_context_buf, session_context_len);
+  if (trusted_ca_ != nullptr) {
+    // The digest covers the whole CA bundle, the CRL and whether expired certificates are allowed.
+    // The session state is shared by the contexts with the same session id context, so a session
+    // established before a CRL update must not resume after it.
+    rc = EVP_DigestUpdate(&md, trusted_ca_->digest_.data(), trusted_ca_->digest_.size());
+    RELEASE_ASSERT(rc == 1, "");
+    const uint8_t require_client_certificate_byte = require_client_certificate;
+    rc = EVP_DigestUpdate(&md, &require_client_certificate_byte,
+                          sizeof(require_client_certificate_byte));
     RELEASE_ASSERT(rc == 1, "");
 
     // verify_subject_alt_name_list_ can only be set with a ca_cert
@@ -893,14 +924,16 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   const EVP_MD* hmac = EVP_sha256();
   const EVP_CIPHER* cipher = EVP_aes_256_cbc();
 
+  // Without configured keys, tickets are protected by the generated keys of the shared session
+  // state, so that they remain valid across context rebuilds and hot restarts.
+  const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey>& session_ticket_keys =
+      session_ticket_keys_.empty() ? session_state_->ticketKeys() : session_ticket_keys_;
+
   if (encrypt == 1) {
     // Encrypt
-    RELEASE_ASSERT(session_ticket_keys_.size() >= 1, "");
-    // TODO(ggreenway): validate in SDS that session_ticket_keys_ cannot be empty,
-    // or if we allow it to be emptied, reconfigure the context so this callback
-    // isn't set.
+    RELEASE_ASSERT(session_ticket_keys.size() >= 1, "");
 
-    const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = session_ticket_keys_.front();
+    const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = session_ticket_keys.front();
 
     static_assert(std::tuple_size<decltype(key.name_)>::value == SSL_TICKET_KEY_NAME_LEN,
                   "Expected key.name length");
@@ -924,7 +957,7 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   } else {
     // Decrypt
     bool is_enc_key = true; // first element is the encryption key
-    for (const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key : session_ticket_keys_) {
+    for (const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key : session_ticket_keys) {
       static_assert(std::tuple_size<decltype(key.name_)>::value == SSL_TICKET_KEY_NAME_LEN,
                     "Expected key.name length");
       if (std::equal(key.name_.begin(), key.name_.end(), key_name)) {
@@ -948,6 +981,38 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   }
 }
 
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  uint8_t* data;
+  size_t data_len;
+  if (!SSL_SESSION_to_bytes(session, &data, &data_len)) {
+    return 0;
+  }
+  bssl::UniquePtr<uint8_t> data_deleter(data);
+  unsigned id_len;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_len);
+  const SystemTime expiry(
+      std::chrono::seconds(SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session)));
+  session_state_->insertSession(absl::string_view(reinterpret_cast<const char*>(id), id_len),
+                                std::string(reinterpret_cast<const char*>(data), data_len), expiry);
+  return 0; // The session was copied, BoringSSL keeps ownership.
+}
+
+SSL_SESSION* ServerContextImpl::getSession(SSL* ssl, const uint8_t* id, int id_len) {
+  const absl::optional<std::string> data =
+      session_state_->lookupSession(absl::string_view(reinterpret_cast<const char*>(id), id_len));
+  SSL_SESSION* session = nullptr;
+  if (data.has_value()) {
+    session = SSL_SESSION_from_bytes(reinterpret_cast<const uint8_t*>(data->data()), data->size(),
+                                     SSL_get_SSL_CTX(ssl));
+  }
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session;
+}
+
 bool ServerContextImpl::isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello) {
   CBS client_hello;
   CBS_init(&client_hello, ssl_client_hello->client_hello, ssl_client_hello->client_hello_len);
@@ -1031,45 +1096,24 @@ ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
   }
   RELEASE_ASSERT(SSL_set_SSL_CTX(ssl_client_hello->ssl, selected_ctx->ssl_ctx_.get()) != nullptr,
                  "");
+
+  auto* phase_times = static_cast<HandshakePhaseTimes*>(
+      SSL_get_ex_data(ssl_client_hello->ssl, handshakePhaseTimesIndex()));
+  if (phase_times != nullptr) {
+    phase_times->certificate_selected_ = time_source_.monotonicTime();
+  }
   return ssl_select_cert_success;
 }
 
 void ServerContextImpl::TlsContext::addClientValidationContext(
-    const Envoy::Ssl::CertificateValidationContextConfig& config, bool require_client_cert) {
-  bssl::UniquePtr<BIO> bio(
-      BIO_new_mem_buf(const_cast<char*>(config.caCert().data()), config.caCert().size()));
-  RELEASE_ASSERT(bio != nullptr, "");
-  // Based on BoringSSL's SSL_add_file_cert_subjects_to_stack().
-  bssl::UniquePtr<STACK_OF(X509_NAME)> list(sk_X509_NAME_new(
-      [](const X509_NAME** a, const X509_NAME** b) -> int { return X509_NAME_cmp(*a, *b); }));
+    const CertificateCache::TrustedCa& trusted_ca, bool require_client_cert) {
+  // SSL_CTX_set_client_CA_list() takes ownership, so copy the shared subject names.
+  bssl::UniquePtr<STACK_OF(X509_NAME)> list(sk_X509_NAME_new_null());
   RELEASE_ASSERT(list != nullptr, "");
-  for (;;) {
-    bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
-    if (cert == nullptr) {
-      break;
-    }
-    X509_NAME* name = X509_get_subject_name(cert.get());
-    if (name == nullptr) {
-      throw EnvoyException(fmt::format("Failed to load trusted client CA certificates from {}",
-                                       config.caCertPath()));
-    }
-    // Check for duplicates.
-    if (sk_X509_NAME_find(list.get(), nullptr, name)) {
-      continue;
-    }
+  for (X509_NAME* name : trusted_ca.subject_names_.get()) {
     bssl::UniquePtr<X509_NAME> name_dup(X509_NAME_dup(name));
-    if (name_dup == nullptr || !sk_X509_NAME_push(list.get(), name_dup.release())) {
-      throw EnvoyException(fmt::format("Failed to load trusted client CA certificates from {}",
-                                       config.caCertPath()));
-    }
-  }
-  // Check for EOF.
-  uint32_t err = ERR_peek_last_error();
-  if (ERR_GET_LIB(err) == ERR_LIB_PEM && ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
-    ERR_clear_error();
-  } else {
-    throw EnvoyException(
-        fmt::format("Failed to load trusted client CA certificates from {}", config.caCertPath()));
+    RELEASE_ASSERT(name_dup != nullptr, "");
+    RELEASE_ASSERT(sk_X509_NAME_push(list.get(), name_dup.release()), "");
   }
   SSL_CTX_set_client_CA_list(ssl_ctx_.get(), list.release());
 
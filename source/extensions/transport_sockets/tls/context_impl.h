@@ -7,10 +7,14 @@
 
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
+#include "envoy/ssl/private_key_method_provider.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 
+#include "extensions/transport_sockets/tls/cert_verify_cache.h"
+#include "extensions/transport_sockets/tls/certificate_cache.h"
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
+#include "extensions/transport_sockets/tls/server_session_cache.h"
 
 #include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
@@ -34,7 +38,18 @@ namespace Tls {
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  COUNTER(ktls_offloaded)                                                                          \
+  COUNTER(ktls_unsupported)                                                                        \
+  COUNTER(verify_cache_hit)                                                                        \
+  COUNTER(verify_cache_miss)                                                                       \
+  COUNTER(verify_cache_time_saved_us)                                                              \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  HISTOGRAM(write_record_size)                                                                     \
+  HISTOGRAM(handshake_certificate_selection_us)                                                    \
+  HISTOGRAM(handshake_signing_us)                                                                  \
+  HISTOGRAM(handshake_finished_us)
 // clang-format on
 
 /**
@@ -44,6 +59,19 @@ struct SslStats {
   ALL_SSL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+/**
+ * The times at which a server handshake went through each of its phases. Owned by the connection
+ * and attached to its SSL object, so that the context callbacks can fill in the phases they see.
+ */
+struct HandshakePhaseTimes {
+  // The start of the SSL_do_handshake() call which read the ClientHello.
+  absl::optional<MonotonicTime> client_hello_;
+  // The end of the certificate selection callback.
+  absl::optional<MonotonicTime> certificate_selected_;
+  // The end of the SSL_do_handshake() call which wrote the signed server flight.
+  absl::optional<MonotonicTime> server_flight_;
+};
+
 class ContextImpl : public virtual Envoy::Ssl::Context {
 public:
   virtual bssl::UniquePtr<SSL> newSsl(absl::optional<std::string> override_server_name);
@@ -72,6 +100,31 @@ public:
   static bool dNSNameMatch(const std::string& dnsName, const char* pattern);
 
   SslStats& stats() { return stats_; }
+  TimeSource& timeSource() { return time_source_; }
+
+  /**
+   * @return the SSL ex_data index of the HandshakePhaseTimes of a server connection.
+   */
+  static int handshakePhaseTimesIndex();
+
+  /**
+   * @return the private key method providers used by the certificates of this context. Every
+   * connection created from this context must be registered with each of them.
+   */
+  std::vector<Envoy::Ssl::PrivateKeyMethodProviderSharedPtr> getPrivateKeyMethodProviders();
+
+  /**
+   * @return true if connections should try to offload their record layer to the kernel once the
+   * handshake has completed.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
+  /**
+   * @return the dynamic record sizing parameters of connections using this context, if enabled.
+   */
+  const absl::optional<Envoy::Ssl::DynamicRecordSizingConfig>& dynamicRecordSizing() const {
+    return dynamic_record_sizing_;
+  }
 
   // Ssl::Context
   size_t daysUntilFirstCertExpires() const override;
@@ -80,7 +133,7 @@ public:
 
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-              TimeSource& time_source);
+              CertificateCache& certificate_cache, TimeSource& time_source);
 
   /**
    * The global SSL-library index used for storing a pointer to the context
@@ -88,14 +141,16 @@ protected:
    */
   static int sslContextIndex();
 
-  // A X509_STORE_CTX_verify_cb callback for ignoring cert expiration in X509_verify_cert().
-  static int ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* store_ctx);
-
   // A SSL_CTX_set_cert_verify_callback for custom cert validation.
   static int verifyCallback(X509_STORE_CTX* store_ctx, void* arg);
 
   int verifyCertificate(X509* cert);
 
+  /**
+   * @return the time at which a verified peer certificate chain stops being valid.
+   */
+  SystemTime verifiedChainExpiry(X509_STORE_CTX* store_ctx, X509& cert) const;
+
   /**
    * Verifies certificate hash for pinning. The hash is a hex-encoded SHA-256 of the DER-encoded
    * certificate.
@@ -131,12 +186,14 @@ protected:
     // safely substituted via SSL_set_SSL_CTX() during the
     // SSL_CTX_set_select_certificate_cb() callback following ClientHello.
     bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+    CertificateCache::CertificateChainConstSharedPtr parsed_cert_chain_;
     bssl::UniquePtr<X509> cert_chain_;
     std::string cert_chain_file_path_;
     bool is_ecdsa_{};
+    Envoy::Ssl::PrivateKeyMethodProviderSharedPtr private_key_method_provider_{};
 
     std::string getCertChainFileName() const { return cert_chain_file_path_; };
-    void addClientValidationContext(const Envoy::Ssl::CertificateValidationContextConfig& config,
+    void addClientValidationContext(const CertificateCache::TrustedCa& trusted_ca,
                                     bool require_client_cert);
     bool isCipherEnabled(uint16_t cipher_id, uint16_t client_version);
   };
@@ -153,12 +210,17 @@ protected:
   Stats::Scope& scope_;
   SslStats stats_;
   std::vector<uint8_t> parsed_alpn_protocols_;
+  CertificateCache::TrustedCaConstSharedPtr trusted_ca_;
   bssl::UniquePtr<X509> ca_cert_;
   bssl::UniquePtr<X509> cert_chain_;
   std::string ca_file_path_;
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  bool kernel_tls_offload_;
+  absl::optional<Envoy::Ssl::DynamicRecordSizingConfig> dynamic_record_sizing_;
+  std::unique_ptr<CertVerifyCache> verify_cache_;
+  bool verify_allow_expired_{};
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -166,7 +228,7 @@ using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
 class ClientContextImpl : public ContextImpl, public Envoy::Ssl::ClientContext {
 public:
   ClientContextImpl(Stats::Scope& scope, const Envoy::Ssl::ClientContextConfig& config,
-                    TimeSource& time_source);
+                    CertificateCache& certificate_cache, TimeSource& time_source);
 
   bssl::UniquePtr<SSL> newSsl(absl::optional<std::string> override_server_name) override;
 
@@ -185,21 +247,27 @@ private:
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names,
+                    CertificateCache& certificate_cache, ServerSessionCache& session_cache,
+                    TimeSource& time_source);
 
 private:
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(SSL* ssl, const uint8_t* id, int id_len);
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   // Select the TLS certificate context in SSL_CTX_set_select_certificate_cb() callback with
   // ClientHello details.
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
   void generateHashForSessionContexId(const std::vector<std::string>& server_names,
+                                      bool require_client_certificate,
                                       uint8_t* session_context_buf, unsigned& session_context_len);
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  ServerSessionCache::SessionStateSharedPtr session_state_;
 };
 
 } // namespace Tls
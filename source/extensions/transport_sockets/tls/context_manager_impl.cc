@@ -30,7 +30,7 @@ ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
   }
 
   Envoy::Ssl::ClientContextSharedPtr context =
-      std::make_shared<ClientContextImpl>(scope, config, time_source_);
+      std::make_shared<ClientContextImpl>(scope, config, certificate_cache_, time_source_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -44,8 +44,8 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+  Envoy::Ssl::ServerContextSharedPtr context = std::make_shared<ServerContextImpl>(
+      scope, config, server_names, certificate_cache_, server_session_cache_, time_source_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -71,6 +71,14 @@ void ContextManagerImpl::iterateContexts(std::function<void(const Envoy::Ssl::Co
   }
 }
 
+std::string ContextManagerImpl::exportServerSessionState() {
+  return server_session_cache_.exportState();
+}
+
+bool ContextManagerImpl::importServerSessionState(const std::string& state) {
+  return server_session_cache_.importState(state);
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
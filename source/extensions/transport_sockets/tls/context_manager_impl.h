@@ -2,11 +2,15 @@
 
 #include <functional>
 #include <list>
+#include <string>
 
 #include "envoy/common/time.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
 
+#include "extensions/transport_sockets/tls/certificate_cache.h"
+#include "extensions/transport_sockets/tls/server_session_cache.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -21,7 +25,8 @@ namespace Tls {
  */
 class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
 public:
-  ContextManagerImpl(TimeSource& time_source) : time_source_(time_source) {}
+  ContextManagerImpl(TimeSource& time_source)
+      : time_source_(time_source), server_session_cache_(time_source) {}
   ~ContextManagerImpl();
 
   // Ssl::ContextManager
@@ -33,11 +38,15 @@ public:
                          const std::vector<std::string>& server_names) override;
   size_t daysUntilFirstCertExpires() const override;
   void iterateContexts(std::function<void(const Envoy::Ssl::Context&)> callback) override;
+  std::string exportServerSessionState() override;
+  bool importServerSessionState(const std::string& state) override;
 
 private:
   void removeEmptyContexts();
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
+  CertificateCache certificate_cache_;
+  ServerSessionCache server_session_cache_;
 };
 
 } // namespace Tls
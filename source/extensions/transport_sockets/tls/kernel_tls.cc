@@ -0,0 +1,219 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/tls.h>)
+#include <linux/tls.h>
+#define ENVOY_KERNEL_TLS 1
+#endif
+#endif
+
+#ifdef ENVOY_KERNEL_TLS
+// Older libc headers predate kTLS even when the kernel headers have it.
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TLS_GET_RECORD_TYPE
+#define TLS_GET_RECORD_TYPE 2
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#ifdef ENVOY_KERNEL_TLS
+namespace {
+
+// The TLS 1.2 implicit nonce ("salt") length of the AES-GCM cipher suites.
+constexpr size_t GcmSaltLength = 4;
+// Record types, and the payload of a warning level close_notify alert.
+constexpr uint8_t AlertRecordType = 21;
+constexpr uint8_t ApplicationDataRecordType = 23;
+constexpr uint8_t CloseNotifyAlert[] = {1, 0};
+constexpr uint8_t CloseNotifyDescription = 0;
+
+template <class CryptoInfo>
+bool installKeys(int fd, int direction, uint16_t cipher_type, const uint8_t* key,
+                 const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  static_assert(sizeof(info.rec_seq) == sizeof(uint64_t), "TLS sequence numbers are 64 bits");
+  for (int i = sizeof(info.rec_seq) - 1; i >= 0; i--) {
+    info.rec_seq[i] = sequence & 0xff;
+    sequence >>= 8;
+  }
+  // Like BoringSSL, use the record sequence number as the explicit part of the nonce. The
+  // kernel advances both together.
+  memcpy(info.iv, info.rec_seq, sizeof(info.iv));
+  return Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TLS, direction, &info, sizeof(info))
+             .rc_ == 0;
+}
+
+bool installDirection(int fd, int direction, int cipher_nid, const uint8_t* key,
+                      const uint8_t* salt, uint64_t sequence) {
+  if (cipher_nid == NID_aes_128_gcm) {
+    return installKeys<tls12_crypto_info_aes_gcm_128>(fd, direction, TLS_CIPHER_AES_GCM_128, key,
+                                                      salt, sequence);
+  }
+  return installKeys<tls12_crypto_info_aes_gcm_256>(fd, direction, TLS_CIPHER_AES_GCM_256, key,
+                                                    salt, sequence);
+}
+
+} // namespace
+
+bool KernelTls::compiledIn() { return true; }
+
+KernelTls::Offload KernelTls::enable(SSL* ssl, int fd) {
+  Offload offload;
+  if (SSL_version(ssl) != TLS1_2_VERSION) {
+    return offload;
+  }
+  const int cipher_nid = SSL_CIPHER_get_cipher_nid(SSL_get_current_cipher(ssl));
+  size_t key_length;
+  if (cipher_nid == NID_aes_128_gcm) {
+    key_length = 16;
+  } else if (cipher_nid == NID_aes_256_gcm) {
+    key_length = 32;
+  } else {
+    return offload;
+  }
+
+  // For AEAD cipher suites the key block has no MAC keys, so it is laid out as the client write
+  // key, the server write key, the client salt and the server salt.
+  const size_t key_block_length = SSL_get_key_block_len(ssl);
+  if (key_block_length != 2 * (key_length + GcmSaltLength)) {
+    return offload;
+  }
+  std::vector<uint8_t> key_block(key_block_length);
+  if (!SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return offload;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + key_length;
+  const uint8_t* client_salt = server_key + key_length;
+  const uint8_t* server_salt = client_salt + GcmSaltLength;
+  const bool is_server = SSL_is_server(ssl);
+
+  static const char ulp_name[] = "tls";
+  if (Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TCP, TCP_ULP, ulp_name, sizeof(ulp_name))
+          .rc_ != 0) {
+    // The kernel lacks kTLS or the tls module isn't loaded.
+    return offload;
+  }
+
+  // Until keys are installed, a socket with the tls ULP still behaves as a plain TCP socket, so
+  // a failure below leaves the connection usable from userspace.
+  offload.tx_ = installDirection(fd, TLS_TX, cipher_nid, is_server ? server_key : client_key,
+                                 is_server ? server_salt : client_salt,
+                                 SSL_get_write_sequence(ssl));
+  if (offload.tx_ && !SSL_has_pending(ssl)) {
+    offload.rx_ = installDirection(fd, TLS_RX, cipher_nid, is_server ? client_key : server_key,
+                                   is_server ? client_salt : server_salt,
+                                   SSL_get_read_sequence(ssl));
+  }
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return offload;
+}
+
+bool KernelTls::sendCloseNotify(int fd) {
+  char control[CMSG_SPACE(sizeof(AlertRecordType))];
+  memset(control, 0, sizeof(control));
+  iovec iov;
+  iov.iov_base = const_cast<uint8_t*>(CloseNotifyAlert);
+  iov.iov_len = sizeof(CloseNotifyAlert);
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(AlertRecordType));
+  *CMSG_DATA(cmsg) = AlertRecordType;
+
+  return Api::OsSysCallsSingleton::get().sendmsg(fd, &message, 0).rc_ ==
+         static_cast<ssize_t>(sizeof(CloseNotifyAlert));
+}
+
+KernelTls::ReadResult KernelTls::read(int fd, const Buffer::RawSlice& slice) {
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  memset(control, 0, sizeof(control));
+  iovec iov;
+  iov.iov_base = slice.mem_;
+  iov.iov_len = slice.len_;
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().recvmsg(fd, &message, 0);
+  if (result.rc_ < 0) {
+    // EIO and EBADMSG report records which failed to decrypt or authenticate.
+    return {result.errno_ == EAGAIN ? ReadStatus::WouldBlock : ReadStatus::Error, 0};
+  }
+  if (result.rc_ == 0) {
+    // The TCP stream ended without a close_notify, so the data may have been truncated.
+    return {ReadStatus::Error, 0};
+  }
+
+  // Without a record type, the kernel only hands over application data.
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (cmsg == nullptr || cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE) {
+    return {ReadStatus::Data, static_cast<uint64_t>(result.rc_)};
+  }
+  const uint8_t record_type = *CMSG_DATA(cmsg);
+  if (record_type == ApplicationDataRecordType) {
+    return {ReadStatus::Data, static_cast<uint64_t>(result.rc_)};
+  }
+  // An alert is a level byte followed by a description byte. The description alone tells a
+  // close_notify apart, whatever the level the peer chose.
+  if (record_type == AlertRecordType &&
+      result.rc_ == static_cast<ssize_t>(sizeof(CloseNotifyAlert)) &&
+      static_cast<const uint8_t*>(slice.mem_)[1] == CloseNotifyDescription) {
+    return {ReadStatus::CloseNotify, 0};
+  }
+  return {ReadStatus::Error, 0};
+}
+
+#else
+
+bool KernelTls::compiledIn() { return false; }
+
+KernelTls::Offload KernelTls::enable(SSL*, int) { return {}; }
+
+bool KernelTls::sendCloseNotify(int) { return false; }
+
+KernelTls::ReadResult KernelTls::read(int, const Buffer::RawSlice&) {
+  return {ReadStatus::Error, 0};
+}
+
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Kernel TLS (kTLS) offload. Once a handshake has completed, the negotiated record layer keys can
+ * be installed into the socket so that the kernel encrypts and decrypts the application data.
+ * The socket can then be written and read with plain writev()/readv() like a raw socket.
+ */
+class KernelTls {
+public:
+  /**
+   * The directions of a connection offloaded to the kernel.
+   */
+  struct Offload {
+    bool tx_{};
+    bool rx_{};
+  };
+
+  /**
+   * The outcome of a read from a socket whose receive direction has been offloaded.
+   */
+  enum class ReadStatus {
+    // Application data was read.
+    Data,
+    // Nothing can be read until the socket is readable again.
+    WouldBlock,
+    // The peer sent a close_notify alert, a clean end of the stream.
+    CloseNotify,
+    // The connection must be closed: a socket error such as ECONNRESET, a record the kernel
+    // failed to decrypt or authenticate, any alert other than close_notify, a handshake record
+    // (renegotiation isn't supported), or the end of the TCP stream without a close_notify.
+    Error,
+  };
+
+  struct ReadResult {
+    ReadStatus status_;
+    uint64_t bytes_read_;
+  };
+
+  /**
+   * @return bool whether kTLS support was compiled in. Kernel support is only known once a
+   *         socket is actually offloaded.
+   */
+  static bool compiledIn();
+
+  /**
+   * Offloads the record layer of an established connection to the kernel. Only TLS 1.2 with the
+   * AES-128-GCM and AES-256-GCM cipher suites is supported. The transmit direction is installed
+   * first; the receive direction is installed only if the transmit direction succeeded and
+   * BoringSSL holds no buffered records. A direction that could not be installed must continue
+   * to use SSL_read()/SSL_write().
+   * @param ssl supplies the connection, which must have completed the handshake.
+   * @param fd supplies the connection's socket.
+   * @return Offload the directions that were installed.
+   */
+  static Offload enable(SSL* ssl, int fd);
+
+  /**
+   * Sends a close_notify alert through the kernel record layer of a socket whose transmit
+   * direction has been offloaded.
+   * @param fd supplies the socket.
+   * @return bool whether the alert was sent.
+   */
+  static bool sendCloseNotify(int fd);
+
+  /**
+   * Reads from a socket whose receive direction has been offloaded. The kernel hands over one
+   * record type per read, along with the type, so application data is told apart from alerts and
+   * other control records.
+   * @param fd supplies the socket.
+   * @param slice supplies the memory to read application data into.
+   * @return ReadResult the outcome of the read, and the number of application data bytes read.
+   */
+  static ReadResult read(int fd, const Buffer::RawSlice& slice);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
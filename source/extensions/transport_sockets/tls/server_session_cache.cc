@@ -0,0 +1,286 @@
+#include "extensions/transport_sockets/tls/server_session_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+#include "common/common/assert.h"
+
+#include "source/extensions/transport_sockets/tls/server_session_state.pb.h"
+
+#include "openssl/rand.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+constexpr size_t ServerSessionCache::MaxSessions;
+constexpr size_t ServerSessionCache::NumShards;
+constexpr std::chrono::hours ServerSessionCache::TicketKeyRotationInterval;
+constexpr size_t ServerSessionCache::MaxExportBytes;
+constexpr size_t ServerSessionCache::SessionState::RetainedTicketKeyGenerations;
+
+namespace {
+
+Envoy::Ssl::ServerContextConfig::SessionTicketKey generateTicketKey() {
+  Envoy::Ssl::ServerContextConfig::SessionTicketKey key;
+  RELEASE_ASSERT(RAND_bytes(key.name_.data(), key.name_.size()) == 1, "");
+  RELEASE_ASSERT(RAND_bytes(key.hmac_key_.data(), key.hmac_key_.size()) == 1, "");
+  RELEASE_ASSERT(RAND_bytes(key.aes_key_.data(), key.aes_key_.size()) == 1, "");
+  return key;
+}
+
+int64_t toUnixSeconds(SystemTime time) {
+  return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+SystemTime fromUnixSeconds(int64_t seconds) { return SystemTime(std::chrono::seconds(seconds)); }
+
+template <size_t N> bool copyKeyBytes(const std::string& bytes, std::array<uint8_t, N>& out) {
+  if (bytes.size() != N) {
+    return false;
+  }
+  std::copy(bytes.begin(), bytes.end(), out.begin());
+  return true;
+}
+
+} // namespace
+
+ServerSessionCache::SessionState::SessionState(TimeSource& time_source, size_t max_sessions,
+                                               size_t num_shards)
+    : time_source_(time_source),
+      num_shards_(std::max<size_t>(1, std::min({num_shards, max_sessions, NumShards}))) {
+  ASSERT(max_sessions > 0);
+  // The first shards take the remainder, so that the shard capacities add up to max_sessions.
+  for (size_t i = 0; i < num_shards_; ++i) {
+    shards_[i].max_sessions_ =
+        max_sessions / num_shards_ + (i < max_sessions % num_shards_ ? 1 : 0);
+  }
+}
+
+void ServerSessionCache::SessionState::insertSession(absl::string_view id, std::string session,
+                                                     SystemTime expiry) {
+  Shard& s = shard(id);
+  absl::MutexLock lock(&s.mutex_);
+  auto it = s.sessions_.find(id);
+  if (it != s.sessions_.end()) {
+    s.lru_.erase(it->second.lru_position_);
+    s.sessions_.erase(it);
+  }
+  if (s.sessions_.size() >= s.max_sessions_) {
+    s.sessions_.erase(s.lru_.back());
+    s.lru_.pop_back();
+  }
+  s.lru_.emplace_front(id);
+  s.sessions_.emplace(s.lru_.front(), Session{std::move(session), expiry, s.lru_.begin()});
+}
+
+absl::optional<std::string> ServerSessionCache::SessionState::lookupSession(absl::string_view id) {
+  const SystemTime now = time_source_.systemTime();
+  Shard& s = shard(id);
+  absl::MutexLock lock(&s.mutex_);
+  auto it = s.sessions_.find(id);
+  if (it == s.sessions_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second.expiry_ <= now) {
+    s.lru_.erase(it->second.lru_position_);
+    s.sessions_.erase(it);
+    return absl::nullopt;
+  }
+  s.lru_.splice(s.lru_.begin(), s.lru_, it->second.lru_position_);
+  return it->second.data_;
+}
+
+const ServerSessionCache::SessionTicketKeys& ServerSessionCache::SessionState::ticketKeys() {
+  const SystemTime now = time_source_.systemTime();
+  const TicketKeys* keys = ticket_keys_.load(std::memory_order_acquire);
+  if (keys != nullptr && now - keys->rotated_ < TicketKeyRotationInterval) {
+    return keys->keys_;
+  }
+  if (keys == nullptr) {
+    // There is nothing to fall back to until the first keys exist.
+    absl::MutexLock lock(&ticket_keys_mutex_);
+    return rotateTicketKeys(now).keys_;
+  }
+  if (!ticket_keys_mutex_.TryLock()) {
+    // Another handshake is rotating the keys. The current ones remain valid meanwhile.
+    return keys->keys_;
+  }
+  const TicketKeys& rotated = rotateTicketKeys(now);
+  ticket_keys_mutex_.Unlock();
+  return rotated.keys_;
+}
+
+const ServerSessionCache::SessionState::TicketKeys&
+ServerSessionCache::SessionState::rotateTicketKeys(SystemTime now) {
+  const TicketKeys* current = ticket_keys_.load(std::memory_order_relaxed);
+  if (current != nullptr && now - current->rotated_ < TicketKeyRotationInterval) {
+    return *current;
+  }
+  auto keys = std::make_unique<TicketKeys>();
+  keys->keys_.push_back(generateTicketKey());
+  if (current != nullptr) {
+    // Tickets encrypted with the previous key are still accepted, and renewed.
+    keys->keys_.push_back(current->keys_.front());
+  }
+  keys->rotated_ = now;
+  publishTicketKeys(std::move(keys));
+  return *ticket_key_generations_.back();
+}
+
+void ServerSessionCache::SessionState::publishTicketKeys(TicketKeysConstPtr&& keys) {
+  ticket_keys_.store(keys.get(), std::memory_order_release);
+  ticket_key_generations_.push_back(std::move(keys));
+  if (ticket_key_generations_.size() > RetainedTicketKeyGenerations) {
+    ticket_key_generations_.pop_front();
+  }
+}
+
+bool ServerSessionCache::SessionState::expired() {
+  const SystemTime now = time_source_.systemTime();
+  bool sessions_expired = true;
+  for (size_t i = 0; i < num_shards_; ++i) {
+    Shard& s = shards_[i];
+    absl::MutexLock lock(&s.mutex_);
+    for (auto it = s.sessions_.begin(); it != s.sessions_.end();) {
+      if (it->second.expiry_ <= now) {
+        s.lru_.erase(it->second.lru_position_);
+        s.sessions_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    sessions_expired = sessions_expired && s.sessions_.empty();
+  }
+  // The current ticket key is retired after one rotation interval and dropped after two.
+  const TicketKeys* keys = ticket_keys_.load(std::memory_order_acquire);
+  const bool tickets_expired =
+      keys == nullptr || now - keys->rotated_ >= 2 * TicketKeyRotationInterval;
+  return sessions_expired && tickets_expired;
+}
+
+ServerSessionCache::ServerSessionCache(TimeSource& time_source, size_t max_sessions,
+                                       size_t num_shards)
+    : time_source_(time_source), max_sessions_(max_sessions), num_shards_(num_shards) {}
+
+ServerSessionCache::SessionStateSharedPtr
+ServerSessionCache::sessionState(absl::string_view session_id_context) {
+  removeExpiredStates();
+  SessionStateSharedPtr& state = states_[std::string(session_id_context)];
+  if (state == nullptr) {
+    state = std::make_shared<SessionState>(time_source_, max_sessions_, num_shards_);
+  }
+  return state;
+}
+
+void ServerSessionCache::removeExpiredStates() {
+  for (auto it = states_.begin(); it != states_.end();) {
+    if (it->second.use_count() == 1 && it->second->expired()) {
+      states_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::string ServerSessionCache::exportState(size_t max_bytes) {
+  removeExpiredStates();
+  const SystemTime now = time_source_.systemTime();
+  size_t shards_left = 0;
+  for (const auto& state_it : states_) {
+    shards_left += state_it.second->num_shards_;
+  }
+
+  envoy::extensions::transport_sockets::tls::ServerSessionState proto;
+  size_t bytes_left = max_bytes;
+  for (const auto& state_it : states_) {
+    SessionState& state = *state_it.second;
+    auto* entry = proto.add_entries();
+    entry->set_session_id_context(state_it.first);
+    const SessionState::TicketKeys* keys = state.ticket_keys_.load(std::memory_order_acquire);
+    if (keys != nullptr) {
+      for (const auto& key : keys->keys_) {
+        auto* key_proto = entry->add_ticket_keys();
+        key_proto->set_name(key.name_.data(), key.name_.size());
+        key_proto->set_hmac_key(key.hmac_key_.data(), key.hmac_key_.size());
+        key_proto->set_aes_key(key.aes_key_.data(), key.aes_key_.size());
+      }
+      entry->set_ticket_keys_rotated_unix_seconds(toUnixSeconds(keys->rotated_));
+    }
+
+    for (size_t i = 0; i < state.num_shards_; ++i) {
+      // Each shard gets an even share of what the previous shards left over.
+      size_t shard_bytes_left = bytes_left / shards_left--;
+      bytes_left -= shard_bytes_left;
+      SessionState::Shard& s = state.shards_[i];
+      absl::MutexLock lock(&s.mutex_);
+      for (const std::string& id : s.lru_) {
+        const SessionState::Session& session = s.sessions_.at(id);
+        if (session.expiry_ <= now) {
+          continue;
+        }
+        const size_t session_bytes = id.size() + session.data_.size();
+        if (session_bytes > shard_bytes_left) {
+          break;
+        }
+        shard_bytes_left -= session_bytes;
+        auto* session_proto = entry->add_sessions();
+        session_proto->set_id(id);
+        session_proto->set_session(session.data_);
+        session_proto->set_expiry_unix_seconds(toUnixSeconds(session.expiry_));
+      }
+      bytes_left += shard_bytes_left;
+    }
+  }
+  return proto.SerializeAsString();
+}
+
+bool ServerSessionCache::importState(const std::string& state) {
+  envoy::extensions::transport_sockets::tls::ServerSessionState proto;
+  if (!proto.ParseFromString(state)) {
+    return false;
+  }
+  for (const auto& entry : proto.entries()) {
+    if (states_.count(entry.session_id_context()) > 0) {
+      continue;
+    }
+    auto imported = std::make_shared<SessionState>(time_source_, max_sessions_, num_shards_);
+    if (!entry.ticket_keys().empty()) {
+      auto keys = std::make_unique<SessionState::TicketKeys>();
+      for (const auto& key_proto : entry.ticket_keys()) {
+        Envoy::Ssl::ServerContextConfig::SessionTicketKey key;
+        if (!copyKeyBytes(key_proto.name(), key.name_) ||
+            !copyKeyBytes(key_proto.hmac_key(), key.hmac_key_) ||
+            !copyKeyBytes(key_proto.aes_key(), key.aes_key_)) {
+          return false;
+        }
+        keys->keys_.push_back(key);
+      }
+      keys->rotated_ = fromUnixSeconds(entry.ticket_keys_rotated_unix_seconds());
+      absl::MutexLock lock(&imported->ticket_keys_mutex_);
+      imported->publishTicketKeys(std::move(keys));
+    }
+    for (const auto& session : entry.sessions()) {
+      SessionState::Shard& s = imported->shard(session.id());
+      absl::MutexLock lock(&s.mutex_);
+      if (s.sessions_.size() >= s.max_sessions_ || s.sessions_.count(session.id()) > 0) {
+        continue;
+      }
+      // Sessions are exported most recently used first, so each one goes after the previous.
+      s.lru_.push_back(session.id());
+      SessionState::Session& cached = s.sessions_[session.id()];
+      cached.data_ = session.session();
+      cached.expiry_ = fromUnixSeconds(session.expiry_unix_seconds());
+      cached.lru_position_ = std::prev(s.lru_.end());
+    }
+    states_.emplace(entry.session_id_context(), std::move(imported));
+  }
+  return true;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/ssl/context_config.h"
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Server session state that outlives the server contexts using it. Contexts with the same session
+ * id context, i.e. serving the same certificate names with the same client validation settings,
+ * share one SessionState, so a context rebuilt on an SDS or LDS update keeps resuming the sessions
+ * established through its predecessor. The most recently used part of the cache is handed over to
+ * the child process on hot restart.
+ *
+ * The cache itself is only used from the main thread, when contexts are created and on hot
+ * restart. A SessionState is used by all the workers handshaking with its contexts: its ticket keys
+ * are read without locking, and its sessions are spread over independently locked shards.
+ */
+class ServerSessionCache {
+public:
+  using SessionTicketKeys = std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey>;
+
+  // BoringSSL's default for the internal session cache of an SSL_CTX.
+  static constexpr size_t MaxSessions = 20 * 1024;
+  static constexpr size_t NumShards = 16;
+  // BoringSSL's default rotation interval for the session ticket keys it generates.
+  static constexpr std::chrono::hours TicketKeyRotationInterval{48};
+  // The most session bytes handed over on hot restart. Sessions carry the peer's certificate chain
+  // when clients are authenticated, so a full cache can take tens of megabytes.
+  static constexpr size_t MaxExportBytes = 4 * 1024 * 1024;
+
+  class SessionState {
+  public:
+    /**
+     * @param max_sessions supplies the maximum number of cached sessions, split as evenly as
+     *        possible between the shards.
+     * @param num_shards supplies the number of independently locked shards. Fewer are used when
+     *        max_sessions is smaller.
+     */
+    SessionState(TimeSource& time_source, size_t max_sessions, size_t num_shards);
+
+    /**
+     * Caches a session for session id resumption, evicting the least recently used session of
+     * its shard if the shard is full.
+     * @param id supplies the session id.
+     * @param session supplies the session serialized by SSL_SESSION_to_bytes().
+     * @param expiry supplies the time at which the session can no longer be resumed.
+     */
+    void insertSession(absl::string_view id, std::string session, SystemTime expiry);
+
+    /**
+     * Looks up a session and marks it most recently used. Expired sessions are dropped.
+     * @param id supplies the session id.
+     * @return the serialized session, if it is cached.
+     */
+    absl::optional<std::string> lookupSession(absl::string_view id);
+
+    /**
+     * @return the keys protecting session tickets when none are configured, the encryption key
+     *         first. The keys are generated on first use and rotated every
+     *         TicketKeyRotationInterval, keeping the previous key to decrypt older tickets. The
+     *         returned keys remain valid for at least two more rotation intervals.
+     */
+    const SessionTicketKeys& ticketKeys();
+
+  private:
+    friend class ServerSessionCache;
+
+    struct Session {
+      std::string data_;
+      SystemTime expiry_;
+      std::list<std::string>::iterator lru_position_;
+    };
+
+    struct Shard {
+      size_t max_sessions_{0};
+      absl::Mutex mutex_;
+      // Session ids, most recently used first.
+      std::list<std::string> lru_ GUARDED_BY(mutex_);
+      absl::flat_hash_map<std::string, Session> sessions_ GUARDED_BY(mutex_);
+    };
+
+    struct TicketKeys {
+      SessionTicketKeys keys_;
+      SystemTime rotated_;
+    };
+    using TicketKeysConstPtr = std::unique_ptr<const TicketKeys>;
+
+    // The number of key generations kept alive, so that a handshake still using keys which were
+    // just replaced never sees them freed.
+    static constexpr size_t RetainedTicketKeyGenerations = 3;
+
+    Shard& shard(absl::string_view id) {
+      return shards_[absl::Hash<absl::string_view>()(id) % num_shards_];
+    }
+    // Replaces the current keys, unless they were rotated concurrently.
+    // @return the current keys.
+    const TicketKeys& rotateTicketKeys(SystemTime now) EXCLUSIVE_LOCKS_REQUIRED(ticket_keys_mutex_);
+    void publishTicketKeys(TicketKeysConstPtr&& keys) EXCLUSIVE_LOCKS_REQUIRED(ticket_keys_mutex_);
+    // @return true if nothing established through this state can be resumed anymore.
+    bool expired();
+
+    TimeSource& time_source_;
+    const size_t num_shards_;
+    std::array<Shard, NumShards> shards_;
+    // The current keys. Handshakes only load this pointer, the keys are only written while held
+    // by ticket_keys_mutex_.
+    std::atomic<const TicketKeys*> ticket_keys_{nullptr};
+    absl::Mutex ticket_keys_mutex_;
+    // The current keys last.
+    std::list<TicketKeysConstPtr> ticket_key_generations_ GUARDED_BY(ticket_keys_mutex_);
+  };
+
+  using SessionStateSharedPtr = std::shared_ptr<SessionState>;
+
+  ServerSessionCache(TimeSource& time_source, size_t max_sessions = MaxSessions,
+                     size_t num_shards = NumShards);
+
+  /**
+   * @param session_id_context supplies the session id context of a server context.
+   * @return SessionStateSharedPtr the state shared by the contexts with this session id context.
+   */
+  SessionStateSharedPtr sessionState(absl::string_view session_id_context);
+
+  /**
+   * @param max_bytes supplies the most session bytes to export. The ticket keys are always
+   *        exported, and the most recently used sessions of each shard are exported until the
+   *        shard's share of max_bytes is spent.
+   * @return std::string the resumable state of all the session id contexts, serialized.
+   */
+  std::string exportState(size_t max_bytes = MaxExportBytes);
+
+  /**
+   * Adds state serialized by exportState(), typically in the parent process. State already held
+   * for a session id context is kept.
+   * @param state supplies the serialized state.
+   * @return false if the state could not be parsed.
+   */
+  bool importState(const std::string& state);
+
+private:
+  // Drops the states which are no longer used by any context and can't resume anything anymore.
+  void removeExpiredStates();
+
+  TimeSource& time_source_;
+  const size_t max_sessions_;
+  const size_t num_shards_;
+  absl::flat_hash_map<std::string, SessionStateSharedPtr> states_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -7,6 +7,7 @@
 #include "common/common/hex.h"
 #include "common/http/headers.h"
 
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -40,6 +41,10 @@ public:
   void onConnected() override {}
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
 };
+
+uint64_t microseconds(MonotonicTime::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
 } // namespace
 
 SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
@@ -48,11 +53,15 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
       ssl_(ctx_->newSsl(transport_socket_options != nullptr
                             ? transport_socket_options->serverNameOverride()
                             : absl::nullopt)) {
+  // A write that is retried after SSL_ERROR_WANT_WRITE passes the same data, but not necessarily
+  // from the same address, see recordData().
+  SSL_set_mode(ssl_.get(), SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
   if (state == InitialState::Client) {
     SSL_set_connect_state(ssl_.get());
   } else {
     ASSERT(state == InitialState::Server);
     SSL_set_accept_state(ssl_.get());
+    SSL_set_ex_data(ssl_.get(), ContextImpl::handshakePhaseTimesIndex(), &handshake_phase_times_);
   }
 }
 
@@ -60,10 +69,26 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
   ASSERT(!callbacks_);
   callbacks_ = &callbacks;
 
+  // Register for asynchronous private key operations. Completions are delivered on this
+  // connection's dispatcher.
+  private_key_method_providers_ = ctx_->getPrivateKeyMethodProviders();
+  for (auto& provider : private_key_method_providers_) {
+    provider->registerPrivateKeyMethod(ssl_.get(), *this, callbacks_->connection().dispatcher());
+  }
+
   BIO* bio = BIO_new_socket(callbacks_->ioHandle().fd(), 0);
   SSL_set_bio(ssl_.get(), bio, bio);
 }
 
+SslSocket::~SslSocket() { unregisterPrivateKeyMethods(); }
+
+void SslSocket::unregisterPrivateKeyMethods() {
+  for (auto& provider : private_key_method_providers_) {
+    provider->unregisterPrivateKeyMethod(ssl_.get());
+  }
+  private_key_method_providers_.clear();
+}
+
 SslSocket::ReadResult SslSocket::sslReadIntoSlice(Buffer::RawSlice& slice) {
   ReadResult result;
   uint8_t* mem = static_cast<uint8_t*>(slice.mem_);
@@ -98,6 +123,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (ktls_rx_) {
+    return kernelTlsRead(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -150,13 +179,91 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::kernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  bool keep_reading = true;
+  while (keep_reading) {
+    Buffer::RawSlice slice;
+    read_buffer.reserve(16384, &slice, 1);
+    const KernelTls::ReadResult result = KernelTls::read(callbacks_->ioHandle().fd(), slice);
+    switch (result.status_) {
+    case KernelTls::ReadStatus::Data:
+      ENVOY_CONN_LOG(trace, "ktls read returns: {}", callbacks_->connection(),
+                     result.bytes_read_);
+      slice.len_ = result.bytes_read_;
+      read_buffer.commit(&slice, 1);
+      bytes_read += result.bytes_read_;
+      if (callbacks_->shouldDrainReadBuffer()) {
+        callbacks_->setReadBufferReady();
+        keep_reading = false;
+      }
+      break;
+    case KernelTls::ReadStatus::WouldBlock:
+      keep_reading = false;
+      break;
+    case KernelTls::ReadStatus::CloseNotify:
+      // Like SSL_ERROR_ZERO_RETURN.
+      ENVOY_CONN_LOG(debug, "ktls read: close_notify", callbacks_->connection());
+      end_stream = true;
+      keep_reading = false;
+      break;
+    case KernelTls::ReadStatus::Error:
+      // A reset, a record which failed to decrypt or authenticate, a fatal alert or a truncated
+      // stream, none of which may look like a graceful half-close.
+      ENVOY_CONN_LOG(debug, "ktls read error", callbacks_->connection());
+      action = PostIoAction::Close;
+      keep_reading = false;
+      break;
+    }
+  }
+
+  return {action, bytes_read, end_stream};
+}
+
+void SslSocket::onPrivateKeyMethodComplete() {
+  ASSERT(async_handshake_in_progress_);
+  async_handshake_in_progress_ = false;
+
+  if (callbacks_->connection().state() != Network::Connection::State::Open) {
+    return;
+  }
+
+  // Resume the handshake. Any further socket I/O it needs is driven by the usual file events.
+  PostIoAction action = doHandshake();
+  if (action == PostIoAction::Close) {
+    ENVOY_CONN_LOG(debug, "async handshake completion error", callbacks_->connection());
+    callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+  } else if (handshake_complete_) {
+    // The peer may have sent application data while the operation was pending and the read event
+    // for it has already fired, so schedule another read. Data written before the handshake
+    // completed, e.g. by a client, is flushed by the connection once Connected has been raised.
+    callbacks_->setReadBufferReady();
+  }
+}
+
 PostIoAction SslSocket::doHandshake() {
   ASSERT(!handshake_complete_);
+  if (async_handshake_in_progress_) {
+    // Waiting for a private key operation; the handshake can't make progress until it completes.
+    return PostIoAction::KeepOpen;
+  }
+
+  const bool is_server = SSL_is_server(ssl_.get());
+  const MonotonicTime call_start = is_server ? ctx_->timeSource().monotonicTime() : MonotonicTime();
   int rc = SSL_do_handshake(ssl_.get());
+  if (is_server) {
+    recordHandshakePhases(call_start, rc);
+  }
   if (rc == 1) {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     handshake_complete_ = true;
+    unregisterPrivateKeyMethods();
     ctx_->logHandshake(ssl_.get());
+    if (ctx_->kernelTlsOffload()) {
+      enableKernelTls();
+    }
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -170,6 +277,9 @@ PostIoAction SslSocket::doHandshake() {
     case SSL_ERROR_WANT_READ:
     case SSL_ERROR_WANT_WRITE:
       return PostIoAction::KeepOpen;
+    case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
+      async_handshake_in_progress_ = true;
+      return PostIoAction::KeepOpen;
     default:
       drainErrorQueue();
       return PostIoAction::Close;
@@ -177,6 +287,55 @@ PostIoAction SslSocket::doHandshake() {
   }
 }
 
+void SslSocket::recordHandshakePhases(MonotonicTime call_start, int rc) {
+  HandshakePhaseTimes& times = handshake_phase_times_;
+  if (!times.certificate_selected_.has_value()) {
+    // The ClientHello hasn't been read yet.
+    return;
+  }
+
+  // Measured with the context's time source, as the certificate selection time is.
+  const MonotonicTime now = ctx_->timeSource().monotonicTime();
+  SslStats& stats = ctx_->stats();
+  if (!times.client_hello_.has_value()) {
+    // The certificate was selected during this call, which read the ClientHello.
+    times.client_hello_ = call_start;
+    stats.handshake_certificate_selection_us_.recordValue(
+        microseconds(times.certificate_selected_.value() - call_start));
+  }
+  if (!times.server_flight_.has_value()) {
+    const int err = rc == 1 ? SSL_ERROR_NONE : SSL_get_error(ssl_.get(), rc);
+    if (err == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+      // The signature is still being computed by a private key method provider.
+      return;
+    }
+    if (err != SSL_ERROR_NONE && err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+      // The handshake failed, possibly because the signature couldn't be computed, so there is no
+      // server flight to time.
+      return;
+    }
+    times.server_flight_ = now;
+    stats.handshake_signing_us_.recordValue(
+        microseconds(now - times.certificate_selected_.value()));
+  }
+  if (rc == 1) {
+    stats.handshake_finished_us_.recordValue(microseconds(now - times.server_flight_.value()));
+  }
+}
+
+void SslSocket::enableKernelTls() {
+  const KernelTls::Offload offload = KernelTls::enable(ssl_.get(), callbacks_->ioHandle().fd());
+  ktls_tx_ = offload.tx_;
+  ktls_rx_ = offload.rx_;
+  ENVOY_CONN_LOG(debug, "kernel TLS offload: tx={} rx={}", callbacks_->connection(), ktls_tx_,
+                 ktls_rx_);
+  if (ktls_tx_) {
+    ctx_->stats().ktls_offloaded_.inc();
+  } else {
+    ctx_->stats().ktls_unsupported_.inc();
+  }
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -213,12 +372,19 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (ktls_tx_) {
+    return kernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    if (write_buffer.length() > 0) {
+      updateRecordSizing();
+    }
+    bytes_to_write = std::min(write_buffer.length(), recordSize());
   }
 
   uint64_t total_bytes_written = 0;
@@ -228,15 +394,21 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
 
     // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
     // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
+    // data, since recordData() will return the same undrained data anyway.
     ASSERT(bytes_to_write <= write_buffer.length());
-    int rc = SSL_write(ssl_.get(), write_buffer.linearize(bytes_to_write), bytes_to_write);
+    const void* data = recordData(write_buffer, bytes_to_write);
+    int rc = SSL_write(ssl_.get(), data, bytes_to_write);
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
     if (rc > 0) {
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      if (ctx_->dynamicRecordSizing().has_value()) {
+        // Each call writes a single record.
+        ctx_->stats().write_record_size_.recordValue(rc);
+        small_record_bytes_written_ += rc;
+      }
+      bytes_to_write = std::min(write_buffer.length(), recordSize());
     } else {
       int err = SSL_get_error(ssl_.get(), rc);
       switch (err) {
@@ -261,14 +433,82 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+const void* SslSocket::recordData(const Buffer::Instance& write_buffer, uint64_t size) {
+  Buffer::RawSlice slice;
+  write_buffer.getRawSlices(&slice, 1);
+  if (slice.len_ >= size) {
+    return slice.mem_;
+  }
+  // Copy small slices into one record rather than linearizing the buffer, which would allocate
+  // a new slice and copy the data all the same.
+  if (record_buffer_.size() < size) {
+    record_buffer_.resize(size);
+  }
+  write_buffer.copyOut(0, size, record_buffer_.data());
+  return record_buffer_.data();
+}
+
+uint64_t SslSocket::recordSize() const {
+  const auto& sizing = ctx_->dynamicRecordSizing();
+  if (sizing.has_value() && small_record_bytes_written_ < sizing->small_record_bytes_) {
+    return sizing->initial_record_size_;
+  }
+  return MaxRecordSize;
+}
+
+void SslSocket::updateRecordSizing() {
+  const auto& sizing = ctx_->dynamicRecordSizing();
+  if (!sizing.has_value()) {
+    return;
+  }
+  // After an idle period the congestion window has likely shrunk again, so go back to records
+  // that fit in a single segment.
+  const MonotonicTime now = callbacks_->connection().dispatcher().timeSource().monotonicTime();
+  if (now - last_write_time_ >= sizing->idle_timeout_) {
+    small_record_bytes_written_ = 0;
+  }
+  last_write_time_ = now;
+}
+
+Network::IoResult SslSocket::kernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    // The kernel frames and encrypts the data, so the buffer is written without linearizing it.
+    Api::IoCallUint64Result result = write_buffer.write(callbacks_->ioHandle());
+    if (result.ok()) {
+      ENVOY_CONN_LOG(trace, "ktls write returns: {}", callbacks_->connection(), result.rc_);
+      total_bytes_written += result.rc_;
+    } else {
+      ENVOY_CONN_LOG(trace, "ktls write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        break;
+      }
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 
 void SslSocket::shutdownSsl() {
   ASSERT(handshake_complete_);
   if (!shutdown_sent_ && callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(ssl_.get());
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
+    if (ktls_tx_) {
+      // BoringSSL no longer owns the write side, so the alert has to go through the kernel.
+      const bool sent = KernelTls::sendCloseNotify(callbacks_->ioHandle().fd());
+      ENVOY_CONN_LOG(debug, "ktls shutdown: sent={}", callbacks_->connection(), sent);
+    } else {
+      int rc = SSL_shutdown(ssl_.get());
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
+    }
     shutdown_sent_ = true;
   }
 }
@@ -382,6 +622,10 @@ std::vector<std::string> SslSocket::dnsSansPeerCertificate() const {
 }
 
 void SslSocket::closeSocket(Network::ConnectionEvent) {
+  // Cancel any pending private key operation so that its completion is never delivered to a
+  // closed connection.
+  unregisterPrivateKeyMethods();
+
   // Attempt to send a shutdown before closing the socket. It's possible this won't go out if
   // there is no room on the socket. We can extend the state machine to handle this at some point
   // if needed.
@@ -2,10 +2,13 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_callbacks.h"
+#include "envoy/ssl/private_key_method_provider.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 
@@ -41,10 +44,12 @@ enum class InitialState { Client, Server };
 
 class SslSocket : public Network::TransportSocket,
                   public Envoy::Ssl::ConnectionInfo,
+                  public Envoy::Ssl::PrivateKeyConnectionCallbacks,
                   protected Logger::Loggable<Logger::Id::connection> {
 public:
   SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
             Network::TransportSocketOptionsSharedPtr transport_socket_options);
+  ~SslSocket() override;
 
   // Ssl::ConnectionInfo
   bool peerCertificatePresented() const override;
@@ -77,26 +82,54 @@ public:
   void onConnected() override;
   const Ssl::ConnectionInfo* ssl() const override { return this; }
 
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override;
+
   SSL* rawSslForTest() const { return ssl_.get(); }
 
 private:
+  // The maximum amount of application data in a TLS record.
+  static constexpr uint64_t MaxRecordSize = 16384;
+
   struct ReadResult {
     bool commit_slice_{};
     absl::optional<int> error_;
   };
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
+  Network::IoResult kernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult kernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
+  const void* recordData(const Buffer::Instance& write_buffer, uint64_t size);
+  uint64_t recordSize() const;
+  void updateRecordSizing();
 
   Network::PostIoAction doHandshake();
+  // Records the phase durations of a server handshake after a call to SSL_do_handshake().
+  void recordHandshakePhases(MonotonicTime call_start, int rc);
   void drainErrorQueue();
   void shutdownSsl();
+  void unregisterPrivateKeyMethods();
+  void enableKernelTls();
 
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   bssl::UniquePtr<SSL> ssl_;
   bool handshake_complete_{};
   bool shutdown_sent_{};
+  bool async_handshake_in_progress_{};
+  // Set once the corresponding direction of the record layer has been offloaded to the kernel.
+  bool ktls_tx_{};
+  bool ktls_rx_{};
   uint64_t bytes_to_retry_{};
+  // Dynamic record sizing state: bytes written since the connection was new or idle, and the time
+  // of the last write.
+  uint64_t small_record_bytes_written_{};
+  MonotonicTime last_write_time_{};
+  // Records whose data spans several buffer slices are gathered here. Only grown to the size of
+  // the largest such record, so connections that write from single slices never allocate it.
+  std::vector<uint8_t> record_buffer_;
+  HandshakePhaseTimes handshake_phase_times_;
   std::string failure_reason_;
+  std::vector<Envoy::Ssl::PrivateKeyMethodProviderSharedPtr> private_key_method_providers_;
   mutable std::string cached_sha_256_peer_certificate_digest_;
   mutable std::string cached_url_encoded_pem_encoded_peer_certificate_;
   mutable std::string cached_url_encoded_pem_encoded_peer_cert_chain_;
@@ -47,6 +47,17 @@ void ConnectionHandlerImpl::removeListeners(uint64_t listener_tag) {
   }
 }
 
+void ConnectionHandlerImpl::removeFilterChains(
+    uint64_t listener_tag, const std::vector<const Network::FilterChain*>& filter_chains) {
+  const absl::flat_hash_set<const Network::FilterChain*> filter_chain_set(filter_chains.begin(),
+                                                                          filter_chains.end());
+  for (auto& listener : listeners_) {
+    if (listener.second->listener_tag_ == listener_tag) {
+      listener.second->removeFilterChains(filter_chain_set);
+    }
+  }
+}
+
 void ConnectionHandlerImpl::stopListeners(uint64_t listener_tag) {
   for (auto& listener : listeners_) {
     if (listener.second->listener_tag_ == listener_tag) {
@@ -262,6 +273,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
   Network::ConnectionPtr new_connection =
       parent_.dispatcher_.createServerConnection(std::move(socket), std::move(transport_socket));
   new_connection->setBufferLimits(config_.perConnectionBufferLimitBytes());
+  config_.bindBufferMemoryAccounts(*new_connection);
 
   const bool empty_filter_chain = !config_.filterChainFactory().createNetworkFilterChain(
       *new_connection, filter_chain->networkFilterFactories());
@@ -272,26 +284,47 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
     return;
   }
 
-  onNewConnection(std::move(new_connection));
+  addConnection(std::move(new_connection), filter_chain);
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onNewConnection(
     Network::ConnectionPtr&& new_connection) {
+  addConnection(std::move(new_connection), nullptr);
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::addConnection(
+    Network::ConnectionPtr&& new_connection, const Network::FilterChain* filter_chain) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "new connection", *new_connection);
 
   // If the connection is already closed, we can just let this connection immediately die.
   if (new_connection->state() != Network::Connection::State::Closed) {
-    ActiveConnectionPtr active_connection(
-        new ActiveConnection(*this, std::move(new_connection), parent_.dispatcher_.timeSource()));
+    ActiveConnectionPtr active_connection(new ActiveConnection(
+        *this, std::move(new_connection), filter_chain, parent_.dispatcher_.timeSource()));
     active_connection->moveIntoList(std::move(active_connection), connections_);
     parent_.num_connections_++;
   }
 }
 
+void ConnectionHandlerImpl::ActiveTcpListener::removeFilterChains(
+    const absl::flat_hash_set<const Network::FilterChain*>& filter_chains) {
+  for (auto it = connections_.begin(); it != connections_.end();) {
+    // Closing the connection removes it from the list, so advance first.
+    ActiveConnection& active_connection = **it++;
+    if (filter_chains.count(active_connection.filter_chain_) != 0) {
+      active_connection.connection_->close(Network::ConnectionCloseType::NoFlush);
+    }
+  }
+
+  // The filter chains are destroyed once this returns, the closed connections' filters must not
+  // outlive them.
+  parent_.dispatcher_.clearDeferredDeleteList();
+}
+
 ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveTcpListener& listener,
                                                           Network::ConnectionPtr&& new_connection,
+                                                          const Network::FilterChain* filter_chain,
                                                           TimeSource& time_source)
-    : listener_(listener), connection_(std::move(new_connection)),
+    : listener_(listener), connection_(std::move(new_connection)), filter_chain_(filter_chain),
       conn_length_(new Stats::Timespan(listener_.stats_.downstream_cx_length_ms_, time_source)) {
   // We just universally set no delay on connections. Theoretically we might at some point want
   // to make this configurable.
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
@@ -19,6 +20,7 @@
 #include "common/common/linked_object.h"
 #include "common/common/non_copyable.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "spdlog/spdlog.h"
 
 namespace Envoy {
@@ -52,6 +54,8 @@ public:
   uint64_t numConnections() override { return num_connections_; }
   void addListener(Network::ListenerConfig& config) override;
   void removeListeners(uint64_t listener_tag) override;
+  void removeFilterChains(uint64_t listener_tag,
+                          const std::vector<const Network::FilterChain*>& filter_chains) override;
   void stopListeners(uint64_t listener_tag) override;
   void stopListeners() override;
   void disableListeners() override;
@@ -85,6 +89,13 @@ private:
 
     virtual ~ActiveListenerBase() = default;
 
+    /**
+     * Close the connections created by the given filter chains.
+     * @param filter_chains supplies the filter chains.
+     */
+    virtual void
+    removeFilterChains(const absl::flat_hash_set<const Network::FilterChain*>& filter_chains) PURE;
+
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     ListenerStats stats_;
@@ -117,6 +128,11 @@ private:
     // Network::UdpReadFilterCallbacks
     Network::UdpListener& udpListener() override;
 
+    // ActiveListenerBase
+    void removeFilterChains(const absl::flat_hash_set<const Network::FilterChain*>&) override {
+      // UDP listeners have no filter chains.
+    }
+
     Network::UdpListener* udp_listener_;
     Network::UdpListenerReadFilterPtr read_filter_;
   };
@@ -137,6 +153,10 @@ private:
                   bool hand_off_restored_destination_connections) override;
     void onNewConnection(Network::ConnectionPtr&& new_connection) override;
 
+    // ActiveListenerBase
+    void removeFilterChains(
+        const absl::flat_hash_set<const Network::FilterChain*>& filter_chains) override;
+
     /**
      * Remove and destroy an active connection.
      * @param connection supplies the connection to remove.
@@ -148,6 +168,14 @@ private:
      */
     void newConnection(Network::ConnectionSocketPtr&& socket);
 
+    /**
+     * Take ownership of a new connection.
+     * @param new_connection supplies the connection.
+     * @param filter_chain supplies the filter chain the connection was created by, if any.
+     */
+    void addConnection(Network::ConnectionPtr&& new_connection,
+                       const Network::FilterChain* filter_chain);
+
     std::list<ActiveSocketPtr> sockets_;
     std::list<ActiveConnectionPtr> connections_;
   };
@@ -159,7 +187,7 @@ private:
                             public Event::DeferredDeletable,
                             public Network::ConnectionCallbacks {
     ActiveConnection(ActiveTcpListener& listener, Network::ConnectionPtr&& new_connection,
-                     TimeSource& time_system);
+                     const Network::FilterChain* filter_chain, TimeSource& time_system);
     ~ActiveConnection() override;
 
     // Network::ConnectionCallbacks
@@ -175,6 +203,7 @@ private:
 
     ActiveTcpListener& listener_;
     Network::ConnectionPtr connection_;
+    const Network::FilterChain* const filter_chain_;
     Stats::TimespanPtr conn_length_;
   };
 
@@ -0,0 +1,173 @@
+#include "server/connection_memory_tracker.h"
+
+#include <algorithm>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Server {
+
+constexpr size_t ConnectionMemoryTracker::NumShards;
+
+std::vector<ConnectionMemoryUsage> ConnectionMemoryTracker::topConnections(uint64_t limit) const {
+  // Only the ids and balances are copied while the shards are locked, the addresses are copied
+  // afterwards for the connections which make the cut.
+  std::vector<ConnectionMemoryUsage> usages;
+  for (const Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    for (const ConnectionMemoryAccount* account : shard.accounts_) {
+      usages.push_back({account->connectionId(), nullptr, nullptr, account->balance()});
+    }
+  }
+
+  auto by_bytes = [](const ConnectionMemoryUsage& lhs, const ConnectionMemoryUsage& rhs) {
+    return lhs.bytes_ > rhs.bytes_;
+  };
+  if (limit < usages.size()) {
+    std::partial_sort(usages.begin(), usages.begin() + limit, usages.end(), by_bytes);
+    usages.resize(limit);
+  } else {
+    std::sort(usages.begin(), usages.end(), by_bytes);
+  }
+
+  absl::flat_hash_map<uint64_t, ConnectionMemoryUsage*> usages_by_id;
+  for (ConnectionMemoryUsage& usage : usages) {
+    usages_by_id.emplace(usage.connection_id_, &usage);
+  }
+  for (const Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    for (const ConnectionMemoryAccount* account : shard.accounts_) {
+      auto it = usages_by_id.find(account->connectionId());
+      if (it != usages_by_id.end()) {
+        const ConnectionMemoryUsage usage = account->usage();
+        it->second->local_address_ = usage.local_address_;
+        it->second->remote_address_ = usage.remote_address_;
+      }
+    }
+  }
+
+  // Drop the connections whose accounts were destroyed in the meantime.
+  usages.erase(std::remove_if(usages.begin(), usages.end(),
+                              [](const ConnectionMemoryUsage& usage) {
+                                return usage.remote_address_ == nullptr;
+                              }),
+               usages.end());
+  return usages;
+}
+
+ConnectionMemoryTracker::AccountList::iterator
+ConnectionMemoryTracker::add(const ConnectionMemoryAccount& account) {
+  Shard& account_shard = shard(account.connectionId());
+  absl::MutexLock lock(&account_shard.mutex_);
+  return account_shard.accounts_.insert(account_shard.accounts_.end(), &account);
+}
+
+void ConnectionMemoryTracker::remove(const ConnectionMemoryAccount& account,
+                                     AccountList::iterator it) {
+  Shard& account_shard = shard(account.connectionId());
+  absl::MutexLock lock(&account_shard.mutex_);
+  account_shard.accounts_.erase(it);
+}
+
+ConnectionMemoryAccountFactory::ConnectionMemoryAccountFactory(
+    ConnectionMemoryTrackerSharedPtr tracker,
+    const envoy::api::v2::Listener::ConnectionMemoryLimit& config, Stats::Scope& scope)
+    : tracker_(std::move(tracker)),
+      read_disable_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, read_disable_bytes, 0)),
+      close_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, close_bytes, 0)),
+      stats_({ALL_CONNECTION_MEMORY_STATS(POOL_COUNTER(scope))}) {}
+
+void ConnectionMemoryAccountFactory::bindAccounts(Network::Connection& connection) {
+  auto account = std::make_shared<ConnectionMemoryAccount>(*this, connection);
+  // The receive account is owned by the connection's account.
+  Buffer::BufferMemoryAccountSharedPtr receive_account(account, &account->receiveAccount());
+  connection.setBufferMemoryAccounts(std::move(receive_account), std::move(account));
+}
+
+ConnectionMemoryAccount::ConnectionMemoryAccount(ConnectionMemoryAccountFactory& parent,
+                                                 Network::Connection& connection)
+    : parent_(parent), connection_(&connection), tracker_(parent.tracker_),
+      connection_id_(connection.id()), local_address_(connection.localAddress()),
+      remote_address_(connection.remoteAddress()) {
+  tracker_it_ = tracker_->add(*this);
+  connection.addConnectionCallbacks(*this);
+}
+
+ConnectionMemoryAccount::~ConnectionMemoryAccount() { tracker_->remove(*this, tracker_it_); }
+
+void ConnectionMemoryAccount::charge(uint64_t amount) {
+  const uint64_t balance = balance_.load(std::memory_order_relaxed) + amount;
+  balance_.store(balance, std::memory_order_relaxed);
+
+  if (connection_ != nullptr && parent_.close_bytes_ > 0 && balance > parent_.close_bytes_ &&
+      close_timer_ == nullptr) {
+    // The charge comes from within a buffer operation of the connection or of one of its filters,
+    // so the connection is closed from the next event loop iteration instead.
+    ENVOY_CONN_LOG(debug, "closing connection: {} buffered bytes", *connection_, balance);
+    parent_.stats_.downstream_cx_memory_close_.inc();
+    close_timer_ = connection_->dispatcher().createTimer([this]() -> void { onCloseTimer(); });
+    close_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void ConnectionMemoryAccount::credit(uint64_t amount) {
+  ASSERT(balance_.load(std::memory_order_relaxed) >= amount);
+  balance_.store(balance_.load(std::memory_order_relaxed) - amount, std::memory_order_relaxed);
+}
+
+void ConnectionMemoryAccount::ReceiveAccount::charge(uint64_t amount) {
+  balance_ += amount;
+  parent_.charge(amount);
+  parent_.updateReadDisable();
+}
+
+void ConnectionMemoryAccount::ReceiveAccount::credit(uint64_t amount) {
+  ASSERT(balance_ >= amount);
+  balance_ -= amount;
+  parent_.credit(amount);
+  parent_.updateReadDisable();
+}
+
+void ConnectionMemoryAccount::updateReadDisable() {
+  if (connection_ == nullptr || parent_.read_disable_bytes_ == 0 ||
+      connection_->state() != Network::Connection::State::Open) {
+    return;
+  }
+
+  const uint64_t balance = receive_account_.balance();
+  if (!read_disabled_ && balance > parent_.read_disable_bytes_) {
+    ENVOY_CONN_LOG(debug, "disabling reads: {} received bytes buffered", *connection_, balance);
+    parent_.stats_.downstream_cx_memory_read_disable_.inc();
+    read_disabled_ = true;
+    connection_->readDisable(true);
+  } else if (read_disabled_ && balance < parent_.read_disable_bytes_ / 2) {
+    read_disabled_ = false;
+    connection_->readDisable(false);
+  }
+}
+
+void ConnectionMemoryAccount::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    connection_ = nullptr;
+    close_timer_.reset();
+  }
+}
+
+ConnectionMemoryUsage ConnectionMemoryAccount::usage() const {
+  return {connection_id_, local_address_, remote_address_, balance()};
+}
+
+void ConnectionMemoryAccount::onCloseTimer() {
+  if (connection_ != nullptr) {
+    connection_->close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
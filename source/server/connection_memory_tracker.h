@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/v2/lds.pb.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/connection.h"
+#include "envoy/server/listener_manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+#include "common/common/thread_annotations.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * All connection memory stats. @see stats_macros.h
+ */
+#define ALL_CONNECTION_MEMORY_STATS(COUNTER)                                                       \
+  COUNTER(downstream_cx_memory_close)                                                              \
+  COUNTER(downstream_cx_memory_read_disable)
+
+/**
+ * Struct definition for all connection memory stats. @see stats_macros.h
+ */
+struct ConnectionMemoryStats {
+  ALL_CONNECTION_MEMORY_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+class ConnectionMemoryAccount;
+
+/**
+ * Registry of the memory accounts of the downstream connections, shared by all the listeners and
+ * workers. The accounts are registered and unregistered by the workers, and listed by the admin.
+ * They are spread over shards by connection id, each with its own lock, so that the workers rarely
+ * contend when accepting and closing connections, and listing them only blocks one shard at a
+ * time.
+ */
+class ConnectionMemoryTracker : NonCopyable {
+public:
+  /**
+   * @see ListenerManager::topConnectionsByMemory().
+   */
+  std::vector<ConnectionMemoryUsage> topConnections(uint64_t limit) const;
+
+private:
+  friend class ConnectionMemoryAccount;
+
+  using AccountList = std::list<const ConnectionMemoryAccount*>;
+
+  struct Shard {
+    mutable absl::Mutex mutex_;
+    AccountList accounts_ GUARDED_BY(mutex_);
+  };
+
+  static constexpr size_t NumShards = 64;
+
+  Shard& shard(uint64_t connection_id) { return shards_[connection_id % NumShards]; }
+  AccountList::iterator add(const ConnectionMemoryAccount& account);
+  void remove(const ConnectionMemoryAccount& account, AccountList::iterator it);
+
+  std::array<Shard, NumShards> shards_;
+};
+
+using ConnectionMemoryTrackerSharedPtr = std::shared_ptr<ConnectionMemoryTracker>;
+
+/**
+ * Creates the memory accounts of the connections of a listener, and holds the limits and the
+ * stats they share.
+ */
+class ConnectionMemoryAccountFactory : NonCopyable {
+public:
+  ConnectionMemoryAccountFactory(
+      ConnectionMemoryTrackerSharedPtr tracker,
+      const envoy::api::v2::Listener::ConnectionMemoryLimit& config, Stats::Scope& scope);
+
+  /**
+   * Create the memory accounts of a new connection and set them with
+   * Network::Connection::setBufferMemoryAccounts().
+   */
+  void bindAccounts(Network::Connection& connection);
+
+private:
+  friend class ConnectionMemoryAccount;
+
+  const ConnectionMemoryTrackerSharedPtr tracker_;
+  // 0 if unlimited.
+  const uint64_t read_disable_bytes_;
+  const uint64_t close_bytes_;
+  ConnectionMemoryStats stats_;
+};
+
+using ConnectionMemoryAccountFactoryPtr = std::unique_ptr<ConnectionMemoryAccountFactory>;
+
+/**
+ * The memory account of a downstream connection. Once the connection's buffers hold more than the
+ * close limit, the connection is closed. Once its receive buffers hold more than the read disable
+ * limit, the connection stops reading until they hold less than half as many bytes. The receive
+ * buffers are charged to a nested account, which also charges this one.
+ *
+ * The account is charged and credited on the connection's worker thread. It can outlive the
+ * connection, in buffers destroyed after it, and then only keeps the balance up to date.
+ */
+class ConnectionMemoryAccount : public Buffer::BufferMemoryAccount,
+                                public Network::ConnectionCallbacks,
+                                NonCopyable,
+                                protected Logger::Loggable<Logger::Id::connection> {
+public:
+  ConnectionMemoryAccount(ConnectionMemoryAccountFactory& parent,
+                          Network::Connection& connection);
+  ~ConnectionMemoryAccount() override;
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  uint64_t balance() const override { return balance_.load(std::memory_order_relaxed); }
+
+  // Network::ConnectionCallbacks
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+  Buffer::BufferMemoryAccount& receiveAccount() { return receive_account_; }
+  uint64_t connectionId() const { return connection_id_; }
+  ConnectionMemoryUsage usage() const;
+
+private:
+  class ReceiveAccount : public Buffer::BufferMemoryAccount {
+  public:
+    explicit ReceiveAccount(ConnectionMemoryAccount& parent) : parent_(parent) {}
+
+    // Buffer::BufferMemoryAccount
+    void charge(uint64_t amount) override;
+    void credit(uint64_t amount) override;
+    uint64_t balance() const override { return balance_; }
+
+  private:
+    ConnectionMemoryAccount& parent_;
+    uint64_t balance_{0};
+  };
+
+  void updateReadDisable();
+  void onCloseTimer();
+
+  // Only used while the connection is open, which guarantees that the listener, and so the
+  // factory, still exist.
+  ConnectionMemoryAccountFactory& parent_;
+  Network::Connection* connection_;
+  const ConnectionMemoryTrackerSharedPtr tracker_;
+  const uint64_t connection_id_;
+  const Network::Address::InstanceConstSharedPtr local_address_;
+  const Network::Address::InstanceConstSharedPtr remote_address_;
+  ConnectionMemoryTracker::AccountList::iterator tracker_it_;
+  // Only written by the worker thread, atomic so that the admin can read it.
+  std::atomic<uint64_t> balance_{0};
+  ReceiveAccount receive_account_{*this};
+  Event::TimerPtr close_timer_;
+  bool read_disabled_{false};
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -29,10 +29,7 @@ void FilterChainManagerImpl::addFilterChain(
     const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
     const std::vector<std::string>& source_ips,
     const Protobuf::RepeatedField<Protobuf::uint32>& source_ports,
-    Network::TransportSocketFactoryPtr&& transport_socket_factory,
-    std::vector<Network::FilterFactoryCb> filters_factory) {
-  const auto filter_chain = std::make_shared<FilterChainImpl>(std::move(transport_socket_factory),
-                                                              std::move(filters_factory));
+    const Network::FilterChainSharedPtr& filter_chain) {
   addFilterChainForDestinationPorts(destination_ports_map_, destination_port, destination_ips,
                                     server_names, transport_protocol, application_protocols,
                                     source_type, source_ips, source_ports, filter_chain);
@@ -196,6 +193,19 @@ std::pair<T, std::vector<Network::Address::CidrRange>> makeCidrListEntry(const s
   return std::make_pair<T, std::vector<Network::Address::CidrRange>>(T(data), std::move(subnets));
 }
 
+// Return the entry of an IP map if it only has the catch-all one, which matches every IP address.
+// Trie lookups allocate their result, so they are skipped in that case, which is the common one
+// for listeners matching on server names only.
+template <class T>
+const T* catchAllOnlyEntry(const absl::flat_hash_map<std::string, T>& ips_map,
+                           const Network::Address::Instance& address) {
+  if (ips_map.size() != 1 || address.type() != Network::Address::Type::Ip) {
+    return nullptr;
+  }
+  const auto catch_all = ips_map.find(EMPTY_STRING);
+  return catch_all != ips_map.end() ? &catch_all->second : nullptr;
+}
+
 }; // namespace
 
 const Network::FilterChain*
@@ -206,28 +216,33 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
   if (address->type() == Network::Address::Type::Ip) {
     const auto port_match = destination_ports_map_.find(address->ip()->port());
     if (port_match != destination_ports_map_.end()) {
-      return findFilterChainForDestinationIP(*port_match->second.second, socket);
+      return findFilterChainForDestinationIP(port_match->second, socket);
     }
   }
 
   // Match on catch-all port 0.
   const auto port_match = destination_ports_map_.find(0);
   if (port_match != destination_ports_map_.end()) {
-    return findFilterChainForDestinationIP(*port_match->second.second, socket);
+    return findFilterChainForDestinationIP(port_match->second, socket);
   }
 
   return nullptr;
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinationIP(
-    const DestinationIPsTrie& destination_ips_trie, const Network::ConnectionSocket& socket) const {
+    const DestinationIPsPair& destination_ips, const Network::ConnectionSocket& socket) const {
   auto address = socket.localAddress();
+  const ServerNamesMapSharedPtr* catch_all = catchAllOnlyEntry(destination_ips.first, *address);
+  if (catch_all != nullptr) {
+    return findFilterChainForServerName(**catch_all, socket);
+  }
+
   if (address->type() != Network::Address::Type::Ip) {
     address = fakeAddress();
   }
 
   // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = destination_ips_trie.getData(address);
+  const auto& data = destination_ips.second->getData(address);
   if (!data.empty()) {
     ASSERT(data.size() == 1);
     return findFilterChainForServerName(*data.back(), socket);
@@ -238,7 +253,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
+  const absl::string_view server_name = socket.requestedServerName();
 
   // Match on exact server name, i.e. "www.example.com" for "www.example.com".
   const auto server_name_exact_match = server_names_map.find(server_name);
@@ -248,8 +263,8 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 
   // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
   size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
+  while (pos < server_name.size() - 1 && pos != absl::string_view::npos) {
+    const absl::string_view wildcard = server_name.substr(pos);
     const auto server_name_wildcard_match = server_names_map.find(wildcard);
     if (server_name_wildcard_match != server_names_map.end()) {
       return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
@@ -269,7 +284,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -325,11 +340,11 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceType
 
   if (is_local_connection) {
     if (!filter_chain_local.first.empty()) {
-      return findFilterChainForSourceIpAndPort(*filter_chain_local.second, socket);
+      return findFilterChainForSourceIpAndPort(filter_chain_local, socket);
     }
   } else {
     if (!filter_chain_external.first.empty()) {
-      return findFilterChainForSourceIpAndPort(*filter_chain_external.second, socket);
+      return findFilterChainForSourceIpAndPort(filter_chain_external, socket);
     }
   }
 
@@ -338,27 +353,35 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceType
                        FilterChainMatch_ConnectionSourceType_ANY];
 
   if (!filter_chain_any.first.empty()) {
-    return findFilterChainForSourceIpAndPort(*filter_chain_any.second, socket);
+    return findFilterChainForSourceIpAndPort(filter_chain_any, socket);
   } else {
     return nullptr;
   }
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceIpAndPort(
-    const SourceIPsTrie& source_ips_trie, const Network::ConnectionSocket& socket) const {
+    const SourceIPsPair& source_ips, const Network::ConnectionSocket& socket) const {
   auto address = socket.remoteAddress();
-  if (address->type() != Network::Address::Type::Ip) {
-    address = fakeAddress();
-  }
+  const SourcePortsMap* source_ports_map_ptr;
+  const SourcePortsMapSharedPtr* catch_all = catchAllOnlyEntry(source_ips.first, *address);
+  if (catch_all != nullptr) {
+    source_ports_map_ptr = catch_all->get();
+  } else {
+    if (address->type() != Network::Address::Type::Ip) {
+      address = fakeAddress();
+    }
 
-  // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = source_ips_trie.getData(address);
-  if (data.empty()) {
-    return nullptr;
+    // Match on both: exact IP and wider CIDR ranges using LcTrie.
+    const auto& data = source_ips.second->getData(address);
+    if (data.empty()) {
+      return nullptr;
+    }
+
+    ASSERT(data.size() == 1);
+    source_ports_map_ptr = data.back().get();
   }
 
-  ASSERT(data.size() == 1);
-  const auto& source_ports_map = *data.back();
+  const auto& source_ports_map = *source_ports_map_ptr;
   const uint32_t source_port = address->ip()->port();
   const auto port_match = source_ports_map.find(source_port);
 
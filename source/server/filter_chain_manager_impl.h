@@ -14,7 +14,10 @@ namespace Envoy {
 namespace Server {
 
 /**
- * Implementation of FilterChainManager.
+ * Implementation of FilterChainManager. The filter chains are added first, finishFilterChain()
+ * then compiles their matching rules into an index which isn't modified afterwards. The index only
+ * refers to the filter chains, so it can be built independently of the listener using it and
+ * shared with the workers while a replacement is being built.
  */
 class FilterChainManagerImpl : public Network::FilterChainManager,
                                Logger::Loggable<Logger::Id::config> {
@@ -30,8 +33,7 @@ public:
                  const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
                  const std::vector<std::string>& source_ips,
                  const Protobuf::RepeatedField<Protobuf::uint32>& source_ports,
-                 Network::TransportSocketFactoryPtr&& transport_socket_factory,
-                 std::vector<Network::FilterFactoryCb> filters_factory);
+                 const Network::FilterChainSharedPtr& filter_chain);
   void finishFilterChain() { convertIPsToTries(); }
   static bool isWildcardServerName(const std::string& name);
 
@@ -42,7 +44,8 @@ private:
   using SourceIPsMap = absl::flat_hash_map<std::string, SourcePortsMapSharedPtr>;
   using SourceIPsTrie = Network::LcTrie::LcTrie<SourcePortsMapSharedPtr>;
   using SourceIPsTriePtr = std::unique_ptr<SourceIPsTrie>;
-  using SourceTypesArray = std::array<std::pair<SourceIPsMap, SourceIPsTriePtr>, 3>;
+  using SourceIPsPair = std::pair<SourceIPsMap, SourceIPsTriePtr>;
+  using SourceTypesArray = std::array<SourceIPsPair, 3>;
   using ApplicationProtocolsMap = absl::flat_hash_map<std::string, SourceTypesArray>;
   using TransportProtocolsMap = absl::flat_hash_map<std::string, ApplicationProtocolsMap>;
   // Both exact server names and wildcard domains are part of the same map, in which wildcard
@@ -53,8 +56,8 @@ private:
   using DestinationIPsMap = absl::flat_hash_map<std::string, ServerNamesMapSharedPtr>;
   using DestinationIPsTrie = Network::LcTrie::LcTrie<ServerNamesMapSharedPtr>;
   using DestinationIPsTriePtr = std::unique_ptr<DestinationIPsTrie>;
-  using DestinationPortsMap =
-      absl::flat_hash_map<uint16_t, std::pair<DestinationIPsMap, DestinationIPsTriePtr>>;
+  using DestinationIPsPair = std::pair<DestinationIPsMap, DestinationIPsTriePtr>;
+  using DestinationPortsMap = absl::flat_hash_map<uint16_t, DestinationIPsPair>;
 
   void addFilterChainForDestinationPorts(
       DestinationPortsMap& destination_ports_map, uint16_t destination_port,
@@ -100,7 +103,7 @@ private:
                                     const Network::FilterChainSharedPtr& filter_chain);
 
   const Network::FilterChain*
-  findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
+  findFilterChainForDestinationIP(const DestinationIPsPair& destination_ips,
                                   const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
   findFilterChainForServerName(const ServerNamesMap& server_names_map,
@@ -116,7 +119,7 @@ private:
                                 const Network::ConnectionSocket& socket) const;
 
   const Network::FilterChain*
-  findFilterChainForSourceIpAndPort(const SourceIPsTrie& source_ips_trie,
+  findFilterChainForSourceIpAndPort(const SourceIPsPair& source_ips,
                                     const Network::ConnectionSocket& socket) const;
 
   // Mapping of FilterChain's configured destination ports, IPs, server names, transport protocols
@@ -124,6 +127,8 @@ private:
   DestinationPortsMap destination_ports_map_;
 };
 
+using FilterChainManagerImplSharedPtr = std::shared_ptr<FilterChainManagerImpl>;
+
 class FilterChainImpl : public Network::FilterChain {
 public:
   FilterChainImpl(Network::TransportSocketFactoryPtr&& transport_socket_factory,
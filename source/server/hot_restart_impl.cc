@@ -135,6 +135,10 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   return response;
 }
 
+std::string HotRestartImpl::getParentTlsSessionState() {
+  return as_child_.getParentTlsSessionState();
+}
+
 void HotRestartImpl::shutdown() { as_parent_.shutdown(); }
 
 std::string HotRestartImpl::version() { return hotRestartVersion(); }
@@ -47,6 +47,23 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   return wrapped_reply;
 }
 
+std::string HotRestartingChild::getParentTlsSessionState() {
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return "";
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_tls_sessions();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  // A parent predating the session handover doesn't recognize the request, start afresh then.
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kTlsSessions)) {
+    return "";
+  }
+  return wrapped_reply->reply().tls_sessions().state();
+}
+
 void HotRestartingChild::drainParentListeners() {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return;
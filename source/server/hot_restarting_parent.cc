@@ -56,6 +56,11 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kTlsSessions: {
+      sendHotRestartMessage(child_address_, internal_->exportTlsSessionsToChild());
+      break;
+    }
+
     case HotRestartMessage::Request::kDrainListeners: {
       internal_->drainListeners();
       break;
@@ -124,6 +129,13 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
+HotRestartMessage HotRestartingParent::Internal::exportTlsSessionsToChild() {
+  HotRestartMessage wrapped_reply;
+  wrapped_reply.mutable_reply()->mutable_tls_sessions()->set_state(
+      server_->sslContextManager().exportServerSessionState());
+  return wrapped_reply;
+}
+
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
 } // namespace Server
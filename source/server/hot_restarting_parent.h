@@ -30,6 +30,8 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Return value is the response to return to the child.
+    envoy::HotRestartMessage exportTlsSessionsToChild();
     void drainListeners();
 
   private:
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <limits>
 #include <regex>
 #include <string>
 #include <unordered_map>
@@ -53,6 +54,8 @@
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -140,6 +143,9 @@ const char AdminHtmlEnd[] = R"(
 
 const std::regex PromRegex("[^a-zA-Z0-9_]");
 
+// Maximum number of metrics formatted per dispatcher iteration by the /stats handlers.
+constexpr uint64_t StatsChunkSize = 1000;
+
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.insertStatus().value(std::to_string(enumToInt(code)));
   const auto& headers = Http::Headers::get();
@@ -169,6 +175,13 @@ absl::optional<std::string> formatParam(Http::Utility::QueryParams params) {
                                                  : absl::nullopt;
 }
 
+// Helper method to get the metric filter from the usedonly, prefix and filter parameters
+StatsFilter statsFilterParams(const Http::Utility::QueryParams& params) {
+  const auto prefix = params.find("prefix");
+  return StatsFilter(params.find("usedonly") != params.end(),
+                     prefix != params.end() ? prefix->second : EMPTY_STRING, filterParam(params));
+}
+
 // Helper method that ensures that we've setting flags based on all the health flag values on the
 // host.
 void setHealthFlag(Upstream::Host::HealthFlag flag, const Upstream::Host& host,
@@ -239,11 +252,25 @@ Http::FilterTrailersStatus AdminFilter::decodeTrailers(Http::HeaderMap&) {
 }
 
 void AdminFilter::onDestroy() {
+  if (watermark_callbacks_added_) {
+    callbacks_->removeDownstreamWatermarkCallbacks(*this);
+  }
+  next_chunk_timer_.reset();
+  next_chunk_ = nullptr;
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
 }
 
+void AdminFilter::onAboveWriteBufferHighWatermark() { high_watermark_count_++; }
+
+void AdminFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ == 0 && next_chunk_ != nullptr) {
+    next_chunk_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
 void AdminFilter::addOnDestroyCallback(std::function<void()> cb) {
   on_destroy_callbacks_.push_back(std::move(cb));
 }
@@ -662,6 +689,33 @@ Http::Code AdminImpl::handlerMemory(absl::string_view, Http::HeaderMap& response
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerMemoryConnections(absl::string_view url,
+                                               Http::HeaderMap& response_headers,
+                                               Buffer::Instance& response, AdminStream&) {
+  const Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  uint64_t limit = 10;
+  const auto limit_param = query_params.find("limit");
+  if (limit_param != query_params.end() && !absl::SimpleAtoi(limit_param->second, &limit)) {
+    response.add("usage: /memory/connections?limit=<number of connections>\n");
+    return Http::Code::BadRequest;
+  }
+
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v2alpha::ConnectionsMemory connections;
+  const std::vector<ConnectionMemoryUsage> usages =
+      server_.listenerManager().topConnectionsByMemory(limit);
+  for (const ConnectionMemoryUsage& usage : usages) {
+    envoy::admin::v2alpha::ConnectionMemory& connection = *connections.add_connections();
+    connection.set_id(usage.connection_id_);
+    connection.set_local_address(usage.local_address_->asString());
+    connection.set_remote_address(usage.remote_address_->asString());
+    connection.set_bytes(usage.bytes_);
+  }
+  response.add(MessageUtil::getJsonStringFromMessage(connections, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerResetCounters(absl::string_view, Http::HeaderMap&,
                                            Buffer::Instance& response, AdminStream&) {
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
@@ -721,34 +775,49 @@ Http::Code AdminImpl::handlerReady(absl::string_view, Http::HeaderMap&, Buffer::
   return code;
 }
 
+bool StatsFilter::shouldShowMetric(const Stats::Metric& metric) const {
+  if (used_only_ && !metric.used()) {
+    return false;
+  }
+  if (prefix_.empty() && !regex_.has_value()) {
+    return true;
+  }
+  bool matches = false;
+  metric.constSymbolTable().callWithStringView(
+      metric.statName(), [this, &matches](absl::string_view name) { matches = matchesName(name); });
+  return matches;
+}
+
+bool StatsFilter::matchesName(absl::string_view name) const {
+  return absl::StartsWith(name, prefix_) &&
+         (!regex_.has_value() || std::regex_search(name.begin(), name.end(), regex_.value()));
+}
+
 Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& response_headers,
                                    Buffer::Instance& response, AdminStream& admin_stream) {
   Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
-
-  const bool used_only = params.find("usedonly") != params.end();
-  const absl::optional<std::regex> regex = filterParam(params);
-
-  std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
-    if (shouldShowMetric(counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
-    }
-  }
-
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
-    if (shouldShowMetric(gauge, used_only, regex)) {
-      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-      all_stats.emplace(gauge->name(), gauge->value());
-    }
-  }
+  const StatsFilter filter = statsFilterParams(params);
 
   if (const auto format_value = formatParam(params)) {
     if (format_value.value() == "json") {
+      std::map<std::string, uint64_t> all_stats;
+      for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+        if (filter.shouldShowMetric(*counter)) {
+          all_stats.emplace(counter->name(), counter->value());
+        }
+      }
+
+      for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+        if (filter.shouldShowMetric(*gauge)) {
+          ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+          all_stats.emplace(gauge->name(), gauge->value());
+        }
+      }
+
       response_headers.insertContentType().value().setReference(
           Http::Headers::get().ContentTypeValues.Json);
-      response.add(
-          AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
+      response.add(AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), filter));
     } else if (format_value.value() == "prometheus") {
       return handlerPrometheusStats(url, response_headers, response, admin_stream);
     } else {
@@ -757,36 +826,95 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
       rc = Http::Code::NotFound;
     }
   } else { // Display plain stats if format query param is not there.
-    for (const auto& stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
-    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
-    // multimap here. This makes sure that duplicate histograms get output. When shared storage is
-    // implemented this can be switched back to a normal map.
-    std::multimap<std::string, std::string> all_histograms;
-    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
-      if (shouldShowMetric(histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
-      }
-    }
-    for (const auto& histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
+    auto formatter = std::make_shared<StatsTextFormatter>(
+        server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(),
+        server_.stats().constSymbolTable(), filter);
+    if (formatter->nextChunk(response, StatsChunkSize)) {
+      admin_stream.setNextChunkCallback([formatter](Buffer::Instance& chunk) -> bool {
+        return formatter->nextChunk(chunk, StatsChunkSize);
+      });
     }
   }
   return rc;
 }
 
 Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, Http::HeaderMap&,
-                                             Buffer::Instance& response, AdminStream&) {
+                                             Buffer::Instance& response,
+                                             AdminStream& admin_stream) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
-  const bool used_only = params.find("usedonly") != params.end();
-  const absl::optional<std::regex> regex = filterParam(params);
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only,
-                                              regex);
+  auto formatter = std::make_shared<PrometheusStatsFormatter>(
+      server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(),
+      statsFilterParams(params));
+  if (formatter->nextChunk(response, StatsChunkSize)) {
+    admin_stream.setNextChunkCallback([formatter](Buffer::Instance& chunk) -> bool {
+      return formatter->nextChunk(chunk, StatsChunkSize);
+    });
+  }
   return Http::Code::OK;
 }
 
+StatsTextFormatter::StatsTextFormatter(
+    const std::vector<Stats::CounterSharedPtr>& counters,
+    const std::vector<Stats::GaugeSharedPtr>& gauges,
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+    const Stats::SymbolTable& symbol_table, const StatsFilter& filter) {
+  for (const Stats::CounterSharedPtr& counter : counters) {
+    if (filter.shouldShowMetric(*counter)) {
+      stats_.emplace_back(counter, counter->value());
+    }
+  }
+  for (const Stats::GaugeSharedPtr& gauge : gauges) {
+    if (filter.shouldShowMetric(*gauge)) {
+      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+      stats_.emplace_back(gauge, gauge->value());
+    }
+  }
+  for (const Stats::ParentHistogramSharedPtr& histogram : histograms) {
+    if (filter.shouldShowMetric(*histogram)) {
+      histograms_.push_back(histogram);
+    }
+  }
+
+  // Counters and gauges share one sorted list. If a counter and gauge have the same name only the
+  // counter, which was added first, is output.
+  const Stats::StatNameLessThan less_than(symbol_table);
+  std::stable_sort(stats_.begin(), stats_.end(), [&less_than](const auto& a, const auto& b) {
+    return less_than(a.first->statName(), b.first->statName());
+  });
+  stats_.erase(std::unique(stats_.begin(), stats_.end(),
+                           [](const auto& a, const auto& b) {
+                             return a.first->statName() == b.first->statName();
+                           }),
+               stats_.end());
+  std::stable_sort(histograms_.begin(), histograms_.end(),
+                   [&less_than](const Stats::ParentHistogramSharedPtr& a,
+                                const Stats::ParentHistogramSharedPtr& b) {
+                     return less_than(a->statName(), b->statName());
+                   });
+}
+
+bool StatsTextFormatter::nextChunk(Buffer::Instance& response, uint64_t max_metrics) {
+  fmt::memory_buffer line;
+  for (; max_metrics > 0 && next_stat_ < stats_.size(); max_metrics--, next_stat_++) {
+    const auto& stat = stats_[next_stat_];
+    fmt::format_to(line, "{}: {}\n", stat.first->name(), stat.second);
+  }
+  for (; max_metrics > 0 && next_histogram_ < histograms_.size();
+       max_metrics--, next_histogram_++) {
+    // Histogram summaries are only computed as they are output.
+    const Stats::ParentHistogram& histogram = *histograms_[next_histogram_];
+    fmt::format_to(line, "{}: {}\n", histogram.name(), histogram.quantileSummary());
+  }
+  response.add(line.data(), line.size());
+  return next_stat_ < stats_.size() || next_histogram_ < histograms_.size();
+}
+
+PrometheusStatsFormatter::PrometheusStatsFormatter(
+    std::vector<Stats::CounterSharedPtr> counters, std::vector<Stats::GaugeSharedPtr> gauges,
+    std::vector<Stats::ParentHistogramSharedPtr> histograms, const StatsFilter& filter)
+    : counters_(std::move(counters)), gauges_(std::move(gauges)),
+      histograms_(std::move(histograms)), filter_(filter) {}
+
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
@@ -818,78 +946,132 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only, const absl::optional<std::regex>& regex) {
-  std::unordered_set<std::string> metric_type_tracker;
-  for (const auto& counter : counters) {
-    if (!shouldShowMetric(counter, used_only, regex)) {
-      continue;
-    }
+  PrometheusStatsFormatter formatter(counters, gauges, histograms,
+                                     StatsFilter(used_only, EMPTY_STRING, regex));
+  while (formatter.nextChunk(response, std::numeric_limits<uint64_t>::max())) {
+  }
+  return formatter.metricTypes();
+}
 
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} counter\n", metric_name));
+bool PrometheusStatsFormatter::nextChunk(Buffer::Instance& response, uint64_t max_metrics) {
+  for (; max_metrics > 0 && next_counter_ < counters_.size(); max_metrics--, next_counter_++) {
+    const Stats::Counter& counter = *counters_[next_counter_];
+    if (filter_.shouldShowMetric(counter)) {
+      formatCounter(counter, response);
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter->value()));
   }
-
-  for (const auto& gauge : gauges) {
-    if (!shouldShowMetric(gauge, used_only, regex)) {
-      continue;
+  for (; max_metrics > 0 && next_gauge_ < gauges_.size(); max_metrics--, next_gauge_++) {
+    const Stats::Gauge& gauge = *gauges_[next_gauge_];
+    if (filter_.shouldShowMetric(gauge)) {
+      formatGauge(gauge, response);
     }
-
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
+  }
+  for (; max_metrics > 0 && next_histogram_ < histograms_.size();
+       max_metrics--, next_histogram_++) {
+    const Stats::ParentHistogram& histogram = *histograms_[next_histogram_];
+    if (filter_.shouldShowMetric(histogram)) {
+      formatHistogram(histogram, response);
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge->value()));
   }
+  return next_counter_ < counters_.size() || next_gauge_ < gauges_.size() ||
+         next_histogram_ < histograms_.size();
+}
 
-  for (const auto& histogram : histograms) {
-    if (!shouldShowMetric(histogram, used_only, regex)) {
-      continue;
-    }
+const std::string& PrometheusStatsFormatter::metricTypeName(const Stats::Metric& metric,
+                                                            absl::string_view type,
+                                                            Buffer::Instance& response) {
+  const Stats::StatName tag_extracted_name = metric.tagExtractedStatName();
+  const auto it = metric_names_.find(tag_extracted_name);
+  if (it != metric_names_.end()) {
+    return *it->second;
+  }
 
-    const std::string tags = formattedTags(histogram->tags());
-    const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+  // Different extracted names may sanitize to the same metric name, which only gets one TYPE.
+  const auto inserted = metric_type_tracker_.insert(metricName(metric.tagExtractedName()));
+  const std::string& metric_name = *inserted.first;
+  if (inserted.second) {
+    line_.clear();
+    fmt::format_to(line_, "# TYPE {0} {1}\n", metric_name, type);
+    response.add(line_.data(), line_.size());
+  }
+  metric_names_.emplace(tag_extracted_name, &metric_name);
+  return metric_name;
+}
 
-    const std::string metric_name = metricName(histogram->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
+void PrometheusStatsFormatter::formatTags(const Stats::Metric& metric) {
+  tags_.clear();
+  const Stats::SymbolTable& symbol_table = metric.constSymbolTable();
+  metric.iterateTagStatNames([this, &symbol_table](Stats::StatName name,
+                                                   Stats::StatName value) -> bool {
+    auto it = tag_names_.find(name);
+    if (it == tag_names_.end()) {
+      it = tag_names_.emplace(name, sanitizeName(symbol_table.toString(name))).first;
     }
-
-    const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
-    const std::vector<double>& supported_buckets = stats.supportedBuckets();
-    const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
-    for (size_t i = 0; i < supported_buckets.size(); ++i) {
-      double bucket = supported_buckets[i];
-      uint64_t value = computed_buckets[i];
-      // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
-      // doesn't have a specific modifier to format as a fixed-point value only so we use the
-      // 'g' operator which prints the number in general fixed point format or scientific format
-      // with precision 50 to round the number up to 32 significant digits in fixed point format
-      // which should cover pretty much all cases
-      response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
-                               bucket, value));
+    if (tags_.size() > 0) {
+      tags_.push_back(',');
     }
+    auto value_it = tag_values_.find(value);
+    if (value_it == tag_values_.end()) {
+      value_it = tag_values_.emplace(value, symbol_table.toString(value)).first;
+    }
+    fmt::format_to(tags_, "{}=\"{}\"", it->second, value_it->second);
+    return true;
+  });
+}
 
-    response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
-                             stats.sampleCount()));
-    response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
-    response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
+void PrometheusStatsFormatter::formatCounter(const Stats::Counter& counter,
+                                             Buffer::Instance& response) {
+  const std::string& metric_name = metricTypeName(counter, "counter", response);
+  formatTags(counter);
+  line_.clear();
+  fmt::format_to(line_, "{0}{{{1}}} {2}\n", metric_name,
+                 fmt::string_view(tags_.data(), tags_.size()), counter.value());
+  response.add(line_.data(), line_.size());
+}
+
+void PrometheusStatsFormatter::formatGauge(const Stats::Gauge& gauge, Buffer::Instance& response) {
+  const std::string& metric_name = metricTypeName(gauge, "gauge", response);
+  formatTags(gauge);
+  line_.clear();
+  fmt::format_to(line_, "{0}{{{1}}} {2}\n", metric_name,
+                 fmt::string_view(tags_.data(), tags_.size()), gauge.value());
+  response.add(line_.data(), line_.size());
+}
+
+void PrometheusStatsFormatter::formatHistogram(const Stats::ParentHistogram& histogram,
+                                               Buffer::Instance& response) {
+  const std::string& metric_name = metricTypeName(histogram, "histogram", response);
+  formatTags(histogram);
+  const fmt::string_view tags(tags_.data(), tags_.size());
+  const char* hist_tags_separator = tags.size() == 0 ? "" : ",";
+
+  line_.clear();
+  const Stats::HistogramStatistics& stats = histogram.cumulativeStatistics();
+  const std::vector<double>& supported_buckets = stats.supportedBuckets();
+  const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+  for (size_t i = 0; i < supported_buckets.size(); ++i) {
+    double bucket = supported_buckets[i];
+    uint64_t value = computed_buckets[i];
+    // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
+    // doesn't have a specific modifier to format as a fixed-point value only so we use the
+    // 'g' operator which prints the number in general fixed point format or scientific format
+    // with precision 50 to round the number up to 32 significant digits in fixed point format
+    // which should cover pretty much all cases
+    fmt::format_to(line_, "{0}_bucket{{{1}{2}le=\"{3:.32g}\"}} {4}\n", metric_name, tags,
+                   hist_tags_separator, bucket, value);
   }
 
-  return metric_type_tracker.size();
+  fmt::format_to(line_, "{0}_bucket{{{1}{2}le=\"+Inf\"}} {3}\n", metric_name, tags,
+                 hist_tags_separator, stats.sampleCount());
+  fmt::format_to(line_, "{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum());
+  fmt::format_to(line_, "{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount());
+  response.add(line_.data(), line_.size());
 }
 
 std::string
 AdminImpl::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                        const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                       const bool used_only, const absl::optional<std::regex> regex,
-                       const bool pretty_print) {
+                       const StatsFilter& filter, const bool pretty_print) {
   rapidjson::Document document;
   document.SetObject();
   rapidjson::Value stats_array(rapidjson::kArrayType);
@@ -916,7 +1098,7 @@ AdminImpl::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
   rapidjson::Value histogram_array(rapidjson::kArrayType);
 
   for (const Stats::ParentHistogramSharedPtr& histogram : all_histograms) {
-    if (shouldShowMetric(histogram, used_only, regex)) {
+    if (filter.shouldShowMetric(*histogram)) {
       if (!found_used_histogram) {
         // It is not possible for the supported quantiles to differ across histograms, so it is ok
         // to send them once.
@@ -1156,11 +1338,50 @@ void AdminFilter::onComplete() {
   RELEASE_ASSERT(request_headers_, "");
   Http::Code code = parent_.runCallback(path, *header_map, response, *this);
   populateFallbackResponseHeaders(code, *header_map);
-  callbacks_->encodeHeaders(std::move(header_map),
-                            end_stream_on_complete_ && response.length() == 0);
+  const bool end_stream = end_stream_on_complete_ && next_chunk_ == nullptr;
+  callbacks_->encodeHeaders(std::move(header_map), end_stream && response.length() == 0);
 
   if (response.length() > 0) {
-    callbacks_->encodeData(response, end_stream_on_complete_);
+    callbacks_->encodeData(response, end_stream);
+  }
+
+  if (next_chunk_ != nullptr) {
+    // The rest of the response is produced one chunk per dispatcher iteration so that other
+    // events, including other admin requests, are serviced in between.
+    next_chunk_timer_ = callbacks_->dispatcher().createTimer([this]() -> void { onNextChunk(); });
+    callbacks_->addDownstreamWatermarkCallbacks(*this);
+    watermark_callbacks_added_ = true;
+    if (high_watermark_count_ == 0) {
+      next_chunk_timer_->enableTimer(std::chrono::milliseconds(0));
+    }
+  }
+}
+
+void AdminFilter::onNextChunk() {
+  ASSERT(next_chunk_ != nullptr);
+  Buffer::OwnedImpl response;
+  const bool more_data = next_chunk_(response);
+  if (!more_data) {
+    next_chunk_ = nullptr;
+  }
+
+  const bool end_stream = !more_data && end_stream_on_complete_;
+  if (response.length() > 0 || end_stream) {
+    callbacks_->encodeData(response, end_stream);
+  }
+
+  // Encoding may have pushed the downstream connection over its high watermark, in which case the
+  // next chunk is scheduled once it drains.
+  if (more_data && high_watermark_count_ == 0) {
+    next_chunk_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void AdminFilter::finishChunkedResponse(Buffer::Instance& response) {
+  while (next_chunk_ != nullptr) {
+    if (!next_chunk_(response)) {
+      next_chunk_ = nullptr;
+    }
   }
 }
 
@@ -1222,6 +1443,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            true},
           {"/memory", "print current allocation/heap usage", MAKE_ADMIN_HANDLER(handlerMemory),
            false, false},
+          {"/memory/connections", "print the connections holding the most buffered memory",
+           MAKE_ADMIN_HANDLER(handlerMemoryConnections), false, false},
           {"/quitquitquit", "exit the server", MAKE_ADMIN_HANDLER(handlerQuitQuitQuit), false,
            true},
           {"/reset_counters", "reset all counters to zero",
@@ -1422,6 +1645,7 @@ Http::Code AdminImpl::request(absl::string_view path_and_query, absl::string_vie
   Buffer::OwnedImpl response;
 
   Http::Code code = runCallback(path_and_query, response_headers, response, filter);
+  filter.finishChunkedResponse(response);
   populateFallbackResponseHeaders(code, response_headers);
   body = response.toString();
   return code;
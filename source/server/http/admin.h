@@ -2,8 +2,10 @@
 
 #include <chrono>
 #include <list>
+#include <regex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -21,6 +23,7 @@
 #include "envoy/upstream/resource_manager.h"
 
 #include "common/common/empty_string.h"
+#include "common/common/fmt.h"
 #include "common/common/logger.h"
 #include "common/common/macros.h"
 #include "common/http/conn_manager_impl.h"
@@ -30,10 +33,12 @@
 #include "common/network/raw_buffer_socket.h"
 #include "common/router/scoped_config_impl.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "server/http/config_tracker_impl.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Server {
@@ -42,6 +47,29 @@ class AdminInternalAddressConfig : public Http::InternalAddressConfig {
   bool isInternalAddress(const Network::Address::Instance&) const override { return false; }
 };
 
+/**
+ * Selects the metrics output by the admin stats handlers, from the usedonly, prefix and filter
+ * query parameters.
+ */
+class StatsFilter {
+public:
+  StatsFilter(bool used_only, absl::string_view prefix, absl::optional<std::regex> regex)
+      : used_only_(used_only), prefix_(prefix), regex_(std::move(regex)) {}
+
+  /**
+   * @return bool whether the metric should be output. The name of the metric is only looked at if
+   *         there is a prefix or regex to match it against.
+   */
+  bool shouldShowMetric(const Stats::Metric& metric) const;
+
+private:
+  bool matchesName(absl::string_view name) const;
+
+  bool used_only_;
+  std::string prefix_;
+  absl::optional<std::regex> regex_;
+};
+
 /**
  * Implementation of Server::Admin.
  */
@@ -218,16 +246,9 @@ private:
   void writeListenersAsJson(Buffer::Instance& response);
   void writeListenersAsText(Buffer::Instance& response);
 
-  static bool shouldShowMetric(const std::shared_ptr<Stats::Metric>& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric->used()) &&
-            (!regex.has_value() || std::regex_search(metric->name(), regex.value())));
-  }
   static std::string statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                                  const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                                 bool used_only,
-                                 const absl::optional<std::regex> regex = absl::nullopt,
-                                 bool pretty_print = false);
+                                 const StatsFilter& filter, bool pretty_print = false);
 
   static std::string
   runtimeAsJson(const std::vector<std::pair<std::string, Runtime::Snapshot::Entry>>& entries);
@@ -271,6 +292,9 @@ private:
                             Buffer::Instance& response, AdminStream&);
   Http::Code handlerMemory(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                            Buffer::Instance& response, AdminStream&);
+  Http::Code handlerMemoryConnections(absl::string_view path_and_query,
+                                      Http::HeaderMap& response_headers,
+                                      Buffer::Instance& response, AdminStream&);
   Http::Code handlerMain(const std::string& path, Buffer::Instance& response, AdminStream&);
   Http::Code handlerQuitQuitQuit(absl::string_view path_and_query,
                                  Http::HeaderMap& response_headers, Buffer::Instance& response,
@@ -308,6 +332,7 @@ private:
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
     uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+    void bindBufferMemoryAccounts(Network::Connection&) override {}
     std::chrono::milliseconds listenerFiltersTimeout() const override {
       return std::chrono::milliseconds();
     }
@@ -368,6 +393,7 @@ private:
  * A terminal HTTP filter that implements server admin functionality.
  */
 class AdminFilter : public Http::StreamDecoderFilter,
+                    public Http::DownstreamWatermarkCallbacks,
                     public AdminStream,
                     Logger::Loggable<Logger::Id::admin> {
 public:
@@ -384,12 +410,26 @@ public:
     callbacks_ = &callbacks;
   }
 
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
   // AdminStream
   void setEndStreamOnComplete(bool end_stream) override { end_stream_on_complete_ = end_stream; }
   void addOnDestroyCallback(std::function<void()> cb) override;
   Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const override;
   const Buffer::Instance* getRequestBody() const override;
   const Http::HeaderMap& getRequestHeaders() const override;
+  void setNextChunkCallback(NextChunkCb next_chunk) override {
+    next_chunk_ = std::move(next_chunk);
+  }
+
+  /**
+   * Synchronously appends any remaining chunks of the response, for requests that are not
+   * served over HTTP.
+   * @param response supplies the buffer to append the chunks to.
+   */
+  void finishChunkedResponse(Buffer::Instance& response);
 
 private:
   /**
@@ -397,6 +437,11 @@ private:
    */
   void onComplete();
 
+  /**
+   * Called once per dispatcher iteration to encode the next chunk of a chunked response.
+   */
+  void onNextChunk();
+
   AdminImpl& parent_;
   // Handlers relying on the reference should use addOnDestroyCallback()
   // to add a callback that will notify them when the reference is no
@@ -405,15 +450,69 @@ private:
   Http::HeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
+  NextChunkCb next_chunk_;
+  Event::TimerPtr next_chunk_timer_;
+  // Number of downstream buffers above their high watermark. No chunks are produced until they
+  // have all drained.
+  uint32_t high_watermark_count_{};
+  bool watermark_callbacks_added_{};
+};
+
+/**
+ * Formats counters, gauges and histograms in the plain text /stats format, sorted by name. The
+ * selected metrics and their values are captured on construction, sorted by their StatName, and
+ * the output can then be written out over as many calls as needed. The name of each metric is
+ * only built as it is written out.
+ */
+class StatsTextFormatter {
+public:
+  StatsTextFormatter(const std::vector<Stats::CounterSharedPtr>& counters,
+                     const std::vector<Stats::GaugeSharedPtr>& gauges,
+                     const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                     const Stats::SymbolTable& symbol_table, const StatsFilter& filter);
+
+  /**
+   * Appends the next metrics to the response.
+   * @param response supplies the buffer to append to.
+   * @param max_metrics supplies the maximum number of metrics to append.
+   * @return bool true if there are metrics left to append.
+   */
+  bool nextChunk(Buffer::Instance& response, uint64_t max_metrics);
+
+private:
+  std::vector<std::pair<std::shared_ptr<const Stats::Metric>, uint64_t>> stats_;
+  std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  size_t next_stat_{};
+  size_t next_histogram_{};
 };
 
 /**
- * Formatter for metric/labels exported to Prometheus.
+ * Formatter for metric/labels exported to Prometheus. The metrics are formatted incrementally, so
+ * that a large number of them can be written out over several calls. Sanitized metric and tag
+ * names, and tag values, are cached by their StatName, so each distinct one is only built once.
  *
  * See: https://prometheus.io/docs/concepts/data_model
  */
 class PrometheusStatsFormatter {
 public:
+  PrometheusStatsFormatter(std::vector<Stats::CounterSharedPtr> counters,
+                           std::vector<Stats::GaugeSharedPtr> gauges,
+                           std::vector<Stats::ParentHistogramSharedPtr> histograms,
+                           const StatsFilter& filter);
+
+  /**
+   * Appends the next metrics that pass the filter to the response.
+   * @param response supplies the buffer to append to.
+   * @param max_metrics supplies the maximum number of metrics to consider.
+   * @return bool true if there are metrics left to consider.
+   */
+  bool nextChunk(Buffer::Instance& response, uint64_t max_metrics);
+
+  /**
+   * @return uint64_t total number of metric types inserted in the response so far.
+   */
+  uint64_t metricTypes() const { return metric_type_tracker_.size(); }
+
   /**
    * Extracts counters and gauges and relevant tags, appending them to
    * the response buffer after sanitizing the metric / label names.
@@ -440,15 +539,38 @@ private:
    */
   static std::string sanitizeName(const std::string& name);
 
-  /*
-   * Determine whether a metric has never been emitted and choose to
-   * not show it if we only wanted used metrics.
+  /**
+   * @return the sanitized Prometheus name of the metric, appending its TYPE line to the response
+   *         the first time the name is seen.
    */
-  static bool shouldShowMetric(const std::shared_ptr<Stats::Metric>& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric->used()) &&
-            (!regex.has_value() || std::regex_search(metric->name(), regex.value())));
-  }
+  const std::string& metricTypeName(const Stats::Metric& metric, absl::string_view type,
+                                    Buffer::Instance& response);
+
+  /**
+   * Formats the tags of the metric into tags_ as a comma-separated list of <tag_name>="<tag_value>"
+   * pairs.
+   */
+  void formatTags(const Stats::Metric& metric);
+
+  void formatCounter(const Stats::Counter& counter, Buffer::Instance& response);
+  void formatGauge(const Stats::Gauge& gauge, Buffer::Instance& response);
+  void formatHistogram(const Stats::ParentHistogram& histogram, Buffer::Instance& response);
+
+  const std::vector<Stats::CounterSharedPtr> counters_;
+  const std::vector<Stats::GaugeSharedPtr> gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  const StatsFilter filter_;
+  size_t next_counter_{};
+  size_t next_gauge_{};
+  size_t next_histogram_{};
+  std::unordered_set<std::string> metric_type_tracker_;
+  // Keyed by tag extracted name, pointing into metric_type_tracker_.
+  Stats::StatNameHashMap<const std::string*> metric_names_;
+  Stats::StatNameHashMap<std::string> tag_names_;
+  Stats::StatNameHashMap<std::string> tag_values_;
+  // Reused across metrics so that formatting does not allocate per metric.
+  fmt::memory_buffer tags_;
+  fmt::memory_buffer line_;
 };
 
 } // namespace Server
@@ -7,6 +7,7 @@
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
+#include "common/common/cleanup.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/utility.h"
@@ -16,6 +17,7 @@
 #include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "server/configuration_impl.h"
 #include "server/drain_manager_impl.h"
@@ -184,7 +186,9 @@ ProdListenerComponentFactory::createDrainManager(envoy::api::v2::Listener::Drain
 ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::string& version_info,
                            ListenerManagerImpl& parent, const std::string& name, bool modifiable,
                            bool workers_started, uint64_t hash)
-    : parent_(parent), address_(Network::Address::resolveProtoAddress(config.address())),
+    : parent_(parent), filter_chain_manager_(std::make_shared<FilterChainManagerImpl>()),
+      filter_chain_manager_slot_(parent_.server_.threadLocal().allocateSlot()),
+      address_(Network::Address::resolveProtoAddress(config.address())),
       socket_type_(Network::Utility::protobufAddressSocketType(config.address())),
       global_scope_(parent_.server_.stats().createScope("")),
       listener_scope_(
@@ -247,6 +251,11 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
         config.tcp_fast_open_queue_length().value()));
   }
 
+  if (config.has_connection_memory_limit()) {
+    connection_memory_account_factory_ = std::make_unique<ConnectionMemoryAccountFactory>(
+        parent_.connection_memory_tracker_, config.connection_memory_limit(), *listener_scope_);
+  }
+
   // Add original dst listener filter if 'use_original_dst' flag is set.
   if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)) {
     auto& factory =
@@ -259,7 +268,7 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
   // TODO(jrajahalme): This is the last listener filter on purpose. When filter chain matching
   //                   is implemented, this needs to be run after the filter chain has been
   //                   selected.
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.filter_chains()[0], use_proxy_proto, false)) {
+  if (usesProxyProtocol(config)) {
     auto& factory =
         Config::Utility::getAndCheckFactory<Configuration::NamedListenerFilterConfigFactory>(
             Extensions::ListenerFilters::ListenerFilterNames::get().ProxyProtocol);
@@ -267,9 +276,41 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
         factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
   }
 
-  bool need_tls_inspector = false;
+  buildFilterChains(config, FilterChainsByConfig(), filter_chains_, *filter_chain_manager_);
+
+  bool need_tls_inspector = needTlsInspector(config);
+
+  // Automatically inject TLS Inspector if it wasn't configured explicitly and it's needed.
+  if (need_tls_inspector) {
+    for (const auto& filter : config.listener_filters()) {
+      if (filter.name() == Extensions::ListenerFilters::ListenerFilterNames::get().TlsInspector) {
+        need_tls_inspector = false;
+        break;
+      }
+    }
+    if (need_tls_inspector) {
+      const std::string message =
+          fmt::format("adding listener '{}': filter chain match rules require TLS Inspector "
+                      "listener filter, but it isn't configured, trying to inject it "
+                      "(this might fail if Envoy is compiled without it)",
+                      address_->asString());
+      ENVOY_LOG(warn, "{}", message);
+
+      auto& factory =
+          Config::Utility::getAndCheckFactory<Configuration::NamedListenerFilterConfigFactory>(
+              Extensions::ListenerFilters::ListenerFilterNames::get().TlsInspector);
+      listener_filter_factories_.push_back(
+          factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
+    }
+  }
+}
+
+void ListenerImpl::buildFilterChains(const envoy::api::v2::Listener& config,
+                                     const FilterChainsByConfig& existing_filter_chains,
+                                     FilterChainsByConfig& filter_chains,
+                                     FilterChainManagerImpl& filter_chain_manager) {
   std::unordered_set<envoy::api::v2::listener::FilterChainMatch, MessageUtil, MessageUtil>
-      filter_chains;
+      filter_chain_matches;
 
   // TODO(lambdai): move the trie construction to FilterChainManagerImpl
   for (const auto& filter_chain : config.filter_chains()) {
@@ -279,31 +320,12 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
                                        "unimplemented fields",
                                        address_->asString()));
     }
-    if (filter_chains.find(filter_chain_match) != filter_chains.end()) {
+    if (filter_chain_matches.find(filter_chain_match) != filter_chain_matches.end()) {
       throw EnvoyException(fmt::format("error adding listener '{}': multiple filter chains with "
                                        "the same matching rules are defined",
                                        address_->asString()));
     }
-    filter_chains.insert(filter_chain_match);
-
-    // If the cluster doesn't have transport socket configured, then use the default "raw_buffer"
-    // transport socket or BoringSSL-based "tls" transport socket if TLS settings are configured.
-    // We copy by value first then override if necessary.
-    auto transport_socket = filter_chain.transport_socket();
-    if (!filter_chain.has_transport_socket()) {
-      if (filter_chain.has_tls_context()) {
-        transport_socket.set_name(Extensions::TransportSockets::TransportSocketNames::get().Tls);
-        MessageUtil::jsonConvert(filter_chain.tls_context(), *transport_socket.mutable_config());
-      } else {
-        transport_socket.set_name(
-            Extensions::TransportSockets::TransportSocketNames::get().RawBuffer);
-      }
-    }
-
-    auto& config_factory = Config::Utility::getAndCheckFactory<
-        Server::Configuration::DownstreamTransportSocketConfigFactory>(transport_socket.name());
-    ProtobufTypes::MessagePtr message = Config::Utility::translateToFactoryConfig(
-        transport_socket, parent_.server_.messageValidationVisitor(), config_factory);
+    filter_chain_matches.insert(filter_chain_match);
 
     // Validate IP addresses.
     std::vector<std::string> destination_ips;
@@ -337,51 +359,165 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
     std::vector<std::string> application_protocols(
         filter_chain_match.application_protocols().begin(),
         filter_chain_match.application_protocols().end());
-    Server::Configuration::TransportSocketFactoryContextImpl factory_context(
-        parent_.server_.admin(), parent_.server_.sslContextManager(), *listener_scope_,
-        parent_.server_.clusterManager(), parent_.server_.localInfo(), parent_.server_.dispatcher(),
-        parent_.server_.random(), parent_.server_.stats(), parent_.server_.singletonManager(),
-        parent_.server_.threadLocal(), parent_.server_.messageValidationVisitor(),
-        parent_.server_.api());
-    factory_context.setInitManager(initManager());
-    filter_chain_manager_.addFilterChain(
+
+    // Filter chains with the same matching rules were rejected above, so the config is new.
+    Network::FilterChainSharedPtr& new_filter_chain = filter_chains[filter_chain];
+    const auto existing_filter_chain = existing_filter_chains.find(filter_chain);
+    new_filter_chain = existing_filter_chain != existing_filter_chains.end()
+                           ? existing_filter_chain->second
+                           : createFilterChain(filter_chain, server_names);
+    filter_chain_manager.addFilterChain(
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(filter_chain_match, destination_port, 0), destination_ips,
         server_names, filter_chain_match.transport_protocol(), application_protocols,
         filter_chain_match.source_type(), source_ips, filter_chain_match.source_ports(),
-        config_factory.createTransportSocketFactory(*message, factory_context, server_names),
-        parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(), *this));
-
-    need_tls_inspector |= filter_chain_match.transport_protocol() == "tls" ||
-                          (filter_chain_match.transport_protocol().empty() &&
-                           (!server_names.empty() || !application_protocols.empty()));
+        new_filter_chain);
   }
 
   // Convert both destination and source IP CIDRs to tries for faster lookups.
-  filter_chain_manager_.finishFilterChain();
+  filter_chain_manager.finishFilterChain();
+}
 
-  // Automatically inject TLS Inspector if it wasn't configured explicitly and it's needed.
-  if (need_tls_inspector) {
-    for (const auto& filter : config.listener_filters()) {
-      if (filter.name() == Extensions::ListenerFilters::ListenerFilterNames::get().TlsInspector) {
-        need_tls_inspector = false;
-        break;
-      }
+Network::FilterChainSharedPtr
+ListenerImpl::createFilterChain(const envoy::api::v2::listener::FilterChain& filter_chain,
+                                const std::vector<std::string>& server_names) {
+  // If the cluster doesn't have transport socket configured, then use the default "raw_buffer"
+  // transport socket or BoringSSL-based "tls" transport socket if TLS settings are configured.
+  // We copy by value first then override if necessary.
+  auto transport_socket = filter_chain.transport_socket();
+  if (!filter_chain.has_transport_socket()) {
+    if (filter_chain.has_tls_context()) {
+      transport_socket.set_name(Extensions::TransportSockets::TransportSocketNames::get().Tls);
+      MessageUtil::jsonConvert(filter_chain.tls_context(), *transport_socket.mutable_config());
+    } else {
+      transport_socket.set_name(
+          Extensions::TransportSockets::TransportSocketNames::get().RawBuffer);
     }
-    if (need_tls_inspector) {
-      const std::string message =
-          fmt::format("adding listener '{}': filter chain match rules require TLS Inspector "
-                      "listener filter, but it isn't configured, trying to inject it "
-                      "(this might fail if Envoy is compiled without it)",
-                      address_->asString());
-      ENVOY_LOG(warn, "{}", message);
+  }
 
-      auto& factory =
-          Config::Utility::getAndCheckFactory<Configuration::NamedListenerFilterConfigFactory>(
-              Extensions::ListenerFilters::ListenerFilterNames::get().TlsInspector);
-      listener_filter_factories_.push_back(
-          factory.createFilterFactoryFromProto(Envoy::ProtobufWkt::Empty(), *this));
+  auto& config_factory = Config::Utility::getAndCheckFactory<
+      Server::Configuration::DownstreamTransportSocketConfigFactory>(transport_socket.name());
+  ProtobufTypes::MessagePtr message = Config::Utility::translateToFactoryConfig(
+      transport_socket, parent_.server_.messageValidationVisitor(), config_factory);
+
+  Server::Configuration::TransportSocketFactoryContextImpl factory_context(
+      parent_.server_.admin(), parent_.server_.sslContextManager(), *listener_scope_,
+      parent_.server_.clusterManager(), parent_.server_.localInfo(), parent_.server_.dispatcher(),
+      parent_.server_.random(), parent_.server_.stats(), parent_.server_.singletonManager(),
+      parent_.server_.threadLocal(), parent_.server_.messageValidationVisitor(),
+      parent_.server_.api());
+  factory_context.setInitManager(initManager());
+  return std::make_shared<FilterChainImpl>(
+      config_factory.createTransportSocketFactory(*message, factory_context, server_names),
+      parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(), *this));
+}
+
+bool ListenerImpl::needTlsInspector(const envoy::api::v2::listener::FilterChainMatch& match) {
+  return match.transport_protocol() == "tls" ||
+         (match.transport_protocol().empty() &&
+          (!match.server_names().empty() || !match.application_protocols().empty()));
+}
+
+bool ListenerImpl::needTlsInspector(const envoy::api::v2::Listener& config) {
+  for (const auto& filter_chain : config.filter_chains()) {
+    if (needTlsInspector(filter_chain.filter_chain_match())) {
+      return true;
     }
   }
+  return false;
+}
+
+bool ListenerImpl::usesProxyProtocol(const envoy::api::v2::Listener& config) {
+  return PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.filter_chains()[0], use_proxy_proto, false);
+}
+
+ListenerImpl::FilterChainUpdate::FilterChainUpdate(ListenerImpl& parent,
+                                                   const envoy::api::v2::Listener& config,
+                                                   const std::string& version_info, uint64_t hash)
+    : config_(config), version_info_(version_info), hash_(hash),
+      filter_chain_manager_(std::make_shared<FilterChainManagerImpl>()),
+      init_manager_(fmt::format("Listener {} filter chains", parent.name())),
+      init_watcher_("ListenerImpl filter chains",
+                    [&parent] { parent.parent_.onFilterChainUpdateWarmed(parent); }) {}
+
+void ListenerImpl::bindBufferMemoryAccounts(Network::Connection& connection) {
+  if (connection_memory_account_factory_ != nullptr) {
+    connection_memory_account_factory_->bindAccounts(connection);
+  }
+}
+
+bool ListenerImpl::supportUpdateFilterChain(const envoy::api::v2::Listener& config) const {
+  if (!Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.listener_in_place_filterchain_update")) {
+    return false;
+  }
+
+  // The listener filters are built from the first filter chain and from the match rules, so
+  // updates changing what they need can't be applied in place.
+  if (socket_type_ != Network::Address::SocketType::Stream || config.filter_chains().empty() ||
+      usesProxyProtocol(config) != usesProxyProtocol(config_) ||
+      needTlsInspector(config) != needTlsInspector(config_)) {
+    return false;
+  }
+
+  Protobuf::util::MessageDifferencer differencer;
+  differencer.IgnoreField(envoy::api::v2::Listener::descriptor()->FindFieldByName("filter_chains"));
+  return differencer.Compare(config, config_);
+}
+
+void ListenerImpl::updateFilterChains(const envoy::api::v2::Listener& config,
+                                      const std::string& version_info, uint64_t hash) {
+  auto update = std::make_unique<FilterChainUpdate>(*this, config, version_info, hash);
+  {
+    // The filter chain factories register their init targets, namely the ones of the route
+    // config subscriptions, with the update's init manager, see initManager().
+    building_filter_chain_update_ = update.get();
+    Cleanup building([this] { building_filter_chain_update_ = nullptr; });
+    buildFilterChains(config, filter_chains_, update->filter_chains_,
+                      *update->filter_chain_manager_);
+  }
+
+  // This cancels a pending update, which won't be applied anymore.
+  filter_chain_update_ = std::move(update);
+  filter_chain_update_->init_manager_.initialize(filter_chain_update_->init_watcher_);
+}
+
+DrainingFilterChainsSharedPtr ListenerImpl::applyFilterChainUpdate() {
+  FilterChainUpdate& update = *filter_chain_update_;
+  auto draining = std::make_shared<DrainingFilterChains>(*this, std::move(filter_chain_manager_));
+  for (const auto& filter_chain : filter_chains_) {
+    if (update.filter_chains_.find(filter_chain.first) == update.filter_chains_.end()) {
+      draining->filter_chains_.push_back(filter_chain.second.get());
+    }
+  }
+
+  filter_chain_manager_ = std::move(update.filter_chain_manager_);
+  filter_chains_ = std::move(update.filter_chains_);
+  config_.Swap(&update.config_);
+  version_info_ = update.version_info_;
+  hash_ = update.hash_;
+  last_updated_ = timeSource().systemTime();
+  publishFilterChainManager();
+
+  draining_filter_chains_.push_back(draining);
+  return draining;
+}
+
+void ListenerImpl::removeDrainingFilterChains(const DrainingFilterChains& draining) {
+  draining_filter_chains_.remove_if(
+      [&draining](const DrainingFilterChainsSharedPtr& entry) { return entry.get() == &draining; });
+}
+
+void ListenerImpl::publishFilterChainManager() {
+  Network::FilterChainManager* filter_chain_manager = filter_chain_manager_.get();
+  filter_chain_manager_slot_->set(
+      [filter_chain_manager](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        return std::make_shared<ThreadLocalFilterChainManager>(*filter_chain_manager);
+      });
+}
+
+Network::FilterChainManager& ListenerImpl::filterChainManager() {
+  return filter_chain_manager_slot_->getTyped<ThreadLocalFilterChainManager>()
+      .filter_chain_manager_;
 }
 
 ListenerImpl::~ListenerImpl() {
@@ -447,6 +583,7 @@ void ListenerImpl::debugLog(const std::string& message) {
 
 void ListenerImpl::initialize() {
   last_updated_ = timeSource().systemTime();
+  publishFilterChainManager();
   // If workers have already started, we shift from using the global init manager to using a local
   // per listener init manager. See ~ListenerImpl() for why we gate the onListenerWarmed() call
   // by resetting the watcher.
@@ -456,6 +593,9 @@ void ListenerImpl::initialize() {
 }
 
 Init::Manager& ListenerImpl::initManager() {
+  if (building_filter_chain_update_ != nullptr) {
+    return building_filter_chain_update_->init_manager_;
+  }
   // See initialize() for why we choose different init managers to return.
   if (workers_started_) {
     return dynamic_init_manager_;
@@ -566,6 +706,17 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     return false;
   }
 
+  // When only the filter chains of an active listener change, the listener is updated in place
+  // so that the connections of the unchanged filter chains don't need to be drained.
+  if (workers_started_ && existing_warming_listener == warming_listeners_.end() &&
+      existing_active_listener != active_listeners_.end() &&
+      (*existing_active_listener)->supportUpdateFilterChain(config)) {
+    (*existing_active_listener)->debugLog("update filter chains of active listener");
+    (*existing_active_listener)->updateFilterChains(config, version_info, hash);
+    stats_.listener_modified_.inc();
+    return true;
+  }
+
   ListenerImplPtr new_listener(
       new ListenerImpl(config, version_info, *this, name, modifiable, workers_started_, hash));
   ListenerImpl& new_listener_ref = *new_listener;
@@ -782,6 +933,64 @@ void ListenerManagerImpl::onListenerWarmed(ListenerImpl& listener) {
   updateWarmingActiveGauges();
 }
 
+void ListenerManagerImpl::onFilterChainUpdateWarmed(ListenerImpl& listener) {
+  // The update is dropped if the listener was replaced or removed in the meantime.
+  auto existing_active_listener = getListenerByName(active_listeners_, listener.name());
+  if (existing_active_listener == active_listeners_.end() ||
+      existing_active_listener->get() != &listener) {
+    return;
+  }
+
+  listener.debugLog("filter chains warm complete. updating active listener");
+  drainFilterChains(listener.applyFilterChainUpdate());
+  // Only updates that were applied are counted, not the ones superseded while warming.
+  stats_.listener_in_place_updated_.inc();
+}
+
+void ListenerManagerImpl::drainFilterChains(const DrainingFilterChainsSharedPtr& draining) {
+  if (draining->filter_chains_.empty()) {
+    // Nothing to close, but the previous filter chain manager is only released once all workers
+    // switched to the new one.
+    removeFilterChainsFromWorkers(draining);
+    return;
+  }
+
+  // The connections of the removed filter chains are given the drain time to complete before
+  // being closed.
+  draining->listener_.debugLog(
+      fmt::format("draining {} filter chains", draining->filter_chains_.size()));
+  std::weak_ptr<DrainingFilterChains> weak_draining = draining;
+  draining->drain_timer_ = server_.dispatcher().createTimer([this, weak_draining]() -> void {
+    if (DrainingFilterChainsSharedPtr draining = weak_draining.lock()) {
+      removeFilterChainsFromWorkers(draining);
+    }
+  });
+  draining->drain_timer_->enableTimer(server_.options().drainTime());
+}
+
+void ListenerManagerImpl::removeFilterChainsFromWorkers(
+    const DrainingFilterChainsSharedPtr& draining) {
+  draining->workers_pending_removal_ = workers_.size();
+  // The draining filter chains are owned by the listener, which may be removed before all workers
+  // are done.
+  std::weak_ptr<DrainingFilterChains> weak_draining = draining;
+  for (const auto& worker : workers_) {
+    worker->removeFilterChains(
+        draining->listener_.listenerTag(), draining->filter_chains_,
+        [this, weak_draining]() -> void {
+          // The completion is called on the worker thread. Post back to the main thread to avoid
+          // locking.
+          server_.dispatcher().post([weak_draining]() -> void {
+            DrainingFilterChainsSharedPtr draining = weak_draining.lock();
+            if (draining != nullptr && --draining->workers_pending_removal_ == 0) {
+              draining->listener_.debugLog("filter chains removal complete");
+              draining->listener_.removeDrainingFilterChains(*draining);
+            }
+          });
+        });
+  }
+}
+
 uint64_t ListenerManagerImpl::numConnections() {
   uint64_t num_connections = 0;
   for (const auto& worker : workers_) {
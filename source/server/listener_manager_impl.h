@@ -1,8 +1,11 @@
 #pragma once
 
+#include <list>
 #include <memory>
+#include <unordered_map>
 
 #include "envoy/api/v2/listener/listener.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/instance.h"
@@ -10,12 +13,15 @@
 #include "envoy/server/transport_socket_config.h"
 #include "envoy/server/worker.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
 #include "common/init/manager_impl.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
+#include "common/protobuf/utility.h"
 
+#include "server/connection_memory_tracker.h"
 #include "server/filter_chain_manager_impl.h"
 #include "server/lds_api.h"
 
@@ -88,6 +94,23 @@ private:
 class ListenerImpl;
 using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
 
+/**
+ * Filter chains removed from a listener by an in place update. The filter chains are owned by the
+ * filter chain manager they were removed from, which is kept until no worker can use it.
+ */
+struct DrainingFilterChains {
+  DrainingFilterChains(ListenerImpl& listener,
+                       FilterChainManagerImplSharedPtr&& filter_chain_manager)
+      : listener_(listener), filter_chain_manager_(std::move(filter_chain_manager)) {}
+
+  ListenerImpl& listener_;
+  const FilterChainManagerImplSharedPtr filter_chain_manager_;
+  std::vector<const Network::FilterChain*> filter_chains_;
+  Event::TimerPtr drain_timer_;
+  uint64_t workers_pending_removal_{};
+};
+using DrainingFilterChainsSharedPtr = std::shared_ptr<DrainingFilterChains>;
+
 /**
  * All listener manager stats. @see stats_macros.h
  */
@@ -95,6 +118,7 @@ using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
   COUNTER(listener_added)                                                                          \
   COUNTER(listener_create_failure)                                                                 \
   COUNTER(listener_create_success)                                                                 \
+  COUNTER(listener_in_place_updated)                                                               \
   COUNTER(listener_modified)                                                                       \
   COUNTER(listener_removed)                                                                        \
   GAUGE(total_listeners_active, NeverImport)                                                       \
@@ -117,6 +141,7 @@ public:
                       WorkerFactory& worker_factory, bool enable_dispatcher_stats);
 
   void onListenerWarmed(ListenerImpl& listener);
+  void onFilterChainUpdateWarmed(ListenerImpl& listener);
 
   // Server::ListenerManager
   bool addOrUpdateListener(const envoy::api::v2::Listener& config, const std::string& version_info,
@@ -127,6 +152,9 @@ public:
   }
   std::vector<std::reference_wrapper<Network::ListenerConfig>> listeners() override;
   uint64_t numConnections() override;
+  std::vector<ConnectionMemoryUsage> topConnectionsByMemory(uint64_t limit) const override {
+    return connection_memory_tracker_->topConnections(limit);
+  }
   bool removeListener(const std::string& listener_name) override;
   void startWorkers(GuardDog& guard_dog) override;
   void stopListeners() override;
@@ -135,6 +163,9 @@ public:
 
   Instance& server_;
   ListenerComponentFactory& factory_;
+  // Shared with the accounts of the connections, which may be destroyed after the manager.
+  const ConnectionMemoryTrackerSharedPtr connection_memory_tracker_{
+      std::make_shared<ConnectionMemoryTracker>()};
 
 private:
   using ListenerList = std::list<ListenerImplPtr>;
@@ -166,6 +197,13 @@ private:
    */
   void drainListener(ListenerImplPtr&& listener);
 
+  /**
+   * Close the connections of the filter chains removed from a listener by an in place update. The
+   * filter chains are released once all workers have closed their connections.
+   */
+  void drainFilterChains(const DrainingFilterChainsSharedPtr& draining);
+  void removeFilterChainsFromWorkers(const DrainingFilterChainsSharedPtr& draining);
+
   /**
    * Get a listener by name. This routine is used because listeners have inherent order in static
    * configuration and especially for tests. Thus, we can't use a map.
@@ -228,6 +266,36 @@ public:
   bool blockUpdate(uint64_t new_hash) { return new_hash == hash_ || !modifiable_; }
   bool blockRemove() { return !modifiable_; }
 
+  /**
+   * @return TRUE if the listener can be updated to the given config in place. This is the case
+   *         when only the filter chains change, and their changes don't require different listener
+   *         filters.
+   */
+  bool supportUpdateFilterChain(const envoy::api::v2::Listener& config) const;
+
+  /**
+   * Build the filter chains of an updated config, reusing the ones which didn't change. The
+   * listener keeps using its current filter chains until the new ones are initialized, at which
+   * point ListenerManagerImpl::onFilterChainUpdateWarmed() is called. A pending update is replaced.
+   * @param config supplies the updated configuration proto.
+   * @param version_info supplies the xDS version of the updated listener.
+   * @param hash supplies the hash of the updated configuration proto.
+   * @throw EnvoyException if the filter chains are invalid, the listener is then left unchanged.
+   */
+  void updateFilterChains(const envoy::api::v2::Listener& config, const std::string& version_info,
+                          uint64_t hash);
+
+  /**
+   * Switch to the filter chains built by updateFilterChains().
+   * @return DrainingFilterChainsSharedPtr the filter chains which were removed by the update.
+   */
+  DrainingFilterChainsSharedPtr applyFilterChainUpdate();
+
+  /**
+   * Release filter chains removed by an update, once no connection uses them anymore.
+   */
+  void removeDrainingFilterChains(const DrainingFilterChains& draining);
+
   /**
    * Called when a listener failed to be actually created on a worker.
    * @return TRUE if we have seen more than one worker failure.
@@ -251,7 +319,7 @@ public:
   const std::string& versionInfo() { return version_info_; }
 
   // Network::ListenerConfig
-  Network::FilterChainManager& filterChainManager() override { return filter_chain_manager_; }
+  Network::FilterChainManager& filterChainManager() override;
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
   Network::Socket& socket() override { return *socket_; }
   const Network::Socket& socket() const override { return *socket_; }
@@ -262,6 +330,7 @@ public:
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
+  void bindBufferMemoryAccounts(Network::Connection& connection) override;
   std::chrono::milliseconds listenerFiltersTimeout() const override {
     return listener_filters_timeout_;
   }
@@ -330,8 +399,68 @@ public:
   SystemTime last_updated_;
 
 private:
+  // Filter chains keyed by their config, so that an update reuses the unchanged ones.
+  using FilterChainsByConfig =
+      std::unordered_map<envoy::api::v2::listener::FilterChain, Network::FilterChainSharedPtr,
+                         MessageUtil, MessageUtil>;
+
+  struct ThreadLocalFilterChainManager : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalFilterChainManager(Network::FilterChainManager& filter_chain_manager)
+        : filter_chain_manager_(filter_chain_manager) {}
+
+    // Owned by the listener, which only releases it once the workers stopped using it.
+    Network::FilterChainManager& filter_chain_manager_;
+  };
+
+  /**
+   * Filter chains built for an updated config, waiting for their initialization.
+   */
+  struct FilterChainUpdate {
+    FilterChainUpdate(ListenerImpl& parent, const envoy::api::v2::Listener& config,
+                      const std::string& version_info, uint64_t hash);
+
+    envoy::api::v2::Listener config_;
+    const std::string version_info_;
+    const uint64_t hash_;
+    FilterChainManagerImplSharedPtr filter_chain_manager_;
+    FilterChainsByConfig filter_chains_;
+    Init::ManagerImpl init_manager_;
+    Init::WatcherImpl init_watcher_;
+  };
+
+  static bool needTlsInspector(const envoy::api::v2::listener::FilterChainMatch& match);
+  static bool usesProxyProtocol(const envoy::api::v2::Listener& config);
+  static bool needTlsInspector(const envoy::api::v2::Listener& config);
+
+  /**
+   * Create the filter chains of a config and add them to a filter chain manager.
+   * @param config supplies the configuration proto.
+   * @param existing_filter_chains supplies filter chains which are reused if their config is
+   *        unchanged.
+   * @param filter_chains receives the filter chains of the config.
+   * @param filter_chain_manager supplies the manager to add the filter chains to.
+   */
+  void buildFilterChains(const envoy::api::v2::Listener& config,
+                         const FilterChainsByConfig& existing_filter_chains,
+                         FilterChainsByConfig& filter_chains,
+                         FilterChainManagerImpl& filter_chain_manager);
+  Network::FilterChainSharedPtr
+  createFilterChain(const envoy::api::v2::listener::FilterChain& filter_chain,
+                    const std::vector<std::string>& server_names);
+  void publishFilterChainManager();
+
   ListenerManagerImpl& parent_;
-  FilterChainManagerImpl filter_chain_manager_;
+  // The filter chain manager used for new connections, which the workers access through the
+  // thread local slot. It is only replaced on the main thread, by an in place update.
+  FilterChainManagerImplSharedPtr filter_chain_manager_;
+  FilterChainsByConfig filter_chains_;
+  ThreadLocal::SlotPtr filter_chain_manager_slot_;
+  // The last in place update. It is kept after being applied so that its init manager outlives
+  // the initialization callback.
+  std::unique_ptr<FilterChainUpdate> filter_chain_update_;
+  // Set while the filter chains of an update are created, see initManager().
+  FilterChainUpdate* building_filter_chain_update_{};
+  std::list<DrainingFilterChainsSharedPtr> draining_filter_chains_;
   Network::Address::InstanceConstSharedPtr address_;
   Network::Address::SocketType socket_type_;
   Network::SocketSharedPtr socket_;
@@ -340,11 +469,12 @@ private:
   const bool bind_to_port_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
+  ConnectionMemoryAccountFactoryPtr connection_memory_account_factory_;
   const uint64_t listener_tag_;
   const std::string name_;
   const bool modifiable_;
   const bool workers_started_;
-  const uint64_t hash_;
+  uint64_t hash_;
 
   // This init manager is populated with targets from the filter chain factories, namely
   // RdsRouteConfigSubscription::init_target_, so the listener can wait for route configs.
@@ -357,8 +487,8 @@ private:
   std::vector<Network::UdpListenerFilterFactoryCb> udp_listener_filter_factories_;
   DrainManagerPtr local_drain_manager_;
   bool saw_listener_create_failure_{};
-  const envoy::api::v2::Listener config_;
-  const std::string version_info_;
+  envoy::api::v2::Listener config_;
+  std::string version_info_;
   Network::Socket::OptionsSharedPtr listen_socket_options_;
   const std::chrono::milliseconds listener_filters_timeout_;
 };
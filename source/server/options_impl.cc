@@ -101,6 +101,10 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::ValueArg<uint32_t> stats_counter_shards(
+      "", "stats-counter-shards",
+      "# of per-thread slots allocated for each counter; 0 keeps one shared value per counter",
+      false, 0, "uint32_t", cmd);
 
   TCLAP::ValueArg<bool> use_libevent_buffer("", "use-libevent-buffers",
                                             "Use the original libevent buffer implementation",
@@ -130,6 +134,7 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
 
   libevent_buffer_enabled_ = use_libevent_buffer.getValue();
   cpuset_threads_ = cpuset_threads.getValue();
+  stats_counter_shards_ = stats_counter_shards.getValue();
 
   log_level_ = default_log_level;
   for (size_t i = 0; i < ARRAY_SIZE(spdlog::level::level_string_views); i++) {
@@ -274,6 +279,7 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
+  command_line_options->set_stats_counter_shards(statsCounterShards());
   command_line_options->set_restart_epoch(restartEpoch());
   return command_line_options;
 }
@@ -286,6 +292,7 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       service_cluster_(service_cluster), service_node_(service_node), service_zone_(service_zone),
       file_flush_interval_msec_(10000), drain_time_(600), parent_shutdown_time_(900),
       mode_(Server::Mode::Serve), hot_restart_disabled_(false), signal_handling_enabled_(true),
-      mutex_tracing_enabled_(false), cpuset_threads_(false), libevent_buffer_enabled_(false) {}
+      mutex_tracing_enabled_(false), cpuset_threads_(false), libevent_buffer_enabled_(false),
+      stats_counter_shards_(0) {}
 
 } // namespace Envoy
@@ -71,6 +71,9 @@ public:
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setStatsCounterShards(uint32_t stats_counter_shards) {
+    stats_counter_shards_ = stats_counter_shards;
+  }
 
   // Server::Options
   uint64_t baseId() const override { return base_id_; }
@@ -106,6 +109,7 @@ public:
   virtual Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  uint32_t statsCounterShards() const override { return stats_counter_shards_; }
   uint32_t count() const;
 
 private:
@@ -136,6 +140,7 @@ private:
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
   bool libevent_buffer_enabled_;
+  uint32_t stats_counter_shards_;
   uint32_t count_;
 };
 
@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "envoy/admin/v2alpha/config_dump.pb.h"
 #include "envoy/config/bootstrap/v2//bootstrap.pb.validate.h"
@@ -131,11 +132,14 @@ void InstanceImpl::drainListeners() {
 
 void InstanceImpl::failHealthcheck(bool fail) { server_stats_->live_.set(!fail); }
 
-MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, bool track_changes) {
   snapped_counters_ = store.counters();
   counters_.reserve(snapped_counters_.size());
   for (const auto& counter : snapped_counters_) {
     counters_.push_back({counter->latch(), *counter});
+    if (track_changes && counters_.back().delta_ > 0) {
+      changed_metrics_.counters_.push_back(counters_.back());
+    }
   }
 
   snapped_gauges_ = store.gauges();
@@ -143,12 +147,19 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
   for (const auto& gauge : snapped_gauges_) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
     gauges_.push_back(*gauge);
+    // Latching is an atomic read-modify-write per gauge, so it is only done if a sink wants it.
+    if (track_changes && gauge->latchChanged()) {
+      changed_metrics_.gauges_.push_back(*gauge);
+    }
   }
 
   snapped_histograms_ = store.histograms();
   histograms_.reserve(snapped_histograms_.size());
   for (const auto& histogram : snapped_histograms_) {
     histograms_.push_back(*histogram);
+    if (track_changes && histogram->intervalStatistics().sampleCount() > 0) {
+      changed_metrics_.histograms_.push_back(*histogram);
+    }
   }
 }
 
@@ -158,9 +169,22 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
   // NOTE: Even if there are no sinks, creating the snapshot has the important property that it
   //       latches all counters on a periodic basis. The hot restart code assumes this is being
   //       done so this should not be removed.
-  MetricSnapshotImpl snapshot(store);
+  std::vector<uint8_t> changed_metrics_only(sinks.size());
+  bool track_changes = false;
+  size_t i = 0;
   for (const auto& sink : sinks) {
-    sink->flush(snapshot);
+    changed_metrics_only[i] = sink->changedMetricsOnly();
+    track_changes |= changed_metrics_only[i];
+    ++i;
+  }
+  MetricSnapshotImpl snapshot(store, track_changes);
+  i = 0;
+  for (const auto& sink : sinks) {
+    if (changed_metrics_only[i++]) {
+      sink->flush(snapshot.changedMetrics());
+    } else {
+      sink->flush(snapshot);
+    }
   }
 }
 
@@ -259,6 +283,7 @@ void InstanceImpl::initialize(const Options& options,
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
@@ -342,6 +367,12 @@ void InstanceImpl::initialize(const Options& options,
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ =
       std::make_unique<Extensions::TransportSockets::Tls::ContextManagerImpl>(time_source_);
+  // Resume the TLS sessions established with our parent, if any, before listeners are created.
+  const std::string tls_session_state = restarter_.getParentTlsSessionState();
+  if (!tls_session_state.empty() &&
+      !ssl_context_manager_->importServerSessionState(tls_session_state)) {
+    ENVOY_LOG(warn, "unable to import TLS session state from the parent process");
+  }
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, *random_generator_,
@@ -299,7 +299,13 @@ private:
 //                     copying and probably be a cleaner API in general.
 class MetricSnapshotImpl : public Stats::MetricSnapshot {
 public:
-  explicit MetricSnapshotImpl(Stats::Store& store);
+  /**
+   * @param store supplies the store to snapshot.
+   * @param track_changes supplies whether to also collect changedMetrics(). If false, gauges
+   *        keep their changed state, which then covers every update since the last tracking
+   *        snapshot.
+   */
+  MetricSnapshotImpl(Stats::Store& store, bool track_changes);
 
   // Stats::MetricSnapshot
   const std::vector<CounterSnapshot>& counters() override { return counters_; }
@@ -310,13 +316,37 @@ public:
     return histograms_;
   }
 
+  /**
+   * @return Stats::MetricSnapshot& the subset of this snapshot that changed since the previous
+   *         snapshot, for sinks that only want changed metrics. Empty unless the snapshot was
+   *         created with track_changes.
+   */
+  Stats::MetricSnapshot& changedMetrics() { return changed_metrics_; }
+
 private:
+  struct ChangedMetricSnapshot : public Stats::MetricSnapshot {
+    // Stats::MetricSnapshot
+    const std::vector<CounterSnapshot>& counters() override { return counters_; }
+    const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
+      return gauges_;
+    }
+    const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>&
+    histograms() override {
+      return histograms_;
+    }
+
+    std::vector<CounterSnapshot> counters_;
+    std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+    std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  };
+
   std::vector<Stats::CounterSharedPtr> snapped_counters_;
   std::vector<CounterSnapshot> counters_;
   std::vector<Stats::GaugeSharedPtr> snapped_gauges_;
   std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
   std::vector<Stats::ParentHistogramSharedPtr> snapped_histograms_;
   std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
+  ChangedMetricSnapshot changed_metrics_;
 };
 
 } // namespace Server
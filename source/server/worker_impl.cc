@@ -67,6 +67,16 @@ void WorkerImpl::removeListener(Network::ListenerConfig& listener,
   });
 }
 
+void WorkerImpl::removeFilterChains(uint64_t listener_tag,
+                                    const std::vector<const Network::FilterChain*>& filter_chains,
+                                    std::function<void()> completion) {
+  ASSERT(thread_);
+  dispatcher_->post([this, listener_tag, filter_chains, completion]() -> void {
+    handler_->removeFilterChains(listener_tag, filter_chains);
+    completion();
+  });
+}
+
 void WorkerImpl::start(GuardDog& guard_dog) {
   ASSERT(!thread_);
   thread_ =
@@ -44,6 +44,9 @@ public:
   void addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) override;
   uint64_t numConnections() override;
   void removeListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
+  void removeFilterChains(uint64_t listener_tag,
+                          const std::vector<const Network::FilterChain*>& filter_chains,
+                          std::function<void()> completion) override;
   void start(GuardDog& guard_dog) override;
   void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
   void stop() override;
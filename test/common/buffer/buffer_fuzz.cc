@@ -137,6 +137,8 @@ public:
     return result;
   }
 
+  void bindAccount(Buffer::BufferMemoryAccountSharedPtr) override {}
+
   std::string data_;
   std::unique_ptr<char[]> tmp_buf_{new char[MaxAllocation]};
 };
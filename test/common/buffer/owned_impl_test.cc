@@ -520,6 +520,65 @@ TEST_P(OwnedImplTest, ReserveZeroCommit) {
   EXPECT_EQ("bbbbb", buf.toString().substr(0, 5));
 }
 
+class TestBufferMemoryAccount : public BufferMemoryAccount {
+public:
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override { balance_ += amount; }
+  void credit(uint64_t amount) override {
+    ASSERT_GE(balance_, amount);
+    balance_ -= amount;
+  }
+  uint64_t balance() const override { return balance_; }
+
+  uint64_t balance_{0};
+};
+
+TEST_P(OwnedImplTest, Account) {
+  auto account = std::make_shared<TestBufferMemoryAccount>();
+  Buffer::OwnedImpl buffer("abc");
+  buffer.bindAccount(account);
+  EXPECT_EQ(3, account->balance());
+  buffer.add("defg");
+  EXPECT_EQ(7, account->balance());
+  buffer.prepend("h");
+  buffer.drain(2);
+  EXPECT_EQ(6, account->balance());
+
+  {
+    Buffer::OwnedImpl other;
+    other.bindAccount(account);
+    other.move(buffer, 4);
+    EXPECT_EQ(6, account->balance());
+
+    // Bytes moved in from an unaccounted buffer are charged.
+    Buffer::OwnedImpl unaccounted("ij");
+    other.move(unaccounted);
+    EXPECT_EQ(8, account->balance());
+
+    Buffer::RawSlice iovec;
+    EXPECT_EQ(1, other.reserve(16, &iovec, 1));
+    iovec.len_ = 4;
+    other.commit(&iovec, 1);
+    EXPECT_EQ(12, account->balance());
+    EXPECT_EQ(10, other.length());
+
+    // Bytes moved out to an unaccounted buffer are credited.
+    unaccounted.move(other, 3);
+    EXPECT_EQ(9, account->balance());
+  }
+  // Destroying a buffer credits what it held.
+  EXPECT_EQ(2, account->balance());
+
+  auto other_account = std::make_shared<TestBufferMemoryAccount>();
+  buffer.bindAccount(other_account);
+  EXPECT_EQ(0, account->balance());
+  EXPECT_EQ(2, other_account->balance());
+
+  buffer.bindAccount(nullptr);
+  buffer.add("k");
+  EXPECT_EQ(0, other_account->balance());
+}
+
 TEST(OverflowDetectingUInt64, Arithmetic) {
   Logger::StderrSinkDelegate stderr_sink(Logger::Registry::getSink()); // For coverage build.
   OverflowDetectingUInt64 length;
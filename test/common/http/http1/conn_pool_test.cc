@@ -723,6 +723,61 @@ TEST_F(Http1ConnPoolImplTest, ConcurrentConnections) {
   EXPECT_EQ(2U, cluster_->stats_.upstream_cx_destroy_remote_.value());
 }
 
+/**
+ * Test that a request preconnects up to the configured ratio and that the preconnected client
+ * serves the next request.
+ */
+TEST_F(Http1ConnPoolImplTest, PreconnectOnDemand) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  cluster_->per_upstream_preconnect_ratio_ = 2.0;
+  InSequence s;
+
+  // Request 1 kicks off a connection for itself and preconnects a second one.
+  conn_pool_.expectClientCreate();
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::CreateConnection);
+  r1.startRequest();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // Request 2 uses the preconnected client immediately. The circuit breaker prevents any further
+  // preconnects.
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Immediate);
+  r2.startRequest();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_wasted_.value());
+}
+
+/**
+ * Test that a preconnected client that never serves a request is counted as wasted.
+ */
+TEST_F(Http1ConnPoolImplTest, PreconnectUnused) {
+  InSequence s;
+
+  conn_pool_.expectClientCreate();
+  conn_pool_.preconnect(1);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+
+  // The pool already holds enough connections.
+  conn_pool_.preconnect(1);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_wasted_.value());
+}
+
 TEST_F(Http1ConnPoolImplTest, DrainCallback) {
   InSequence s;
   ReadyWatcher drained;
@@ -702,6 +702,55 @@ TEST_F(Http2ConnPoolImplTest, GoAway) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_close_notify_.value());
 }
 
+// A preconnected primary client is used by the next stream instead of a new connection.
+TEST_F(Http2ConnPoolImplTest, PreconnectUsed) {
+  InSequence s;
+
+  expectClientCreate();
+  pool_.preconnect(1);
+  // All streams share the primary client, so it is the only connection preconnected.
+  pool_.preconnect(2);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+
+  EXPECT_CALL(*test_clients_[0].connect_timer_, disableTimer());
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  ActiveTestRequest r1(*this, 0, true);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+  ActiveTestRequest r2(*this, 0, true);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+  completeRequest(r1);
+  completeRequestCloseUpstream(0, r2);
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_wasted_.value());
+}
+
+// A preconnected client closed before carrying any stream is counted as wasted.
+TEST_F(Http2ConnPoolImplTest, PreconnectWasted) {
+  InSequence s;
+
+  expectClientCreate();
+  pool_.preconnect(1);
+  EXPECT_CALL(*test_clients_[0].connect_timer_, disableTimer());
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  closeClient(0);
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_wasted_.value());
+}
+
+// Nothing is preconnected when no connection is asked for, or the circuit breaker is open.
+TEST_F(Http2ConnPoolImplTest, PreconnectNotNeeded) {
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  pool_.preconnect(0);
+
+  cluster_->resetResourceManager(0, 1024, 1024, 1, 1);
+  pool_.preconnect(1);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+}
+
 TEST_F(Http2ConnPoolImplTest, NoActiveConnectionsByDefault) {
   EXPECT_FALSE(pool_.hasActiveConnections());
 }
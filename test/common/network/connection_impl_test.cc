@@ -509,6 +509,42 @@ TEST_P(ConnectionImplTest, ReadDisable) {
   disconnect(false);
 }
 
+// The read and write buffers of the connection are charged to its memory account, not to its
+// receive account.
+TEST_P(ConnectionImplTest, BufferMemoryAccounts) {
+  setUpBasicConnection();
+  connect();
+
+  auto receive_account = std::make_shared<NiceMock<MockBufferMemoryAccount>>();
+  auto account = std::make_shared<NiceMock<MockBufferMemoryAccount>>();
+  server_connection_->setBufferMemoryAccounts(receive_account, account);
+  EXPECT_EQ(receive_account, server_connection_->receiveBufferMemoryAccount());
+  EXPECT_EQ(account, server_connection_->bufferMemoryAccount());
+  EXPECT_CALL(*receive_account, charge(_)).Times(0);
+
+  EXPECT_CALL(*account, charge(11));
+  EXPECT_CALL(*read_filter_, onData(_, false))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> FilterStatus {
+        EXPECT_EQ(11, account->balance());
+        data.drain(data.length());
+        EXPECT_EQ(0, account->balance());
+        dispatcher_->exit();
+        return FilterStatus::StopIteration;
+      }));
+  Buffer::OwnedImpl request("hello world");
+  client_connection_->write(request, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_CALL(*account, charge(5));
+  EXPECT_CALL(*account, credit(5));
+  Buffer::OwnedImpl response("hello");
+  server_connection_->write(response, false);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, account->balance());
+
+  disconnect(true);
+}
+
 // Regression test for (at least one failure mode of)
 // https://github.com/envoyproxy/envoy/issues/3639 where readDisable on a close
 // connection caused a crash.
@@ -2638,6 +2638,7 @@ virtual_hosts:
         additional_request_chance:
           numerator: 4
           denominator: HUNDRED
+        hedge_delay_percentile: {value: 95}
   - match: {prefix: /bar}
     route: {cluster: www}
   - match: {prefix: /}
@@ -2668,6 +2669,10 @@ virtual_hosts:
           .additionalRequestChance();
   EXPECT_EQ(4, percent.numerator());
   EXPECT_EQ(100, ProtobufPercentHelper::fractionalPercentDenominatorToInt(percent.denominator()));
+  EXPECT_NE(nullptr, config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+                         ->routeEntry()
+                         ->hedgePolicy()
+                         .hedgeDelayEstimator());
 
   EXPECT_EQ(1, config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
                    ->routeEntry()
@@ -2682,6 +2687,10 @@ virtual_hosts:
                 ->hedgePolicy()
                 .additionalRequestChance();
   EXPECT_EQ(0, percent.numerator());
+  EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
+                         ->routeEntry()
+                         ->hedgePolicy()
+                         .hedgeDelayEstimator());
 
   EXPECT_EQ(5, config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
                    ->routeEntry()
@@ -3016,6 +3025,155 @@ virtual_hosts:
   }
 }
 
+TEST_F(RouteMatcherTest, RequestStats) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: www2
+    domains: ["www.lyft.com"]
+    request_stats: true
+    routes:
+      - match: { prefix: "/users"}
+        stat_prefix: users
+        route: { cluster: www2 }
+      - match: { prefix: "/accounts"}
+        stat_prefix: users
+        route: { cluster: www2 }
+      - match: { prefix: "/rides"}
+        stat_prefix: rides
+        route:
+          weighted_clusters:
+            clusters:
+              - name: www2
+                weight: 50
+              - name: www2_staging
+                weight: 50
+      - match: { prefix: "/"}
+        route: { cluster: www2 }
+  - name: api
+    domains: ["api.lyft.com"]
+    routes:
+      - match: { prefix: "/"}
+        stat_prefix: users
+        route: { cluster: www2 }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, false);
+
+  auto route_stats = [&config](const std::string& host, const std::string& path) {
+    return config.route(genHeaders(host, path, "GET"), 0)->routeEntry()->requestStats();
+  };
+
+  const RouteStats* users = route_stats("www.lyft.com", "/users");
+  ASSERT_NE(nullptr, users);
+  EXPECT_EQ("vhost.www2.route.users.upstream_rq_completed", users->upstream_rq_completed_.name());
+  EXPECT_EQ("vhost.www2.route.users.upstream_rq_time", users->upstream_rq_time_.name());
+  // Routes with the same stat prefix share their stats.
+  EXPECT_EQ(users, route_stats("www.lyft.com", "/accounts"));
+
+  // Each weighted cluster uses the stats of its route.
+  for (uint64_t random_value : {0, 75}) {
+    const RouteStats* rides =
+        config.route(genHeaders("www.lyft.com", "/rides", "GET"), random_value)
+            ->routeEntry()
+            ->requestStats();
+    ASSERT_NE(nullptr, rides);
+    EXPECT_EQ("vhost.www2.route.rides.upstream_rq_2xx", rides->upstream_rq_2xx_.name());
+  }
+
+  EXPECT_EQ(nullptr, route_stats("www.lyft.com", "/"));
+
+  const RouteStats* vhost_stats = config.route(genHeaders("www.lyft.com", "/", "GET"), 0)
+                                       ->routeEntry()
+                                       ->virtualHost()
+                                       .requestStats();
+  ASSERT_NE(nullptr, vhost_stats);
+  EXPECT_EQ("vhost.www2.upstream_rq_5xx", vhost_stats->upstream_rq_5xx_.name());
+
+  // The stats of routes in different virtual hosts are distinct.
+  const RouteStats* api_users = route_stats("api.lyft.com", "/");
+  ASSERT_NE(nullptr, api_users);
+  EXPECT_EQ("vhost.api.route.users.upstream_rq_completed",
+            api_users->upstream_rq_completed_.name());
+  EXPECT_EQ(nullptr, config.route(genHeaders("api.lyft.com", "/", "GET"), 0)
+                         ->routeEntry()
+                         ->virtualHost()
+                         .requestStats());
+}
+
+TEST_F(RouteMatcherTest, RequestStatsLimit) {
+  const std::string yaml = R"EOF(
+max_route_stats: 2
+virtual_hosts:
+  - name: www2
+    domains: ["www.lyft.com"]
+    routes:
+      - match: { prefix: "/users"}
+        stat_prefix: users
+        route: { cluster: www2 }
+      - match: { prefix: "/rides"}
+        stat_prefix: rides
+        route: { cluster: www2 }
+      - match: { prefix: "/accounts"}
+        stat_prefix: users
+        route: { cluster: www2 }
+      - match: { prefix: "/payments"}
+        stat_prefix: payments
+        route: { cluster: www2 }
+  - name: api
+    domains: ["api.lyft.com"]
+    request_stats: true
+    routes:
+      - match: { prefix: "/"}
+        stat_prefix: users
+        route: { cluster: www2 }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, false);
+
+  auto route_stat_name = [&config](const std::string& host, const std::string& path) {
+    return config.route(genHeaders(host, path, "GET"), 0)
+        ->routeEntry()
+        ->requestStats()
+        ->upstream_rq_completed_.name();
+  };
+
+  EXPECT_EQ("vhost.www2.route.users.upstream_rq_completed",
+            route_stat_name("www.lyft.com", "/users"));
+  EXPECT_EQ("vhost.www2.route.rides.upstream_rq_completed",
+            route_stat_name("www.lyft.com", "/rides"));
+  // Existing route stats may still be shared once the limit is reached.
+  EXPECT_EQ("vhost.www2.route.users.upstream_rq_completed",
+            route_stat_name("www.lyft.com", "/accounts"));
+  EXPECT_EQ("vhost.www2.route.other.upstream_rq_completed",
+            route_stat_name("www.lyft.com", "/payments"));
+  EXPECT_EQ("vhost.api.route.other.upstream_rq_completed", route_stat_name("api.lyft.com", "/"));
+  // Virtual host stats do not count towards the limit.
+  EXPECT_EQ("vhost.api.upstream_rq_completed",
+            config.route(genHeaders("api.lyft.com", "/", "GET"), 0)
+                ->routeEntry()
+                ->virtualHost()
+                .requestStats()
+                ->upstream_rq_completed_.name());
+}
+
+// The stat prefix of the routes beyond the limit is reserved, so that their stats never mix with
+// those of a route.
+TEST_F(RouteMatcherTest, RequestStatsOtherReserved) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: www2
+    domains: ["www.lyft.com"]
+    routes:
+      - match: { prefix: "/"}
+        stat_prefix: other
+        route: { cluster: www2 }
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(
+      TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, false),
+      EnvoyException, "route: stat_prefix 'other' is reserved for routes beyond max_route_stats");
+}
+
 TEST_F(RouteMatcherTest, DirectResponse) {
   const auto pathname =
       TestEnvironment::writeStringToFileForTest("direct_response_body", "Example text 3");
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <vector>
+
+#include "common/router/hedge_delay_estimator_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+TEST(HedgeDelayEstimatorImplTest, BucketBounds) {
+  for (int64_t ms = 0; ms < 200000; ms++) {
+    const uint32_t index = HedgeDelayEstimatorImpl::bucketIndex(std::chrono::milliseconds(ms));
+    ASSERT_LT(index, 64U);
+    if (ms <= 131071) {
+      EXPECT_GE(HedgeDelayEstimatorImpl::bucketUpperBound(index).count(), ms);
+      if (index > 0) {
+        EXPECT_LT(HedgeDelayEstimatorImpl::bucketUpperBound(index - 1).count(), ms);
+      }
+    } else {
+      EXPECT_EQ(63U, index);
+    }
+  }
+  EXPECT_EQ(0U, HedgeDelayEstimatorImpl::bucketIndex(std::chrono::milliseconds(-5)));
+}
+
+TEST(HedgeDelayEstimatorImplTest, NoDelayUntilEnoughSamples) {
+  HedgeDelayEstimatorImpl estimator(90);
+  for (uint32_t i = 0; i < 96; i++) {
+    estimator.recordResponseTime(std::chrono::milliseconds(10));
+  }
+  EXPECT_FALSE(estimator.hedgeDelay().has_value());
+
+  for (uint32_t i = 0; i < 16; i++) {
+    estimator.recordResponseTime(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(11), estimator.hedgeDelay());
+}
+
+TEST(HedgeDelayEstimatorImplTest, Percentile) {
+  HedgeDelayEstimatorImpl estimator(90);
+  // 90% of responses take 10ms and 10% take 500ms.
+  for (uint32_t i = 0; i < 800; i++) {
+    estimator.recordResponseTime(std::chrono::milliseconds(i % 10 == 0 ? 500 : 10));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(11), estimator.hedgeDelay());
+
+  HedgeDelayEstimatorImpl p99_estimator(99);
+  for (uint32_t i = 0; i < 800; i++) {
+    p99_estimator.recordResponseTime(std::chrono::milliseconds(i % 10 == 0 ? 500 : 10));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(511), p99_estimator.hedgeDelay());
+}
+
+// Old samples decay so that the estimate follows a change in latency.
+TEST(HedgeDelayEstimatorImplTest, TracksRecentLatency) {
+  HedgeDelayEstimatorImpl estimator(50);
+  for (uint32_t i = 0; i < 2000; i++) {
+    estimator.recordResponseTime(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(11), estimator.hedgeDelay());
+
+  for (uint32_t i = 0; i < 2000; i++) {
+    estimator.recordResponseTime(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(111), estimator.hedgeDelay());
+}
+
+// Workers record and recompute concurrently. Decays never overlap, so no bucket wraps around.
+TEST(HedgeDelayEstimatorImplTest, ConcurrentRecording) {
+  HedgeDelayEstimatorImpl estimator(50);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < 4; i++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&estimator]() {
+      for (uint32_t j = 0; j < 100000; j++) {
+        estimator.recordResponseTime(std::chrono::milliseconds(10));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(std::chrono::milliseconds(11), estimator.hedgeDelay());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
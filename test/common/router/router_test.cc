@@ -124,6 +124,13 @@ public:
     return AssertionSuccess();
   }
 
+  void expectHedgeStats(uint64_t sent, uint64_t won, uint64_t cancelled) {
+    auto& stats_store = cm_.thread_local_cluster_.cluster_.info_->stats_store_;
+    EXPECT_EQ(sent, stats_store.counter("upstream_rq_hedge_sent").value());
+    EXPECT_EQ(won, stats_store.counter("upstream_rq_hedge_won").value());
+    EXPECT_EQ(cancelled, stats_store.counter("upstream_rq_hedge_cancelled").value());
+  }
+
   void verifyMetadataMatchCriteriaFromRequest(bool route_entry_has_match) {
     ProtobufWkt::Struct request_struct, route_struct;
     ProtobufWkt::Value val;
@@ -1568,7 +1575,7 @@ TEST_F(RouterTest, HedgedPerTryTimeoutFirstRequestSucceeds) {
   response_decoder1->decodeHeaders(std::move(response_headers), true);
   EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
 
-  // TODO: Verify hedge stats here once they are implemented.
+  expectHedgeStats(1, 0, 1);
 }
 
 // Three requests sent: 1) 5xx error, 2) per try timeout, 3) gets good response
@@ -1654,7 +1661,7 @@ TEST_F(RouterTest, HedgedPerTryTimeoutThirdRequestSucceeds) {
   response_decoder3->decodeHeaders(std::move(response_headers2), true);
   EXPECT_TRUE(verifyHostUpstreamStats(1, 1));
 
-  // TODO: Verify hedge stats here once they are implemented.
+  expectHedgeStats(1, 1, 1);
 }
 
 // First request times out and is retried, and then a response is received.
@@ -1858,7 +1865,147 @@ TEST_F(RouterTest, HedgedPerTryTimeoutGlobalTimeout) {
   response_timeout_->callback_();
   EXPECT_TRUE(verifyHostUpstreamStats(0, 2));
   EXPECT_EQ(2, cm_.conn_pool_.host_->stats_store_.counter("rq_timeout").value());
-  // TODO: Verify hedge stats here once they are implemented.
+  expectHedgeStats(1, 0, 0);
+}
+
+// Two initial requests are sent as soon as the downstream request is complete
+// and the second one wins.
+TEST_F(RouterTest, HedgedInitialRequestsSecondRequestSucceeds) {
+  callbacks_.route_->route_entry_.hedge_policy_.initial_requests_ = 2;
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder1 = nullptr;
+  NiceMock<Http::MockStreamEncoder> encoder2;
+  Http::StreamDecoder* response_decoder2 = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder1 = &decoder;
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_);
+        return nullptr;
+      }))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder2 = &decoder;
+        callbacks.onPoolReady(encoder2, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+  ASSERT_NE(nullptr, response_decoder2);
+  expectHedgeStats(1, 0, 0);
+
+  // Write a 200 back on the second request. We expect the first stream to be
+  // reset.
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(cm_.conn_pool_.host_->outlier_detector_, putHttpResponseCode(200));
+  EXPECT_CALL(encoder1.stream_, resetStream(_));
+  EXPECT_CALL(encoder2.stream_, resetStream(_)).Times(0);
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder2->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+  expectHedgeStats(1, 1, 1);
+}
+
+// With an adaptive hedge delay the second initial request is only sent once
+// the delay expires, and response times are fed back into the estimator.
+TEST_F(RouterTest, HedgedInitialRequestsAfterDelay) {
+  NiceMock<MockHedgeDelayEstimator> hedge_delay_estimator;
+  callbacks_.route_->route_entry_.hedge_policy_.initial_requests_ = 2;
+  callbacks_.route_->route_entry_.hedge_policy_.hedge_delay_estimator_ = &hedge_delay_estimator;
+  EXPECT_CALL(hedge_delay_estimator, hedgeDelay())
+      .WillOnce(Return(std::chrono::milliseconds(20)));
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  Http::StreamDecoder* response_decoder1 = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder1 = &decoder;
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  Event::MockTimer* hedge_timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timer, enableTimer(std::chrono::milliseconds(20)));
+  EXPECT_CALL(*hedge_timer, disableTimer());
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+  expectHedgeStats(0, 0, 0);
+
+  test_time_.sleep(std::chrono::milliseconds(30));
+  NiceMock<Http::MockStreamEncoder> encoder2;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder2, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  hedge_timer->callback_();
+  expectHedgeStats(1, 0, 0);
+
+  // The first request still wins the race.
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(hedge_delay_estimator, recordResponseTime(std::chrono::milliseconds(30)));
+  EXPECT_CALL(cm_.conn_pool_.host_->outlier_detector_, putHttpResponseCode(200));
+  EXPECT_CALL(encoder1.stream_, resetStream(_)).Times(0);
+  EXPECT_CALL(encoder2.stream_, resetStream(_));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder1->decodeHeaders(std::move(response_headers), true);
+  expectHedgeStats(1, 0, 1);
+}
+
+// When the hedge wins, the abandoned first request is recorded with the time it was outstanding.
+TEST_F(RouterTest, HedgedInitialRequestsAfterDelayHedgeWins) {
+  NiceMock<MockHedgeDelayEstimator> hedge_delay_estimator;
+  callbacks_.route_->route_entry_.hedge_policy_.initial_requests_ = 2;
+  callbacks_.route_->route_entry_.hedge_policy_.hedge_delay_estimator_ = &hedge_delay_estimator;
+  EXPECT_CALL(hedge_delay_estimator, hedgeDelay())
+      .WillOnce(Return(std::chrono::milliseconds(20)));
+
+  NiceMock<Http::MockStreamEncoder> encoder1;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder1, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  Event::MockTimer* hedge_timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*hedge_timer, enableTimer(std::chrono::milliseconds(20)));
+  EXPECT_CALL(*hedge_timer, disableTimer());
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  test_time_.sleep(std::chrono::milliseconds(30));
+  NiceMock<Http::MockStreamEncoder> encoder2;
+  Http::StreamDecoder* response_decoder2 = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder2 = &decoder;
+        callbacks.onPoolReady(encoder2, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  hedge_timer->callback_();
+
+  test_time_.sleep(std::chrono::milliseconds(10));
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  EXPECT_CALL(hedge_delay_estimator, recordResponseTime(std::chrono::milliseconds(10)));
+  EXPECT_CALL(hedge_delay_estimator, recordResponseTime(std::chrono::milliseconds(40)));
+  EXPECT_CALL(cm_.conn_pool_.host_->outlier_detector_, putHttpResponseCode(200));
+  EXPECT_CALL(encoder1.stream_, resetStream(_));
+  EXPECT_CALL(encoder2.stream_, resetStream(_)).Times(0);
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, true));
+  response_decoder2->decodeHeaders(std::move(response_headers), true);
+  expectHedgeStats(1, 1, 1);
 }
 
 // Sequence: 1) per try timeout w/ hedge retry, 2) second request gets a 5xx
@@ -2979,6 +3126,42 @@ TEST_F(RouterTest, AltStatName) {
                     .value());
 }
 
+TEST_F(RouterTest, RequestStats) {
+  RouteStats route_stats{ALL_ROUTE_STATS(POOL_COUNTER_PREFIX(stats_store_, "route."),
+                                         POOL_HISTOGRAM_PREFIX(stats_store_, "route."))};
+  RouteStats vhost_stats{ALL_ROUTE_STATS(POOL_COUNTER_PREFIX(stats_store_, "vhost."),
+                                         POOL_HISTOGRAM_PREFIX(stats_store_, "vhost."))};
+  ON_CALL(callbacks_.route_->route_entry_, requestStats()).WillByDefault(Return(&route_stats));
+  ON_CALL(callbacks_.route_->route_entry_.virtual_host_, requestStats())
+      .WillByDefault(Return(&vhost_stats));
+
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(stats_store_, deliverHistogramToSinks(_, _)).Times(testing::AnyNumber());
+  EXPECT_CALL(stats_store_, deliverHistogramToSinks(Ref(route_stats.upstream_rq_time_), _));
+  EXPECT_CALL(stats_store_, deliverHistogramToSinks(Ref(vhost_stats.upstream_rq_time_), _));
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "503"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+
+  for (const RouteStats* stats : {&route_stats, &vhost_stats}) {
+    EXPECT_EQ(1U, stats->upstream_rq_completed_.value());
+    EXPECT_EQ(1U, stats->upstream_rq_5xx_.value());
+    EXPECT_EQ(0U, stats->upstream_rq_2xx_.value());
+  }
+}
+
 TEST_F(RouterTest, Redirect) {
   MockDirectResponseEntry direct_response;
   std::string route_name("route-test-name");
@@ -3249,12 +3432,13 @@ TEST_F(RouterTest, UpstreamTimingTimeout) {
 
 TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
   Http::TestHeaderMapImpl empty_headers;
+  NiceMock<Runtime::MockRandomGenerator> random;
   { // route says true, header not present, expect true.
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = true;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
     FilterUtility::HedgingParams hedgingParams =
-        FilterUtility::finalHedgingParams(route, empty_headers);
+        FilterUtility::finalHedgingParams(route, empty_headers, random);
     EXPECT_TRUE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says false, header not present, expect false.
@@ -3262,7 +3446,7 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     route.hedge_policy_.hedge_on_per_try_timeout_ = false;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
     FilterUtility::HedgingParams hedgingParams =
-        FilterUtility::finalHedgingParams(route, empty_headers);
+        FilterUtility::finalHedgingParams(route, empty_headers, random);
     EXPECT_FALSE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says false, header says true, expect true.
@@ -3270,7 +3454,8 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = false;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
-    FilterUtility::HedgingParams hedgingParams = FilterUtility::finalHedgingParams(route, headers);
+    FilterUtility::HedgingParams hedgingParams =
+        FilterUtility::finalHedgingParams(route, headers, random);
     EXPECT_TRUE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says false, header says false, expect false.
@@ -3278,7 +3463,8 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = false;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
-    FilterUtility::HedgingParams hedgingParams = FilterUtility::finalHedgingParams(route, headers);
+    FilterUtility::HedgingParams hedgingParams =
+        FilterUtility::finalHedgingParams(route, headers, random);
     EXPECT_FALSE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says true, header says false, expect false.
@@ -3286,7 +3472,8 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = true;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
-    FilterUtility::HedgingParams hedgingParams = FilterUtility::finalHedgingParams(route, headers);
+    FilterUtility::HedgingParams hedgingParams =
+        FilterUtility::finalHedgingParams(route, headers, random);
     EXPECT_FALSE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says true, header says true, expect true.
@@ -3294,7 +3481,8 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = true;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
-    FilterUtility::HedgingParams hedgingParams = FilterUtility::finalHedgingParams(route, headers);
+    FilterUtility::HedgingParams hedgingParams =
+        FilterUtility::finalHedgingParams(route, headers, random);
     EXPECT_TRUE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says true, header is invalid, expect true.
@@ -3302,7 +3490,8 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = true;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
-    FilterUtility::HedgingParams hedgingParams = FilterUtility::finalHedgingParams(route, headers);
+    FilterUtility::HedgingParams hedgingParams =
+        FilterUtility::finalHedgingParams(route, headers, random);
     EXPECT_TRUE(hedgingParams.hedge_on_per_try_timeout_);
   }
   { // route says false, header is invalid, expect false.
@@ -3310,11 +3499,33 @@ TEST(RouterFilterUtilityTest, FinalHedgingParamsHedgeOnPerTryTimeout) {
     NiceMock<MockRouteEntry> route;
     route.hedge_policy_.hedge_on_per_try_timeout_ = false;
     EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
-    FilterUtility::HedgingParams hedgingParams = FilterUtility::finalHedgingParams(route, headers);
+    FilterUtility::HedgingParams hedgingParams =
+        FilterUtility::finalHedgingParams(route, headers, random);
     EXPECT_FALSE(hedgingParams.hedge_on_per_try_timeout_);
   }
 }
 
+TEST(RouterFilterUtilityTest, FinalHedgingParamsInitialRequests) {
+  Http::TestHeaderMapImpl headers;
+  NiceMock<Runtime::MockRandomGenerator> random;
+  NiceMock<MockRouteEntry> route;
+  EXPECT_CALL(route, hedgePolicy).WillRepeatedly(ReturnRef(route.hedge_policy_));
+  route.hedge_policy_.initial_requests_ = 2;
+  route.hedge_policy_.additional_request_chance_.set_numerator(50);
+  route.hedge_policy_.additional_request_chance_.set_denominator(
+      envoy::type::FractionalPercent::HUNDRED);
+
+  EXPECT_CALL(random, random()).WillOnce(Return(49));
+  EXPECT_EQ(3U, FilterUtility::finalHedgingParams(route, headers, random).initial_requests_);
+  EXPECT_CALL(random, random()).WillOnce(Return(50));
+  EXPECT_EQ(2U, FilterUtility::finalHedgingParams(route, headers, random).initial_requests_);
+
+  // Without an additional request chance no random number is drawn.
+  route.hedge_policy_.additional_request_chance_.set_numerator(0);
+  EXPECT_CALL(random, random()).Times(0);
+  EXPECT_EQ(2U, FilterUtility::finalHedgingParams(route, headers, random).initial_requests_);
+}
+
 TEST(RouterFilterUtilityTest, FinalTimeout) {
   {
     NiceMock<MockRouteEntry> route;
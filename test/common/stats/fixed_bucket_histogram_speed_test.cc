@@ -0,0 +1,138 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "common/stats/fixed_bucket_histogram.h"
+
+#include "benchmark/benchmark.h"
+#include "circllhist.h"
+
+namespace {
+
+// The number of values recorded, a power of 2 so that benchmarks can cycle through them cheaply.
+constexpr size_t NumValues = 4096;
+
+// Request latencies in milliseconds, log-normally distributed around 20ms with a long tail.
+std::vector<uint64_t> makeLatencies() {
+  std::mt19937_64 generator(42);
+  std::lognormal_distribution<double> distribution(3.0, 1.2);
+  std::vector<uint64_t> values(NumValues);
+  for (uint64_t& value : values) {
+    value = static_cast<uint64_t>(distribution(generator));
+  }
+  return values;
+}
+
+// Reports the largest relative error of the quantiles computed from histogram, compared to the
+// exact quantiles of the values recorded into it.
+void reportQuantileError(benchmark::State& state, const std::vector<uint64_t>& values,
+                         const histogram_t* histogram) {
+  const std::vector<double> quantiles{0.5, 0.9, 0.99, 0.999};
+  std::vector<double> computed(quantiles.size());
+  hist_approx_quantile(histogram, quantiles.data(), quantiles.size(), computed.data());
+
+  std::vector<uint64_t> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  double max_error = 0;
+  for (size_t i = 0; i < quantiles.size(); ++i) {
+    const double exact = sorted[static_cast<size_t>(quantiles[i] * (sorted.size() - 1))];
+    if (exact > 0) {
+      max_error = std::max(max_error, std::abs(computed[i] - exact) / exact);
+    }
+  }
+  state.counters["max_quantile_error"] = max_error;
+}
+
+} // namespace
+
+// Records values with hist_insert_intscale(), as a ThreadLocalHistogramImpl does by default.
+static void BM_CircllhistRecordValue(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeLatencies();
+  histogram_t* histogram = hist_alloc();
+  size_t index = 0;
+  for (auto _ : state) {
+    hist_insert_intscale(histogram, values[index], 0, 1);
+    index = (index + 1) & (NumValues - 1);
+  }
+
+  hist_clear(histogram);
+  for (uint64_t value : values) {
+    hist_insert_intscale(histogram, value, 0, 1);
+  }
+  reportQuantileError(state, values, histogram);
+  hist_free(histogram);
+}
+BENCHMARK(BM_CircllhistRecordValue);
+
+// Records values into fixed buckets, as a ThreadLocalHistogramImpl with fixed buckets does.
+static void BM_FixedBucketRecordValue(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeLatencies();
+  Envoy::Stats::FixedBucketHistogram histogram;
+  size_t index = 0;
+  for (auto _ : state) {
+    histogram.recordValue(values[index]);
+    index = (index + 1) & (NumValues - 1);
+  }
+
+  histogram_t* merged = hist_alloc();
+  histogram.merge(merged);
+  hist_clear(merged);
+  for (uint64_t value : values) {
+    histogram.recordValue(value);
+  }
+  histogram.merge(merged);
+  reportQuantileError(state, values, merged);
+  hist_free(merged);
+}
+BENCHMARK(BM_FixedBucketRecordValue);
+
+// Merges a flush interval's worth of values, as ParentHistogramImpl does for each thread.
+static void BM_CircllhistMerge(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeLatencies();
+  histogram_t* histogram = hist_alloc();
+  histogram_t* merged = hist_alloc();
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (uint64_t value : values) {
+      hist_insert_intscale(histogram, value, 0, 1);
+    }
+    state.ResumeTiming();
+    hist_accumulate(merged, &histogram, 1);
+    hist_clear(histogram);
+  }
+  hist_free(histogram);
+  hist_free(merged);
+}
+BENCHMARK(BM_CircllhistMerge);
+
+static void BM_FixedBucketMerge(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeLatencies();
+  Envoy::Stats::FixedBucketHistogram histogram;
+  histogram_t* merged = hist_alloc();
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (uint64_t value : values) {
+      histogram.recordValue(value);
+    }
+    state.ResumeTiming();
+    histogram.merge(merged);
+  }
+  hist_free(merged);
+}
+BENCHMARK(BM_FixedBucketMerge);
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
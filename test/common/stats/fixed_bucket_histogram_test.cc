@@ -0,0 +1,99 @@
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/stats/fixed_bucket_histogram.h"
+#include "common/stats/histogram_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "circllhist.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+void expectBucket(int val, int exp, uint64_t value) {
+  const hist_bucket_t bucket = FixedBucketHistogram::bucket(value);
+  EXPECT_EQ(val, bucket.val) << value;
+  EXPECT_EQ(exp, bucket.exp) << value;
+}
+
+TEST(FixedBucketHistogramTest, Bucket) {
+  expectBucket(0, 0, 0);
+  expectBucket(10, 0, 1);
+  expectBucket(90, 0, 9);
+  expectBucket(10, 1, 10);
+  expectBucket(99, 1, 99);
+  expectBucket(10, 2, 100);
+  expectBucket(12, 2, 129);
+  expectBucket(99, 2, 999);
+  expectBucket(10, 3, 1000);
+  expectBucket(10, 3, 1023);
+  expectBucket(10, 3, 1024);
+  expectBucket(45, 6, 4567890);
+  expectBucket(10, 19, 10000000000000000000U);
+  expectBucket(18, 19, std::numeric_limits<uint64_t>::max());
+}
+
+TEST(FixedBucketHistogramTest, MergeMatchesCircllhist) {
+  FixedBucketHistogram histogram;
+  EXPECT_FALSE(histogram.used());
+  histogram_t* expected = hist_alloc();
+  for (uint64_t value = 0; value < 100000; value = value * 3 / 2 + 1) {
+    for (uint64_t i = 0; i <= value % 7; ++i) {
+      histogram.recordValue(value);
+      hist_insert_intscale(expected, value, 0, 1);
+    }
+  }
+  EXPECT_TRUE(histogram.used());
+
+  histogram_t* merged = hist_alloc();
+  EXPECT_EQ(hist_sample_count(expected), histogram.merge(merged));
+  const HistogramStatisticsImpl expected_statistics(expected);
+  const HistogramStatisticsImpl merged_statistics(merged);
+  EXPECT_EQ(expected_statistics.sampleCount(), merged_statistics.sampleCount());
+  EXPECT_EQ(expected_statistics.sampleSum(), merged_statistics.sampleSum());
+  EXPECT_EQ(expected_statistics.quantileSummary(), merged_statistics.quantileSummary());
+  EXPECT_EQ(expected_statistics.bucketSummary(), merged_statistics.bucketSummary());
+
+  // The values were taken by the merge.
+  EXPECT_EQ(0, histogram.merge(merged));
+  EXPECT_EQ(hist_sample_count(expected), hist_sample_count(merged));
+  EXPECT_TRUE(histogram.used());
+
+  hist_free(expected);
+  hist_free(merged);
+}
+
+// Values recorded while merges run on another thread are each merged exactly once.
+TEST(FixedBucketHistogramTest, ConcurrentMerge) {
+  constexpr uint64_t NumValues = 1000000;
+  FixedBucketHistogram histogram;
+  std::atomic<bool> done{false};
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&histogram, &done]() {
+    for (uint64_t i = 0; i < NumValues; ++i) {
+      histogram.recordValue(i % 5000);
+    }
+    done = true;
+  });
+
+  histogram_t* merged = hist_alloc();
+  uint64_t merged_count = 0;
+  while (!done) {
+    merged_count += histogram.merge(merged);
+  }
+  thread->join();
+  merged_count += histogram.merge(merged);
+
+  EXPECT_EQ(NumValues, merged_count);
+  EXPECT_EQ(NumValues, hist_sample_count(merged));
+  hist_free(merged);
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
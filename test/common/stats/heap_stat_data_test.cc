@@ -1,9 +1,11 @@
 #include <string>
+#include <vector>
 
 #include "common/stats/fake_symbol_table_impl.h"
 #include "common/stats/heap_stat_data.h"
 
 #include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "gtest/gtest.h"
 
@@ -57,6 +59,79 @@ TEST_F(HeapStatDataTest, HeapAlloc) {
   alloc_.free(*stat_3);
 }
 
+TEST_F(HeapStatDataTest, ShardedCounter) {
+  HeapStatDataAllocator sharded_alloc(symbol_table_, 4);
+  StatName name = makeStat("sharded_counter");
+  CounterSharedPtr counter = sharded_alloc.makeCounter(name, "sharded_counter", std::vector<Tag>());
+  EXPECT_FALSE(counter->used());
+  EXPECT_EQ(0U, counter->value());
+
+  // Increment from several threads, each of which lands in its own slot (or shares one, when there
+  // are more threads than slots).
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < 6; ++i) {
+    threads.push_back(thread_factory.createThread([&counter]() {
+      for (uint32_t j = 0; j < 1000; ++j) {
+        counter->inc();
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  counter->add(5);
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(6005U, counter->value());
+  EXPECT_EQ(6005U, counter->latch());
+  EXPECT_EQ(0U, counter->latch());
+
+  // A counter with the same name shares the slots.
+  CounterSharedPtr counter2 = sharded_alloc.makeCounter(name, "sharded_counter", std::vector<Tag>());
+  counter2->add(10);
+  EXPECT_EQ(6015U, counter->value());
+  EXPECT_EQ(10U, counter->latch());
+
+  // Reset does not affect the pending increment reported by latch().
+  counter->inc();
+  counter->reset();
+  EXPECT_EQ(0U, counter2->value());
+  counter->add(2);
+  EXPECT_EQ(2U, counter2->value());
+  EXPECT_EQ(3U, counter2->latch());
+
+  // The slots are freed with the last counter of the name.
+  counter.reset();
+  counter2.reset();
+  counter = sharded_alloc.makeCounter(name, "sharded_counter", std::vector<Tag>());
+  EXPECT_FALSE(counter->used());
+  EXPECT_EQ(0U, counter->value());
+  EXPECT_EQ(0U, counter->latch());
+}
+
+TEST_F(HeapStatDataTest, GaugeLatchChanged) {
+  GaugeSharedPtr gauge = alloc_.makeGauge(makeStat("gauge"), "gauge", std::vector<Tag>(),
+                                          Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(gauge->latchChanged());
+
+  gauge->set(0);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+
+  gauge->inc();
+  gauge->dec();
+  EXPECT_TRUE(gauge->used());
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+
+  // Latching leaves the other flags alone.
+  gauge->add(2);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_TRUE(gauge->used());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, gauge->importMode());
+  EXPECT_EQ(2U, gauge->value());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
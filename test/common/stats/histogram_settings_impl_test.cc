@@ -0,0 +1,38 @@
+#include "envoy/config/metrics/v2/stats.pb.h"
+
+#include "common/stats/histogram_settings_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+TEST(HistogramSettingsTest, NoFixedBuckets) {
+  HistogramSettingsImpl default_settings;
+  EXPECT_FALSE(default_settings.fixedBuckets("cluster.foo.upstream_rq_time"));
+
+  HistogramSettingsImpl settings{envoy::config::metrics::v2::StatsConfig()};
+  EXPECT_FALSE(settings.fixedBuckets("cluster.foo.upstream_rq_time"));
+}
+
+TEST(HistogramSettingsTest, FixedBuckets) {
+  envoy::config::metrics::v2::StatsConfig stats_config;
+  TestUtility::loadFromYaml(R"EOF(
+fixed_bucket_histograms:
+  patterns:
+  - suffix: upstream_rq_time
+  - exact: http.ingress.downstream_rq_time
+)EOF",
+                            stats_config);
+  HistogramSettingsImpl settings(stats_config);
+
+  EXPECT_TRUE(settings.fixedBuckets("cluster.foo.upstream_rq_time"));
+  EXPECT_TRUE(settings.fixedBuckets("http.ingress.downstream_rq_time"));
+  EXPECT_FALSE(settings.fixedBuckets("http.egress.downstream_rq_time"));
+  EXPECT_FALSE(settings.fixedBuckets("cluster.foo.upstream_cx_length_ms"));
+}
+
+} // namespace Stats
+} // namespace Envoy
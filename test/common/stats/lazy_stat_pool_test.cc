@@ -0,0 +1,120 @@
+#include <string>
+
+#include "envoy/stats/stats_macros.h"
+
+#include "common/stats/isolated_store_impl.h"
+#include "common/stats/lazy_stat_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class LazyStatPoolTest : public testing::Test {
+protected:
+  LazyStatPoolTest() : scope_(store_.createScope("scope.")), pool_(*scope_) {}
+
+  bool hasCounter(const std::string& name) {
+    StatNameManagedStorage storage(name, store_.symbolTable());
+    return store_.findCounter(storage.statName()).has_value();
+  }
+  bool hasGauge(const std::string& name) {
+    StatNameManagedStorage storage(name, store_.symbolTable());
+    return store_.findGauge(storage.statName()).has_value();
+  }
+  bool hasHistogram(const std::string& name) {
+    StatNameManagedStorage storage(name, store_.symbolTable());
+    return store_.findHistogram(storage.statName()).has_value();
+  }
+
+  IsolatedStoreImpl store_;
+  ScopePtr scope_;
+  LazyStatPool pool_;
+};
+
+TEST_F(LazyStatPoolTest, Counter) {
+  Counter& counter = pool_.counter("counter");
+  EXPECT_FALSE(counter.used());
+  EXPECT_EQ(0U, counter.value());
+  EXPECT_EQ(0U, counter.latch());
+  counter.reset();
+  EXPECT_FALSE(hasCounter("scope.counter"));
+
+  counter.inc();
+  EXPECT_TRUE(hasCounter("scope.counter"));
+  EXPECT_TRUE(counter.used());
+  counter.add(2);
+  EXPECT_EQ(3U, counter.value());
+  EXPECT_EQ(3U, counter.latch());
+  EXPECT_EQ(3U, store_.counter("scope.counter").value());
+  EXPECT_EQ("scope.counter", counter.name());
+  EXPECT_EQ(0U, counter.tags().size());
+  counter.reset();
+  EXPECT_EQ(0U, counter.value());
+}
+
+TEST_F(LazyStatPoolTest, Gauge) {
+  Gauge& gauge = pool_.gauge("gauge", Gauge::ImportMode::NeverImport);
+  EXPECT_EQ(Gauge::ImportMode::NeverImport, gauge.importMode());
+
+  // Setting an untouched gauge to zero leaves it untouched.
+  gauge.set(0);
+  gauge.add(0);
+  gauge.sub(0);
+  EXPECT_FALSE(gauge.used());
+  EXPECT_EQ(0U, gauge.value());
+  EXPECT_FALSE(hasGauge("scope.gauge"));
+
+  gauge.set(5);
+  EXPECT_TRUE(hasGauge("scope.gauge"));
+  EXPECT_TRUE(gauge.used());
+  gauge.inc();
+  gauge.sub(2);
+  EXPECT_EQ(4U, gauge.value());
+  gauge.set(0);
+  EXPECT_EQ(0U, store_.gauge("scope.gauge", Gauge::ImportMode::NeverImport).value());
+  EXPECT_EQ(Gauge::ImportMode::NeverImport, gauge.importMode());
+}
+
+TEST_F(LazyStatPoolTest, Histogram) {
+  Histogram& histogram = pool_.histogram("histogram");
+  EXPECT_FALSE(histogram.used());
+  EXPECT_FALSE(hasHistogram("scope.histogram"));
+
+  histogram.recordValue(1);
+  EXPECT_TRUE(hasHistogram("scope.histogram"));
+  EXPECT_EQ("scope.histogram", histogram.name());
+}
+
+#define LAZY_TEST_STATS(COUNTER, GAUGE, HISTOGRAM)                                                 \
+  COUNTER(lazy_counter)                                                                            \
+  GAUGE(lazy_gauge, Accumulate)                                                                    \
+  HISTOGRAM(lazy_histogram)
+
+struct LazyTestStats {
+  LAZY_TEST_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+// The pool can be used with the stats macros in place of a scope.
+TEST_F(LazyStatPoolTest, StatsMacros) {
+  LazyTestStats stats{
+      LAZY_TEST_STATS(POOL_COUNTER(pool_), POOL_GAUGE(pool_), POOL_HISTOGRAM(pool_))};
+  EXPECT_FALSE(hasCounter("scope.lazy_counter"));
+  EXPECT_FALSE(hasGauge("scope.lazy_gauge"));
+
+  stats.lazy_counter_.inc();
+  stats.lazy_gauge_.inc();
+  EXPECT_TRUE(hasCounter("scope.lazy_counter"));
+  EXPECT_TRUE(hasGauge("scope.lazy_gauge"));
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, stats.lazy_gauge_.importMode());
+  EXPECT_FALSE(hasHistogram("scope.lazy_histogram"));
+
+  NullGaugeImpl& null_gauge = pool_.nullGauge("null_gauge");
+  null_gauge.set(1);
+  EXPECT_FALSE(hasGauge("scope.null_gauge"));
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
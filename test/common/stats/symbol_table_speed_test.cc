@@ -5,10 +5,14 @@
 
 #include "common/common/logger.h"
 #include "common/common/thread.h"
+#include "common/config/well_known_names.h"
 #include "common/stats/symbol_table_impl.h"
+#include "common/stats/tag_extractor_impl.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/match.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -54,6 +58,67 @@ static void BM_CreateRace(benchmark::State& state) {
 }
 BENCHMARK(BM_CreateRace);
 
+// Measures the rate at which the stats of new clusters can be named: extracting the default tags
+// from each stat name, and encoding the name and tags in the symbol table. Default tags are
+// extracted with their token patterns where they have one when range(0) is 1, and only with
+// regexes when it is 0.
+static void BM_CreateClusterStats(benchmark::State& state) {
+  const bool use_tokens = state.range(0) != 0;
+  const int num_clusters = state.range(1);
+
+  // As in TagProducerImpl, only extractors without a prefix or with the "cluster" prefix are
+  // applied to cluster stats.
+  std::vector<Envoy::Stats::TagExtractorPtr> extractors;
+  for (const auto& desc : Envoy::Config::TagNames::get().descriptorVec()) {
+    Envoy::Stats::TagExtractorPtr extractor =
+        use_tokens && !desc.tokens_.empty()
+            ? Envoy::Stats::TagExtractorTokensImpl::createTagExtractor(desc.name_, desc.tokens_)
+            : Envoy::Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_,
+                                                                 desc.substr_);
+    if (extractor->prefixToken().empty() || extractor->prefixToken() == "cluster") {
+      extractors.push_back(std::move(extractor));
+    }
+  }
+
+  std::vector<std::string> names;
+  Envoy::Stats::TestUtil::forEachSampleStat(num_clusters, [&names](absl::string_view name) {
+    if (absl::StartsWith(name, "cluster.")) {
+      names.emplace_back(name);
+    }
+  });
+
+  for (auto _ : state) {
+    Envoy::Stats::SymbolTableImpl table;
+    std::vector<Envoy::Stats::StatNameStorage> storage;
+    for (const std::string& name : names) {
+      std::vector<Envoy::Stats::Tag> tags;
+      Envoy::IntervalSetImpl<size_t> remove_characters;
+      for (const Envoy::Stats::TagExtractorPtr& extractor : extractors) {
+        extractor->extractTag(name, tags, remove_characters);
+      }
+      storage.emplace_back(name, table);
+      storage.emplace_back(Envoy::StringUtil::removeCharacters(name, remove_characters), table);
+      for (const Envoy::Stats::Tag& tag : tags) {
+        storage.emplace_back(tag.name_, table);
+        storage.emplace_back(tag.value_, table);
+      }
+    }
+    for (Envoy::Stats::StatNameStorage& stat_name : storage) {
+      stat_name.free(table);
+    }
+  }
+
+  state.counters["clusters_per_second"] =
+      benchmark::Counter(static_cast<double>(num_clusters) * state.iterations(),
+                         benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CreateClusterStats)
+    ->Args({0, 100})
+    ->Args({1, 100})
+    ->Args({0, 1000})
+    ->Args({1, 1000})
+    ->Unit(benchmark::kMillisecond);
+
 int main(int argc, char** argv) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logger_context(spdlog::level::warn,
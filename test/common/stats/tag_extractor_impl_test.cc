@@ -9,6 +9,10 @@
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -279,6 +283,16 @@ TEST(TagExtractorTest, DefaultTagExtractors) {
   regex_tester.testRegex("vhost.vhost_1.vcluster.vcluster_1.upstream_rq_200",
                          "vhost.vcluster.upstream_rq", {vhost, vcluster, response_code});
 
+  // Route
+  Tag route;
+  route.name_ = tag_names.ROUTE;
+  route.value_ = "route_1";
+
+  regex_tester.testRegex("vhost.vhost_1.route.route_1.upstream_rq_2xx",
+                         "vhost.route.upstream_rq_xx", {vhost, route, response_code_class});
+  regex_tester.testRegex("vhost.vhost_1.route.route_1.upstream_rq_time",
+                         "vhost.route.upstream_rq_time", {vhost, route});
+
   // Listener http prefix
   Tag listener_http_prefix;
   listener_http_prefix.name_ = tag_names.HTTP_CONN_MANAGER_PREFIX;
@@ -370,5 +384,113 @@ TEST(TagExtractorTest, CreateTagExtractorNoRegex) {
                           EnvoyException, "^No regex specified for tag specifier and no default");
 }
 
+class TagExtractorTokensTest : public testing::Test {
+protected:
+  // Extracts the tag for stat_name, returning the tag value and the tag extracted name, or
+  // "no match" if the tokens do not match.
+  std::string extract(const std::string& tokens, const std::string& stat_name) {
+    return extract(*TagExtractorTokensImpl::createTagExtractor("tag", tokens), stat_name);
+  }
+
+  static std::string extract(const TagExtractor& tag_extractor, const std::string& stat_name) {
+    std::vector<Tag> tags;
+    IntervalSetImpl<size_t> remove_characters;
+    if (!tag_extractor.extractTag(stat_name, tags, remove_characters)) {
+      return "no match";
+    }
+    EXPECT_EQ(1, tags.size());
+    EXPECT_EQ(tag_extractor.name(), tags[0].name_);
+    return absl::StrCat(tags[0].value_, " ",
+                        StringUtil::removeCharacters(stat_name, remove_characters));
+  }
+};
+
+TEST_F(TagExtractorTokensTest, Value) {
+  EXPECT_EQ("foo cluster.upstream_cx_total",
+            extract("cluster.$.**", "cluster.foo.upstream_cx_total"));
+  EXPECT_EQ("foo cluster.a.b", extract("cluster.$.**", "cluster.foo.a.b"));
+  EXPECT_EQ(" cluster.x", extract("cluster.$.**", "cluster..x"));
+  EXPECT_EQ("no match", extract("cluster.$.**", "cluster.foo"));
+  EXPECT_EQ("no match", extract("cluster.$.**", "clusters.foo.bar"));
+  EXPECT_EQ("bar a.foo", extract("a.*.$", "a.foo.bar"));
+  EXPECT_EQ("no match", extract("a.*.$", "a.foo.bar.baz"));
+}
+
+TEST_F(TagExtractorTokensTest, ValueTokens) {
+  EXPECT_EQ("foo.bar tcp.cx_total", extract("tcp.$$.%", "tcp.foo.bar.cx_total"));
+  EXPECT_EQ("no match", extract("tcp.$$.%", "tcp.foo.bar.cx-total"));
+  EXPECT_EQ("no match", extract("tcp.$$.%", "tcp.cx_total"));
+  EXPECT_EQ("AES256-SHA listener.1.ssl.cipher",
+            extract("listener.**.ssl.cipher.$$", "listener.1.ssl.cipher.AES256-SHA"));
+  EXPECT_EQ("a.b listener.ssl.cipher",
+            extract("listener.**.ssl.cipher.$$", "listener.ssl.cipher.a.b"));
+  EXPECT_EQ("no match", extract("listener.**.ssl.cipher.$$", "listener.ssl.cipher"));
+}
+
+TEST_F(TagExtractorTokensTest, AnyTokens) {
+  // Wildcards match as few tokens as possible.
+  EXPECT_EQ("b cluster.a.grpc.grpc.c.d",
+            extract("cluster.**.grpc.$.**", "cluster.a.grpc.b.grpc.c.d"));
+  EXPECT_EQ("m cluster.a.grpc.s.success",
+            extract("cluster.**.grpc.**.$.%", "cluster.a.grpc.s.m.success"));
+  EXPECT_EQ("s cluster.a.grpc.success",
+            extract("cluster.**.grpc.**.$.%", "cluster.a.grpc.s.success"));
+  EXPECT_EQ("no match", extract("cluster.**.grpc.**.$.%", "cluster.a.grpc.success"));
+}
+
+TEST_F(TagExtractorTokensTest, PrefixToken) {
+  EXPECT_EQ("cluster", TagExtractorTokensImpl("tag", "cluster.$.**").prefixToken());
+  EXPECT_EQ("", TagExtractorTokensImpl("tag", "**.cluster.$").prefixToken());
+  EXPECT_EQ("", TagExtractorTokensImpl("tag", "$.foo").prefixToken());
+}
+
+TEST_F(TagExtractorTokensTest, BadTokens) {
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl::createTagExtractor("", "cluster.$"),
+                            EnvoyException, "tag_name cannot be empty");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl::createTagExtractor("tag", ""), EnvoyException,
+                            "No tokens specified for tag name: 'tag'");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl::createTagExtractor("tag", "cluster.**"),
+                            EnvoyException,
+                            "Tag tokens 'cluster.**' must contain exactly one '$' or '$$' value");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl::createTagExtractor("tag", "cluster.$.$$"),
+                            EnvoyException,
+                            "Tag tokens 'cluster.$.$$' must contain exactly one '$' or '$$' value");
+}
+
+// Every default tag with a token pattern must extract exactly what its regex does. For each such
+// tag, this compares both on all names of up to five tokens made from the literals of the pattern
+// and a few others, including empty and non-word tokens.
+TEST_F(TagExtractorTokensTest, DefaultTokensMatchRegexes) {
+  for (const auto& desc : Config::TagNames::get().descriptorVec()) {
+    if (desc.tokens_.empty()) {
+      continue;
+    }
+    TagExtractorTokensImpl tokens_extractor(desc.name_, desc.tokens_);
+    TagExtractorImpl regex_extractor(desc.name_, desc.regex_, desc.substr_);
+    EXPECT_EQ(regex_extractor.prefixToken(), tokens_extractor.prefixToken()) << desc.tokens_;
+
+    std::vector<std::string> words{"foo", "a-b", ""};
+    for (absl::string_view token : absl::StrSplit(desc.tokens_, '.')) {
+      if (absl::ascii_isalpha(token[0])) {
+        words.emplace_back(token);
+      }
+    }
+    std::vector<std::vector<std::string>> names{{}};
+    for (size_t num_tokens = 1; num_tokens <= 5; ++num_tokens) {
+      std::vector<std::vector<std::string>> longer_names;
+      for (const auto& name : names) {
+        for (const std::string& word : words) {
+          longer_names.push_back(name);
+          longer_names.back().push_back(word);
+          const std::string stat_name = absl::StrJoin(longer_names.back(), ".");
+          ASSERT_EQ(extract(regex_extractor, stat_name), extract(tokens_extractor, stat_name))
+              << desc.tokens_ << " on " << stat_name;
+        }
+      }
+      names = std::move(longer_names);
+    }
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -15,14 +15,15 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
 
 class ThreadLocalStorePerf {
 public:
-  ThreadLocalStorePerf()
-      : heap_alloc_(symbol_table_), store_(heap_alloc_),
+  explicit ThreadLocalStorePerf(uint32_t counter_shards = 0)
+      : heap_alloc_(symbol_table_, counter_shards), store_(heap_alloc_),
         api_(Api::createApiForTest(store_, time_system_)) {
     store_.setTagProducer(std::make_unique<Stats::TagProducerImpl>(stats_config_));
 
@@ -39,6 +40,15 @@ public:
     if (tls_) {
       tls_->shutdownGlobalThreading();
     }
+    for (auto& worker_dispatcher : worker_dispatchers_) {
+      worker_dispatcher->exit();
+    }
+    for (auto& worker_thread : worker_threads_) {
+      worker_thread->join();
+    }
+    if (tls_) {
+      tls_->shutdownThread();
+    }
   }
 
   void accessCounters() {
@@ -47,12 +57,43 @@ public:
     }
   }
 
-  void initThreading() {
+  Stats::Counter& counter(const std::string& name) { return store_.counter(name); }
+
+  void initThreading(uint32_t num_workers = 0) {
     dispatcher_ = api_->allocateDispatcher();
     tls_ = std::make_unique<ThreadLocal::InstanceImpl>();
+    tls_->registerThread(*dispatcher_, true);
+    for (uint32_t i = 0; i < num_workers; ++i) {
+      worker_dispatchers_.push_back(api_->allocateDispatcher());
+      Event::Dispatcher& worker_dispatcher = *worker_dispatchers_.back();
+      tls_->registerThread(worker_dispatcher, false);
+      worker_threads_.push_back(api_->threadFactory().createThread([this, &worker_dispatcher]() {
+        worker_dispatcher.run(Event::Dispatcher::RunType::RunUntilExit);
+        tls_->shutdownThread();
+      }));
+    }
     store_.initializeThreading(*dispatcher_, *tls_);
   }
 
+  void createHistograms(uint32_t num_histograms) {
+    for (uint32_t i = 0; i < num_histograms; ++i) {
+      histograms_.push_back(&store_.histogram(absl::StrCat("cluster.c", i, ".upstream_rq_time")));
+    }
+  }
+
+  void recordHistogramValues() {
+    uint64_t value = 0;
+    for (Stats::Histogram* histogram : histograms_) {
+      histogram->recordValue(++value % 1000);
+    }
+  }
+
+  // Merges the histograms, running the main thread dispatcher until the merge completes.
+  void mergeHistograms() {
+    store_.mergeHistograms([this]() -> void { dispatcher_->exit(); });
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
 private:
   Stats::FakeSymbolTableImpl symbol_table_;
   Event::SimulatedTimeSystem time_system_;
@@ -61,8 +102,11 @@ private:
   Api::ApiPtr api_;
   Event::DispatcherPtr dispatcher_;
   std::unique_ptr<ThreadLocal::InstanceImpl> tls_;
+  std::vector<Event::DispatcherPtr> worker_dispatchers_;
+  std::vector<Thread::ThreadPtr> worker_threads_;
   envoy::config::metrics::v2::StatsConfig stats_config_;
   std::vector<std::unique_ptr<Stats::StatNameStorage>> stat_names_;
+  std::vector<Stats::Histogram*> histograms_;
 };
 
 } // namespace Envoy
@@ -94,6 +138,60 @@ BENCHMARK(BM_StatsWithTls);
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
 
+// Tests the throughput of incrementing a single hot counter from many threads at once, as workers
+// do for counters such as downstream_rq_total. The argument is the number of counter shards; with
+// 0 every increment contends for the same cache line.
+static Envoy::ThreadLocalStorePerf* counter_context;
+static Envoy::Stats::Counter* hot_counter;
+static void BM_CounterIncrementMultiThreaded(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    counter_context = new Envoy::ThreadLocalStorePerf(state.range(0));
+    hot_counter = &counter_context->counter("http.ingress.downstream_rq_total");
+  }
+
+  // The benchmark loop starts with a barrier, so all threads see the counter created above.
+  for (auto _ : state) {
+    hot_counter->inc();
+  }
+
+  if (state.thread_index == 0) {
+    delete counter_context;
+    counter_context = nullptr;
+    hot_counter = nullptr;
+  }
+}
+BENCHMARK(BM_CounterIncrementMultiThreaded)->Arg(0)->Arg(64)->ThreadRange(1, 32)->UseRealTime();
+
+// Tests the latency of merging 10000 histograms, as done on every stats flush. The first argument
+// is the number of workers the merge is shared with, and the second is 1 if every histogram has
+// new values to merge, or 0 if none have, in which case there are no statistics to recompute.
+static void BM_HistogramMerge(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading(state.range(0));
+  context.createHistograms(10000);
+  const bool record_values = state.range(1) != 0;
+  context.recordHistogramValues();
+  context.mergeHistograms();
+
+  for (auto _ : state) {
+    if (record_values) {
+      state.PauseTiming();
+      context.recordHistogramValues();
+      state.ResumeTiming();
+    }
+    context.mergeHistograms();
+  }
+}
+BENCHMARK(BM_HistogramMerge)
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({4, 0})
+    ->Args({4, 1})
+    ->Args({16, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
 int main(int argc, char** argv) {
   benchmark::Initialize(&argc, argv);
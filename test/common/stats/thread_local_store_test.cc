@@ -1,6 +1,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "envoy/config/metrics/v2/stats.pb.h"
@@ -8,6 +9,7 @@
 #include "common/common/c_smart_ptr.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/memory/stats.h"
+#include "common/stats/histogram_settings_impl.h"
 #include "common/stats/stats_matcher_impl.h"
 #include "common/stats/tag_producer_impl.h"
 #include "common/stats/thread_local_store.h"
@@ -1079,6 +1081,71 @@ TEST_F(HistogramTest, BasicHistogramMergeSummary) {
             name_histogram_map["h1"]->cumulativeStatistics().bucketSummary());
 }
 
+// Validates that statistics which cannot have changed are not recomputed by a merge.
+TEST_F(HistogramTest, MergeSkipsUnchangedStatistics) {
+  Histogram& h1 = store_->histogram("h1");
+
+  expectCallAndAccumulate(h1, 1);
+  EXPECT_EQ(1, validateMerge());
+  const ParentHistogramSharedPtr parent = store_->histograms()[0];
+  const HistogramStatistics* cumulative_statistics = &parent->cumulativeStatistics();
+  const HistogramStatistics* interval_statistics = &parent->intervalStatistics();
+
+  // Without new values the cumulative statistics are kept, while the interval statistics are
+  // cleared once and then kept.
+  EXPECT_EQ(1, validateMerge());
+  EXPECT_EQ(cumulative_statistics, &parent->cumulativeStatistics());
+  EXPECT_NE(interval_statistics, &parent->intervalStatistics());
+  interval_statistics = &parent->intervalStatistics();
+  EXPECT_EQ(0, interval_statistics->sampleCount());
+
+  EXPECT_EQ(1, validateMerge());
+  EXPECT_EQ(cumulative_statistics, &parent->cumulativeStatistics());
+  EXPECT_EQ(interval_statistics, &parent->intervalStatistics());
+
+  expectCallAndAccumulate(h1, 2);
+  EXPECT_EQ(1, validateMerge());
+  EXPECT_NE(cumulative_statistics, &parent->cumulativeStatistics());
+  EXPECT_NE(interval_statistics, &parent->intervalStatistics());
+  EXPECT_EQ(2, parent->cumulativeStatistics().sampleCount());
+}
+
+// Validates that histograms merged on a worker thread are only visible once the merge completes
+// on the main thread.
+TEST_F(HistogramTest, MergeOnWorkerThread) {
+  Histogram& h1 = store_->histogram("h1");
+  expectCallAndAccumulate(h1, 1);
+
+  Event::PostCb merge_complete_cb;
+  uint32_t run_on_all_threads_calls = 0;
+  ON_CALL(tls_, runOnAllThreads(_, _))
+      .WillByDefault(Invoke([&](Event::PostCb cb, Event::PostCb main_callback) {
+        cb();
+        if (++run_on_all_threads_calls == 1) {
+          // Swapping the TLS histograms must happen on the thread owning them.
+          main_callback();
+          return;
+        }
+        std::thread worker(cb);
+        worker.join();
+        merge_complete_cb = main_callback;
+      }));
+
+  bool merge_called = false;
+  store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+  const ParentHistogramSharedPtr parent = store_->histograms()[0];
+  EXPECT_FALSE(merge_called);
+  EXPECT_FALSE(parent->used());
+  EXPECT_EQ(0, parent->cumulativeStatistics().sampleCount());
+
+  ASSERT_TRUE(merge_complete_cb != nullptr);
+  merge_complete_cb();
+  EXPECT_TRUE(merge_called);
+  EXPECT_TRUE(parent->used());
+  EXPECT_EQ(1, parent->cumulativeStatistics().sampleCount());
+  EXPECT_EQ(1, parent->intervalStatistics().sampleCount());
+}
+
 TEST_F(HistogramTest, BasicHistogramUsed) {
   ScopePtr scope1 = store_->createScope("scope1.");
 
@@ -1110,5 +1177,31 @@ TEST_F(HistogramTest, BasicHistogramUsed) {
   }
 }
 
+TEST_F(HistogramTest, FixedBucketHistogramMerge) {
+  envoy::config::metrics::v2::StatsConfig stats_config;
+  stats_config.mutable_fixed_bucket_histograms()->add_patterns()->set_exact("h2");
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(stats_config));
+
+  Histogram& h1 = store_->histogram("h1");
+  Histogram& h2 = store_->histogram("h2");
+  EXPECT_FALSE(dynamic_cast<ParentHistogramImpl&>(h1).fixedBuckets());
+  EXPECT_TRUE(dynamic_cast<ParentHistogramImpl&>(h2).fixedBuckets());
+
+  // The statistics of the histogram with fixed buckets match those computed from a circllhist.
+  for (uint64_t value : {0, 1, 7, 10, 99, 100, 123, 4567, 89012, 1000000}) {
+    expectCallAndAccumulate(h1, value);
+    expectCallAndAccumulate(h2, value);
+  }
+  EXPECT_EQ(2, validateMerge());
+
+  expectCallAndAccumulate(h2, 42);
+  EXPECT_EQ(2, validateMerge());
+
+  EXPECT_EQ(2, validateMerge());
+  for (const ParentHistogramSharedPtr& histogram : store_->histograms()) {
+    EXPECT_TRUE(histogram->used());
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
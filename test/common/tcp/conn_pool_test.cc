@@ -763,6 +763,73 @@ TEST_F(TcpConnPoolImplTest, MaxRequestsPerConnection) {
   EXPECT_EQ(1U, cluster_->stats_.upstream_cx_max_requests_.value());
 }
 
+/**
+ * Test that a request preconnects up to the configured ratio and that the preconnected connection
+ * serves the next request.
+ */
+TEST_F(TcpConnPoolImplTest, PreconnectOnDemand) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  cluster_->per_upstream_preconnect_ratio_ = 2.0;
+  InSequence s;
+
+  // Request 1 kicks off a connection for itself and preconnects a second one.
+  ConnPoolCallbacks callbacks;
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  Tcp::ConnectionPool::Cancellable* handle = conn_pool_.newConnection(callbacks);
+  EXPECT_NE(nullptr, handle);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+
+  EXPECT_CALL(callbacks.pool_ready_, ready());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // Request 2 is bound to the preconnected connection immediately. The circuit breaker prevents
+  // any further preconnects.
+  ConnPoolCallbacks callbacks2;
+  EXPECT_CALL(callbacks2.pool_ready_, ready());
+  handle = conn_pool_.newConnection(callbacks2);
+  EXPECT_EQ(nullptr, handle);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  callbacks.conn_data_.reset();
+  callbacks2.conn_data_.reset();
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_wasted_.value());
+}
+
+/**
+ * Test explicit preconnects and that preconnected connections closed without use are counted.
+ */
+TEST_F(TcpConnPoolImplTest, PreconnectUnused) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  InSequence s;
+
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  conn_pool_.preconnect(2);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+
+  // The pool already holds enough connections.
+  conn_pool_.preconnect(2);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_total_.value());
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_preconnect_wasted_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_preconnect_used_.value());
+}
+
 /*
  * Test that multiple connections can be assigned at once.
  */
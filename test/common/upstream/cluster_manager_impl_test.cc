@@ -2126,6 +2126,102 @@ TEST_F(ClusterManagerImplTest, DynamicHostRemoveDefaultPriority) {
   factory_.tls_.shutdownThread();
 }
 
+class PreconnectOnHostAddTest : public ClusterManagerImplTest {
+public:
+  // Creates a STRICT_DNS cluster resolving to 127.0.0.2, with the given preconnect policy, and has
+  // the worker use its HTTP/1.1 and TCP pools.
+  void initialize(const std::string& preconnect_policy) {
+    const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STRICT_DNS
+      dns_resolvers:
+      - socket_address:
+          address: 1.2.3.4
+          port_value: 80
+      lb_policy: ROUND_ROBIN
+      load_assignment:
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 127.0.0.1
+                    port_value: 11001
+  )EOF" + preconnect_policy;
+
+    std::shared_ptr<Network::MockDnsResolver> dns_resolver(new Network::MockDnsResolver());
+    EXPECT_CALL(factory_.dispatcher_, createDnsResolver(_)).WillOnce(Return(dns_resolver));
+    dns_timer_ = new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+    EXPECT_CALL(*dns_resolver, resolve(_, _, _))
+        .WillRepeatedly(DoAll(SaveArg<2>(&dns_callback_), Return(&active_dns_query_)));
+    create(parseBootstrapFromV2Yaml(yaml));
+    dns_callback_(TestUtility::makeDnsResponse({"127.0.0.2"}));
+
+    EXPECT_CALL(factory_, allocateConnPool_(_, _))
+        .WillOnce(ReturnNew<NiceMock<Http::ConnectionPool::MockInstance>>());
+    EXPECT_CALL(factory_, allocateTcpConnPool_(_))
+        .WillOnce(ReturnNew<NiceMock<Tcp::ConnectionPool::MockInstance>>());
+    EXPECT_NE(nullptr,
+              cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                       Http::Protocol::Http11, nullptr));
+    EXPECT_NE(nullptr, cluster_manager_->tcpConnPoolForCluster(
+                           "cluster_1", ResourcePriority::Default, nullptr, nullptr));
+  }
+
+  // Resolves to an additional host.
+  void addHost() {
+    dns_timer_->callback_();
+    dns_callback_(TestUtility::makeDnsResponse({"127.0.0.2", "127.0.0.3"}));
+  }
+
+  Network::DnsResolver::ResolveCb dns_callback_;
+  Event::MockTimer* dns_timer_;
+  Network::MockActiveDnsQuery active_dns_query_;
+};
+
+// A host added to a cluster preconnecting on host add gets the configured number of connections
+// in each of the pools the worker uses for the cluster.
+TEST_F(PreconnectOnHostAddTest, HostAddedWithPreconnect) {
+  initialize(R"EOF(
+      preconnect_policy:
+        preconnect_on_host_add: 1
+  )EOF");
+
+  auto* http_pool = new NiceMock<Http::ConnectionPool::MockInstance>();
+  auto* tcp_pool = new NiceMock<Tcp::ConnectionPool::MockInstance>();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).WillOnce(Return(http_pool));
+  EXPECT_CALL(factory_, allocateTcpConnPool_(_)).WillOnce(Return(tcp_pool));
+  EXPECT_CALL(*http_pool, preconnect(1));
+  EXPECT_CALL(*tcp_pool, preconnect(1));
+  addHost();
+
+  // The new host's pools are the ones later used for it.
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).Times(0);
+  EXPECT_CALL(factory_, allocateTcpConnPool_(_)).Times(0);
+  for (int i = 0; i < 2; i++) {
+    cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                             Http::Protocol::Http11, nullptr);
+    cluster_manager_->tcpConnPoolForCluster("cluster_1", ResourcePriority::Default, nullptr,
+                                            nullptr);
+  }
+
+  factory_.tls_.shutdownThread();
+}
+
+// Without the policy, added hosts get their pools and connections on first use only.
+TEST_F(PreconnectOnHostAddTest, HostAddedWithoutPreconnect) {
+  initialize("");
+
+  EXPECT_CALL(factory_, allocateConnPool_(_, _)).Times(0);
+  EXPECT_CALL(factory_, allocateTcpConnPool_(_)).Times(0);
+  addHost();
+
+  factory_.tls_.shutdownThread();
+}
+
 class MockConnPoolWithDestroy : public Http::ConnectionPool::MockInstance {
 public:
   ~MockConnPoolWithDestroy() { onDestroy(); }
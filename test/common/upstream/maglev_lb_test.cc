@@ -79,6 +79,46 @@ TEST_F(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// With bounded loads, overloaded hosts are skipped in favor of the next slot in the table.
+TEST_F(MaglevLoadBalancerTest, BoundedLoad) {
+  host_set_.hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      100);
+  init(7);
+
+  // See the Basic test for the table layout: {:92, :94, :90, :91, :95, :90, :93}.
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(host_set_.hosts_[2], lb->chooseHost(&context));
+
+  // With 3 active requests, each host is allowed ceil(4 * 1/6) = 1 of them.
+  host_set_.hosts_[2]->stats().rq_active_.set(3);
+  EXPECT_EQ(host_set_.hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(1UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // Wrap around the end of the table. With 6 active requests, each host is allowed 2.
+  TestLoadBalancerContext last_slot_context(6);
+  host_set_.hosts_[3]->stats().rq_active_.set(3);
+  EXPECT_EQ(host_set_.hosts_[4], lb->chooseHost(&last_slot_context));
+  EXPECT_EQ(3UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // A walk from slot 0 visits as many slots as there are hosts, which never reaches :93. With 34
+  // active requests, each host is allowed ceil(35 * 1/6) = 6, so every host visited is over its
+  // bound and the least overloaded one is chosen.
+  for (const uint32_t i : {0, 1, 2, 4}) {
+    host_set_.hosts_[i]->stats().rq_active_.set(7);
+  }
+  host_set_.hosts_[3]->stats().rq_active_.set(0);
+  host_set_.hosts_[5]->stats().rq_active_.set(6);
+  EXPECT_EQ(host_set_.hosts_[5], lb->chooseHost(&context));
+  EXPECT_EQ(9UL, stats_.lb_hash_bounded_load_overflow_.value());
+}
+
 // Weighted sanity test.
 TEST_F(MaglevLoadBalancerTest, Weighted) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", 1),
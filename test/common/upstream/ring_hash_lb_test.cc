@@ -158,6 +158,44 @@ TEST_P(RingHashLoadBalancerTest, Basic) {
   EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
 }
 
+// With bounded loads, overloaded hosts are skipped in favor of the next host on the ring.
+TEST_P(RingHashLoadBalancerTest, BoundedLoad) {
+  hostSet().hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::api::v2::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+  init();
+
+  // See the Basic test for the ring layout. Hash 0 maps to :94, followed by :92, :90, :95, :93 and
+  // :91 clockwise.
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(0UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // With 10 active requests, each host is allowed ceil(11 * 1/6 * 1.5) = 3 of them. :94 is over
+  // its bound, so the request walks to :92. The total is taken from the hosts' own counts, so the
+  // cluster's count doesn't matter.
+  stats_.upstream_rq_active_.set(1000);
+  hostSet().hosts_[4]->stats().rq_active_.set(10);
+  EXPECT_EQ(hostSet().hosts_[2], lb->chooseHost(&context));
+  EXPECT_EQ(1UL, stats_.lb_hash_bounded_load_overflow_.value());
+
+  // With 22 active requests, each host is allowed ceil(23 * 1/6 * 1.5) = 6 of them. :92 and :90
+  // are at their bound, which excludes them as well.
+  hostSet().hosts_[2]->stats().rq_active_.set(6);
+  hostSet().hosts_[0]->stats().rq_active_.set(6);
+  EXPECT_EQ(hostSet().hosts_[5], lb->chooseHost(&context));
+  EXPECT_EQ(4UL, stats_.lb_hash_bounded_load_overflow_.value());
+}
+
 // Ensure if all the hosts with priority 0 unhealthy, the next priority hosts are used.
 TEST_P(RingHashFailoverTest, BasicFailover) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
@@ -46,6 +46,27 @@ private:
   std::shared_ptr<SubsetLoadBalancer> lb_;
 };
 
+class SubsetLoadBalancerLazySubsetsTester {
+public:
+  SubsetLoadBalancerLazySubsetsTester(std::shared_ptr<SubsetLoadBalancer> lb) : lb_(lb) {}
+
+  // Counts the entries in the subset trie, initialized or not.
+  size_t trieSize() const { return trieSize(lb_->subsets_); }
+
+private:
+  static size_t trieSize(const SubsetLoadBalancer::LbSubsetMap& subsets) {
+    size_t size = 0;
+    for (const auto& kv : subsets) {
+      for (const auto& vs : kv.second) {
+        size += 1 + trieSize(vs.second->children_);
+      }
+    }
+    return size;
+  }
+
+  std::shared_ptr<SubsetLoadBalancer> lb_;
+};
+
 namespace SubsetLoadBalancerTest {
 
 class TestMetadataMatchCriterion : public Router::MetadataMatchCriterion {
@@ -634,6 +655,107 @@ TEST_P(SubsetLoadBalancerTest, BalancesSubsetAfterUpdate) {
   EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
 }
 
+// Test that lazy subsets are only created when requested, kept in LRU order, and updated when
+// matching hosts are added.
+TEST_P(SubsetLoadBalancerTest, LazySubsetsCreatedOnDemand) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, maxLazySubsets()).WillRepeatedly(Return(2));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {
+      std::make_shared<SubsetSelector>(SubsetSelector{
+          {"version"}, envoy::api::v2::Cluster::LbSubsetConfig::LbSubsetSelector::NOT_DEFINED})};
+
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:82", {{"version", "1.1"}}},
+      {"tcp://127.0.0.1:83", {{"version", "1.1"}}},
+  });
+  EXPECT_EQ(0U, stats_.lb_subsets_created_.value());
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_11));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_10));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+
+  // The 1.2 subset has no hosts yet, but is kept. This evicts the least recently used 1.1 subset.
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_12));
+  EXPECT_EQ(1U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
+
+  modifyHosts({makeHost("tcp://127.0.0.1:8000", {{"version", "1.2"}})}, {});
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(host_set_.hosts_[4], lb_->chooseHost(&context_12));
+
+  // Recreating the 1.1 subset evicts the 1.0 subset.
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(4U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_removed_.value());
+
+  // Criteria which do not correspond to a subset selector never create a subset.
+  TestLoadBalancerContext context_stage({{"stage", "prod"}});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_stage));
+  EXPECT_EQ(4U, stats_.lb_subsets_created_.value());
+}
+
+// Evicted subsets are removed from the subset trie, along with ancestors left empty.
+TEST_P(SubsetLoadBalancerTest, LazySubsetsPrunedOnEviction) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, maxLazySubsets()).WillRepeatedly(Return(2));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {
+      std::make_shared<SubsetSelector>(SubsetSelector{
+          {"version"}, envoy::api::v2::Cluster::LbSubsetConfig::LbSubsetSelector::NOT_DEFINED}),
+      std::make_shared<SubsetSelector>(
+          SubsetSelector{{"stage", "version"},
+                         envoy::api::v2::Cluster::LbSubsetConfig::LbSubsetSelector::NOT_DEFINED})};
+
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}, {"stage", "prod"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}, {"stage", "prod"}}},
+  });
+  SubsetLoadBalancerLazySubsetsTester tester(lb_);
+  EXPECT_EQ(0U, tester.trieSize());
+
+  // Requests for many distinct values keep at most two subsets and their ancestors in the trie.
+  for (int i = 0; i < 10; i++) {
+    TestLoadBalancerContext context({{"stage", "prod"}, {"version", std::to_string(i)}});
+    EXPECT_EQ(nullptr, lb_->chooseHost(&context));
+    EXPECT_GE(3U, tester.trieSize());
+  }
+
+  TestLoadBalancerContext context_prod_10({{"stage", "prod"}, {"version", "1.0"}});
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_prod_10));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10));
+  // stage=prod, its version=1.0 child and version=1.0.
+  EXPECT_EQ(3U, tester.trieSize());
+
+  // Evicting the stage=prod,version=1.0 subset also removes the stage=prod entry.
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11));
+  EXPECT_EQ(2U, tester.trieSize());
+
+  // A pruned subset is rebuilt on next use.
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_prod_10));
+  EXPECT_EQ(3U, tester.trieSize());
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+}
+
 // Test that adding backends to a failover group causes no problems.
 TEST_P(SubsetLoadBalancerTest, UpdateFailover) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
@@ -2027,6 +2027,58 @@ TEST_F(ClusterInfoImplTest, TestTrackRemainingResourcesGauges) {
   EXPECT_EQ(4U, high_remaining_retries.value());
 }
 
+TEST_F(ClusterInfoImplTest, LazyStats) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    lazy_stats: true
+
+    circuit_breakers:
+      thresholds:
+      - priority: DEFAULT
+        max_retries: 1
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  auto has_counter = [this](const std::string& name) {
+    Stats::StatNameManagedStorage storage(name, stats_.symbolTable());
+    return stats_.findCounter(storage.statName()).has_value();
+  };
+  auto has_gauge = [this](const std::string& name) {
+    Stats::StatNameManagedStorage storage(name, stats_.symbolTable());
+    return stats_.findGauge(storage.statName()).has_value();
+  };
+
+  // Stats only exist in the scope once they have been updated.
+  EXPECT_FALSE(has_counter("cluster.name.upstream_rq_total"));
+  EXPECT_EQ(0U, cluster->info()->stats().upstream_rq_total_.value());
+  cluster->info()->stats().upstream_rq_total_.inc();
+  EXPECT_TRUE(has_counter("cluster.name.upstream_rq_total"));
+  EXPECT_EQ(1U, stats_.counter("cluster.name.upstream_rq_total").value());
+
+  // Circuit breaker gauges that are only ever set to zero are never created.
+  ResourceManager& resource_manager = cluster->info()->resourceManager(ResourcePriority::Default);
+  EXPECT_FALSE(has_gauge("cluster.name.circuit_breakers.default.rq_retry_open"));
+  EXPECT_FALSE(has_gauge("cluster.name.circuit_breakers.default.remaining_retries"));
+  resource_manager.retries().inc();
+  EXPECT_TRUE(has_gauge("cluster.name.circuit_breakers.default.rq_retry_open"));
+  EXPECT_EQ(1U, stats_.gauge("cluster.name.circuit_breakers.default.rq_retry_open",
+                             Stats::Gauge::ImportMode::Accumulate)
+                    .value());
+  resource_manager.retries().dec();
+  EXPECT_EQ(0U, stats_.gauge("cluster.name.circuit_breakers.default.rq_retry_open",
+                             Stats::Gauge::ImportMode::Accumulate)
+                    .value());
+  EXPECT_FALSE(has_gauge("cluster.name.circuit_breakers.default.remaining_retries"));
+
+  // Load report stats are also created on first use.
+  EXPECT_EQ(0U, cluster->info()->loadReportStats().upstream_rq_dropped_.latch());
+  cluster->info()->loadReportStats().upstream_rq_dropped_.inc();
+  EXPECT_EQ(1U, cluster->info()->loadReportStats().upstream_rq_dropped_.latch());
+}
+
 class TestFilterConfigFactoryBase {
 public:
   TestFilterConfigFactoryBase(
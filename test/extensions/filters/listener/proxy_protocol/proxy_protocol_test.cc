@@ -70,6 +70,7 @@ public:
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+  void bindBufferMemoryAccounts(Network::Connection&) override {}
   std::chrono::milliseconds listenerFiltersTimeout() const override {
     return std::chrono::milliseconds();
   }
@@ -267,12 +268,6 @@ TEST_P(ProxyProtocolTest, errorRecv_2) {
   EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
       .Times(AnyNumber())
       .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
-  EXPECT_CALL(os_sys_calls, ioctl(_, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        const int rc = ::ioctl(fd, request, argp);
-        return Api::SysCallIntResult{rc, errno};
-      }));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -293,15 +288,22 @@ TEST_P(ProxyProtocolTest, errorRecv_2) {
   expectProxyProtoError();
 }
 
-TEST_P(ProxyProtocolTest, errorFIONREAD_1) {
-  // A well formed v4/tcp message, no extensions, but introduce an error on ioctl(...FIONREAD...)
+TEST_P(ProxyProtocolTest, errorRecv_1) {
+  // A well formed v4/tcp message, no extensions, but introduce an error when the peeked header is
+  // removed from the socket
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
                                 'r',  'e',  ' ',  'd',  'a',  't',  'a'};
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
-  EXPECT_CALL(os_sys_calls, ioctl(_, FIONREAD, _)).WillOnce(Return(Api::SysCallIntResult{-1, 0}));
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
+        const ssize_t rc = ::recv(fd, buf, len, flags);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, 0)).WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -482,36 +484,134 @@ TEST_P(ProxyProtocolTest, v2ParseExtensions) {
   }
   write(data, sizeof(data));
   expectData("DATA");
+
+  const auto& tlvs =
+      server_connection_->streamInfo().filterState().getDataReadOnly<ProxyProtocolTlvs>(
+          ProxyProtocolTlvs::key());
+  ASSERT_EQ(2, tlvs.tlvs().size());
+  for (const ProxyProtocolTlvs::Tlv& tlv : tlvs.tlvs()) {
+    EXPECT_EQ(0, tlv.type_);
+    EXPECT_EQ("\xff", tlv.value_);
+  }
+
   disconnect();
 }
 
-TEST_P(ProxyProtocolTest, v2ParseExtensionsIoctlError) {
-  // A well-formed ipv4/tcp with a TLV extension. An error is created in the ioctl(...FIONREAD...)
+TEST_P(ProxyProtocolTest, v2ExtensionsFilterState) {
+  // A well-formed ipv4/tcp header with ALPN and authority TLVs, available to the network filters
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
-                                0x54, 0x0a, 0x21, 0x11, 0x00, 0x10, 0x01, 0x02, 0x03, 0x04,
+                                0x54, 0x0a, 0x21, 0x11, 0x00, 0x1f, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02};
-  constexpr uint8_t tlv[] = {0x0, 0x0, 0x1, 0xff};
+  constexpr uint8_t tlvs[] = {0x01, 0x00, 0x02, 'h', '2', 0x02, 0x00, 0x0b, 'e', 'x', 'a',
+                              'm',  'p',  'l',  'e', '.', 'c',  'o',  'm',  'D', 'A', 'T',
+                              'A'};
 
+  connect();
+  write(buffer, sizeof(buffer));
+  write(tlvs, sizeof(tlvs));
+  expectData("DATA");
+
+  const StreamInfo::FilterState& filter_state = server_connection_->streamInfo().filterState();
+  ASSERT_TRUE(filter_state.hasData<ProxyProtocolTlvs>(ProxyProtocolTlvs::key()));
+  const auto& state = filter_state.getDataReadOnly<ProxyProtocolTlvs>(ProxyProtocolTlvs::key());
+  EXPECT_EQ(2, state.tlvs().size());
+  EXPECT_EQ("h2", state.value(PROXY_PROTO_V2_TLV_TYPE_ALPN));
+  EXPECT_EQ("example.com", state.value(PROXY_PROTO_V2_TLV_TYPE_AUTHORITY));
+  EXPECT_FALSE(state.value(PROXY_PROTO_V2_TLV_TYPE_UNIQUE_ID).has_value());
+
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2ExtensionsNoFilterState) {
+  // Without extensions, nothing is added to the filter state
+  constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
+                                0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
+                                0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
+                                'r',  'e',  ' ',  'd',  'a',  't',  'a'};
+  connect();
+  write(buffer, sizeof(buffer));
+  expectData("more data");
+
+  EXPECT_FALSE(server_connection_->streamInfo().filterState().hasData<ProxyProtocolTlvs>(
+      ProxyProtocolTlvs::key()));
+
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2TruncatedExtension) {
+  // A TLV whose length exceeds the extensions encoded in the header is rejected
+  constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
+                                0x54, 0x0a, 0x21, 0x11, 0x00, 0x10, 0x01, 0x02, 0x03, 0x04,
+                                0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 0x01, 0x00,
+                                0x02, 'h',  'm',  'o',  'r',  'e',  ' ',  'd',  'a',  't',
+                                'a'};
+  connect(false);
+  write(buffer, sizeof(buffer));
+
+  expectProxyProtoError();
+}
+
+TEST_P(ProxyProtocolTest, v2SinglePeek) {
+  // A well-formed ipv4/tcp header with a TLV, delivered at once, is peeked and read only once
+  constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
+                                0x54, 0x0a, 0x21, 0x11, 0x00, 0x10, 0x01, 0x02, 0x03, 0x04,
+                                0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 0x00, 0x00,
+                                0x01, 0xff, 'm',  'o',  'r',  'e',  ' ',  'd',  'a',  't',
+                                'a'};
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
-
-  EXPECT_CALL(os_sys_calls, ioctl(_, FIONREAD, _))
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
+      .WillOnce(Invoke([](int fd, void* buf, size_t len, int flags) {
+        const ssize_t rc = ::recv(fd, buf, len, flags);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, recv(_, _, 32, 0))
+      .WillOnce(Invoke([](int fd, void* buf, size_t len, int flags) {
+        const ssize_t rc = ::recv(fd, buf, len, flags);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, ioctl(_, _, _)).Times(0);
+  EXPECT_CALL(os_sys_calls, writev(_, _, _))
+      .Times(AnyNumber())
+      .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
+        const ssize_t rc = ::writev(fd, iov, iovcnt);
+        return Api::SysCallSizeResult{rc, errno};
+      }));
+  EXPECT_CALL(os_sys_calls, readv(_, _, _))
       .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        int x = ::ioctl(fd, request, argp);
-        if (x == 0 && *static_cast<int*>(argp) == sizeof(tlv)) {
-          return Api::SysCallIntResult{-1, errno};
-        } else {
-          return Api::SysCallIntResult{x, errno};
-        }
+      .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
+        const ssize_t rc = ::readv(fd, iov, iovcnt);
+        return Api::SysCallSizeResult{rc, errno};
       }));
 
-  EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
+  connect();
+  write(buffer, sizeof(buffer));
+  expectData("more data");
+
+  EXPECT_EQ(server_connection_->remoteAddress()->ip()->addressAsString(), "1.2.3.4");
+
+  disconnect();
+}
+
+TEST_P(ProxyProtocolTest, v2ParseExtensionsRecvError) {
+  // A well-formed ipv4/tcp with a TLV extension. An error is created when the header, once
+  // complete, is removed from the socket.
+  constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
+                                0x54, 0x0a, 0x21, 0x11, 0x00, 0x10, 0x01, 0x02, 0x03, 0x04,
+                                0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02};
+  constexpr uint8_t tlv[] = {0x0, 0x0, 0x1, 0xff};
+
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
         const ssize_t rc = ::recv(fd, buf, len, flags);
         return Api::SysCallSizeResult{rc, errno};
       }));
+  EXPECT_CALL(os_sys_calls, recv(_, _, sizeof(buffer) + sizeof(tlv), 0))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
 
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
@@ -616,8 +716,8 @@ TEST_P(ProxyProtocolTest, v2Fragmented2) {
 }
 
 TEST_P(ProxyProtocolTest, v2Fragmented3Error) {
-  // A well-formed ipv4/tcp header, delivering all of the signature +1, w/ an error
-  // simulated in recv() on the +1
+  // A well-formed ipv4/tcp header, delivering all of the signature +1, then the remainder, w/ an
+  // error simulated in the peek sized by the header length
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
@@ -632,16 +732,9 @@ TEST_P(ProxyProtocolTest, v2Fragmented3Error) {
         const ssize_t rc = ::recv(fd, buf, len, flags);
         return Api::SysCallSizeResult{rc, errno};
       }));
-  EXPECT_CALL(os_sys_calls, recv(_, _, 1, _))
-      .Times(AnyNumber())
+  EXPECT_CALL(os_sys_calls, recv(_, _, 28, MSG_PEEK))
       .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
 
-  EXPECT_CALL(os_sys_calls, ioctl(_, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        const int rc = ::ioctl(fd, request, argp);
-        return Api::SysCallIntResult{rc, errno};
-      }));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -657,13 +750,15 @@ TEST_P(ProxyProtocolTest, v2Fragmented3Error) {
 
   connect(false);
   write(buffer, 17);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  write(buffer + 17, 20);
 
   expectProxyProtoError();
 }
 
 TEST_P(ProxyProtocolTest, v2Fragmented4Error) {
   // A well-formed ipv4/tcp header, part of the signature with an error introduced
-  // in recv() on the remainder
+  // in the peek of the remainder
   constexpr uint8_t buffer[] = {0x0d, 0x0a, 0x0d, 0x0a, 0x00, 0x0d, 0x0a, 0x51, 0x55, 0x49,
                                 0x54, 0x0a, 0x21, 0x11, 0x00, 0x0c, 0x01, 0x02, 0x03, 0x04,
                                 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x00, 0x02, 'm',  'o',
@@ -672,22 +767,13 @@ TEST_P(ProxyProtocolTest, v2Fragmented4Error) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-  EXPECT_CALL(os_sys_calls, recv(_, _, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, void* buf, size_t len, int flags) {
+  EXPECT_CALL(os_sys_calls, recv(_, _, _, MSG_PEEK))
+      .WillOnce(Invoke([](int fd, void* buf, size_t len, int flags) {
         const ssize_t rc = ::recv(fd, buf, len, flags);
         return Api::SysCallSizeResult{rc, errno};
-      }));
-  EXPECT_CALL(os_sys_calls, recv(_, _, 4, _))
-      .Times(AnyNumber())
+      }))
       .WillOnce(Return(Api::SysCallSizeResult{-1, 0}));
 
-  EXPECT_CALL(os_sys_calls, ioctl(_, _, _))
-      .Times(AnyNumber())
-      .WillRepeatedly(Invoke([](int fd, unsigned long int request, void* argp) {
-        const int rc = ::ioctl(fd, request, argp);
-        return Api::SysCallIntResult{rc, errno};
-      }));
   EXPECT_CALL(os_sys_calls, writev(_, _, _))
       .Times(AnyNumber())
       .WillRepeatedly(Invoke([](int fd, const struct iovec* iov, int iovcnt) {
@@ -898,6 +984,7 @@ public:
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+  void bindBufferMemoryAccounts(Network::Connection&) override {}
   std::chrono::milliseconds listenerFiltersTimeout() const override {
     return std::chrono::milliseconds();
   }
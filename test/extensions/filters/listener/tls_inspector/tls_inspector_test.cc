@@ -51,6 +51,13 @@ public:
     filter_->onAccept(cb_);
   }
 
+  // Simulates a previous listener filter which peeked the beginning of the stream.
+  void setStreamPrefix(const std::vector<uint8_t>& data) {
+    const size_t offset = 16;
+    memcpy(PeekBuffer::data() + offset, data.data(), data.size());
+    PeekBuffer::setStreamPrefix(42, offset, data.size());
+  }
+
   NiceMock<Api::MockOsSysCalls> os_sys_calls_;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
   Stats::IsolatedStoreImpl store_;
@@ -231,6 +238,66 @@ TEST_F(TlsInspectorTest, NotSsl) {
   EXPECT_EQ(1, cfg_->stats().tls_not_found_.value());
 }
 
+// Test that a ClientHello peeked by a previous filter is inspected without peeking again.
+TEST_F(TlsInspectorTest, StreamPrefixClientHello) {
+  const std::string servername("example.com");
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(servername, "");
+  setStreamPrefix(client_hello);
+  filter_ = std::make_unique<Filter>(cfg_);
+
+  EXPECT_CALL(cb_, socket()).WillRepeatedly(ReturnRef(socket_));
+  EXPECT_CALL(socket_, ioHandle()).WillRepeatedly(ReturnRef(*io_handle_));
+  EXPECT_CALL(dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  EXPECT_CALL(os_sys_calls_, recv(_, _, _, _)).Times(0);
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setRequestedApplicationProtocols(_)).Times(0);
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_CALL(cb_, continueFilterChain(_)).Times(0);
+  EXPECT_EQ(Network::FilterStatus::Continue, filter_->onAccept(cb_));
+  PeekBuffer::clearStreamPrefix();
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+  EXPECT_EQ(1, cfg_->stats().sni_found_.value());
+}
+
+// Test that the socket is peeked for the rest of a ClientHello peeked in part by a previous filter.
+TEST_F(TlsInspectorTest, StreamPrefixPartialClientHello) {
+  const std::string servername("example.com");
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello(servername, "");
+  setStreamPrefix({client_hello.begin(), client_hello.begin() + client_hello.size() / 2});
+  init();
+  PeekBuffer::clearStreamPrefix();
+
+  EXPECT_CALL(os_sys_calls_, recv(42, _, _, MSG_PEEK))
+      .WillOnce(
+          Invoke([&client_hello](int, void* buffer, size_t length, int) -> Api::SysCallSizeResult {
+            ASSERT(length >= client_hello.size());
+            memcpy(buffer, client_hello.data(), client_hello.size());
+            return Api::SysCallSizeResult{ssize_t(client_hello.size()), 0};
+          }));
+  EXPECT_CALL(socket_, setRequestedServerName(Eq(servername)));
+  EXPECT_CALL(socket_, setDetectedTransportProtocol(absl::string_view("tls")));
+  EXPECT_CALL(cb_, continueFilterChain(true));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().tls_found_.value());
+}
+
+// Test that the filter fails on the first read event when the bytes peeked by a previous filter
+// already exceed the maximum ClientHello size.
+TEST_F(TlsInspectorTest, StreamPrefixClientHelloTooBig) {
+  const size_t max_size = 50;
+  cfg_ = std::make_shared<Config>(store_, max_size);
+  std::vector<uint8_t> client_hello = Tls::Test::generateClientHello("example.com", "");
+  ASSERT(client_hello.size() > max_size);
+  setStreamPrefix(client_hello);
+  init();
+  PeekBuffer::clearStreamPrefix();
+
+  EXPECT_CALL(os_sys_calls_, recv(_, _, _, _)).Times(0);
+  EXPECT_CALL(cb_, continueFilterChain(false));
+  file_event_callback_(Event::FileReadyType::Read);
+  EXPECT_EQ(1, cfg_->stats().client_hello_too_large_.value());
+}
+
 } // namespace
 } // namespace TlsInspector
 } // namespace ListenerFilters
@@ -0,0 +1,234 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares TLS handshake throughput with the private key operations done inline on the event
+// loop and offloaded to the thread pool provider, and reports the p99 of the time the event
+// loop is blocked in a single server side SSL_do_handshake() call.
+//
+// NOLINT(namespace-envoy)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/private_key_provider/thread_pool/v2alpha/thread_pool.pb.h"
+
+#include "common/common/assert.h"
+#include "common/singleton/manager_impl.h"
+
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/bn.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/ssl.h"
+#include "openssl/x509.h"
+
+namespace {
+
+using Envoy::Extensions::PrivateKeyProviders::ThreadPool::ThreadPoolPrivateKeyMethodProvider;
+
+// A freshly generated 2048-bit RSA key and a self-signed certificate for it, so that the
+// benchmark doesn't depend on runfiles.
+struct TestCredentials {
+  TestCredentials() {
+    bssl::UniquePtr<RSA> rsa(RSA_new());
+    bssl::UniquePtr<BIGNUM> exponent(BN_new());
+    RELEASE_ASSERT(BN_set_word(exponent.get(), RSA_F4), "");
+    RELEASE_ASSERT(RSA_generate_key_ex(rsa.get(), 2048, exponent.get(), nullptr), "");
+    key_.reset(EVP_PKEY_new());
+    RELEASE_ASSERT(EVP_PKEY_assign_RSA(key_.get(), rsa.release()), "");
+
+    cert_.reset(X509_new());
+    X509_set_version(cert_.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert_.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert_.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert_.get()), 24 * 3600);
+    X509_set_pubkey(cert_.get(), key_.get());
+    X509_NAME* name = X509_get_subject_name(cert_.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const uint8_t*>("benchmark"), -1, -1, 0);
+    X509_set_issuer_name(cert_.get(), name);
+    RELEASE_ASSERT(X509_sign(cert_.get(), key_.get(), EVP_sha256()), "");
+
+    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+    RELEASE_ASSERT(
+        PEM_write_bio_PrivateKey(bio.get(), key_.get(), nullptr, nullptr, 0, nullptr, nullptr),
+        "");
+    const uint8_t* data;
+    size_t len;
+    BIO_mem_contents(bio.get(), &data, &len);
+    key_pem_.assign(reinterpret_cast<const char*>(data), len);
+  }
+
+  bssl::UniquePtr<EVP_PKEY> key_;
+  bssl::UniquePtr<X509> cert_;
+  std::string key_pem_;
+};
+
+const TestCredentials& credentials() {
+  static const TestCredentials* credentials = new TestCredentials();
+  return *credentials;
+}
+
+bssl::UniquePtr<SSL_CTX> serverContext(ThreadPoolPrivateKeyMethodProvider* provider) {
+  bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(SSL_CTX_use_certificate(ctx.get(), credentials().cert_.get()), "");
+  if (provider != nullptr) {
+    SSL_CTX_set_private_key_method(ctx.get(), provider->getBoringSslPrivateKeyMethod());
+  } else {
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey(ctx.get(), credentials().key_.get()), "");
+  }
+  return ctx;
+}
+
+// A client and a server connected by an in-memory BIO pair. Only the server side runs "on the
+// event loop"; the client stands in for the remote peer.
+class Handshake : public Envoy::Ssl::PrivateKeyConnectionCallbacks {
+public:
+  Handshake(SSL_CTX* client_ctx, SSL_CTX* server_ctx, ThreadPoolPrivateKeyMethodProvider* provider,
+            Envoy::Event::Dispatcher& dispatcher)
+      : client_(SSL_new(client_ctx)), server_(SSL_new(server_ctx)), provider_(provider),
+        dispatcher_(dispatcher) {
+    BIO* client_bio;
+    BIO* server_bio;
+    RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0), "");
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+    if (provider_ != nullptr) {
+      provider_->registerPrivateKeyMethod(server_.get(), *this, dispatcher_);
+    }
+  }
+
+  ~Handshake() override {
+    if (provider_ != nullptr) {
+      provider_->unregisterPrivateKeyMethod(server_.get());
+    }
+  }
+
+  // Envoy::Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override {
+    waiting_ = false;
+    dispatcher_.exit();
+  }
+
+  bool done() const { return client_done_ && server_done_; }
+  bool waiting() const { return waiting_; }
+
+  // Advances both sides until the handshake completes or the server waits for the provider.
+  // The duration of every server side call is appended to stalls.
+  void step(std::vector<double>& stalls) {
+    while (!done() && !waiting_) {
+      if (!client_done_) {
+        client_done_ = SSL_do_handshake(client_.get()) == 1;
+      }
+      if (!server_done_) {
+        const auto start = std::chrono::steady_clock::now();
+        const int rc = SSL_do_handshake(server_.get());
+        stalls.push_back(std::chrono::duration<double, std::micro>(
+                             std::chrono::steady_clock::now() - start)
+                             .count());
+        server_done_ = rc == 1;
+        if (!server_done_) {
+          const int err = SSL_get_error(server_.get(), rc);
+          RELEASE_ASSERT(err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION,
+                         "");
+          waiting_ = err == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION;
+        }
+      }
+    }
+  }
+
+private:
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+  ThreadPoolPrivateKeyMethodProvider* provider_;
+  Envoy::Event::Dispatcher& dispatcher_;
+  bool client_done_{};
+  bool server_done_{};
+  bool waiting_{};
+};
+
+void reportStalls(benchmark::State& state, std::vector<double>& stalls) {
+  std::sort(stalls.begin(), stalls.end());
+  state.counters["p99_loop_stall_us"] = stalls[stalls.size() * 99 / 100];
+  state.counters["max_loop_stall_us"] = stalls.back();
+}
+
+// Runs batches of state.range(0) concurrent handshakes. With an async provider the completions
+// of different handshakes overlap on the dispatcher, which is how a worker sees them.
+void runHandshakes(benchmark::State& state, ThreadPoolPrivateKeyMethodProvider* provider) {
+  Envoy::Api::ApiPtr api = Envoy::Api::createApiForTest();
+  Envoy::Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> server_ctx = serverContext(provider);
+  const size_t concurrency = state.range(0);
+  std::vector<double> stalls;
+
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<Handshake>> handshakes;
+    for (size_t i = 0; i < concurrency; i++) {
+      handshakes.emplace_back(
+          new Handshake(client_ctx.get(), server_ctx.get(), provider, *dispatcher));
+    }
+    size_t remaining = concurrency;
+    while (remaining > 0) {
+      remaining = 0;
+      bool any_waiting = false;
+      for (auto& handshake : handshakes) {
+        if (!handshake->waiting()) {
+          handshake->step(stalls);
+        }
+        remaining += handshake->done() ? 0 : 1;
+        any_waiting |= handshake->waiting();
+      }
+      if (any_waiting) {
+        dispatcher->run(Envoy::Event::Dispatcher::RunType::RunUntilExit);
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * concurrency);
+  reportStalls(state, stalls);
+}
+
+// Private key operations done inline, as with a locally loaded key.
+void BM_HandshakeSync(benchmark::State& state) { runHandshakes(state, nullptr); }
+BENCHMARK(BM_HandshakeSync)->Arg(1)->Arg(16)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Private key operations offloaded to a pool of state.range(1) threads.
+void BM_HandshakeThreadPool(benchmark::State& state) {
+  Envoy::Api::ApiPtr api = Envoy::Api::createApiForTest();
+  envoy::config::private_key_provider::thread_pool::v2alpha::ThreadPoolPrivateKeyProvider config;
+  config.mutable_private_key()->set_inline_string(credentials().key_pem_);
+  config.mutable_threads()->set_value(state.range(1));
+  Envoy::Singleton::ManagerImpl singleton_manager(
+      Envoy::Thread::threadFactoryForTest().currentThreadId());
+  ThreadPoolPrivateKeyMethodProvider provider(config, *api, singleton_manager);
+  runHandshakes(state, &provider);
+}
+BENCHMARK(BM_HandshakeThreadPool)
+    ->Args({1, 1})
+    ->Args({16, 1})
+    ->Args({16, 4})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,169 @@
+#include <memory>
+#include <string>
+
+#include "envoy/config/private_key_provider/thread_pool/v2alpha/thread_pool.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key_method_provider_config.h"
+
+#include "common/singleton/manager_impl.h"
+
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+#include "extensions/private_key_providers/well_known_names.h"
+
+#include "test/mocks/ssl/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/pem.h"
+#include "openssl/ssl.h"
+
+using testing::Invoke;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyProviders {
+namespace ThreadPool {
+namespace {
+
+class ThreadPoolPrivateKeyProviderTest : public testing::Test {
+protected:
+  ThreadPoolPrivateKeyProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()) {
+    config_.mutable_private_key()->set_filename(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"));
+    config_.mutable_threads()->set_value(1);
+  }
+
+  // Sets up an in-memory client/server pair whose server signs with the provider.
+  void setupHandshake(ThreadPoolPrivateKeyMethodProvider& provider) {
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    const std::string cert = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"));
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(cert.data(), cert.size()));
+    bssl::UniquePtr<X509> x509(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+    ASSERT_TRUE(SSL_CTX_use_certificate(server_ctx_.get(), x509.get()));
+    SSL_CTX_set_private_key_method(server_ctx_.get(), provider.getBoringSslPrivateKeyMethod());
+
+    client_.reset(SSL_new(client_ctx_.get()));
+    server_.reset(SSL_new(server_ctx_.get()));
+    BIO* client_bio;
+    BIO* server_bio;
+    ASSERT_TRUE(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+    provider.registerPrivateKeyMethod(server_.get(), callbacks_, *dispatcher_);
+  }
+
+  // Drives the handshake until it completes or the server waits for the provider. Returns the
+  // last server side SSL error.
+  int driveHandshake() {
+    int err = SSL_ERROR_NONE;
+    for (int i = 0; i < 10; i++) {
+      const int client_rc = SSL_do_handshake(client_.get());
+      const int server_rc = SSL_do_handshake(server_.get());
+      if (client_rc == 1 && server_rc == 1) {
+        return SSL_ERROR_NONE;
+      }
+      err = SSL_get_error(server_.get(), server_rc);
+      if (err != SSL_ERROR_WANT_READ) {
+        break;
+      }
+    }
+    return err;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Singleton::ManagerImpl singleton_manager_{Thread::threadFactoryForTest().currentThreadId()};
+  envoy::config::private_key_provider::thread_pool::v2alpha::ThreadPoolPrivateKeyProvider config_;
+  testing::StrictMock<Ssl::MockPrivateKeyConnectionCallbacks> callbacks_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+};
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, InvalidPrivateKey) {
+  config_.mutable_private_key()->set_inline_string("not a key");
+  EXPECT_THROW_WITH_MESSAGE(
+      ThreadPoolPrivateKeyMethodProvider provider(config_, *api_, singleton_manager_),
+      EnvoyException, "Failed to load private key from <inline>");
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, FactoryIsRegistered) {
+  auto* factory =
+      Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::getFactory(
+          PrivateKeyProviderNames::get().ThreadPool);
+  ASSERT_NE(nullptr, factory);
+  EXPECT_NE(nullptr,
+            factory->createPrivateKeyMethodProviderInstance(config_, *api_, singleton_manager_));
+}
+
+// All providers share one pool, sized by the largest configured number of threads.
+TEST_F(ThreadPoolPrivateKeyProviderTest, SharedPool) {
+  ThreadPoolPrivateKeyMethodProvider provider1(config_, *api_, singleton_manager_);
+  EXPECT_EQ(1U, provider1.poolForTest().numThreads());
+
+  config_.mutable_threads()->set_value(3);
+  ThreadPoolPrivateKeyMethodProvider provider2(config_, *api_, singleton_manager_);
+  EXPECT_EQ(&provider1.poolForTest(), &provider2.poolForTest());
+  EXPECT_EQ(3U, provider1.poolForTest().numThreads());
+
+  config_.mutable_threads()->set_value(2);
+  ThreadPoolPrivateKeyMethodProvider provider3(config_, *api_, singleton_manager_);
+  EXPECT_EQ(&provider1.poolForTest(), &provider3.poolForTest());
+  EXPECT_EQ(3U, provider3.poolForTest().numThreads());
+}
+
+// The signature is computed off the dispatcher thread and the handshake resumes once the
+// completion has been posted back.
+TEST_F(ThreadPoolPrivateKeyProviderTest, AsyncSign) {
+  ThreadPoolPrivateKeyMethodProvider provider(config_, *api_, singleton_manager_);
+  setupHandshake(provider);
+
+  EXPECT_EQ(SSL_ERROR_WANT_PRIVATE_KEY_OPERATION, driveHandshake());
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() {
+    dispatcher_->exit();
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+  EXPECT_EQ(SSL_ERROR_NONE, driveHandshake());
+  provider.unregisterPrivateKeyMethod(server_.get());
+}
+
+// A completion for an unregistered connection is dropped.
+TEST_F(ThreadPoolPrivateKeyProviderTest, CancelledOperation) {
+  {
+    ThreadPoolPrivateKeyMethodProvider provider(config_, *api_, singleton_manager_);
+    setupHandshake(provider);
+
+    EXPECT_EQ(SSL_ERROR_WANT_PRIVATE_KEY_OPERATION, driveHandshake());
+    provider.unregisterPrivateKeyMethod(server_.get());
+    // Destroying the last provider destroys the pool and joins the worker, so any completion has
+    // been posted by now.
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// Freeing the SSL object without unregistering also cancels the pending operation.
+TEST_F(ThreadPoolPrivateKeyProviderTest, SslFreedWithPendingOperation) {
+  {
+    ThreadPoolPrivateKeyMethodProvider provider(config_, *api_, singleton_manager_);
+    setupHandshake(provider);
+
+    EXPECT_EQ(SSL_ERROR_WANT_PRIVATE_KEY_OPERATION, driveHandshake());
+    server_.reset();
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyProviders
+} // namespace Extensions
+} // namespace Envoy
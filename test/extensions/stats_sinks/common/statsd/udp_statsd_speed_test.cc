@@ -0,0 +1,93 @@
+// Counts the datagrams, i.e. send() syscalls, the UDP statsd sink emits per flush, with and without
+// coalescing.
+//
+// Usage: bazel run //test/extensions/stats_sinks/common/statsd:udp_statsd_speed_test
+//
+// NOLINT(namespace-envoy)
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+
+#include "extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Counts datagrams instead of sending them.
+class CountingWriter : public Envoy::Extensions::StatSinks::Common::Statsd::Writer {
+public:
+  void write(const std::string& message) override {
+    datagrams_++;
+    bytes_ += message.size();
+  }
+
+  uint64_t datagrams_{};
+  uint64_t bytes_{};
+};
+
+} // namespace
+
+// Args: number of counters and gauges each, max bytes per datagram (0 disables coalescing).
+static void BM_UdpStatsdFlush(benchmark::State& state) {
+  const uint64_t num_stats = state.range(0);
+  const uint64_t max_bytes_per_datagram = state.range(1);
+
+  testing::NiceMock<Envoy::ThreadLocal::MockInstance> tls;
+  auto writer = std::make_shared<CountingWriter>();
+  Envoy::Extensions::StatSinks::Common::Statsd::UdpStatsdSink sink(tls, writer, false, "",
+                                                                   max_bytes_per_datagram);
+
+  testing::NiceMock<Envoy::Stats::MockMetricSnapshot> snapshot;
+  std::vector<std::unique_ptr<testing::NiceMock<Envoy::Stats::MockCounter>>> counters;
+  std::vector<std::unique_ptr<testing::NiceMock<Envoy::Stats::MockGauge>>> gauges;
+  for (uint64_t i = 0; i < num_stats; i++) {
+    counters.push_back(std::make_unique<testing::NiceMock<Envoy::Stats::MockCounter>>());
+    counters.back()->name_ = fmt::format("cluster.service_{}.upstream_rq_total", i);
+    counters.back()->used_ = true;
+    snapshot.counters_.push_back({i, *counters.back()});
+
+    gauges.push_back(std::make_unique<testing::NiceMock<Envoy::Stats::MockGauge>>());
+    gauges.back()->name_ = fmt::format("cluster.service_{}.upstream_rq_active", i);
+    gauges.back()->used_ = true;
+    gauges.back()->value_ = i;
+    snapshot.gauges_.push_back(*gauges.back());
+  }
+
+  for (auto _ : state) {
+    sink.flush(snapshot);
+  }
+
+  state.counters["datagrams_per_flush"] =
+      static_cast<double>(writer->datagrams_) / state.iterations();
+  state.counters["bytes_per_datagram"] =
+      static_cast<double>(writer->bytes_) / std::max<uint64_t>(1, writer->datagrams_);
+  tls.shutdownThread();
+}
+BENCHMARK(BM_UdpStatsdFlush)
+    ->Args({1000, 0})
+    ->Args({1000, 1432})
+    ->Args({1000, 8932})
+    ->Args({40000, 0})
+    ->Args({40000, 1432})
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logger_context(spdlog::level::warn,
+                                        Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -5,6 +5,7 @@
 
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
@@ -15,6 +16,7 @@
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::_;
 using testing::NiceMock;
 
 namespace Envoy {
@@ -178,6 +180,46 @@ TEST(UdpStatsdSinkTest, CheckActualStatsWithCustomPrefix) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, CheckBatchedStats) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::MockTimer* flush_timer = new Event::MockTimer(&tls_.dispatcher_);
+  // Room for two of the counter lines below plus their separator, but not three.
+  UdpStatsdSink sink(tls_, writer_ptr, false, "", 50);
+
+  std::vector<std::shared_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (uint32_t i = 0; i < 3; i++) {
+    auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+    counter->name_ = fmt::format("test_counter_{}", i);
+    counter->used_ = true;
+    counter->latch_ = 1;
+    snapshot.counters_.push_back({1, *counter});
+    counters.push_back(counter);
+  }
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*writer_ptr, write("envoy.test_counter_0:1|c\nenvoy.test_counter_1:1|c"));
+    EXPECT_CALL(*writer_ptr, write("envoy.test_counter_2:1|c"));
+  }
+  sink.flush(snapshot);
+
+  // Histogram samples are held until the datagram fills up or the flush timer fires.
+  NiceMock<Stats::MockHistogram> timer;
+  timer.name_ = "test_timer";
+  EXPECT_CALL(*flush_timer, enableTimer(_));
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  sink.onHistogramComplete(timer, 5);
+  sink.onHistogramComplete(timer, 6);
+
+  EXPECT_CALL(*writer_ptr, write("envoy.test_timer:5|ms\nenvoy.test_timer:6|ms"));
+  EXPECT_CALL(*flush_timer, disableTimer());
+  flush_timer->callback_();
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -0,0 +1,83 @@
+#include "envoy/config/metrics/v2/stats.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/stat_sinks/prometheus_remote_write/config.h"
+#include "extensions/stat_sinks/prometheus_remote_write/prometheus_remote_write.h"
+#include "extensions/stat_sinks/well_known_names.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace PrometheusRemoteWrite {
+namespace {
+
+class PrometheusRemoteWriteConfigTest : public testing::Test {
+protected:
+  PrometheusRemoteWriteConfigTest() {
+    factory_ = Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(
+        StatsSinkNames::get().PrometheusRemoteWrite);
+    TestUtility::loadFromYaml(R"EOF(
+http_uri:
+  uri: http://prometheus/api/v1/write
+  cluster: prometheus
+  timeout: 1s
+)EOF",
+                              sink_config_);
+  }
+
+  Stats::SinkPtr createSink() {
+    ProtobufTypes::MessagePtr message = factory_->createEmptyConfigProto();
+    TestUtility::jsonConvert(sink_config_, *message);
+    return factory_->createStatsSink(*message, server_);
+  }
+
+  Server::Configuration::StatsSinkFactory* factory_;
+  envoy::config::metrics::v2::PrometheusRemoteWriteSink sink_config_;
+  NiceMock<Server::MockInstance> server_;
+};
+
+TEST_F(PrometheusRemoteWriteConfigTest, ValidSink) {
+  ASSERT_NE(factory_, nullptr);
+  sink_config_.set_changed_metrics_only(true);
+
+  Stats::SinkPtr sink = createSink();
+  EXPECT_NE(dynamic_cast<RemoteWriteSink*>(sink.get()), nullptr);
+  EXPECT_TRUE(sink->changedMetricsOnly());
+}
+
+TEST_F(PrometheusRemoteWriteConfigTest, UnknownCluster) {
+  ASSERT_NE(factory_, nullptr);
+  EXPECT_CALL(server_.cluster_manager_, get(_)).WillOnce(Return(nullptr));
+  EXPECT_THROW_WITH_MESSAGE(createSink(), EnvoyException,
+                            "prometheus remote write: unknown cluster 'prometheus'");
+}
+
+TEST_F(PrometheusRemoteWriteConfigTest, ZeroSeriesPerRequest) {
+  ASSERT_NE(factory_, nullptr);
+  sink_config_.mutable_max_series_per_request()->set_value(0);
+  EXPECT_THROW(createSink(), ProtoValidationException);
+}
+
+TEST_F(PrometheusRemoteWriteConfigTest, ZeroRequestsInFlight) {
+  ASSERT_NE(factory_, nullptr);
+  sink_config_.mutable_max_requests_in_flight()->set_value(0);
+  EXPECT_THROW(createSink(), ProtoValidationException);
+}
+
+} // namespace
+} // namespace PrometheusRemoteWrite
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
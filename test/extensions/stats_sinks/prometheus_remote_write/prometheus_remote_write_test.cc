@@ -0,0 +1,358 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/http/message_impl.h"
+#include "common/stats/histogram_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/stat_sinks/prometheus_remote_write/prometheus_remote_write.h"
+
+#include "test/extensions/stats_sinks/prometheus_remote_write/remote_write.pb.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "circllhist.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "snappy.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace PrometheusRemoteWrite {
+namespace {
+
+// Decompresses with the snappy library, which rejects anything that isn't valid snappy.
+std::string uncompress(absl::string_view input) {
+  std::string output;
+  EXPECT_TRUE(snappy::Uncompress(input.data(), input.size(), &output));
+  return output;
+}
+
+struct Series {
+  std::vector<std::pair<std::string, std::string>> labels_;
+  double value_;
+  int64_t timestamp_;
+
+  std::string name() const { return labels_.empty() ? "" : labels_[0].second; }
+  std::map<std::string, std::string> labelMap() const { return {labels_.begin(), labels_.end()}; }
+};
+
+// Parses a WriteRequest as Prometheus does, checking that each series has exactly one sample.
+std::vector<Series> decodeWriteRequest(const std::string& request) {
+  prometheus::WriteRequest write_request;
+  EXPECT_TRUE(write_request.ParseFromString(request));
+  std::vector<Series> series;
+  for (const prometheus::TimeSeries& time_series : write_request.timeseries()) {
+    series.emplace_back();
+    for (const prometheus::Label& label : time_series.labels()) {
+      series.back().labels_.emplace_back(label.name(), label.value());
+    }
+    EXPECT_EQ(1, time_series.samples_size());
+    if (time_series.samples_size() > 0) {
+      series.back().value_ = time_series.samples(0).value();
+      series.back().timestamp_ = time_series.samples(0).timestamp();
+    }
+  }
+  return series;
+}
+
+class RemoteWriteSinkTest : public testing::Test {
+protected:
+  RemoteWriteSinkTest() {
+    TestUtility::loadFromYaml(R"EOF(
+uri: http://prometheus/api/v1/write
+cluster: prometheus
+timeout: 2s
+)EOF",
+                              http_uri_);
+    time_system_.setSystemTime(std::chrono::milliseconds(1234567));
+    ON_CALL(snapshot_, counters()).WillByDefault(ReturnRef(snapshot_.counters_));
+    ON_CALL(snapshot_, gauges()).WillByDefault(ReturnRef(snapshot_.gauges_));
+    ON_CALL(snapshot_, histograms()).WillByDefault(ReturnRef(snapshot_.histograms_));
+  }
+
+  void createSink(uint32_t max_series_per_request = 1000, uint32_t max_requests_in_flight = 100) {
+    sink_ = std::make_unique<RemoteWriteSink>(http_uri_, max_series_per_request,
+                                              max_requests_in_flight, false, cm_, dispatcher_,
+                                              store_, time_system_);
+  }
+
+  void addCounter(const std::string& name, uint64_t value, std::vector<Stats::Tag> tags = {}) {
+    auto counter = std::make_unique<NiceMock<Stats::MockCounter>>();
+    counter->name_ = name;
+    counter->setTags(tags);
+    counter->used_ = true;
+    counter->value_ = value;
+    snapshot_.counters_.push_back({value, *counter});
+    counters_.push_back(std::move(counter));
+  }
+
+  // Expects one request per entry of num_series, capturing the series sent.
+  void expectRequests(std::vector<size_t> num_series) {
+    EXPECT_CALL(cm_, httpAsyncClientForCluster("prometheus"))
+        .Times(num_series.size())
+        .WillRepeatedly(ReturnRef(cm_.async_client_));
+    EXPECT_CALL(cm_.async_client_, send_(_, _,
+                                         Http::AsyncClient::RequestOptions().setTimeout(
+                                             std::chrono::milliseconds(2000))))
+        .Times(num_series.size())
+        .WillRepeatedly(
+            Invoke([this, num_series](Http::MessagePtr& message,
+                                      Http::AsyncClient::Callbacks& callbacks,
+                                      const Http::AsyncClient::RequestOptions&)
+                       -> Http::AsyncClient::Request* {
+              checkRequest(*message, num_series[callbacks_.size()]);
+              callbacks_.push_back(&callbacks);
+              return &request_;
+            }));
+  }
+
+  void checkRequest(Http::Message& message, size_t num_series) {
+    const Http::HeaderMap& headers = message.headers();
+    EXPECT_EQ("POST", headers.Method()->value().getStringView());
+    EXPECT_EQ("/api/v1/write", headers.Path()->value().getStringView());
+    EXPECT_EQ("prometheus", headers.Host()->value().getStringView());
+    EXPECT_EQ("application/x-protobuf", headers.ContentType()->value().getStringView());
+    EXPECT_EQ("snappy", headers.ContentEncoding()->value().getStringView());
+    const Http::HeaderEntry* version =
+        headers.get(Http::LowerCaseString("x-prometheus-remote-write-version"));
+    ASSERT_NE(nullptr, version);
+    EXPECT_EQ("0.1.0", version->value().getStringView());
+
+    const std::string body = message.bodyAsString();
+    const std::string request = uncompress(body);
+    compressed_bytes_ += body.size();
+    uncompressed_bytes_ += request.size();
+    const std::vector<Series> series = decodeWriteRequest(request);
+    EXPECT_EQ(num_series, series.size());
+    series_.insert(series_.end(), series.begin(), series.end());
+  }
+
+  void respond(Http::AsyncClient::Callbacks& callbacks, const std::string& status) {
+    callbacks.onSuccess(Http::MessagePtr{new Http::ResponseMessageImpl(
+        Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", status}}})});
+  }
+
+  envoy::api::v2::core::HttpUri http_uri_;
+  NiceMock<Upstream::MockClusterManager> cm_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Stats::IsolatedStoreImpl store_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot_;
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters_;
+  Http::MockAsyncClientRequest request_{&cm_.async_client_};
+  std::vector<Http::AsyncClient::Callbacks*> callbacks_;
+  std::vector<Series> series_;
+  uint64_t compressed_bytes_{};
+  uint64_t uncompressed_bytes_{};
+  std::unique_ptr<RemoteWriteSink> sink_;
+};
+
+TEST_F(RemoteWriteSinkTest, FlushMetrics) {
+  createSink();
+  addCounter("cluster.foo.upstream_rq_total", 7, {{"envoy.cluster_name", "foo"}});
+  counters_.back()->setTagExtractedName("cluster.upstream_rq_total");
+
+  NiceMock<Stats::MockCounter> unused_counter;
+  unused_counter.name_ = "unused";
+  unused_counter.used_ = false;
+  unused_counter.value_ = 0;
+  snapshot_.counters_.push_back({0, unused_counter});
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "1st.gauge";
+  gauge.used_ = true;
+  gauge.value_ = 3;
+  gauge.setTags({{"Zone", "a"}});
+  snapshot_.gauges_.push_back(gauge);
+
+  histogram_t* hist = hist_alloc();
+  for (uint64_t value : {1, 20, 300}) {
+    hist_insert_intscale(hist, value, 0, 1);
+  }
+  Stats::HistogramStatisticsImpl statistics(hist);
+  hist_free(hist);
+  NiceMock<Stats::MockParentHistogram> histogram;
+  histogram.name_ = "histogram";
+  histogram.used_ = true;
+  ON_CALL(histogram, cumulativeStatistics()).WillByDefault(ReturnRef(statistics));
+  snapshot_.histograms_.push_back(histogram);
+  const size_t num_buckets = statistics.supportedBuckets().size();
+
+  expectRequests({2 + num_buckets + 3});
+  sink_->flush(snapshot_);
+  ASSERT_EQ(2 + num_buckets + 3, series_.size());
+
+  // Labels are sorted by name, which puts __name__ after uppercase tag names.
+  EXPECT_EQ((std::vector<std::pair<std::string, std::string>>{
+                {"__name__", "envoy_cluster_upstream_rq_total"}, {"envoy_cluster_name", "foo"}}),
+            series_[0].labels_);
+  EXPECT_EQ(7, series_[0].value_);
+  EXPECT_EQ(1234567, series_[0].timestamp_);
+
+  EXPECT_EQ((std::vector<std::pair<std::string, std::string>>{{"Zone", "a"},
+                                                              {"__name__", "envoy_1st_gauge"}}),
+            series_[1].labels_);
+  EXPECT_EQ(3, series_[1].value_);
+
+  EXPECT_EQ("envoy_histogram_bucket", series_[2].labelMap()["__name__"]);
+  EXPECT_EQ("0.5", series_[2].labelMap()["le"]);
+  EXPECT_EQ(0, series_[2].value_);
+  EXPECT_EQ("+Inf", series_[2 + num_buckets].labelMap()["le"]);
+  EXPECT_EQ(3, series_[2 + num_buckets].value_);
+  EXPECT_EQ("envoy_histogram_sum", series_[3 + num_buckets].name());
+  EXPECT_EQ(statistics.sampleSum(), series_[3 + num_buckets].value_);
+  EXPECT_EQ("envoy_histogram_count", series_[4 + num_buckets].name());
+  EXPECT_EQ(3, series_[4 + num_buckets].value_);
+
+  respond(*callbacks_[0], "200");
+  EXPECT_EQ(1, store_.counter("prometheus_remote_write.requests_sent").value());
+  EXPECT_EQ(2 + num_buckets + 3, store_.counter("prometheus_remote_write.series_sent").value());
+}
+
+TEST_F(RemoteWriteSinkTest, BatchSeries) {
+  createSink(2);
+  addCounter("a", 1);
+  addCounter("b", 2);
+  addCounter("c", 3);
+
+  expectRequests({2, 1});
+  sink_->flush(snapshot_);
+  ASSERT_EQ(3, series_.size());
+  EXPECT_EQ("envoy_c", series_[2].name());
+  EXPECT_EQ(3, series_[2].value_);
+}
+
+// The snappy compressed bodies of a large flush round trip, and the repetitive label sets of the
+// series compress well.
+TEST_F(RemoteWriteSinkTest, CompressedBodyRoundTrips) {
+  createSink();
+  for (uint32_t i = 0; i < 1000; ++i) {
+    const std::string cluster_name = absl::StrCat("cluster_", i);
+    addCounter(absl::StrCat("cluster.", cluster_name, ".upstream_rq_total"), i,
+               {{"envoy.cluster_name", cluster_name}});
+    counters_.back()->setTagExtractedName("cluster.upstream_rq_total");
+  }
+
+  expectRequests({1000});
+  sink_->flush(snapshot_);
+  ASSERT_EQ(1000, series_.size());
+  EXPECT_EQ("cluster_999", series_[999].labelMap()["envoy_cluster_name"]);
+  EXPECT_EQ(999, series_[999].value_);
+  EXPECT_LT(compressed_bytes_ * 4, uncompressed_bytes_);
+}
+
+TEST_F(RemoteWriteSinkTest, NothingToFlush) {
+  createSink();
+  EXPECT_CALL(cm_, httpAsyncClientForCluster(_)).Times(0);
+  sink_->flush(snapshot_);
+}
+
+TEST_F(RemoteWriteSinkTest, RequestFailures) {
+  createSink();
+  addCounter("a", 1);
+
+  expectRequests({1, 1, 1});
+  sink_->flush(snapshot_);
+  sink_->flush(snapshot_);
+  sink_->flush(snapshot_);
+
+  EXPECT_CALL(dispatcher_, deferredDelete_(_)).Times(3);
+  respond(*callbacks_[0], "500");
+  callbacks_[1]->onFailure(Http::AsyncClient::FailureReason::Reset);
+  respond(*callbacks_[2], "204");
+  EXPECT_EQ(2, store_.counter("prometheus_remote_write.requests_failed").value());
+  EXPECT_EQ(1, store_.counter("prometheus_remote_write.requests_sent").value());
+  EXPECT_EQ(1, store_.counter("prometheus_remote_write.series_sent").value());
+}
+
+TEST_F(RemoteWriteSinkTest, CancelRequestsOnDestruction) {
+  createSink();
+  addCounter("a", 1);
+
+  expectRequests({1, 1});
+  sink_->flush(snapshot_);
+  sink_->flush(snapshot_);
+  respond(*callbacks_[0], "200");
+
+  // Only the request still in flight is cancelled.
+  EXPECT_CALL(request_, cancel());
+  sink_.reset();
+}
+
+TEST_F(RemoteWriteSinkTest, RequestFailsInline) {
+  createSink();
+  addCounter("a", 1);
+
+  EXPECT_CALL(cm_.async_client_, send_(_, _, _))
+      .WillOnce(Invoke([](Http::MessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                          const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+        callbacks.onFailure(Http::AsyncClient::FailureReason::Reset);
+        return nullptr;
+      }));
+  sink_->flush(snapshot_);
+  EXPECT_EQ(1, store_.counter("prometheus_remote_write.requests_failed").value());
+
+  EXPECT_CALL(request_, cancel()).Times(0);
+  sink_.reset();
+}
+
+// Once max_requests_in_flight requests await a response, further requests are dropped.
+TEST_F(RemoteWriteSinkTest, RequestsInFlightCapped) {
+  createSink(1, 2);
+  addCounter("a", 1);
+  addCounter("b", 2);
+
+  expectRequests({1, 1, 1});
+  sink_->flush(snapshot_);
+  EXPECT_EQ(0, store_.counter("prometheus_remote_write.requests_dropped").value());
+  sink_->flush(snapshot_);
+  EXPECT_EQ(2, store_.counter("prometheus_remote_write.requests_dropped").value());
+
+  // A response makes room for the next request.
+  respond(*callbacks_[0], "200");
+  sink_->flush(snapshot_);
+  EXPECT_EQ(3, store_.counter("prometheus_remote_write.requests_dropped").value());
+  EXPECT_EQ("envoy_a", series_.back().name());
+}
+
+TEST_F(RemoteWriteSinkTest, CachedLabelsExpire) {
+  createSink();
+  addCounter("a", 1, {{"tag", "old"}});
+
+  expectRequests(std::vector<size_t>(3, 1));
+  sink_->flush(snapshot_);
+  EXPECT_EQ("old", series_.back().labelMap()["tag"]);
+
+  // The labels of a metric are computed once, while it keeps being flushed.
+  counters_[0]->setTags({{"tag", "new"}});
+  sink_->flush(snapshot_);
+  EXPECT_EQ("old", series_.back().labelMap()["tag"]);
+
+  auto counter_snapshot = snapshot_.counters_;
+  snapshot_.counters_.clear();
+  for (uint64_t i = 0; i < RemoteWriteSink::CachedSeriesExpiryFlushes + 1; ++i) {
+    sink_->flush(snapshot_);
+  }
+  snapshot_.counters_ = counter_snapshot;
+  sink_->flush(snapshot_);
+  EXPECT_EQ("new", series_.back().labelMap()["tag"]);
+}
+
+} // namespace
+} // namespace PrometheusRemoteWrite
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
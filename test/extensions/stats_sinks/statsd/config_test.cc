@@ -164,6 +164,26 @@ TEST(StatsConfigTest, TcpSinkCustomPrefix) {
   EXPECT_EQ(tcp_sink->getPrefix(), prefix);
 }
 
+TEST(StatsConfigTest, TcpSinkChangedMetricsOnly) {
+  const std::string name = StatsSinkNames::get().Statsd;
+
+  envoy::config::metrics::v2::StatsdSink sink_config;
+  sink_config.set_tcp_cluster_name("fake_cluster");
+  sink_config.set_changed_metrics_only(true);
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(name);
+  ASSERT_NE(factory, nullptr);
+
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  TestUtility::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::MockInstance> server;
+  Stats::SinkPtr sink = factory->createStatsSink(*message, server);
+  ASSERT_NE(sink, nullptr);
+  EXPECT_TRUE(sink->changedMetricsOnly());
+}
+
 class StatsConfigLoopbackTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, StatsConfigLoopbackTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -0,0 +1,107 @@
+#include <chrono>
+
+#include "extensions/transport_sockets/tls/cert_verify_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Keys with the same first byte share a shard.
+CertVerifyCache::Key makeKey(uint8_t shard, uint8_t id) {
+  CertVerifyCache::Key key{};
+  key[0] = shard;
+  key[1] = id;
+  return key;
+}
+
+class CertVerifyCacheTest : public testing::Test {
+protected:
+  const SystemTime now_{std::chrono::hours(1000)};
+  const SystemTime later_{now_ + std::chrono::hours(1)};
+};
+
+TEST_F(CertVerifyCacheTest, Miss) {
+  CertVerifyCache cache(16);
+  EXPECT_FALSE(cache.lookup(makeKey(0, 0), now_).has_value());
+}
+
+TEST_F(CertVerifyCacheTest, HitReturnsVerifyTime) {
+  CertVerifyCache cache(16);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(250));
+  const auto verify_time = cache.lookup(makeKey(0, 0), now_);
+  ASSERT_TRUE(verify_time.has_value());
+  EXPECT_EQ(std::chrono::microseconds(250), verify_time.value());
+  EXPECT_FALSE(cache.lookup(makeKey(0, 1), now_).has_value());
+}
+
+TEST_F(CertVerifyCacheTest, ExpiredEntryDropped) {
+  CertVerifyCache cache(16);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(250));
+  EXPECT_FALSE(cache.lookup(makeKey(0, 0), later_).has_value());
+  EXPECT_FALSE(cache.lookup(makeKey(0, 0), now_).has_value());
+}
+
+// Each shard holds max_entries / 16 chains and evicts its least recently used one.
+TEST_F(CertVerifyCacheTest, LeastRecentlyUsedEvicted) {
+  CertVerifyCache cache(32);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(0, 1), later_, std::chrono::microseconds(1));
+  EXPECT_TRUE(cache.lookup(makeKey(0, 0), now_).has_value());
+
+  cache.insert(makeKey(0, 2), later_, std::chrono::microseconds(1));
+  EXPECT_TRUE(cache.lookup(makeKey(0, 0), now_).has_value());
+  EXPECT_FALSE(cache.lookup(makeKey(0, 1), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(0, 2), now_).has_value());
+}
+
+TEST_F(CertVerifyCacheTest, ShardsAreIndependent) {
+  CertVerifyCache cache(16);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(1, 0), later_, std::chrono::microseconds(1));
+  EXPECT_TRUE(cache.lookup(makeKey(0, 0), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(1, 0), now_).has_value());
+}
+
+// A cache smaller than the number of shards uses one shard per chain rather than rounding up.
+TEST_F(CertVerifyCacheTest, FewerEntriesThanShards) {
+  CertVerifyCache cache(2);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(1, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(2, 0), later_, std::chrono::microseconds(1));
+  EXPECT_FALSE(cache.lookup(makeKey(0, 0), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(1, 0), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(2, 0), now_).has_value());
+}
+
+// The shards which take the remainder of the division hold one more chain.
+TEST_F(CertVerifyCacheTest, RemainderSpreadOverShards) {
+  CertVerifyCache cache(17);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(0, 1), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(1, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(1, 1), later_, std::chrono::microseconds(1));
+  EXPECT_TRUE(cache.lookup(makeKey(0, 0), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(0, 1), now_).has_value());
+  EXPECT_FALSE(cache.lookup(makeKey(1, 0), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(1, 1), now_).has_value());
+}
+
+// Re-inserting a cached chain keeps a single entry.
+TEST_F(CertVerifyCacheTest, DuplicateInsert) {
+  CertVerifyCache cache(32);
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(0, 0), later_, std::chrono::microseconds(1));
+  cache.insert(makeKey(0, 1), later_, std::chrono::microseconds(1));
+  EXPECT_TRUE(cache.lookup(makeKey(0, 0), now_).has_value());
+  EXPECT_TRUE(cache.lookup(makeKey(0, 1), now_).has_value());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,127 @@
+#include <memory>
+#include <string>
+
+#include "envoy/api/v2/auth/cert.pb.h"
+
+#include "common/ssl/certificate_validation_context_config_impl.h"
+
+#include "extensions/transport_sockets/tls/certificate_cache.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class CertificateCacheTest : public testing::Test {
+protected:
+  CertificateCacheTest() : api_(Api::createApiForTest()) {}
+
+  std::unique_ptr<Envoy::Ssl::CertificateValidationContextConfigImpl>
+  validationContext(const std::string& ca_file, const std::string& crl_file = "",
+                    bool allow_expired = false) {
+    envoy::api::v2::auth::CertificateValidationContext config;
+    config.mutable_trusted_ca()->set_filename(testDataPath(ca_file));
+    if (!crl_file.empty()) {
+      config.mutable_crl()->set_filename(testDataPath(crl_file));
+    }
+    config.set_allow_expired_certificate(allow_expired);
+    return std::make_unique<Envoy::Ssl::CertificateValidationContextConfigImpl>(config, *api_);
+  }
+
+  std::string testData(const std::string& file) {
+    return TestEnvironment::readFileToStringForTest(testDataPath(file));
+  }
+
+  static std::string testDataPath(const std::string& file) {
+    return TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + file);
+  }
+
+  Api::ApiPtr api_;
+  CertificateCache cache_;
+};
+
+TEST_F(CertificateCacheTest, TrustedCaSharedByContent) {
+  CertificateCache::TrustedCaConstSharedPtr trusted_ca =
+      cache_.trustedCa(*validationContext("ca_cert.pem"));
+  ASSERT_NE(nullptr, trusted_ca->store_);
+  ASSERT_NE(nullptr, trusted_ca->first_cert_);
+  EXPECT_EQ(1, sk_X509_NAME_num(trusted_ca->subject_names_.get()));
+
+  EXPECT_EQ(trusted_ca, cache_.trustedCa(*validationContext("ca_cert.pem")));
+  EXPECT_NE(trusted_ca, cache_.trustedCa(*validationContext("ca_certificates.pem")));
+}
+
+// The CRL and the expiration handling are part of the store, so they are part of the key.
+TEST_F(CertificateCacheTest, TrustedCaKeyedByVerificationSettings) {
+  CertificateCache::TrustedCaConstSharedPtr trusted_ca =
+      cache_.trustedCa(*validationContext("ca_cert.pem"));
+  EXPECT_NE(trusted_ca, cache_.trustedCa(*validationContext("ca_cert.pem", "ca_cert.crl")));
+  EXPECT_NE(trusted_ca, cache_.trustedCa(*validationContext("ca_cert.pem", "", true)));
+}
+
+TEST_F(CertificateCacheTest, TrustedCaSubjectNames) {
+  CertificateCache::TrustedCaConstSharedPtr trusted_ca =
+      cache_.trustedCa(*validationContext("ca_certificates.pem"));
+  EXPECT_EQ(2, sk_X509_NAME_num(trusted_ca->subject_names_.get()));
+}
+
+TEST_F(CertificateCacheTest, TrustedCaInvalid) {
+  EXPECT_THROW_WITH_REGEX(cache_.trustedCa(*validationContext("ca_cert.pem", "not_a_crl.crl")),
+                          EnvoyException, "^Failed to load CRL from .*/not_a_crl.crl$");
+}
+
+// The cache doesn't keep entries alive once no context uses them.
+TEST_F(CertificateCacheTest, UnusedEntryReleased) {
+  std::weak_ptr<const CertificateCache::TrustedCa> trusted_ca =
+      cache_.trustedCa(*validationContext("ca_cert.pem"));
+  EXPECT_TRUE(trusted_ca.expired());
+  EXPECT_NE(nullptr, cache_.trustedCa(*validationContext("ca_cert.pem"))->store_);
+}
+
+// Entries no longer in use are swept when an entry of the same kind is inserted, even if their
+// material is never requested again.
+TEST_F(CertificateCacheTest, UnusedEntriesSweptOnInsert) {
+  CertificateCache::TrustedCaConstSharedPtr trusted_ca =
+      cache_.trustedCa(*validationContext("ca_cert.pem"));
+  cache_.trustedCa(*validationContext("ca_certificates.pem"));
+  cache_.certificateChain(testData("san_dns3_chain.pem"), "san_dns3_chain.pem");
+  EXPECT_EQ(3, cache_.sizeForTest());
+
+  // Sweeps the unused CA bundle, but not yet the unused chain.
+  CertificateCache::TrustedCaConstSharedPtr crl_trusted_ca =
+      cache_.trustedCa(*validationContext("ca_cert.pem", "ca_cert.crl"));
+  EXPECT_EQ(3, cache_.sizeForTest());
+
+  CertificateCache::CertificateChainConstSharedPtr chain =
+      cache_.certificateChain(testData("no_san_chain.pem"), "no_san_chain.pem");
+  EXPECT_EQ(3, cache_.sizeForTest());
+  EXPECT_EQ(trusted_ca, cache_.trustedCa(*validationContext("ca_cert.pem")));
+}
+
+TEST_F(CertificateCacheTest, CertificateChainSharedByContent) {
+  CertificateCache::CertificateChainConstSharedPtr chain =
+      cache_.certificateChain(testData("san_dns3_chain.pem"), "san_dns3_chain.pem");
+  ASSERT_NE(nullptr, chain->leaf_);
+  EXPECT_EQ(1, chain->intermediates_.size());
+
+  EXPECT_EQ(chain, cache_.certificateChain(testData("san_dns3_chain.pem"), "other path"));
+  EXPECT_NE(chain, cache_.certificateChain(testData("no_san_chain.pem"), "no_san_chain.pem"));
+}
+
+TEST_F(CertificateCacheTest, CertificateChainInvalid) {
+  EXPECT_THROW_WITH_MESSAGE(cache_.certificateChain("not a certificate", "bad.pem"),
+                            EnvoyException, "Failed to load certificate chain from bad.pem");
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
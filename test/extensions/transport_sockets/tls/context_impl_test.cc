@@ -1065,6 +1065,39 @@ TEST_F(ServerContextConfigImplTest, TlsCertificatesAndSdsConfig) {
       "SDS and non-SDS TLS certificates may not be mixed in server contexts");
 }
 
+// A certificate can't have both a local private key and a private key provider.
+TEST_F(ServerContextConfigImplTest, PrivateKeyAndPrivateKeyProvider) {
+  envoy::api::v2::auth::DownstreamTlsContext tls_context;
+  const std::string tls_certificate_yaml = R"EOF(
+  certificate_chain:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+  private_key:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+  private_key_provider:
+    provider_name: envoy.private_key_providers.thread_pool
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_certificate_yaml),
+                            *tls_context.mutable_common_tls_context()->add_tls_certificates());
+  EXPECT_THROW_WITH_MESSAGE(
+      ServerContextConfigImpl server_context_config(tls_context, factory_context_), EnvoyException,
+      "Certificate configuration can't have both private_key and private_key_provider");
+}
+
+TEST_F(ServerContextConfigImplTest, UnknownPrivateKeyProvider) {
+  envoy::api::v2::auth::DownstreamTlsContext tls_context;
+  const std::string tls_certificate_yaml = R"EOF(
+  certificate_chain:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+  private_key_provider:
+    provider_name: envoy.private_key_providers.unknown
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_certificate_yaml),
+                            *tls_context.mutable_common_tls_context()->add_tls_certificates());
+  EXPECT_THROW_WITH_MESSAGE(
+      ServerContextConfigImpl server_context_config(tls_context, factory_context_), EnvoyException,
+      "Didn't find a registered implementation for name: 'envoy.private_key_providers.unknown'");
+}
+
 TEST_F(ServerContextConfigImplTest, MultiSdsConfig) {
   envoy::api::v2::auth::DownstreamTlsContext tls_context;
   tls_context.mutable_common_tls_context()->add_tls_certificate_sds_secret_configs();
@@ -0,0 +1,288 @@
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "common/api/os_sys_calls_impl.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/extensions/transport_sockets/tls/ssl_test_utility.h"
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+constexpr int Fd = 42;
+
+class KernelTlsTest : public testing::Test {
+protected:
+  // Completes an in-memory handshake limited to the given version and cipher list.
+  void handshake(uint16_t version, const char* ciphers) {
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    for (SSL_CTX* ctx : {client_ctx_.get(), server_ctx_.get()}) {
+      ASSERT_TRUE(SSL_CTX_set_min_proto_version(ctx, version));
+      ASSERT_TRUE(SSL_CTX_set_max_proto_version(ctx, version));
+      ASSERT_TRUE(SSL_CTX_set_strict_cipher_list(ctx, ciphers));
+    }
+    bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"));
+    ASSERT_TRUE(SSL_CTX_use_certificate(server_ctx_.get(), cert.get()));
+    ASSERT_TRUE(SSL_CTX_use_PrivateKey_file(
+        server_ctx_.get(),
+        TestEnvironment::substitute(
+            "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem")
+            .c_str(),
+        SSL_FILETYPE_PEM));
+
+    client_.reset(SSL_new(client_ctx_.get()));
+    server_.reset(SSL_new(server_ctx_.get()));
+    BIO* client_bio;
+    BIO* server_bio;
+    ASSERT_TRUE(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+
+    bool done = false;
+    for (int i = 0; i < 10 && !done; i++) {
+      const int client_rc = SSL_do_handshake(client_.get());
+      const int server_rc = SSL_do_handshake(server_.get());
+      done = client_rc == 1 && server_rc == 1;
+    }
+    ASSERT_TRUE(done);
+  }
+
+  Api::MockOsSysCalls os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+};
+
+// TLS 1.3 traffic keys aren't exported, so nothing is offloaded.
+TEST_F(KernelTlsTest, Tls13NotOffloaded) {
+  handshake(TLS1_3_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+
+  const KernelTls::Offload offload = KernelTls::enable(server_.get(), Fd);
+  EXPECT_FALSE(offload.tx_);
+  EXPECT_FALSE(offload.rx_);
+}
+
+TEST_F(KernelTlsTest, UnsupportedCipherNotOffloaded) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305");
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+
+  const KernelTls::Offload offload = KernelTls::enable(server_.get(), Fd);
+  EXPECT_FALSE(offload.tx_);
+  EXPECT_FALSE(offload.rx_);
+}
+
+TEST_F(KernelTlsTest, BothDirectionsOffloaded) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  {
+    InSequence s;
+    // TCP_ULP, then TLS_TX, then TLS_RX.
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, _, _, _, sizeof("tls"))).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, _, _, _, _)).Times(2).WillRepeatedly(Return(0));
+  }
+
+  const KernelTls::Offload offload = KernelTls::enable(server_.get(), Fd);
+  EXPECT_TRUE(offload.tx_);
+  EXPECT_TRUE(offload.rx_);
+}
+
+TEST_F(KernelTlsTest, Aes256Offloaded) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES256-GCM-SHA384");
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, _, _, _, _)).Times(3).WillRepeatedly(Return(0));
+
+  const KernelTls::Offload offload = KernelTls::enable(client_.get(), Fd);
+  EXPECT_TRUE(offload.tx_);
+  EXPECT_TRUE(offload.rx_);
+}
+
+// A kernel without the tls ULP leaves the connection in userspace.
+TEST_F(KernelTlsTest, UlpUnavailable) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, _, _, _, _))
+      .Times(KernelTls::compiledIn() ? 1 : 0)
+      .WillRepeatedly(Return(-1));
+
+  const KernelTls::Offload offload = KernelTls::enable(server_.get(), Fd);
+  EXPECT_FALSE(offload.tx_);
+  EXPECT_FALSE(offload.rx_);
+}
+
+// The receive direction is only installed once the transmit direction is.
+TEST_F(KernelTlsTest, TxFailureSkipsRx) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256");
+  {
+    InSequence s;
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, _, _, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(os_sys_calls_, setsockopt_(Fd, _, _, _, _)).WillOnce(Return(-1));
+  }
+
+  const KernelTls::Offload offload = KernelTls::enable(server_.get(), Fd);
+  EXPECT_FALSE(offload.tx_);
+  EXPECT_FALSE(offload.rx_);
+}
+
+class KernelTlsReadTest : public testing::Test {
+protected:
+  // The kernel's SOL_TLS and TLS_GET_RECORD_TYPE.
+  static constexpr int SolTls = 282;
+  static constexpr int TlsGetRecordType = 2;
+
+  // Has the next recvmsg() return the given bytes, tagged with the given record type if any.
+  void expectRecvmsg(const std::string& payload, absl::optional<uint8_t> record_type) {
+    EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, 0))
+        .WillOnce(Invoke([payload, record_type](int, msghdr* message, int) {
+          memcpy(message->msg_iov[0].iov_base, payload.data(), payload.size());
+          if (record_type.has_value()) {
+            cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+            cmsg->cmsg_level = SolTls;
+            cmsg->cmsg_type = TlsGetRecordType;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+            *CMSG_DATA(cmsg) = record_type.value();
+          } else {
+            message->msg_controllen = 0;
+          }
+          return Api::SysCallSizeResult{static_cast<ssize_t>(payload.size()), 0};
+        }));
+  }
+
+  void expectRecvmsgError(int error) {
+    EXPECT_CALL(os_sys_calls_, recvmsg(Fd, _, 0))
+        .WillOnce(Return(Api::SysCallSizeResult{-1, error}));
+  }
+
+  KernelTls::ReadResult read() {
+    Buffer::RawSlice slice{buffer_, sizeof(buffer_)};
+    return KernelTls::read(Fd, slice);
+  }
+
+  Api::MockOsSysCalls os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  char buffer_[64];
+};
+
+TEST_F(KernelTlsReadTest, ApplicationData) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  expectRecvmsg("hello", 23);
+  KernelTls::ReadResult result = read();
+  EXPECT_EQ(KernelTls::ReadStatus::Data, result.status_);
+  EXPECT_EQ(5, result.bytes_read_);
+  EXPECT_EQ("hello", std::string(buffer_, 5));
+
+  // Without a record type, the kernel only hands over application data.
+  expectRecvmsg("world", absl::nullopt);
+  result = read();
+  EXPECT_EQ(KernelTls::ReadStatus::Data, result.status_);
+  EXPECT_EQ(5, result.bytes_read_);
+}
+
+TEST_F(KernelTlsReadTest, WouldBlock) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  expectRecvmsgError(EAGAIN);
+  EXPECT_EQ(KernelTls::ReadStatus::WouldBlock, read().status_);
+}
+
+TEST_F(KernelTlsReadTest, CloseNotify) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  expectRecvmsg(std::string("\x01\x00", 2), 21);
+  KernelTls::ReadResult result = read();
+  EXPECT_EQ(KernelTls::ReadStatus::CloseNotify, result.status_);
+  EXPECT_EQ(0, result.bytes_read_);
+
+  // Some peers send close_notify at the fatal level.
+  expectRecvmsg(std::string("\x02\x00", 2), 21);
+  EXPECT_EQ(KernelTls::ReadStatus::CloseNotify, read().status_);
+}
+
+TEST_F(KernelTlsReadTest, FatalAlert) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  // bad_record_mac.
+  expectRecvmsg(std::string("\x02\x14", 2), 21);
+  EXPECT_EQ(KernelTls::ReadStatus::Error, read().status_);
+}
+
+// Renegotiation isn't supported.
+TEST_F(KernelTlsReadTest, HandshakeRecord) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  // hello_request.
+  expectRecvmsg(std::string("\x00\x00\x00\x00", 4), 22);
+  EXPECT_EQ(KernelTls::ReadStatus::Error, read().status_);
+}
+
+TEST_F(KernelTlsReadTest, Reset) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  expectRecvmsgError(ECONNRESET);
+  EXPECT_EQ(KernelTls::ReadStatus::Error, read().status_);
+}
+
+// The kernel fails reads of records which it can't decrypt or authenticate.
+TEST_F(KernelTlsReadTest, BadRecord) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  expectRecvmsgError(EBADMSG);
+  EXPECT_EQ(KernelTls::ReadStatus::Error, read().status_);
+  expectRecvmsgError(EIO);
+  EXPECT_EQ(KernelTls::ReadStatus::Error, read().status_);
+}
+
+// The end of the TCP stream without a close_notify may be a truncation attack.
+TEST_F(KernelTlsReadTest, EndOfStreamWithoutCloseNotify) {
+  if (!KernelTls::compiledIn()) {
+    return;
+  }
+  expectRecvmsg("", absl::nullopt);
+  EXPECT_EQ(KernelTls::ReadStatus::Error, read().status_);
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
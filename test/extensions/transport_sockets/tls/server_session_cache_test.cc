@@ -0,0 +1,225 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "extensions/transport_sockets/tls/server_session_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/strings/str_cat.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class ServerSessionCacheTest : public testing::Test {
+protected:
+  ServerSessionCacheTest() { time_system_.setSystemTime(std::chrono::hours(1000)); }
+
+  SystemTime later() { return time_system_.systemTime() + std::chrono::hours(1); }
+
+  Event::SimulatedTimeSystem time_system_;
+  // A single shard, so that the least recently used session is evicted across all ids.
+  ServerSessionCache cache_{time_system_, 2, 1};
+};
+
+// Contexts with the same session id context share their sessions and ticket keys.
+TEST_F(ServerSessionCacheTest, SharedBySessionIdContext) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  EXPECT_EQ(state, cache_.sessionState("a"));
+  EXPECT_NE(state, cache_.sessionState("b"));
+}
+
+TEST_F(ServerSessionCacheTest, LookupSession) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  EXPECT_FALSE(state->lookupSession("id1").has_value());
+  state->insertSession("id1", "session1", later());
+  EXPECT_EQ("session1", state->lookupSession("id1").value());
+  EXPECT_FALSE(cache_.sessionState("b")->lookupSession("id1").has_value());
+}
+
+TEST_F(ServerSessionCacheTest, ExpiredSessionDropped) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  state->insertSession("id1", "session1", later());
+  time_system_.sleep(std::chrono::hours(1));
+  EXPECT_FALSE(state->lookupSession("id1").has_value());
+}
+
+TEST_F(ServerSessionCacheTest, LeastRecentlyUsedSessionEvicted) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  state->insertSession("id1", "session1", later());
+  state->insertSession("id2", "session2", later());
+  EXPECT_TRUE(state->lookupSession("id1").has_value());
+
+  state->insertSession("id3", "session3", later());
+  EXPECT_TRUE(state->lookupSession("id1").has_value());
+  EXPECT_FALSE(state->lookupSession("id2").has_value());
+  EXPECT_TRUE(state->lookupSession("id3").has_value());
+}
+
+TEST_F(ServerSessionCacheTest, TicketKeysRotated) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  const ServerSessionCache::SessionTicketKeys keys = state->ticketKeys();
+  ASSERT_EQ(1, keys.size());
+  EXPECT_EQ(&state->ticketKeys(), &state->ticketKeys());
+  EXPECT_EQ(keys.front().name_, state->ticketKeys().front().name_);
+
+  time_system_.sleep(ServerSessionCache::TicketKeyRotationInterval);
+  const ServerSessionCache::SessionTicketKeys rotated = state->ticketKeys();
+  ASSERT_EQ(2, rotated.size());
+  EXPECT_NE(keys.front().name_, rotated.front().name_);
+  // The previous key still decrypts older tickets.
+  EXPECT_EQ(keys.front().name_, rotated[1].name_);
+
+  time_system_.sleep(ServerSessionCache::TicketKeyRotationInterval);
+  const ServerSessionCache::SessionTicketKeys& rotated_again = state->ticketKeys();
+  ASSERT_EQ(2, rotated_again.size());
+  EXPECT_EQ(rotated.front().name_, rotated_again[1].name_);
+}
+
+// Keys handed out remain readable while later generations replace them.
+TEST_F(ServerSessionCacheTest, ReplacedTicketKeysRetained) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  const ServerSessionCache::SessionTicketKeys& keys = state->ticketKeys();
+  const auto name = keys.front().name_;
+  for (int i = 0; i < 2; i++) {
+    time_system_.sleep(ServerSessionCache::TicketKeyRotationInterval);
+    EXPECT_NE(&keys, &state->ticketKeys());
+  }
+  EXPECT_EQ(name, keys.front().name_);
+}
+
+// Sessions are spread over shards, each evicting its own least recently used session.
+TEST_F(ServerSessionCacheTest, ShardedSessions) {
+  ServerSessionCache cache(time_system_, 64, 4);
+  ServerSessionCache::SessionStateSharedPtr state = cache.sessionState("a");
+  for (int i = 0; i < 64; i++) {
+    state->insertSession(absl::StrCat("id", i), absl::StrCat("session", i), later());
+  }
+  int cached = 0;
+  for (int i = 0; i < 64; i++) {
+    cached += state->lookupSession(absl::StrCat("id", i)).has_value() ? 1 : 0;
+  }
+  // Ids rarely hash evenly, so the fuller shards evicted some of theirs.
+  EXPECT_LE(cached, 64);
+  EXPECT_GE(cached, 16);
+
+  // A shard never holds more than its share.
+  for (int i = 64; i < 1024; i++) {
+    state->insertSession(absl::StrCat("id", i), absl::StrCat("session", i), later());
+  }
+  cached = 0;
+  for (int i = 0; i < 1024; i++) {
+    cached += state->lookupSession(absl::StrCat("id", i)).has_value() ? 1 : 0;
+  }
+  EXPECT_EQ(64, cached);
+}
+
+// More shards than sessions leaves every shard room for at least one session.
+TEST_F(ServerSessionCacheTest, FewerSessionsThanShards) {
+  ServerSessionCache cache(time_system_, 3, 16);
+  ServerSessionCache::SessionStateSharedPtr state = cache.sessionState("a");
+  for (int i = 0; i < 100; i++) {
+    state->insertSession(absl::StrCat("id", i), absl::StrCat("session", i), later());
+  }
+  int cached = 0;
+  for (int i = 0; i < 100; i++) {
+    cached += state->lookupSession(absl::StrCat("id", i)).has_value() ? 1 : 0;
+  }
+  EXPECT_EQ(3, cached);
+}
+
+// A state no longer used by any context is kept for as long as it can resume sessions.
+TEST_F(ServerSessionCacheTest, UnusedStateDroppedOnceExpired) {
+  std::weak_ptr<ServerSessionCache::SessionState> unused = cache_.sessionState("a");
+  unused.lock()->insertSession("id1", "session1", later());
+  cache_.sessionState("b");
+  EXPECT_FALSE(unused.expired());
+
+  time_system_.sleep(std::chrono::hours(1));
+  cache_.sessionState("b");
+  EXPECT_TRUE(unused.expired());
+}
+
+TEST_F(ServerSessionCacheTest, ExportImport) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  state->insertSession("id1", "session1", later());
+  state->insertSession("id2", "session2", later());
+  const ServerSessionCache::SessionTicketKeys keys = state->ticketKeys();
+
+  ServerSessionCache child(time_system_, 2, 1);
+  ASSERT_TRUE(child.importState(cache_.exportState()));
+  ServerSessionCache::SessionStateSharedPtr imported = child.sessionState("a");
+  EXPECT_EQ("session1", imported->lookupSession("id1").value());
+  EXPECT_EQ("session2", imported->lookupSession("id2").value());
+
+  const ServerSessionCache::SessionTicketKeys& imported_keys = imported->ticketKeys();
+  ASSERT_EQ(1, imported_keys.size());
+  EXPECT_EQ(keys.front().name_, imported_keys.front().name_);
+  EXPECT_EQ(keys.front().hmac_key_, imported_keys.front().hmac_key_);
+  EXPECT_EQ(keys.front().aes_key_, imported_keys.front().aes_key_);
+
+  // The rotation schedule carries over.
+  time_system_.sleep(ServerSessionCache::TicketKeyRotationInterval);
+  EXPECT_EQ(2, imported->ticketKeys().size());
+}
+
+// The recency order survives the handover.
+TEST_F(ServerSessionCacheTest, ExportImportKeepsRecency) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  state->insertSession("id1", "session1", later());
+  state->insertSession("id2", "session2", later());
+  EXPECT_TRUE(state->lookupSession("id1").has_value());
+
+  ServerSessionCache child(time_system_, 2, 1);
+  ASSERT_TRUE(child.importState(cache_.exportState()));
+  ServerSessionCache::SessionStateSharedPtr imported = child.sessionState("a");
+  imported->insertSession("id3", "session3", later());
+  EXPECT_TRUE(imported->lookupSession("id1").has_value());
+  EXPECT_FALSE(imported->lookupSession("id2").has_value());
+}
+
+// State already held by the importing process wins.
+TEST_F(ServerSessionCacheTest, ImportKeepsExistingState) {
+  cache_.sessionState("a")->insertSession("id1", "session1", later());
+
+  ServerSessionCache child(time_system_, 2, 1);
+  ServerSessionCache::SessionStateSharedPtr existing = child.sessionState("a");
+  ASSERT_TRUE(child.importState(cache_.exportState()));
+  EXPECT_EQ(existing, child.sessionState("a"));
+  EXPECT_FALSE(existing->lookupSession("id1").has_value());
+}
+
+// The export is capped, keeping the most recently used sessions and the ticket keys.
+TEST_F(ServerSessionCacheTest, ExportCapped) {
+  ServerSessionCache::SessionStateSharedPtr state = cache_.sessionState("a");
+  state->insertSession("id1", std::string(100, 'a'), later());
+  state->insertSession("id2", std::string(100, 'b'), later());
+  const ServerSessionCache::SessionTicketKeys keys = state->ticketKeys();
+
+  ServerSessionCache child(time_system_, 2, 1);
+  ASSERT_TRUE(child.importState(cache_.exportState(150)));
+  ServerSessionCache::SessionStateSharedPtr imported = child.sessionState("a");
+  EXPECT_FALSE(imported->lookupSession("id1").has_value());
+  EXPECT_TRUE(imported->lookupSession("id2").has_value());
+  EXPECT_EQ(keys.front().name_, imported->ticketKeys().front().name_);
+
+  ServerSessionCache empty_child(time_system_, 2, 1);
+  ASSERT_TRUE(empty_child.importState(cache_.exportState(0)));
+  EXPECT_FALSE(empty_child.sessionState("a")->lookupSession("id2").has_value());
+  EXPECT_EQ(keys.front().name_, empty_child.sessionState("a")->ticketKeys().front().name_);
+}
+
+TEST_F(ServerSessionCacheTest, ImportInvalidState) {
+  EXPECT_FALSE(cache_.importState("not a proto"));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,304 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the cost of full and resumed SslSocket handshakes and of bulk encryption. The client
+// and server connections are joined by a socketpair and driven by a real dispatcher, so that the
+// numbers include the transport socket and connection overheads seen in production.
+
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/api/v2/auth/cert.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/event/libevent.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/transport_sockets/tls/context_config_impl.h"
+#include "extensions/transport_sockets/tls/context_manager_impl.h"
+#include "extensions/transport_sockets/tls/ssl_socket.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/bn.h"
+#include "openssl/ec_key.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+enum class KeyType { Rsa, Ecdsa };
+
+std::string bioContents(BIO* bio) {
+  const uint8_t* data;
+  size_t len;
+  RELEASE_ASSERT(BIO_mem_contents(bio, &data, &len), "");
+  return std::string(reinterpret_cast<const char*>(data), len);
+}
+
+// A freshly generated key and a self-signed certificate for it, so that the benchmark doesn't
+// depend on runfiles.
+struct TestCredentials {
+  explicit TestCredentials(KeyType key_type) {
+    bssl::UniquePtr<EVP_PKEY> key(EVP_PKEY_new());
+    if (key_type == KeyType::Rsa) {
+      bssl::UniquePtr<RSA> rsa(RSA_new());
+      bssl::UniquePtr<BIGNUM> exponent(BN_new());
+      RELEASE_ASSERT(BN_set_word(exponent.get(), RSA_F4), "");
+      RELEASE_ASSERT(RSA_generate_key_ex(rsa.get(), 2048, exponent.get(), nullptr), "");
+      RELEASE_ASSERT(EVP_PKEY_assign_RSA(key.get(), rsa.release()), "");
+    } else {
+      bssl::UniquePtr<EC_KEY> ec_key(EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+      RELEASE_ASSERT(ec_key != nullptr && EC_KEY_generate_key(ec_key.get()), "");
+      RELEASE_ASSERT(EVP_PKEY_assign_EC_KEY(key.get(), ec_key.release()), "");
+    }
+
+    bssl::UniquePtr<X509> cert(X509_new());
+    X509_set_version(cert.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 24 * 3600);
+    X509_set_pubkey(cert.get(), key.get());
+    X509_NAME* name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const uint8_t*>("benchmark"), -1, -1, 0);
+    X509_set_issuer_name(cert.get(), name);
+    RELEASE_ASSERT(X509_sign(cert.get(), key.get(), EVP_sha256()), "");
+
+    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+    RELEASE_ASSERT(PEM_write_bio_X509(bio.get(), cert.get()), "");
+    cert_pem_ = bioContents(bio.get());
+    bio.reset(BIO_new(BIO_s_mem()));
+    RELEASE_ASSERT(
+        PEM_write_bio_PrivateKey(bio.get(), key.get(), nullptr, nullptr, 0, nullptr, nullptr), "");
+    key_pem_ = bioContents(bio.get());
+  }
+
+  std::string cert_pem_;
+  std::string key_pem_;
+};
+
+const TestCredentials& credentials(KeyType key_type) {
+  static const TestCredentials* rsa = new TestCredentials(KeyType::Rsa);
+  static const TestCredentials* ecdsa = new TestCredentials(KeyType::Ecdsa);
+  return key_type == KeyType::Rsa ? *rsa : *ecdsa;
+}
+
+// Counts the application data received by the server, and stops the dispatcher once the expected
+// amount has arrived.
+class CountingReadFilter : public Network::ReadFilter {
+public:
+  explicit CountingReadFilter(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  void expect(uint64_t bytes) { expected_ += bytes; }
+
+  // Network::ReadFilter
+  Network::FilterStatus onData(Buffer::Instance& data, bool) override {
+    received_ += data.length();
+    data.drain(data.length());
+    if (received_ >= expected_) {
+      dispatcher_.exit();
+    }
+    return Network::FilterStatus::StopIteration;
+  }
+  Network::FilterStatus onNewConnection() override { return Network::FilterStatus::Continue; }
+  void initializeReadFilterCallbacks(Network::ReadFilterCallbacks&) override {}
+
+private:
+  Event::Dispatcher& dispatcher_;
+  uint64_t expected_{};
+  uint64_t received_{};
+};
+
+// Client and server SslSocket factories for one key type and protocol version, and the
+// connections made with them.
+class SslSocketPair : public Network::ConnectionCallbacks {
+public:
+  SslSocketPair(KeyType key_type, bool tls13, bool resume)
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
+        manager_(api_->timeSource()) {
+    ON_CALL(factory_context_, api()).WillByDefault(testing::ReturnRef(*api_));
+    const auto version = tls13 ? envoy::api::v2::auth::TlsParameters::TLSv1_3
+                               : envoy::api::v2::auth::TlsParameters::TLSv1_2;
+
+    envoy::api::v2::auth::DownstreamTlsContext server_tls_context;
+    auto* server_common_tls_context = server_tls_context.mutable_common_tls_context();
+    auto* tls_certificate = server_common_tls_context->add_tls_certificates();
+    tls_certificate->mutable_certificate_chain()->set_inline_string(
+        credentials(key_type).cert_pem_);
+    tls_certificate->mutable_private_key()->set_inline_string(credentials(key_type).key_pem_);
+    server_common_tls_context->mutable_tls_params()->set_tls_minimum_protocol_version(version);
+    server_common_tls_context->mutable_tls_params()->set_tls_maximum_protocol_version(version);
+    server_factory_ = std::make_unique<ServerSslSocketFactory>(
+        std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_), manager_,
+        server_stats_store_, std::vector<std::string>{});
+
+    envoy::api::v2::auth::UpstreamTlsContext client_tls_context;
+    auto* client_common_tls_context = client_tls_context.mutable_common_tls_context();
+    client_common_tls_context->mutable_tls_params()->set_tls_minimum_protocol_version(version);
+    client_common_tls_context->mutable_tls_params()->set_tls_maximum_protocol_version(version);
+    // The client resumes whenever it has a session, so don't keep any for full handshakes.
+    client_tls_context.mutable_max_session_keys()->set_value(resume ? 1 : 0);
+    client_factory_ = std::make_unique<ClientSslSocketFactory>(
+        std::make_unique<ClientContextConfigImpl>(client_tls_context, factory_context_), manager_,
+        client_stats_store_);
+  }
+
+  ~SslSocketPair() override { disconnect(); }
+
+  // Connects a new client and server over a socketpair and runs the dispatcher until both sides
+  // have completed the handshake.
+  void connect() {
+    int fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    // Both ends are already connected; the transport sockets decide which side is the client.
+    client_ = dispatcher_->createServerConnection(connectionSocket(fds[0]),
+                                                  client_factory_->createTransportSocket(nullptr));
+    server_ = dispatcher_->createServerConnection(connectionSocket(fds[1]),
+                                                  server_factory_->createTransportSocket(nullptr));
+    client_->addConnectionCallbacks(*this);
+    server_->addConnectionCallbacks(*this);
+    connected_ = 0;
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    RELEASE_ASSERT(connected_ == 2, "");
+    // Let the client read what the server sent after its handshake, e.g. TLS 1.3 session tickets.
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  void disconnect() {
+    if (client_ != nullptr) {
+      client_->close(Network::ConnectionCloseType::NoFlush);
+      server_->close(Network::ConnectionCloseType::NoFlush);
+      client_.reset();
+      server_.reset();
+    }
+  }
+
+  uint64_t serverSessionsReused() {
+    return server_stats_store_.counter("ssl.session_reused").value();
+  }
+
+  Event::Dispatcher& dispatcher() { return *dispatcher_; }
+  Network::Connection& client() { return *client_; }
+  Network::Connection& server() { return *server_; }
+
+  // Network::ConnectionCallbacks
+  void onEvent(Network::ConnectionEvent event) override {
+    if (event == Network::ConnectionEvent::Connected && ++connected_ == 2) {
+      dispatcher_->exit();
+    }
+  }
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+private:
+  static Network::ConnectionSocketPtr connectionSocket(int fd) {
+    return std::make_unique<Network::ConnectionSocketImpl>(
+        std::make_unique<Network::IoSocketHandleImpl>(fd), nullptr, nullptr);
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  ContextManagerImpl manager_;
+  Stats::IsolatedStoreImpl server_stats_store_;
+  Stats::IsolatedStoreImpl client_stats_store_;
+  Network::TransportSocketFactoryPtr server_factory_;
+  Network::TransportSocketFactoryPtr client_factory_;
+  Network::ConnectionPtr client_;
+  Network::ConnectionPtr server_;
+  uint32_t connected_{};
+};
+
+// Args: ECDSA (instead of RSA) certificate, TLS 1.3 (instead of 1.2), resumed handshake.
+void BM_Handshake(benchmark::State& state) {
+  const bool resume = state.range(2);
+  SslSocketPair pair(state.range(0) ? KeyType::Ecdsa : KeyType::Rsa, state.range(1), resume);
+  if (resume) {
+    // Get the client a session to resume.
+    pair.connect();
+    pair.disconnect();
+  }
+  const uint64_t reused_before = pair.serverSessionsReused();
+
+  for (auto _ : state) {
+    pair.connect();
+    pair.disconnect();
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  const uint64_t expected_reused = resume ? state.iterations() : 0;
+  RELEASE_ASSERT(pair.serverSessionsReused() - reused_before == expected_reused, "");
+}
+BENCHMARK(BM_Handshake)
+    ->ArgNames({"ecdsa", "tls13", "resumed"})
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      for (int ecdsa = 0; ecdsa <= 1; ecdsa++) {
+        for (int tls13 = 0; tls13 <= 1; tls13++) {
+          for (int resumed = 0; resumed <= 1; resumed++) {
+            benchmark->Args({ecdsa, tls13, resumed});
+          }
+        }
+      }
+    })
+    ->Unit(benchmark::kMicrosecond);
+
+// Args: TLS 1.3 (instead of 1.2), bytes written by the client in each iteration.
+void BM_Throughput(benchmark::State& state) {
+  SslSocketPair pair(KeyType::Ecdsa, state.range(0), false);
+  pair.connect();
+  auto filter = std::make_shared<CountingReadFilter>(pair.dispatcher());
+  pair.server().addReadFilter(filter);
+  pair.server().initializeReadFilters();
+  const std::string data(state.range(1), 'a');
+
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffer(data);
+    filter->expect(data.size());
+    pair.client().write(buffer, false);
+    pair.dispatcher().run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Throughput)
+    ->ArgNames({"tls13", "bytes"})
+    ->Args({0, 16 * 1024})
+    ->Args({0, 1024 * 1024})
+    ->Args({1, 16 * 1024})
+    ->Args({1, 1024 * 1024})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  Envoy::Event::Libevent::Global::initialize();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
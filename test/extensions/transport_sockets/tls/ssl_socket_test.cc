@@ -45,6 +45,7 @@ using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Property;
 using testing::Return;
 using testing::ReturnRef;
 using testing::StrictMock;
@@ -718,6 +719,9 @@ protected:
   void testClientSessionResumption(const std::string& server_ctx_yaml,
                                    const std::string& client_ctx_yaml, bool expect_reuse,
                                    const Network::Address::IpVersion version);
+  void testVerificationCache(const std::string& server_ctx_yaml,
+                             const std::string& client_ctx_yaml, bool expect_success,
+                             const std::string& failure_stat);
 
   Event::DispatcherPtr dispatcher_;
 };
@@ -959,6 +963,121 @@ TEST_P(SslSocketTest, MultiCertPreferEcdsa) {
   testUtil(test_options);
 }
 
+// The thread pool private key method provider signs the handshake off the event loop.
+TEST_P(SslSocketTest, PrivateKeyProviderAsyncRsaSign) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+          threads: 1
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options);
+}
+
+// RSA key exchange needs the provider's decrypt operation rather than sign.
+TEST_P(SslSocketTest, PrivateKeyProviderAsyncRsaDecrypt) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_2
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - AES128-SHA
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options);
+}
+
+// With several certificates using the provider, the key matching the selected certificate is
+// used.
+TEST_P(SslSocketTest, PrivateKeyProviderAsyncMultiCert) {
+  const std::string client_ctx_yaml = absl::StrCat(R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_minimum_protocol_version: TLSv1_2
+        tls_maximum_protocol_version: TLSv1_2
+        cipher_suites:
+        - ECDHE-ECDSA-AES128-GCM-SHA256
+        - ECDHE-RSA-AES128-GCM-SHA256
+      validation_context:
+        verify_certificate_hash: )EOF",
+                                                   TEST_SELFSIGNED_ECDSA_P256_CERT_HASH);
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_key.pem"
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options);
+}
+
+// A provider key that doesn't match the certificate produces a signature the client rejects.
+TEST_P(SslSocketTest, PrivateKeyProviderAsyncMismatchedKey) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, false, GetParam());
+  testUtil(test_options.setExpectedServerStats("ssl.connection_error"));
+}
+
 TEST_P(SslSocketTest, GetUriWithLocalUriSan) {
   const std::string client_ctx_yaml = R"EOF(
   common_tls_context:
@@ -2462,6 +2581,26 @@ TEST_P(SslSocketTest, TicketSessionResumption) {
                               GetParam());
 }
 
+// Without configured ticket keys, tickets issued through a context are accepted by contexts built
+// later from the same configuration, e.g. after an SDS update.
+TEST_P(SslSocketTest, TicketSessionResumptionAcrossContextRebuild) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              GetParam());
+}
+
 TEST_P(SslSocketTest, TicketSessionResumptionWithClientCA) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -2491,6 +2630,49 @@ TEST_P(SslSocketTest, TicketSessionResumptionWithClientCA) {
                               GetParam());
 }
 
+// Sessions established before a CRL update, such as one delivered by SDS, are not resumed after it,
+// even though the rebuilt context keeps the same certificates and generated ticket keys.
+TEST_P(SslSocketTest, TicketSessionResumptionCrlUpdate) {
+  const std::string server_ctx_yaml1 = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+)EOF";
+
+  const std::string server_ctx_yaml2 = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+      crl:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.crl"
+)EOF";
+
+  // The client certificate isn't revoked, so the full handshake after the update succeeds.
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_key.pem"
+)EOF";
+
+  testTicketSessionResumption(server_ctx_yaml1, {}, server_ctx_yaml2, {}, client_ctx_yaml, false,
+                              GetParam());
+}
+
 TEST_P(SslSocketTest, TicketSessionResumptionRotateKey) {
   const std::string server_ctx_yaml1 = R"EOF(
   common_tls_context:
@@ -3108,6 +3290,135 @@ TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls13) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// Performs two full handshakes against the same server context, whose validation context caches
+// verifications, and checks that only a successful verification is remembered.
+void SslSocketTest::testVerificationCache(const std::string& server_ctx_yaml,
+                                          const std::string& client_ctx_yaml, bool expect_success,
+                                          const std::string& failure_stat) {
+  ContextManagerImpl manager(time_system_);
+  Stats::IsolatedStoreImpl server_stats_store;
+  envoy::api::v2::auth::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+  ServerSslSocketFactory server_ssl_socket_factory(std::move(server_cfg), manager,
+                                                   server_stats_store, std::vector<std::string>{});
+
+  Stats::IsolatedStoreImpl client_stats_store;
+  envoy::api::v2::auth::UpstreamTlsContext client_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), client_tls_context);
+  auto client_cfg = std::make_unique<ClientContextConfigImpl>(client_tls_context, factory_context_);
+  ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                   client_stats_store);
+
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr,
+                                  true);
+  Network::MockListenerCallbacks callbacks;
+  Network::ListenerPtr listener = dispatcher_->createListener(socket, callbacks, true, false);
+
+  for (uint64_t attempt = 1; attempt <= 2; ++attempt) {
+    Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+        socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
+        client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+    NiceMock<Network::MockConnectionCallbacks> client_connection_callbacks;
+    client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+    Network::ConnectionPtr server_connection;
+    NiceMock<Network::MockConnectionCallbacks> server_connection_callbacks;
+    EXPECT_CALL(callbacks, onAccept_(_, _))
+        .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+          Network::ConnectionPtr new_connection = dispatcher_->createServerConnection(
+              std::move(socket), server_ssl_socket_factory.createTransportSocket(nullptr));
+          callbacks.onNewConnection(std::move(new_connection));
+        }));
+    EXPECT_CALL(callbacks, onNewConnection_(_))
+        .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+          server_connection = std::move(conn);
+          server_connection->addConnectionCallbacks(server_connection_callbacks);
+        }));
+
+    // With TLS 1.2 the client is only connected once the server has verified its certificate.
+    if (expect_success) {
+      EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+          .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+            client_connection->close(Network::ConnectionCloseType::NoFlush);
+            dispatcher_->exit();
+          }));
+    } else {
+      EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+          .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+    }
+
+    client_connection->connect();
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    if (server_connection != nullptr) {
+      server_connection->close(Network::ConnectionCloseType::NoFlush);
+    }
+
+    // Only the first handshake of a successful chain misses the cache.
+    EXPECT_EQ(expect_success ? attempt - 1 : 0,
+              server_stats_store.counter("ssl.verify_cache_hit").value());
+    EXPECT_EQ(expect_success ? 1 : attempt,
+              server_stats_store.counter("ssl.verify_cache_miss").value());
+    EXPECT_EQ(expect_success ? attempt : 0, server_stats_store.counter("ssl.handshake").value());
+    if (!expect_success) {
+      EXPECT_EQ(attempt, server_stats_store.counter(failure_stat).value());
+    }
+  }
+}
+
+const std::string VerificationCacheClientCtxYaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_2
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 0
+)EOF";
+
+const std::string VerificationCacheServerCtxYaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+      verification_cache_size: 16
+)EOF";
+
+TEST_P(SslSocketTest, VerificationCacheHit) {
+  testVerificationCache(VerificationCacheServerCtxYaml, VerificationCacheClientCtxYaml, true, "");
+}
+
+TEST_P(SslSocketTest, VerificationCacheChainFailureNotCached) {
+  const std::string client_ctx_yaml = absl::StrReplaceAll(
+      VerificationCacheClientCtxYaml,
+      {{"no_san_cert.pem", "selfsigned_cert.pem"}, {"no_san_key.pem", "selfsigned_key.pem"}});
+  testVerificationCache(VerificationCacheServerCtxYaml, client_ctx_yaml, false,
+                        "ssl.fail_verify_error");
+}
+
+TEST_P(SslSocketTest, VerificationCacheSanFailureNotCached) {
+  const std::string server_ctx_yaml =
+      absl::StrCat(VerificationCacheServerCtxYaml, "      verify_subject_alt_name: example.com\n");
+  testVerificationCache(server_ctx_yaml, VerificationCacheClientCtxYaml, false,
+                        "ssl.fail_verify_san");
+}
+
+TEST_P(SslSocketTest, VerificationCachePinningFailureNotCached) {
+  const std::string server_ctx_yaml =
+      absl::StrCat(VerificationCacheServerCtxYaml, "      verify_certificate_hash: \"",
+                   TEST_SAN_URI_CERT_HASH, "\"\n");
+  testVerificationCache(server_ctx_yaml, VerificationCacheClientCtxYaml, false,
+                        "ssl.fail_verify_cert_hash");
+}
+
 TEST_P(SslSocketTest, SslError) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3933,13 +4244,13 @@ protected:
     dispatcher_->run(Event::Dispatcher::RunType::Block);
   }
 
-  Stats::IsolatedStoreImpl server_stats_store_;
-  Stats::IsolatedStoreImpl client_stats_store_;
+  NiceMock<Stats::MockIsolatedStatsStore> server_stats_store_;
+  NiceMock<Stats::MockIsolatedStatsStore> client_stats_store_;
   Network::TcpListenSocket socket_{Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr,
                                    true};
   Network::MockListenerCallbacks listener_callbacks_;
   Network::MockConnectionHandler connection_handler_;
-  const std::string server_ctx_yaml_ = R"EOF(
+  std::string server_ctx_yaml_ = R"EOF(
   common_tls_context:
     tls_certificates:
       certificate_chain:
@@ -3951,7 +4262,7 @@ protected:
         filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
 )EOF";
 
-  const std::string client_ctx_yaml_ = R"EOF(
+  std::string client_ctx_yaml_ = R"EOF(
   common_tls_context:
     tls_certificates:
       certificate_chain:
@@ -3994,6 +4305,225 @@ TEST_P(SslReadBufferLimitTest, SomeLimit) {
   readBufferLimitTest(32 * 1024, 32 * 1024, 256 * 1024, 1, false);
 }
 
+// New connections write small records until small_record_bytes have been written.
+TEST_P(SslReadBufferLimitTest, DynamicRecordSizing) {
+  client_ctx_yaml_ += R"EOF(
+    dynamic_record_sizing:
+      initial_record_size: 1000
+      small_record_bytes: 4000
+)EOF";
+  std::vector<uint64_t> record_sizes;
+  EXPECT_CALL(client_stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "ssl.write_record_size"), _))
+      .WillRepeatedly(Invoke([&](const Stats::Histogram&, uint64_t value) -> void {
+        record_sizes.push_back(value);
+      }));
+
+  readBufferLimitTest(0, 256 * 1024, 10 * 1024, 1, false);
+  EXPECT_EQ((std::vector<uint64_t>{1000, 1000, 1000, 1000, 6240}), record_sizes);
+}
+
+// Once small_record_bytes have been written, data spread over many small slices is coalesced into
+// full size records.
+TEST_P(SslReadBufferLimitTest, SmallSlicesCoalescedIntoFullRecords) {
+  client_ctx_yaml_ += R"EOF(
+    dynamic_record_sizing:
+      small_record_bytes: 0
+)EOF";
+  std::vector<uint64_t> record_sizes;
+  EXPECT_CALL(client_stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "ssl.write_record_size"), _))
+      .WillRepeatedly(Invoke([&](const Stats::Histogram&, uint64_t value) -> void {
+        record_sizes.push_back(value);
+      }));
+
+  // All of the writes are queued before the connection gets to write them.
+  readBufferLimitTest(0, 256 * 1024, 1024, 64, false);
+  EXPECT_EQ((std::vector<uint64_t>{16384, 16384, 16384, 16384}), record_sizes);
+}
+
+// Without dynamic record sizing, the record sizes are not recorded.
+TEST_P(SslReadBufferLimitTest, RecordSizesNotRecordedWithoutDynamicRecordSizing) {
+  EXPECT_CALL(client_stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "ssl.write_record_size"), _))
+      .Times(0);
+
+  readBufferLimitTest(0, 256 * 1024, 1024, 64, false);
+}
+
+// A connection which has been idle for idle_timeout goes back to small records.
+TEST_P(SslReadBufferLimitTest, DynamicRecordSizingAfterIdle) {
+  client_ctx_yaml_ += R"EOF(
+    dynamic_record_sizing:
+      initial_record_size: 1000
+      small_record_bytes: 2000
+      idle_timeout: 10s
+)EOF";
+  std::vector<uint64_t> record_sizes;
+  EXPECT_CALL(client_stats_store_,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "ssl.write_record_size"), _))
+      .WillRepeatedly(Invoke([&](const Stats::Histogram&, uint64_t value) -> void {
+        record_sizes.push_back(value);
+      }));
+
+  initialize();
+  EXPECT_CALL(listener_callbacks_, onAccept_(_, _))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+        Network::ConnectionPtr new_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory_->createTransportSocket(nullptr));
+        listener_callbacks_.onNewConnection(std::move(new_connection));
+      }));
+  EXPECT_CALL(listener_callbacks_, onNewConnection_(_))
+      .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        server_connection_ = std::move(conn);
+        server_connection_->addConnectionCallbacks(server_callbacks_);
+        server_connection_->addReadFilter(read_filter_);
+      }));
+  EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  uint64_t bytes_expected = 0;
+  uint64_t bytes_seen = 0;
+  EXPECT_CALL(*read_filter_, onNewConnection());
+  EXPECT_CALL(*read_filter_, onData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) -> Network::FilterStatus {
+        bytes_seen += data.length();
+        data.drain(data.length());
+        if (bytes_seen == bytes_expected) {
+          dispatcher_->exit();
+        }
+        return Network::FilterStatus::StopIteration;
+      }));
+  // Writes the given amount of data and returns the sizes of the records it was written in.
+  const auto write = [&](uint64_t size) -> std::vector<uint64_t> {
+    record_sizes.clear();
+    bytes_expected += size;
+    Buffer::OwnedImpl data(std::string(size, 'a'));
+    client_connection_->write(data, false);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    return record_sizes;
+  };
+
+  EXPECT_EQ((std::vector<uint64_t>{1000, 1000, 1000}), write(3000));
+  // Within the idle timeout, the connection keeps writing full size records.
+  time_system_.sleep(std::chrono::seconds(9));
+  EXPECT_EQ((std::vector<uint64_t>{3000}), write(3000));
+  time_system_.sleep(std::chrono::seconds(10));
+  EXPECT_EQ((std::vector<uint64_t>{1000, 1000, 1000}), write(3000));
+
+  disconnect();
+}
+
+// Every server handshake records the duration of each of its phases once.
+TEST_P(SslReadBufferLimitTest, HandshakePhaseHistograms) {
+  for (const char* name : {"ssl.handshake_certificate_selection_us", "ssl.handshake_signing_us",
+                           "ssl.handshake_finished_us"}) {
+    EXPECT_CALL(server_stats_store_,
+                deliverHistogramToSinks(Property(&Stats::Metric::name, name), _));
+  }
+  singleWriteTest(0, 1024);
+}
+
+// A server handshake whose signature fails records no signing or finished time.
+TEST_P(SslReadBufferLimitTest, HandshakePhaseHistogramsSigningFailure) {
+  // The provider can't sign for the RSA certificate with an ECDSA key.
+  server_ctx_yaml_ = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_key.pem"
+)EOF";
+  EXPECT_CALL(server_stats_store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "ssl.handshake_certificate_selection_us"), _));
+  for (const char* name : {"ssl.handshake_signing_us", "ssl.handshake_finished_us"}) {
+    EXPECT_CALL(server_stats_store_,
+                deliverHistogramToSinks(Property(&Stats::Metric::name, name), _))
+        .Times(0);
+  }
+
+  initialize();
+  EXPECT_CALL(listener_callbacks_, onAccept_(_, _))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+        Network::ConnectionPtr new_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory_->createTransportSocket(nullptr));
+        listener_callbacks_.onNewConnection(std::move(new_connection));
+      }));
+  EXPECT_CALL(listener_callbacks_, onNewConnection_(_))
+      .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        server_connection_ = std::move(conn);
+        server_connection_->addConnectionCallbacks(server_callbacks_);
+      }));
+  // Depending on the alert sent by the server, the client closes the connection or sees it closed.
+  EXPECT_CALL(client_callbacks_, onEvent(_))
+      .WillOnce(Invoke([&](Network::ConnectionEvent event) -> void {
+        EXPECT_NE(Network::ConnectionEvent::Connected, event);
+        dispatcher_->exit();
+      }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+}
+
+// A client signing with the thread pool provider resumes its handshake once the signature has
+// completed, and then sends the data written before the handshake finished.
+TEST_P(SslReadBufferLimitTest, PrivateKeyProviderAsyncClientCertificate) {
+  client_ctx_yaml_ = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key_provider:
+        provider_name: envoy.private_key_providers.thread_pool
+        typed_config:
+          "@type": type.googleapis.com/envoy.config.private_key_provider.thread_pool.v2alpha.ThreadPoolPrivateKeyProvider
+          private_key:
+            filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+          threads: 1
+)EOF";
+
+  initialize();
+  EXPECT_CALL(listener_callbacks_, onAccept_(_, _))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+        Network::ConnectionPtr new_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory_->createTransportSocket(nullptr));
+        listener_callbacks_.onNewConnection(std::move(new_connection));
+      }));
+  EXPECT_CALL(listener_callbacks_, onNewConnection_(_))
+      .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        server_connection_ = std::move(conn);
+        server_connection_->addConnectionCallbacks(server_callbacks_);
+        server_connection_->addReadFilter(read_filter_);
+      }));
+  EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::Connected));
+
+  const std::string data_to_write(1024, 'a');
+  std::string data_read;
+  EXPECT_CALL(*read_filter_, onNewConnection());
+  EXPECT_CALL(*read_filter_, onData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) -> Network::FilterStatus {
+        data_read += data.toString();
+        data.drain(data.length());
+        if (data_read.size() == data_to_write.size()) {
+          dispatcher_->exit();
+        }
+        return Network::FilterStatus::StopIteration;
+      }));
+
+  // The data is buffered by the client connection until its handshake completes.
+  Buffer::OwnedImpl buffer_to_write(data_to_write);
+  client_connection_->write(buffer_to_write, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(data_to_write, data_read);
+
+  disconnect();
+}
+
 TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5 * 1024, 1024); }
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
@@ -0,0 +1,104 @@
+#include "common/http/codec_client.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/integration/http_protocol_integration.h"
+#include "test/integration/utility.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/network_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+class ConnectionMemoryIntegrationTest : public HttpProtocolIntegrationTest {
+protected:
+  void initializeWithLimit(uint32_t read_disable_bytes, uint32_t close_bytes) {
+    config_helper_.addConfigModifier(
+        [read_disable_bytes, close_bytes](envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+          auto* limit = bootstrap.mutable_static_resources()
+                            ->mutable_listeners(0)
+                            ->mutable_connection_memory_limit();
+          if (read_disable_bytes > 0) {
+            limit->mutable_read_disable_bytes()->set_value(read_disable_bytes);
+          }
+          if (close_bytes > 0) {
+            limit->mutable_close_bytes()->set_value(close_bytes);
+          }
+        });
+    initialize();
+  }
+
+  // A client with the smallest HTTP/2 windows, so that Envoy has to read the client's window
+  // updates to send a large response.
+  IntegrationCodecClientPtr makeSmallWindowHttpConnection() {
+    auto cluster = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+    cluster->http2_settings_.initial_stream_window_size_ =
+        Http::Http2Settings::MIN_INITIAL_STREAM_WINDOW_SIZE;
+    cluster->http2_settings_.initial_connection_window_size_ =
+        Http::Http2Settings::MIN_INITIAL_CONNECTION_WINDOW_SIZE;
+    Upstream::HostDescriptionConstSharedPtr host_description{Upstream::makeTestHostDescription(
+        cluster, fmt::format("tcp://{}:80", Network::Test::getLoopbackAddressUrlString(version_)))};
+    auto codec = std::make_unique<IntegrationCodecClient>(
+        *dispatcher_, makeClientConnection(lookupPort("http")), host_description,
+        downstream_protocol_);
+    EXPECT_TRUE(codec->connected());
+    return codec;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(Protocols, ConnectionMemoryIntegrationTest,
+                         testing::ValuesIn(HttpProtocolIntegrationTest::getProtocolTestParams()),
+                         HttpProtocolIntegrationTest::protocolTestParamsToString);
+
+// Requests and responses far larger than the read disable limit complete, even when sending the
+// response depends on reading the client's window updates.
+TEST_P(ConnectionMemoryIntegrationTest, LargeRequestAndResponseBelowReadDisable) {
+  initializeWithLimit(1024, 0);
+  codec_client_ = makeSmallWindowHttpConnection();
+  auto response = sendRequestAndWaitForResponse(default_request_headers_, 256 * 1024,
+                                                default_response_headers_, 1024 * 1024);
+  checkSimpleRequestSuccess(256 * 1024, 1024 * 1024, response.get());
+
+  // Only the bytes received on HTTP/2 streams disable reads, each time a DATA frame larger than
+  // the limit is received.
+  if (downstreamProtocol() == Http::CodecClient::Type::HTTP2) {
+    test_server_->waitForCounterGe(listenerStatPrefix("downstream_cx_memory_read_disable"), 1);
+  } else {
+    EXPECT_EQ(0, test_server_->counter(listenerStatPrefix("downstream_cx_memory_read_disable"))
+                     ->value());
+  }
+  EXPECT_EQ(0, test_server_->counter(listenerStatPrefix("downstream_cx_memory_close"))->value());
+}
+
+TEST_P(ConnectionMemoryIntegrationTest, CloseAboveLimit) {
+  initializeWithLimit(0, 1024);
+  fake_upstreams_[0]->set_allow_unexpected_disconnects(true);
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+  auto response = codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+  waitForNextUpstreamRequest();
+  upstream_request_->encodeHeaders(default_response_headers_, false);
+  upstream_request_->encodeData(1024 * 1024, true);
+
+  codec_client_->waitForDisconnect();
+  EXPECT_FALSE(response->complete());
+  test_server_->waitForCounterGe(listenerStatPrefix("downstream_cx_memory_close"), 1);
+}
+
+TEST_P(ConnectionMemoryIntegrationTest, AdminListsConnections) {
+  initializeWithLimit(0, 1024 * 1024);
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+  auto response = sendRequestAndWaitForResponse(default_request_headers_, 0,
+                                                default_response_headers_, 0);
+  EXPECT_TRUE(response->complete());
+
+  BufferingStreamDecoderPtr admin_response = IntegrationUtil::makeSingleRequest(
+      lookupPort("admin"), "GET", "/memory/connections?limit=5", "", downstreamProtocol(),
+      version_);
+  EXPECT_TRUE(admin_response->complete());
+  EXPECT_EQ("200", admin_response->headers().Status()->value().getStringView());
+  EXPECT_THAT(admin_response->body(), testing::HasSubstr("remote_address"));
+}
+
+} // namespace
+} // namespace Envoy
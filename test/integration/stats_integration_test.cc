@@ -145,18 +145,19 @@ public:
   ClusterMemoryTestHelper()
       : BaseIntegrationTest(testing::TestWithParam<Network::Address::IpVersion>::GetParam()) {}
 
-  static size_t computeMemory(int num_clusters) {
+  static size_t computeMemory(int num_clusters, bool lazy_stats = false) {
     ClusterMemoryTestHelper helper;
-    return helper.clusterMemoryHelper(num_clusters, true);
+    return helper.clusterMemoryHelper(num_clusters, true, lazy_stats);
   }
 
 private:
   /**
    * @param num_clusters number of clusters appended to bootstrap_config
    * @param allow_stats if false, enable set_reject_all in stats_config
+   * @param lazy_stats if true, enable lazy_stats on every cluster
    * @return size_t the total memory allocated
    */
-  size_t clusterMemoryHelper(int num_clusters, bool allow_stats) {
+  size_t clusterMemoryHelper(int num_clusters, bool allow_stats, bool lazy_stats) {
     Stats::TestUtil::MemoryTest memory_test;
     config_helper_.addConfigModifier([&](envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
       if (!allow_stats) {
@@ -166,6 +167,9 @@ private:
         auto* c = bootstrap.mutable_static_resources()->add_clusters();
         c->set_name(fmt::format("cluster_{}", i));
       }
+      for (auto& cluster : *bootstrap.mutable_static_resources()->mutable_clusters()) {
+        cluster.set_lazy_stats(lazy_stats);
+      }
     });
     initialize();
 
@@ -212,5 +216,22 @@ TEST_P(ClusterMemoryTestRunner, MemoryLargeClusterSizeWithStats) {
   EXPECT_MEMORY_LE(m_per_cluster, 49700);
 }
 
+TEST_P(ClusterMemoryTestRunner, MemoryLargeClusterSizeWithLazyStats) {
+  const size_t m1 = ClusterMemoryTestHelper::computeMemory(1, true);
+  const size_t m1001 = ClusterMemoryTestHelper::computeMemory(1001, true);
+  const size_t m_per_cluster = (m1001 - m1) / 1000;
+
+  const size_t eager_m1 = ClusterMemoryTestHelper::computeMemory(1);
+  const size_t eager_m1001 = ClusterMemoryTestHelper::computeMemory(1001);
+  const size_t eager_m_per_cluster = (eager_m1001 - eager_m1) / 1000;
+  ENVOY_LOG_MISC(info, "Bytes per cluster: {} with lazy stats, {} without", m_per_cluster,
+                 eager_m_per_cluster);
+
+  // None of these clusters see any traffic, so almost none of their stats should be created.
+  if (Stats::TestUtil::MemoryTest::mode() != Stats::TestUtil::MemoryTest::Mode::Disabled) {
+    EXPECT_LT(m_per_cluster, eager_m_per_cluster / 2);
+  }
+}
+
 } // namespace
 } // namespace Envoy
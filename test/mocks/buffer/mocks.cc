@@ -25,4 +25,15 @@ template <> MockBufferBase<Buffer::OwnedImpl>::MockBufferBase() : Buffer::OwnedI
 MockBufferFactory::MockBufferFactory() {}
 MockBufferFactory::~MockBufferFactory() {}
 
+MockBufferMemoryAccount::MockBufferMemoryAccount() {
+  ON_CALL(*this, charge(testing::_)).WillByDefault(testing::Invoke([this](uint64_t amount) {
+    balance_ += amount;
+  }));
+  ON_CALL(*this, credit(testing::_)).WillByDefault(testing::Invoke([this](uint64_t amount) {
+    balance_ -= amount;
+  }));
+  ON_CALL(*this, balance()).WillByDefault(testing::ReturnPointee(&balance_));
+}
+MockBufferMemoryAccount::~MockBufferMemoryAccount() {}
+
 } // namespace Envoy
@@ -101,6 +101,18 @@ public:
                                           std::function<void()> above_high));
 };
 
+class MockBufferMemoryAccount : public Buffer::BufferMemoryAccount {
+public:
+  MockBufferMemoryAccount();
+  ~MockBufferMemoryAccount();
+
+  MOCK_METHOD1(charge, void(uint64_t amount));
+  MOCK_METHOD1(credit, void(uint64_t amount));
+  MOCK_CONST_METHOD0(balance, uint64_t());
+
+  uint64_t balance_{};
+};
+
 MATCHER_P(BufferEqual, rhs, testing::PrintToString(*rhs)) {
   return TestUtility::buffersEqual(arg, *rhs);
 }
@@ -30,6 +30,7 @@ public:
   MOCK_METHOD1(addDrainedCallback, void(DrainedCb cb));
   MOCK_METHOD0(drainConnections, void());
   MOCK_CONST_METHOD0(hasActiveConnections, bool());
+  MOCK_METHOD1(preconnect, void(uint32_t min_connections));
   MOCK_METHOD2(newStream, Cancellable*(Http::StreamDecoder& response_decoder,
                                        Http::ConnectionPool::Callbacks& callbacks));
   MOCK_CONST_METHOD0(host, Upstream::HostDescriptionConstSharedPtr());
@@ -65,6 +65,16 @@ template <class T> static void initializeMockConnection(T& connection) {
   ON_CALL(connection, localAddress()).WillByDefault(ReturnRef(connection.local_address_));
   ON_CALL(connection, id()).WillByDefault(Return(connection.next_id_));
   ON_CALL(connection, state()).WillByDefault(ReturnPointee(&connection.state_));
+  ON_CALL(connection, setBufferMemoryAccounts(_, _))
+      .WillByDefault(Invoke([&connection](Buffer::BufferMemoryAccountSharedPtr receive_account,
+                                          Buffer::BufferMemoryAccountSharedPtr account) {
+        connection.receive_buffer_memory_account_ = std::move(receive_account);
+        connection.buffer_memory_account_ = std::move(account);
+      }));
+  ON_CALL(connection, receiveBufferMemoryAccount())
+      .WillByDefault(ReturnRef(connection.receive_buffer_memory_account_));
+  ON_CALL(connection, bufferMemoryAccount())
+      .WillByDefault(ReturnRef(connection.buffer_memory_account_));
 
   // The real implementation will move the buffer data into the socket.
   ON_CALL(connection, write(_, _)).WillByDefault(Invoke([](Buffer::Instance& buffer, bool) -> void {
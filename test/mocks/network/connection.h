@@ -41,6 +41,8 @@ public:
   Address::InstanceConstSharedPtr remote_address_;
   Address::InstanceConstSharedPtr local_address_;
   bool read_enabled_{true};
+  Buffer::BufferMemoryAccountSharedPtr receive_buffer_memory_account_;
+  Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
   testing::NiceMock<StreamInfo::MockStreamInfo> stream_info_;
   Connection::State state_{Connection::State::Open};
 };
@@ -77,6 +79,10 @@ public:
   MOCK_METHOD2(write, void(Buffer::Instance& data, bool end_stream));
   MOCK_METHOD1(setBufferLimits, void(uint32_t limit));
   MOCK_CONST_METHOD0(bufferLimit, uint32_t());
+  MOCK_METHOD2(setBufferMemoryAccounts, void(Buffer::BufferMemoryAccountSharedPtr receive_account,
+                                             Buffer::BufferMemoryAccountSharedPtr account));
+  MOCK_CONST_METHOD0(receiveBufferMemoryAccount, const Buffer::BufferMemoryAccountSharedPtr&());
+  MOCK_CONST_METHOD0(bufferMemoryAccount, const Buffer::BufferMemoryAccountSharedPtr&());
   MOCK_CONST_METHOD0(localAddressRestored, bool());
   MOCK_CONST_METHOD0(aboveHighWatermark, bool());
   MOCK_CONST_METHOD0(socketOptions, const Network::ConnectionSocket::OptionsSharedPtr&());
@@ -123,6 +129,10 @@ public:
   MOCK_METHOD2(write, void(Buffer::Instance& data, bool end_stream));
   MOCK_METHOD1(setBufferLimits, void(uint32_t limit));
   MOCK_CONST_METHOD0(bufferLimit, uint32_t());
+  MOCK_METHOD2(setBufferMemoryAccounts, void(Buffer::BufferMemoryAccountSharedPtr receive_account,
+                                             Buffer::BufferMemoryAccountSharedPtr account));
+  MOCK_CONST_METHOD0(receiveBufferMemoryAccount, const Buffer::BufferMemoryAccountSharedPtr&());
+  MOCK_CONST_METHOD0(bufferMemoryAccount, const Buffer::BufferMemoryAccountSharedPtr&());
   MOCK_CONST_METHOD0(localAddressRestored, bool());
   MOCK_CONST_METHOD0(aboveHighWatermark, bool());
   MOCK_CONST_METHOD0(socketOptions, const Network::ConnectionSocket::OptionsSharedPtr&());
@@ -172,6 +182,10 @@ public:
   MOCK_METHOD2(write, void(Buffer::Instance& data, bool end_stream));
   MOCK_METHOD1(setBufferLimits, void(uint32_t limit));
   MOCK_CONST_METHOD0(bufferLimit, uint32_t());
+  MOCK_METHOD2(setBufferMemoryAccounts, void(Buffer::BufferMemoryAccountSharedPtr receive_account,
+                                             Buffer::BufferMemoryAccountSharedPtr account));
+  MOCK_CONST_METHOD0(receiveBufferMemoryAccount, const Buffer::BufferMemoryAccountSharedPtr&());
+  MOCK_CONST_METHOD0(bufferMemoryAccount, const Buffer::BufferMemoryAccountSharedPtr&());
   MOCK_CONST_METHOD0(localAddressRestored, bool());
   MOCK_CONST_METHOD0(aboveHighWatermark, bool());
   MOCK_CONST_METHOD0(socketOptions, const Network::ConnectionSocket::OptionsSharedPtr&());
@@ -15,6 +15,7 @@
 
 #include "common/network/filter_manager_impl.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/stream_info/filter_state_impl.h"
 
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/network/connection.h"
@@ -269,6 +270,7 @@ public:
   MOCK_CONST_METHOD0(requestedApplicationProtocols, const std::vector<std::string>&());
   MOCK_METHOD1(setRequestedServerName, void(absl::string_view));
   MOCK_CONST_METHOD0(requestedServerName, absl::string_view());
+  MOCK_METHOD0(filterState, StreamInfo::FilterState&());
   MOCK_METHOD1(addOption_, void(const Socket::OptionConstSharedPtr&));
   MOCK_METHOD1(addOptions_, void(const Socket::OptionsSharedPtr&));
   MOCK_CONST_METHOD0(options, const Network::ConnectionSocket::OptionsSharedPtr&());
@@ -280,6 +282,7 @@ public:
   IoHandlePtr io_handle_;
   Address::InstanceConstSharedPtr local_address_;
   Address::InstanceConstSharedPtr remote_address_;
+  StreamInfo::FilterStateImpl filter_state_;
 };
 
 class MockListenerFilterCallbacks : public ListenerFilterCallbacks {
@@ -306,6 +309,7 @@ public:
   MOCK_METHOD0(bindToPort, bool());
   MOCK_CONST_METHOD0(handOffRestoredDestinationConnections, bool());
   MOCK_CONST_METHOD0(perConnectionBufferLimitBytes, uint32_t());
+  MOCK_METHOD1(bindBufferMemoryAccounts, void(Connection&));
   MOCK_CONST_METHOD0(listenerFiltersTimeout, std::chrono::milliseconds());
   MOCK_METHOD0(listenerScope, Stats::Scope&());
   MOCK_CONST_METHOD0(listenerTag, uint64_t());
@@ -337,6 +341,8 @@ public:
   MOCK_METHOD1(findListenerByAddress,
                Network::Listener*(const Network::Address::Instance& address));
   MOCK_METHOD1(removeListeners, void(uint64_t listener_tag));
+  MOCK_METHOD2(removeFilterChains, void(uint64_t listener_tag,
+                                        const std::vector<const FilterChain*>& filter_chains));
   MOCK_METHOD1(stopListeners, void(uint64_t listener_tag));
   MOCK_METHOD0(stopListeners, void());
   MOCK_METHOD0(disableListeners, void());
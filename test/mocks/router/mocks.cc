@@ -18,6 +18,9 @@ namespace Router {
 MockDirectResponseEntry::MockDirectResponseEntry() {}
 MockDirectResponseEntry::~MockDirectResponseEntry() {}
 
+MockHedgeDelayEstimator::MockHedgeDelayEstimator() {}
+MockHedgeDelayEstimator::~MockHedgeDelayEstimator() {}
+
 MockRetryState::MockRetryState() {}
 
 void MockRetryState::expectHeadersRetry() {
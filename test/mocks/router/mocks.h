@@ -79,10 +79,22 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  HedgeDelayEstimator* hedgeDelayEstimator() const override { return hedge_delay_estimator_; }
 
   uint32_t initial_requests_{};
   envoy::type::FractionalPercent additional_request_chance_{};
   bool hedge_on_per_try_timeout_{};
+  HedgeDelayEstimator* hedge_delay_estimator_{};
+};
+
+class MockHedgeDelayEstimator : public HedgeDelayEstimator {
+public:
+  MockHedgeDelayEstimator();
+  ~MockHedgeDelayEstimator() override;
+
+  // Router::HedgeDelayEstimator
+  MOCK_METHOD1(recordResponseTime, void(std::chrono::milliseconds response_time));
+  MOCK_CONST_METHOD0(hedgeDelay, absl::optional<std::chrono::milliseconds>());
 };
 
 class TestRetryPolicy : public RetryPolicy {
@@ -215,6 +227,7 @@ public:
   MOCK_CONST_METHOD0(routeConfig, const Config&());
   MOCK_CONST_METHOD1(perFilterConfig, const RouteSpecificFilterConfig*(const std::string&));
   MOCK_CONST_METHOD0(includeAttemptCount, bool());
+  MOCK_CONST_METHOD0(requestStats, const RouteStats*());
   MOCK_METHOD0(retryPriority, Upstream::RetryPrioritySharedPtr());
   MOCK_METHOD0(retryHostPredicate, Upstream::RetryHostPredicateSharedPtr());
 
@@ -293,6 +306,7 @@ public:
   MOCK_CONST_METHOD1(virtualCluster, const VirtualCluster*(const Http::HeaderMap& headers));
   MOCK_CONST_METHOD0(virtualHostName, const std::string&());
   MOCK_CONST_METHOD0(virtualHost, const VirtualHost&());
+  MOCK_CONST_METHOD0(requestStats, const RouteStats*());
   MOCK_CONST_METHOD0(autoHostRewrite, bool());
   MOCK_CONST_METHOD0(opaqueConfig, const std::multimap<std::string, std::string>&());
   MOCK_CONST_METHOD0(includeVirtualHostRateLimits, bool());
@@ -81,6 +81,7 @@ public:
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
   MOCK_CONST_METHOD0(libeventBufferEnabled, bool());
   MOCK_CONST_METHOD0(cpusetThreadsEnabled, bool());
+  MOCK_CONST_METHOD0(statsCounterShards, uint32_t());
   MOCK_CONST_METHOD0(toCommandLineOptions, Server::CommandLineOptionsPtr());
 
   std::string config_path_;
@@ -97,6 +98,7 @@ public:
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
   bool cpuset_threads_enabled_{};
+  uint32_t stats_counter_shards_{};
 };
 
 class MockConfigTracker : public ConfigTracker {
@@ -150,6 +152,7 @@ public:
   MOCK_CONST_METHOD0(getRequestHeaders, Http::HeaderMap&());
   MOCK_CONST_METHOD0(getDecoderFilterCallbacks,
                      NiceMock<Http::MockStreamDecoderFilterCallbacks>&());
+  MOCK_METHOD1(setNextChunkCallback, void(NextChunkCb));
 };
 
 class MockDrainManager : public DrainManager {
@@ -202,6 +205,7 @@ public:
   MOCK_METHOD1(sendParentAdminShutdownRequest, void(time_t& original_start_time));
   MOCK_METHOD0(sendParentTerminateRequest, void());
   MOCK_METHOD1(mergeParentStatsIfAny, ServerStatsFromParent(Stats::StoreRoot& stats_store));
+  MOCK_METHOD0(getParentTlsSessionState, std::string());
   MOCK_METHOD0(shutdown, void());
   MOCK_METHOD0(version, std::string());
   MOCK_METHOD0(logLock, Thread::BasicLockable&());
@@ -261,6 +265,7 @@ public:
   MOCK_METHOD1(createLdsApi, void(const envoy::api::v2::core::ConfigSource& lds_config));
   MOCK_METHOD0(listeners, std::vector<std::reference_wrapper<Network::ListenerConfig>>());
   MOCK_METHOD0(numConnections, uint64_t());
+  MOCK_CONST_METHOD1(topConnectionsByMemory, std::vector<ConnectionMemoryUsage>(uint64_t limit));
   MOCK_METHOD1(removeListener, bool(const std::string& listener_name));
   MOCK_METHOD1(startWorkers, void(GuardDog& guard_dog));
   MOCK_METHOD0(stopListeners, void());
@@ -305,12 +310,22 @@ public:
     remove_listener_completion_ = nullptr;
   }
 
+  void callRemoveFilterChainsCompletion() {
+    EXPECT_NE(nullptr, remove_filter_chains_completion_);
+    remove_filter_chains_completion_();
+    remove_filter_chains_completion_ = nullptr;
+  }
+
   // Server::Worker
   MOCK_METHOD2(addListener,
                void(Network::ListenerConfig& listener, AddListenerCompletion completion));
   MOCK_METHOD0(numConnections, uint64_t());
   MOCK_METHOD2(removeListener,
                void(Network::ListenerConfig& listener, std::function<void()> completion));
+  MOCK_METHOD3(removeFilterChains,
+               void(uint64_t listener_tag,
+                    const std::vector<const Network::FilterChain*>& filter_chains,
+                    std::function<void()> completion));
   MOCK_METHOD1(start, void(GuardDog& guard_dog));
   MOCK_METHOD2(initializeStats, void(Stats::Scope& scope, const std::string& prefix));
   MOCK_METHOD0(stop, void());
@@ -319,6 +334,7 @@ public:
 
   AddListenerCompletion add_listener_completion_;
   std::function<void()> remove_listener_completion_;
+  std::function<void()> remove_filter_chains_completion_;
 };
 
 class MockOverloadManager : public OverloadManager {
@@ -509,6 +525,7 @@ public:
   testing::NiceMock<Upstream::MockClusterManager> cluster_manager_;
   std::unique_ptr<Secret::SecretManager> secret_manager_;
   testing::NiceMock<Api::MockApi> api_;
+  Singleton::ManagerPtr singleton_manager_;
 };
 
 class MockListenerFactoryContext : public MockFactoryContext, public ListenerFactoryContext {
@@ -12,5 +12,8 @@ MockConnectionInfo::~MockConnectionInfo() {}
 MockClientContext::MockClientContext() {}
 MockClientContext::~MockClientContext() {}
 
+MockPrivateKeyConnectionCallbacks::MockPrivateKeyConnectionCallbacks() {}
+MockPrivateKeyConnectionCallbacks::~MockPrivateKeyConnectionCallbacks() {}
+
 } // namespace Ssl
 } // namespace Envoy
@@ -7,6 +7,7 @@
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
 #include "envoy/ssl/context_manager.h"
+#include "envoy/ssl/private_key_method_provider.h"
 #include "envoy/stats/scope.h"
 
 #include "test/mocks/secret/mocks.h"
@@ -28,6 +29,8 @@ public:
                                       const std::vector<std::string>& server_names));
   MOCK_CONST_METHOD0(daysUntilFirstCertExpires, size_t());
   MOCK_METHOD1(iterateContexts, void(std::function<void(const Context&)> callback));
+  MOCK_METHOD0(exportServerSessionState, std::string());
+  MOCK_METHOD1(importServerSessionState, bool(const std::string& state));
 };
 
 class MockConnectionInfo : public ConnectionInfo {
@@ -65,5 +68,13 @@ public:
   MOCK_CONST_METHOD0(getCertChainInformation, std::vector<CertificateDetailsPtr>());
 };
 
+class MockPrivateKeyConnectionCallbacks : public PrivateKeyConnectionCallbacks {
+public:
+  MockPrivateKeyConnectionCallbacks();
+  ~MockPrivateKeyConnectionCallbacks();
+
+  MOCK_METHOD0(onPrivateKeyMethodComplete, void());
+};
+
 } // namespace Ssl
 } // namespace Envoy
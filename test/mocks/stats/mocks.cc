@@ -34,6 +34,7 @@ void MockMetric::setTagExtractedName(absl::string_view name) {
 
 void MockMetric::setTags(const std::vector<Tag>& tags) {
   tag_pool_.clear();
+  tag_names_and_values_.clear();
   tags_ = tags;
   for (const Tag& tag : tags) {
     tag_names_and_values_.push_back(tag_pool_.add(tag.name_));
@@ -62,7 +62,9 @@ public:
   std::string tagExtractedName() const override {
     return tag_extracted_name_.empty() ? name() : tag_extracted_name_;
   }
-  StatName tagExtractedStatName() const override { return tag_extracted_stat_name_->statName(); }
+  StatName tagExtractedStatName() const override {
+    return tag_extracted_stat_name_ == nullptr ? statName() : tag_extracted_stat_name_->statName();
+  }
   void iterateTagStatNames(const TagStatNameIterFn& fn) const override;
   void iterateTags(const TagIterFn& fn) const override;
 
@@ -110,6 +112,7 @@ public:
   MOCK_METHOD1(mergeImportMode, void(ImportMode));
   MOCK_CONST_METHOD0(used, bool());
   MOCK_CONST_METHOD0(value, uint64_t());
+  MOCK_METHOD0(latchChanged, bool());
   MOCK_CONST_METHOD0(cachedShouldImport, absl::optional<bool>());
   MOCK_CONST_METHOD0(importMode, ImportMode());
 
@@ -169,6 +172,7 @@ public:
   ~MockSink();
 
   MOCK_METHOD1(flush, void(MetricSnapshot& snapshot));
+  MOCK_CONST_METHOD0(changedMetricsOnly, bool());
   MOCK_METHOD2(onHistogramComplete, void(const Histogram& histogram, uint64_t value));
 };
 
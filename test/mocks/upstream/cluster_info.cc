@@ -50,6 +50,9 @@ MockClusterInfo::MockClusterInfo()
   ON_CALL(*this, extensionProtocolOptions(_)).WillByDefault(Return(extension_protocol_options_));
   ON_CALL(*this, maxRequestsPerConnection())
       .WillByDefault(ReturnPointee(&max_requests_per_connection_));
+  ON_CALL(*this, perUpstreamPreconnectRatio())
+      .WillByDefault(ReturnPointee(&per_upstream_preconnect_ratio_));
+  ON_CALL(*this, preconnectOnHostAdd()).WillByDefault(ReturnPointee(&preconnect_on_host_add_));
   ON_CALL(*this, stats()).WillByDefault(ReturnRef(stats_));
   ON_CALL(*this, statsScope()).WillByDefault(ReturnRef(stats_store_));
   // TODO(mattklein123): The following is a hack because it's not possible to directly embed
@@ -37,6 +37,7 @@ public:
   MOCK_CONST_METHOD0(localityWeightAware, bool());
   MOCK_CONST_METHOD0(scaleLocalityWeight, bool());
   MOCK_CONST_METHOD0(panicModeAny, bool());
+  MOCK_CONST_METHOD0(maxLazySubsets, uint32_t());
 
   std::vector<SubsetSelectorPtr> subset_selectors_;
 };
@@ -103,6 +104,8 @@ public:
   MOCK_CONST_METHOD0(clusterSocketOptions, const Network::ConnectionSocket::OptionsSharedPtr&());
   MOCK_CONST_METHOD0(drainConnectionsOnHostRemoval, bool());
   MOCK_CONST_METHOD0(warmHosts, bool());
+  MOCK_CONST_METHOD0(perUpstreamPreconnectRatio, float());
+  MOCK_CONST_METHOD0(preconnectOnHostAdd, uint32_t());
   MOCK_CONST_METHOD0(eds_service_name, absl::optional<std::string>());
 
   std::string name_{"fake_cluster"};
@@ -110,6 +113,8 @@ public:
   Http::Http2Settings http2_settings_{};
   ProtocolOptionsConfigConstSharedPtr extension_protocol_options_;
   uint64_t max_requests_per_connection_{};
+  float per_upstream_preconnect_ratio_{1.0};
+  uint32_t preconnect_on_host_add_{};
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   ClusterStats stats_;
   Network::TransportSocketFactoryPtr transport_socket_factory_;
@@ -7,6 +7,7 @@
 
 #include "server/connection_handler_impl.h"
 
+#include "test/mocks/buffer/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/network_utility.h"
@@ -55,6 +56,11 @@ public:
       return hand_off_restored_destination_connections_;
     }
     uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+    void bindBufferMemoryAccounts(Network::Connection& connection) override {
+      if (account_ != nullptr) {
+        connection.setBufferMemoryAccounts(receive_account_, account_);
+      }
+    }
     std::chrono::milliseconds listenerFiltersTimeout() const override {
       return listener_filters_timeout_;
     }
@@ -69,6 +75,8 @@ public:
     const bool hand_off_restored_destination_connections_;
     const std::string name_;
     const std::chrono::milliseconds listener_filters_timeout_;
+    Buffer::BufferMemoryAccountSharedPtr receive_account_;
+    Buffer::BufferMemoryAccountSharedPtr account_;
   };
 
   using TestListenerPtr = std::unique_ptr<TestListener>;
@@ -252,6 +260,85 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+// The memory accounts are set before the network filters are created, so that they can bind them
+// to their buffers.
+TEST_F(ConnectionHandlerTest, BindBufferMemoryAccounts) {
+  InSequence s;
+
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->receive_account_ = std::make_shared<NiceMock<MockBufferMemoryAccount>>();
+  test_listener->account_ = std::make_shared<NiceMock<MockBufferMemoryAccount>>();
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  auto* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).WillOnce(Return(connection));
+  EXPECT_CALL(*connection,
+              setBufferMemoryAccounts(test_listener->receive_account_, test_listener->account_));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillOnce(Return(true));
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+  EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(test_listener->account_, connection->bufferMemoryAccount());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
+TEST_F(ConnectionHandlerTest, RemoveFilterChains) {
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  const Network::FilterChainSharedPtr other_filter_chain =
+      Network::Test::createEmptyFilterChainWithRawBufferSockets();
+  EXPECT_CALL(manager_, findFilterChain(_))
+      .WillOnce(Return(filter_chain_.get()))
+      .WillOnce(Return(other_filter_chain.get()));
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  Network::MockConnection* other_connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _))
+      .WillOnce(Return(connection))
+      .WillOnce(Return(other_connection));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  // Unknown listener.
+  handler_->removeFilterChains(0, {filter_chain_.get()});
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  // Only the connections of the removed filter chains are closed.
+  EXPECT_CALL(*connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*other_connection, close(_)).Times(0);
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  handler_->removeFilterChains(1, {filter_chain_.get()});
+  EXPECT_EQ(1UL, handler_->numConnections());
+  testing::Mock::VerifyAndClearExpectations(other_connection);
+
+  EXPECT_CALL(*listener, onDestroy());
+  handler_.reset();
+}
+
 TEST_F(ConnectionHandlerTest, FindListenerByAddress) {
   TestListener* test_listener1 = addListener(1, true, true, "test_listener1");
   Network::Address::InstanceConstSharedPtr alt_address(
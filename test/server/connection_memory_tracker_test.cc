@@ -0,0 +1,230 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "server/connection_memory_tracker.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class ConnectionMemoryTrackerTest : public testing::Test {
+public:
+  ConnectionMemoryTrackerTest() {
+    connection_.local_address_ = Network::Utility::resolveUrl("tcp://127.0.0.1:80");
+  }
+
+  void initialize(const std::string& yaml) {
+    envoy::api::v2::Listener::ConnectionMemoryLimit config;
+    TestUtility::loadFromYaml(yaml, config);
+    factory_ = std::make_unique<ConnectionMemoryAccountFactory>(tracker_, config, store_);
+  }
+
+  // Binds the accounts of the connection, and hands them over to the test.
+  void bindAccounts(Network::MockConnection& connection) {
+    factory_->bindAccounts(connection);
+    receive_account_ = std::move(connection.receive_buffer_memory_account_);
+    account_ = std::move(connection.buffer_memory_account_);
+  }
+
+  ConnectionMemoryTrackerSharedPtr tracker_{std::make_shared<ConnectionMemoryTracker>()};
+  Stats::IsolatedStoreImpl store_;
+  ConnectionMemoryAccountFactoryPtr factory_;
+  NiceMock<Network::MockConnection> connection_;
+  Buffer::BufferMemoryAccountSharedPtr receive_account_;
+  Buffer::BufferMemoryAccountSharedPtr account_;
+};
+
+TEST_F(ConnectionMemoryTrackerTest, Unlimited) {
+  initialize("{}");
+  bindAccounts(connection_);
+  EXPECT_CALL(connection_, readDisable(_)).Times(0);
+  EXPECT_CALL(connection_.dispatcher_, createTimer_(_)).Times(0);
+
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl receive_buffer;
+  buffer.bindAccount(account_);
+  receive_buffer.bindAccount(receive_account_);
+  buffer.add(std::string(1 << 20, 'a'));
+  receive_buffer.add(std::string(1 << 20, 'a'));
+  EXPECT_EQ(2 << 20, account_->balance());
+  EXPECT_EQ(1 << 20, receive_account_->balance());
+  buffer.drain(buffer.length());
+  receive_buffer.drain(receive_buffer.length());
+  EXPECT_EQ(0, account_->balance());
+  EXPECT_EQ(0, receive_account_->balance());
+}
+
+TEST_F(ConnectionMemoryTrackerTest, ReadDisable) {
+  initialize("read_disable_bytes: 100");
+  bindAccounts(connection_);
+  Buffer::OwnedImpl receive_buffer;
+  Buffer::OwnedImpl other_receive_buffer;
+  receive_buffer.bindAccount(receive_account_);
+  other_receive_buffer.bindAccount(receive_account_);
+
+  receive_buffer.add(std::string(60, 'a'));
+  EXPECT_CALL(connection_, readDisable(true));
+  other_receive_buffer.add(std::string(60, 'b'));
+  EXPECT_EQ(1, store_.counter("downstream_cx_memory_read_disable").value());
+  EXPECT_EQ(120, account_->balance());
+
+  // Still above half of the limit.
+  other_receive_buffer.drain(60);
+  other_receive_buffer.add(std::string(60, 'b'));
+
+  other_receive_buffer.drain(60);
+  EXPECT_CALL(connection_, readDisable(false));
+  receive_buffer.drain(20);
+  EXPECT_EQ(40, receive_account_->balance());
+
+  EXPECT_CALL(connection_, readDisable(true));
+  other_receive_buffer.add(std::string(80, 'b'));
+  EXPECT_EQ(2, store_.counter("downstream_cx_memory_read_disable").value());
+
+  // Once the connection is closed, the accounts only keep the balance.
+  connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(connection_, readDisable(_)).Times(0);
+  other_receive_buffer.drain(80);
+  EXPECT_EQ(40, receive_account_->balance());
+  EXPECT_EQ(40, account_->balance());
+}
+
+// The bytes which may only drain once more is read from the connection, such as the write buffer
+// waiting for a window update, never disable reads.
+TEST_F(ConnectionMemoryTrackerTest, NoReadDisableForOtherBuffers) {
+  initialize("read_disable_bytes: 100");
+  bindAccounts(connection_);
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl receive_buffer;
+  buffer.bindAccount(account_);
+  receive_buffer.bindAccount(receive_account_);
+
+  EXPECT_CALL(connection_, readDisable(_)).Times(0);
+  buffer.add(std::string(1000, 'a'));
+  receive_buffer.add(std::string(100, 'b'));
+  EXPECT_EQ(1100, account_->balance());
+  EXPECT_EQ(0, store_.counter("downstream_cx_memory_read_disable").value());
+}
+
+TEST_F(ConnectionMemoryTrackerTest, Close) {
+  initialize("close_bytes: 100");
+  bindAccounts(connection_);
+  Buffer::OwnedImpl buffer;
+  Buffer::OwnedImpl receive_buffer;
+  buffer.bindAccount(account_);
+  receive_buffer.bindAccount(receive_account_);
+
+  buffer.add(std::string(50, 'a'));
+  receive_buffer.add(std::string(50, 'a'));
+  Event::MockTimer* close_timer = new Event::MockTimer(&connection_.dispatcher_);
+  EXPECT_CALL(*close_timer, enableTimer(std::chrono::milliseconds(0)));
+  // The connection isn't closed from within the buffer operation.
+  EXPECT_CALL(connection_, close(_)).Times(0);
+  receive_buffer.add("b");
+  EXPECT_EQ(1, store_.counter("downstream_cx_memory_close").value());
+
+  // The close is only scheduled once.
+  buffer.add("c");
+  EXPECT_EQ(1, store_.counter("downstream_cx_memory_close").value());
+
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  close_timer->invokeCallback();
+  EXPECT_EQ(Network::Connection::State::Closed, connection_.state_);
+}
+
+TEST_F(ConnectionMemoryTrackerTest, CloseBeforeTimer) {
+  initialize("close_bytes: 10");
+  bindAccounts(connection_);
+  Buffer::OwnedImpl buffer;
+  buffer.bindAccount(account_);
+
+  Event::MockTimer* close_timer = new Event::MockTimer(&connection_.dispatcher_);
+  buffer.add(std::string(20, 'a'));
+  EXPECT_TRUE(close_timer->enabled_);
+
+  // The timer is destroyed along with the connection.
+  connection_.raiseEvent(Network::ConnectionEvent::LocalClose);
+  EXPECT_CALL(connection_, close(_)).Times(0);
+}
+
+TEST_F(ConnectionMemoryTrackerTest, TopConnections) {
+  initialize("{}");
+  bindAccounts(connection_);
+  Buffer::BufferMemoryAccountSharedPtr account = std::move(account_);
+  Buffer::BufferMemoryAccountSharedPtr receive_account = std::move(receive_account_);
+  NiceMock<Network::MockConnection> other_connection;
+  other_connection.remote_address_ = Network::Utility::resolveUrl("tcp://10.0.0.4:50000");
+  bindAccounts(other_connection);
+  Buffer::OwnedImpl buffer("abc");
+  Buffer::OwnedImpl other_buffer("abcdef");
+  buffer.bindAccount(account);
+  other_buffer.bindAccount(account_);
+
+  std::vector<ConnectionMemoryUsage> usages = tracker_->topConnections(10);
+  ASSERT_EQ(2, usages.size());
+  EXPECT_EQ("10.0.0.4:50000", usages[0].remote_address_->asString());
+  EXPECT_EQ(6, usages[0].bytes_);
+  EXPECT_EQ(connection_.id(), usages[1].connection_id_);
+  EXPECT_EQ(3, usages[1].bytes_);
+  EXPECT_EQ("127.0.0.1:80", usages[1].local_address_->asString());
+  EXPECT_EQ("10.0.0.3:50000", usages[1].remote_address_->asString());
+
+  Buffer::OwnedImpl receive_buffer("defghi");
+  receive_buffer.bindAccount(receive_account);
+  usages = tracker_->topConnections(1);
+  ASSERT_EQ(1, usages.size());
+  EXPECT_EQ("10.0.0.3:50000", usages[0].remote_address_->asString());
+  EXPECT_EQ(9, usages[0].bytes_);
+
+  // The account is unregistered once its connection and buffers are gone.
+  account.reset();
+  receive_account.reset();
+  buffer.bindAccount(nullptr);
+  receive_buffer.bindAccount(nullptr);
+  usages = tracker_->topConnections(10);
+  ASSERT_EQ(1, usages.size());
+  EXPECT_EQ("10.0.0.4:50000", usages[0].remote_address_->asString());
+}
+
+TEST_F(ConnectionMemoryTrackerTest, TopConnectionsAcrossShards) {
+  initialize("{}");
+  std::vector<std::unique_ptr<NiceMock<Network::MockConnection>>> connections;
+  std::vector<Buffer::BufferMemoryAccountSharedPtr> accounts;
+  std::vector<std::unique_ptr<Buffer::OwnedImpl>> buffers;
+  for (uint64_t i = 0; i < 200; ++i) {
+    connections.push_back(std::make_unique<NiceMock<Network::MockConnection>>());
+    ON_CALL(*connections.back(), id()).WillByDefault(Return(i));
+    bindAccounts(*connections.back());
+    accounts.push_back(account_);
+    buffers.push_back(std::make_unique<Buffer::OwnedImpl>(std::string(i, 'a')));
+    buffers.back()->bindAccount(account_);
+  }
+
+  std::vector<ConnectionMemoryUsage> usages = tracker_->topConnections(3);
+  ASSERT_EQ(3, usages.size());
+  EXPECT_EQ(199, usages[0].connection_id_);
+  EXPECT_EQ(199, usages[0].bytes_);
+  EXPECT_EQ(198, usages[1].connection_id_);
+  EXPECT_EQ(197, usages[2].connection_id_);
+  EXPECT_NE(nullptr, usages[2].remote_address_);
+  EXPECT_EQ(200, tracker_->topConnections(1000).size());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
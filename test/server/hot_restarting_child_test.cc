@@ -0,0 +1,89 @@
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "server/hot_restarting_child.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+using HotRestartMessage = envoy::HotRestartMessage;
+
+// The domain sockets stay bound for the life of the process, so every test uses its own ids, and
+// the ids of concurrently running test processes don't overlap either.
+int uniqueBaseId() {
+  static int next_test = 0;
+  return (getpid() % 10000) * 300 + 3 * next_test++;
+}
+
+// Answers a single request from the child of epoch 1, as the parent of epoch 0 would.
+class TestParent : HotRestartingBase {
+public:
+  explicit TestParent(int base_id) : HotRestartingBase(base_id) {
+    bindDomainSocket(0, "parent");
+  }
+
+  // @param reply supplies the reply, or nullptr to reply like a parent not knowing the request.
+  void replyOnce(std::unique_ptr<HotRestartMessage> reply) {
+    reply_ = std::move(reply);
+    thread_ = Thread::threadFactoryForTest().createThread([this]() {
+      std::unique_ptr<HotRestartMessage> request = receiveHotRestartMessage(Blocking::Yes);
+      ASSERT_NE(nullptr, request);
+      EXPECT_EQ(HotRestartMessage::Request::kTlsSessions, request->request().request_case());
+      HotRestartMessage wrapped_reply;
+      if (reply_ != nullptr) {
+        wrapped_reply = *reply_;
+      } else {
+        wrapped_reply.set_didnt_recognize_your_last_message(true);
+      }
+      sockaddr_un child_address = createDomainSocketAddress(1, "child");
+      sendHotRestartMessage(child_address, wrapped_reply);
+    });
+  }
+
+  void join() { thread_->join(); }
+
+private:
+  std::unique_ptr<HotRestartMessage> reply_;
+  Thread::ThreadPtr thread_;
+};
+
+TEST(HotRestartingChildTest, GetParentTlsSessionState) {
+  const int base_id = uniqueBaseId();
+  TestParent parent(base_id);
+  HotRestartingChild child(base_id, 1);
+
+  auto reply = std::make_unique<HotRestartMessage>();
+  reply->mutable_reply()->mutable_tls_sessions()->set_state("sessions");
+  parent.replyOnce(std::move(reply));
+  EXPECT_EQ("sessions", child.getParentTlsSessionState());
+  parent.join();
+}
+
+// A parent predating the session handover doesn't recognize the request, and the child starts
+// with an empty cache.
+TEST(HotRestartingChildTest, GetParentTlsSessionStateFromOldParent) {
+  const int base_id = uniqueBaseId();
+  TestParent parent(base_id);
+  HotRestartingChild child(base_id, 1);
+
+  parent.replyOnce(nullptr);
+  EXPECT_EQ("", child.getParentTlsSessionState());
+  parent.join();
+}
+
+// The first epoch has no parent to ask.
+TEST(HotRestartingChildTest, GetParentTlsSessionStateWithoutParent) {
+  HotRestartingChild child(uniqueBaseId(), 0);
+  EXPECT_EQ("", child.getParentTlsSessionState());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
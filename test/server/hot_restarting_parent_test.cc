@@ -3,6 +3,7 @@
 #include "server/hot_restarting_parent.h"
 
 #include "test/mocks/server/mocks.h"
+#include "test/mocks/ssl/mocks.h"
 
 #include "gtest/gtest.h"
 
@@ -77,6 +78,14 @@ TEST_F(HotRestartingParentTest, exportStatsToChild) {
   }
 }
 
+TEST_F(HotRestartingParentTest, exportTlsSessionsToChild) {
+  Ssl::MockContextManager ssl_context_manager;
+  EXPECT_CALL(server_, sslContextManager()).WillOnce(ReturnRef(ssl_context_manager));
+  EXPECT_CALL(ssl_context_manager, exportServerSessionState()).WillOnce(Return("state"));
+  HotRestartMessage message = hot_restarting_parent_.exportTlsSessionsToChild();
+  EXPECT_EQ("state", message.reply().tls_sessions().state());
+}
+
 TEST_F(HotRestartingParentTest, drainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
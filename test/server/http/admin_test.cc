@@ -29,6 +29,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -59,7 +60,8 @@ public:
   statsAsJsonHandler(std::map<std::string, uint64_t>& all_stats,
                      const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
                      const bool used_only, const absl::optional<std::regex> regex = absl::nullopt) {
-    return AdminImpl::statsAsJson(all_stats, all_histograms, used_only, regex,
+    return AdminImpl::statsAsJson(all_stats, all_histograms,
+                                  StatsFilter(used_only, EMPTY_STRING, regex),
                                   true /*pretty_print*/);
   }
 
@@ -576,6 +578,44 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_headers_));
 }
 
+TEST_P(AdminFilterTest, StatsStreamedInChunks) {
+  // Enough counters for the response to take three chunks.
+  for (uint32_t i = 0; i < 2500; i++) {
+    server_.stats_store_.counter(absl::StrCat("chunked.", i)).inc();
+  }
+  Http::TestHeaderMapImpl request_headers{{":path", "/stats?prefix=chunked."}};
+  Event::MockTimer* timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  std::string body;
+  bool end_stream = false;
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(_, _))
+      .WillRepeatedly(Invoke([&body, &end_stream](Buffer::Instance& data, bool end) -> void {
+        body += data.toString();
+        end_stream = end;
+      }));
+  EXPECT_CALL(callbacks_, addDownstreamWatermarkCallbacks(Ref(filter_)));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(0))).Times(2);
+  filter_.decodeHeaders(request_headers, true);
+  EXPECT_EQ(1000, std::count(body.begin(), body.end(), '\n'));
+  EXPECT_FALSE(end_stream);
+
+  // No further chunks are scheduled while the connection is backed up.
+  filter_.onAboveWriteBufferHighWatermark();
+  timer->invokeCallback();
+  EXPECT_EQ(2000, std::count(body.begin(), body.end(), '\n'));
+  EXPECT_FALSE(end_stream);
+
+  filter_.onBelowWriteBufferLowWatermark();
+  timer->invokeCallback();
+  EXPECT_EQ(2500, std::count(body.begin(), body.end(), '\n'));
+  EXPECT_TRUE(end_stream);
+  EXPECT_THAT(body, HasSubstr("chunked.0: 1\n"));
+  EXPECT_THAT(body, HasSubstr("chunked.2499: 1\n"));
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(Ref(filter_)));
+  filter_.onDestroy();
+}
+
 class AdminInstanceTest : public testing::TestWithParam<Network::Address::IpVersion> {
 public:
   AdminInstanceTest()
@@ -894,6 +934,32 @@ TEST_P(AdminInstanceTest, Memory) {
                     Property(&envoy::admin::v2alpha::Memory::total_thread_cache, Ge(0))));
 }
 
+TEST_P(AdminInstanceTest, MemoryConnections) {
+  const std::vector<ConnectionMemoryUsage> usages{
+      {3, Network::Utility::resolveUrl("tcp://127.0.0.1:80"),
+       Network::Utility::resolveUrl("tcp://10.0.0.1:50000"), 4096}};
+  EXPECT_CALL(server_.listener_manager_, topConnectionsByMemory(2)).WillOnce(Return(usages));
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/connections?limit=2", header_map, response));
+  envoy::admin::v2alpha::ConnectionsMemory output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  ASSERT_EQ(1, output_proto.connections_size());
+  EXPECT_EQ(3, output_proto.connections(0).id());
+  EXPECT_EQ("127.0.0.1:80", output_proto.connections(0).local_address());
+  EXPECT_EQ("10.0.0.1:50000", output_proto.connections(0).remote_address());
+  EXPECT_EQ(4096, output_proto.connections(0).bytes());
+
+  EXPECT_CALL(server_.listener_manager_, topConnectionsByMemory(10))
+      .WillOnce(Return(std::vector<ConnectionMemoryUsage>{}));
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::OK, getCallback("/memory/connections", header_map, response));
+
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/memory/connections?limit=many", header_map, response));
+}
+
 TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
   Http::HeaderMapImpl header_map;
   Buffer::OwnedImpl response;
@@ -1284,6 +1350,28 @@ TEST_P(AdminInstanceTest, GetRequestJson) {
               HasSubstr("application/json"));
 }
 
+TEST_P(AdminInstanceTest, GetRequestStatsWithPrefix) {
+  server_.stats_store_.counter("prefix.counter").inc();
+  server_.stats_store_.gauge("prefix.gauge", Stats::Gauge::ImportMode::Accumulate).set(2);
+  server_.stats_store_.counter("other.prefix.counter").inc();
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/stats?prefix=prefix.", "GET", response_headers, body));
+  EXPECT_EQ("prefix.counter: 1\nprefix.gauge: 2\n", body);
+}
+
+TEST_P(AdminInstanceTest, GetRequestStatsInChunks) {
+  // Requests not made over HTTP get the whole response at once.
+  for (uint32_t i = 0; i < 1500; i++) {
+    server_.stats_store_.counter(absl::StrCat("chunked.", i)).inc();
+  }
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK,
+            admin_.request("/stats?prefix=chunked.&usedonly", "GET", response_headers, body));
+  EXPECT_EQ(1500, std::count(body.begin(), body.end(), '\n'));
+}
+
 TEST_P(AdminInstanceTest, PostRequest) {
   Http::HeaderMapImpl response_headers;
   std::string body;
@@ -1691,5 +1779,48 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+TEST_F(PrometheusStatsFormatterTest, OutputWithPrefix) {
+  addCounter("cluster.test_1.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
+  addCounter("cluster.test_10.upstream_cx_total", {{"another_tag_name", "another_tag-value"}});
+  addGauge("cluster.test_1.upstream_cx_active", {});
+
+  PrometheusStatsFormatter formatter(counters_, gauges_, histograms_,
+                                     StatsFilter(false, "cluster.test_1.", absl::nullopt));
+  Buffer::OwnedImpl response;
+  EXPECT_FALSE(formatter.nextChunk(response, 10));
+  EXPECT_EQ(2UL, formatter.metricTypes());
+
+  const std::string expected_output =
+      R"EOF(# TYPE envoy_cluster_test_1_upstream_cx_total counter
+envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
+# TYPE envoy_cluster_test_1_upstream_cx_active gauge
+envoy_cluster_test_1_upstream_cx_active{} 0
+)EOF";
+
+  EXPECT_EQ(expected_output, response.toString());
+}
+
+TEST_F(PrometheusStatsFormatterTest, OutputInChunks) {
+  addCounter("cluster.test_cluster_1.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
+  addCounter("cluster.test_cluster_1.upstream_cx_total",
+             {{"another_tag_name", "another_tag-value"}});
+  addGauge("cluster.test_cluster_2.upstream_cx_total",
+           {{"another_tag_name_3", "another_tag_3-value"}});
+
+  Buffer::OwnedImpl expected;
+  PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_, expected, false,
+                                              absl::nullopt);
+
+  // Formatting one metric at a time gives the same output, with each TYPE line written once.
+  PrometheusStatsFormatter formatter(counters_, gauges_, histograms_,
+                                     StatsFilter(false, EMPTY_STRING, absl::nullopt));
+  Buffer::OwnedImpl response;
+  EXPECT_TRUE(formatter.nextChunk(response, 1));
+  EXPECT_TRUE(formatter.nextChunk(response, 1));
+  EXPECT_FALSE(formatter.nextChunk(response, 1));
+  EXPECT_EQ(expected.toString(), response.toString());
+  EXPECT_EQ(2UL, formatter.metricTypes());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -9,6 +9,8 @@
 #include "envoy/server/filter_config.h"
 
 #include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/cleanup.h"
 #include "common/config/metadata.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
@@ -23,6 +25,7 @@
 #include "extensions/filters/listener/original_dst/original_dst.h"
 #include "extensions/transport_sockets/tls/ssl_socket.h"
 
+#include "test/common/runtime/utility.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/server/utility.h"
@@ -332,6 +335,58 @@ per_connection_buffer_limit_bytes: 8192
   EXPECT_EQ(8192U, manager_->listeners().back().get().perConnectionBufferLimitBytes());
 }
 
+TEST_F(ListenerManagerImplWithRealFiltersTest, NoConnectionMemoryLimit) {
+  const std::string yaml = R"EOF(
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), "", true);
+  NiceMock<Network::MockConnection> connection;
+  EXPECT_CALL(connection, setBufferMemoryAccounts(_, _)).Times(0);
+  manager_->listeners().back().get().bindBufferMemoryAccounts(connection);
+  EXPECT_TRUE(manager_->topConnectionsByMemory(10).empty());
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ConnectionMemoryLimit) {
+  const std::string yaml = R"EOF(
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+connection_memory_limit:
+  read_disable_bytes: 100
+  close_bytes: 1000
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), "", true);
+  NiceMock<Network::MockConnection> connection;
+  manager_->listeners().back().get().bindBufferMemoryAccounts(connection);
+  ASSERT_NE(nullptr, connection.receive_buffer_memory_account_);
+  ASSERT_NE(nullptr, connection.buffer_memory_account_);
+
+  // The limits are applied to the connection, and its stats are in the listener's scope.
+  Buffer::OwnedImpl receive_buffer;
+  receive_buffer.bindAccount(connection.receive_buffer_memory_account_);
+  EXPECT_CALL(connection, readDisable(true));
+  receive_buffer.add(std::string(101, 'a'));
+  const std::string stat_name = "listener.127.0.0.1_1234.downstream_cx_memory_read_disable";
+  EXPECT_EQ(1UL, server_.stats_store_.counter(stat_name).value());
+
+  std::vector<ConnectionMemoryUsage> usages = manager_->topConnectionsByMemory(10);
+  ASSERT_EQ(1, usages.size());
+  EXPECT_EQ(connection.id(), usages[0].connection_id_);
+  EXPECT_EQ(101, usages[0].bytes_);
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, SslContext) {
   const std::string yaml = TestEnvironment::substitute(R"EOF(
 address:
@@ -2353,6 +2408,115 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, MultipleFilterChainsWithOverlappi
                             "overlapping matching rules are defined");
 }
 
+// Updates changing only the filter chains keep the listener and the unchanged filter chains.
+TEST_F(ListenerManagerImplWithRealFiltersTest, UpdateFilterChainsInPlace) {
+  const std::string feature = "envoy.reloadable_features.listener_in_place_filterchain_update";
+  Runtime::RuntimeFeaturesPeer::addFeature(feature);
+  Cleanup remove_feature([&feature] { Runtime::RuntimeFeaturesPeer::removeFeature(feature); });
+  ON_CALL(listener_factory_, createDrainManager_(_))
+      .WillByDefault(Invoke([](envoy::api::v2::Listener::DrainType) -> DrainManager* {
+        return new NiceMock<MockDrainManager>();
+      }));
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  const std::string yaml = R"EOF(
+    name: foo
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    listener_filters:
+    - name: "envoy.listener.tls_inspector"
+      config: {}
+    filter_chains:
+    - filter_chain_match:
+        server_names: "server1.example.com"
+      filters: []
+    - filter_chain_match:
+        server_names: "server2.example.com"
+      filters: []
+  )EOF";
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(yaml), "version1", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 0, 0, 0, 1, 0);
+
+  const Network::FilterChain* server1 =
+      findFilterChain(1234, "127.0.0.1", "server1.example.com", "tls", {}, "127.0.0.1", 111);
+  const Network::FilterChain* server2 =
+      findFilterChain(1234, "127.0.0.1", "server2.example.com", "tls", {}, "127.0.0.1", 111);
+  ASSERT_NE(nullptr, server1);
+  ASSERT_NE(nullptr, server2);
+  EXPECT_EQ(nullptr,
+            findFilterChain(1234, "127.0.0.1", "server3.example.com", "tls", {}, "127.0.0.1", 111));
+
+  const std::string updated_yaml = R"EOF(
+    name: foo
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    listener_filters:
+    - name: "envoy.listener.tls_inspector"
+      config: {}
+    filter_chains:
+    - filter_chain_match:
+        server_names: "server1.example.com"
+      filters: []
+    - filter_chain_match:
+        server_names: "server3.example.com"
+      filters: []
+  )EOF";
+
+  // The listener isn't replaced on the workers, only the connections of the removed filter chain
+  // are closed once the drain time elapsed.
+  Event::MockTimer* drain_timer = new Event::MockTimer(&server_.dispatcher_);
+  EXPECT_CALL(*drain_timer, enableTimer(_));
+  EXPECT_TRUE(
+      manager_->addOrUpdateListener(parseListenerFromV2Yaml(updated_yaml), "version2", true));
+  checkStats(1, 1, 0, 0, 1, 0);
+  EXPECT_EQ(1UL,
+            server_.stats_store_.counter("listener_manager.listener_in_place_updated").value());
+  EXPECT_EQ(1U, manager_->listeners().size());
+
+  EXPECT_EQ(server1,
+            findFilterChain(1234, "127.0.0.1", "server1.example.com", "tls", {}, "127.0.0.1", 111));
+  EXPECT_EQ(nullptr,
+            findFilterChain(1234, "127.0.0.1", "server2.example.com", "tls", {}, "127.0.0.1", 111));
+  EXPECT_NE(nullptr,
+            findFilterChain(1234, "127.0.0.1", "server3.example.com", "tls", {}, "127.0.0.1", 111));
+
+  EXPECT_CALL(*worker_,
+              removeFilterChains(_, std::vector<const Network::FilterChain*>{server2}, _));
+  drain_timer->invokeCallback();
+  worker_->callRemoveFilterChainsCompletion();
+
+  // Updating the listener filters requires a new listener.
+  const std::string updated_listener_filters_yaml = R"EOF(
+    name: foo
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    listener_filters:
+    - name: "envoy.listener.tls_inspector"
+      config: {}
+    - name: "envoy.listener.original_dst"
+      config: {}
+    filter_chains:
+    - filter_chain_match:
+        server_names: "server1.example.com"
+      filters: []
+  )EOF";
+
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_CALL(*worker_, stopListener(_));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(updated_listener_filters_yaml),
+                                            "version3", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 2, 0, 0, 1, 1);
+  EXPECT_EQ(1UL,
+            server_.stats_store_.counter("listener_manager.listener_in_place_updated").value());
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, TlsFilterChainWithoutTlsInspector) {
   const std::string yaml = TestEnvironment::substitute(R"EOF(
     address:
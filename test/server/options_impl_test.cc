@@ -75,7 +75,7 @@ TEST_F(OptionsImplTest, All) {
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
-      "--disable-hot-restart --cpuset-threads");
+      "--disable-hot-restart --cpuset-threads --stats-counter-shards 16");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -95,6 +95,7 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(true, options->hotRestartDisabled());
   EXPECT_EQ(true, options->libeventBufferEnabled());
   EXPECT_EQ(true, options->cpusetThreadsEnabled());
+  EXPECT_EQ(16U, options->statsCounterShards());
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
@@ -126,6 +127,7 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setHotRestartDisabled(!options->hotRestartDisabled());
   options->setSignalHandling(!options->signalHandlingEnabled());
   options->setCpusetThreads(!options->cpusetThreadsEnabled());
+  options->setStatsCounterShards(8);
 
   EXPECT_EQ(109876, options->baseId());
   EXPECT_EQ(42U, options->concurrency());
@@ -147,6 +149,7 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(!hot_restart_disabled, options->hotRestartDisabled());
   EXPECT_EQ(!signal_handling_enabled, options->signalHandlingEnabled());
   EXPECT_EQ(!cpuset_threads_enabled, options->cpusetThreadsEnabled());
+  EXPECT_EQ(8U, options->statsCounterShards());
 
   // Validate that CommandLineOptions is constructed correctly.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -174,6 +177,7 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->hotRestartDisabled(), command_line_options->disable_hot_restart());
   EXPECT_EQ(options->mutexTracingEnabled(), command_line_options->enable_mutex_tracing());
   EXPECT_EQ(options->cpusetThreadsEnabled(), command_line_options->cpuset_threads());
+  EXPECT_EQ(options->statsCounterShards(), command_line_options->stats_counter_shards());
 }
 
 TEST_F(OptionsImplTest, DefaultParams) {
@@ -185,6 +189,7 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(Server::Mode::Serve, options->mode());
   EXPECT_EQ(false, options->hotRestartDisabled());
   EXPECT_EQ(false, options->cpusetThreadsEnabled());
+  EXPECT_EQ(0U, options->statsCounterShards());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -197,6 +202,7 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(envoy::admin::v2alpha::CommandLineOptions::Serve, command_line_options->mode());
   EXPECT_EQ(false, command_line_options->disable_hot_restart());
   EXPECT_EQ(false, command_line_options->cpuset_threads());
+  EXPECT_EQ(0U, command_line_options->stats_counter_shards());
 }
 
 // Validates that the server_info proto is in sync with the options.
@@ -293,6 +299,7 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
             test_options_impl.fileFlushIntervalMsec());
   EXPECT_EQ(regular_options_impl->hotRestartDisabled(), test_options_impl.hotRestartDisabled());
   EXPECT_EQ(regular_options_impl->cpusetThreadsEnabled(), test_options_impl.cpusetThreadsEnabled());
+  EXPECT_EQ(regular_options_impl->statsCounterShards(), test_options_impl.statsCounterShards());
 }
 
 TEST_F(OptionsImplTest, SetBothConcurrencyAndCpuset) {
@@ -51,6 +51,7 @@ TEST(ServerInstanceUtil, flushHelper) {
 
   Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
   sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, changedMetricsOnly()).WillOnce(Return(false));
   EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
     ASSERT_EQ(snapshot.counters().size(), 1);
     EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "hello");
@@ -68,6 +69,7 @@ TEST(ServerInstanceUtil, flushHelper) {
   Stats::ParentHistogramSharedPtr parent_histogram(new Stats::MockParentHistogram());
   std::vector<Stats::ParentHistogramSharedPtr> parent_histograms = {parent_histogram};
   ON_CALL(mock_store, histograms).WillByDefault(Return(parent_histograms));
+  EXPECT_CALL(*sink, changedMetricsOnly()).WillOnce(Return(false));
   EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
     EXPECT_TRUE(snapshot.counters().empty());
     EXPECT_TRUE(snapshot.gauges().empty());
@@ -76,6 +78,90 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store);
 }
 
+// Sinks which only want changed metrics get a snapshot without the unchanged counters and gauges.
+TEST(ServerInstanceUtil, flushChangedMetricsOnly) {
+  InSequence s;
+
+  Stats::IsolatedStoreImpl store;
+  Stats::Counter& c1 = store.counter("c1");
+  store.counter("c2").inc();
+  Stats::Gauge& g1 = store.gauge("g1", Stats::Gauge::ImportMode::Accumulate);
+  store.gauge("g2", Stats::Gauge::ImportMode::Accumulate).set(5);
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* full_sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(full_sink);
+  Stats::MockSink* changed_sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(changed_sink);
+
+  // Every sink is asked whether it only wants changed metrics before the snapshot is taken.
+  EXPECT_CALL(*full_sink, changedMetricsOnly()).WillOnce(Return(false));
+  EXPECT_CALL(*changed_sink, changedMetricsOnly()).WillOnce(Return(true));
+  EXPECT_CALL(*full_sink, flush(_));
+  EXPECT_CALL(*changed_sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "c2");
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "g2");
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  c1.add(3);
+  g1.set(7);
+  EXPECT_CALL(*full_sink, changedMetricsOnly()).WillOnce(Return(false));
+  EXPECT_CALL(*changed_sink, changedMetricsOnly()).WillOnce(Return(true));
+  EXPECT_CALL(*full_sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+  }));
+  EXPECT_CALL(*changed_sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "c1");
+    EXPECT_EQ(snapshot.counters()[0].delta_, 3);
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "g1");
+    EXPECT_EQ(snapshot.gauges()[0].get().value(), 7);
+    EXPECT_TRUE(snapshot.histograms().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  // Nothing changed since the previous flush.
+  EXPECT_CALL(*full_sink, changedMetricsOnly()).WillOnce(Return(false));
+  EXPECT_CALL(*changed_sink, changedMetricsOnly()).WillOnce(Return(true));
+  EXPECT_CALL(*full_sink, flush(_));
+  EXPECT_CALL(*changed_sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
+// Gauges are only latched if some sink wants changed metrics.
+TEST(ServerInstanceUtil, flushWithoutChangedMetricsSinks) {
+  NiceMock<Stats::MockStore> store;
+  auto gauge = std::make_shared<StrictMock<Stats::MockGauge>>();
+  EXPECT_CALL(*gauge, importMode()).WillRepeatedly(Return(Stats::Gauge::ImportMode::Accumulate));
+  EXPECT_CALL(*gauge, latchChanged()).Times(0);
+  std::vector<Stats::GaugeSharedPtr> gauges = {gauge};
+  ON_CALL(store, gauges()).WillByDefault(Return(gauges));
+
+  std::list<Stats::SinkPtr> sinks;
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, changedMetricsOnly()).WillOnce(Return(false));
+  EXPECT_CALL(*sink, flush(_));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  EXPECT_CALL(*sink, changedMetricsOnly()).WillOnce(Return(true));
+  EXPECT_CALL(*gauge, latchChanged()).WillOnce(Return(true));
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.gauges().size(), 1);
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {